@@ -0,0 +1,377 @@
+#pragma once
+
+#include "gs/bytecode.hpp"
+#include "gs/export.hpp"
+#include "gs/vm.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace gs {
+
+// Native function bodies produced ahead of time by generateAotCpp (`gsc --aot-cpp`).
+//
+// The generated translation unit holds one C++ function per bytecode function plus a static
+// AotRegistration. Linking it into the host registers the bodies under a key computed from each
+// function's code and constants; when a loaded module calls a function with a matching key, the
+// VM runs the native body instead of interpreting it (see FunctionBytecode::aotBody).
+//
+// A native body works on the interpreter's own frame: locals, operand stack and registers. It
+// covers the numeric, comparison, local-variable and control-flow instructions, checks operand
+// types before it writes anything, and on any other instruction, unexpected operand or error
+// path hands the frame back to the interpreter at that instruction. Results, exceptions and
+// debugger-visible state are therefore the interpreter's; the native code only skips dispatch.
+struct AotFunctionEntry {
+    std::uint64_t key{0};
+    std::size_t codeSize{0};
+    AotFunction body{nullptr};
+};
+
+GS_API std::uint64_t aotFunctionKey(const Module& module, const FunctionBytecode& fn);
+GS_API void registerAotFunctions(const AotFunctionEntry* entries, std::size_t count);
+GS_API void unregisterAotFunctions(const AotFunctionEntry* entries, std::size_t count);
+GS_API std::size_t registeredAotFunctionCount();
+// Number of functions that were linked to a native body on their first call.
+GS_API std::size_t linkedAotFunctionCount();
+// On by default. Applies to functions that have not been called yet; a function keeps the body
+// it was linked to on its first call.
+GS_API void setAotFunctionsEnabled(bool enabled);
+GS_API bool aotFunctionsEnabled();
+// Links `fn` to its registered native body, if any. Called by the VM on the first call, once the
+// body is decoded.
+GS_API void resolveAotBody(const Module& module, const FunctionBytecode& fn);
+// The native functions, entry table and registration for `module`; generateAotCpp prepends them
+// to the module builder.
+GS_API std::string generateAotFunctions(const Module& module);
+
+// Registers a generated table for the lifetime of the object; the generated code holds one
+// as a static.
+class AotRegistration {
+public:
+    AotRegistration(const AotFunctionEntry* entries, std::size_t count)
+        : entries_(entries),
+          count_(count) {
+        registerAotFunctions(entries_, count_);
+    }
+    ~AotRegistration() { unregisterAotFunctions(entries_, count_); }
+
+    AotRegistration(const AotRegistration&) = delete;
+    AotRegistration& operator=(const AotRegistration&) = delete;
+
+private:
+    const AotFunctionEntry* entries_;
+    std::size_t count_;
+};
+
+GS_API bool isUpvalueCell(const Object* object);
+
+// Helpers called by generated code. Each operation mirrors the interpreter's fast path and
+// returns false where the interpreter would take another path (strings, objects, errors).
+namespace aot {
+
+#ifndef NDEBUG
+inline constexpr bool kCheckDeclaredTypes = true;
+#else
+inline constexpr bool kCheckDeclaredTypes = false;
+#endif
+// Backward jumps a native body takes before it returns to the interpreter, which then gets to
+// run its step accounting, GC slices and task switches.
+inline constexpr std::uint32_t kLoopFuel = 1024;
+
+inline void handback(Frame& frame, std::size_t sp, std::size_t ip) {
+    frame.stackTop = sp;
+    frame.ip = ip;
+    frame.aotHandbackIp = ip;
+}
+
+inline const Value& reg(const Frame& frame, std::size_t index) {
+    return index == 0 ? frame.registerValue : frame.registers[index];
+}
+
+inline void setReg(Frame& frame, std::size_t index, const Value& value) {
+    frame.registers[index] = value;
+    if (index == 0) {
+        frame.registerValue = value;
+    }
+}
+
+// A local the interpreter would load unchanged: not an upvalue cell and not a raw function,
+// class, module or string literal that it normalizes into an object.
+inline bool plain(const Value& value) {
+    switch (value.valueType()) {
+    case ValueType::Ref:
+        return !isUpvalueCell(value.asRef());
+    case ValueType::String:
+    case ValueType::Function:
+    case ValueType::Class:
+    case ValueType::Module:
+        return false;
+    default:
+        return true;
+    }
+}
+
+inline bool scalar(const Value& value) {
+    const ValueType type = value.valueType();
+    return type == ValueType::Nil || type == ValueType::Bool || type == ValueType::Int || type == ValueType::Float;
+}
+
+inline bool number(const Value& value) {
+    return value.isInt() || value.isFloat();
+}
+
+inline double toDouble(const Value& value) {
+    return value.isInt() ? static_cast<double>(value.rawPayload()) : value.asFloat();
+}
+
+inline bool truthy(const Value& value) {
+    switch (value.valueType()) {
+    case ValueType::Nil:
+        return false;
+    case ValueType::Bool:
+    case ValueType::Int:
+        return value.rawPayload() != 0;
+    case ValueType::Float:
+        return std::abs(value.asFloat()) > std::numeric_limits<double>::epsilon();
+    default:
+        return true;
+    }
+}
+
+inline bool makeInt(std::int64_t value, Value& out) {
+#if defined(GS_COMPACT_VALUE)
+    if (value < Value::kCompactIntMin || value > Value::kCompactIntMax) {
+        return false;
+    }
+#endif
+    out = Value::Int(value);
+    return true;
+}
+
+inline bool nonZero(double divisor) {
+    return std::abs(divisor) > std::numeric_limits<double>::epsilon();
+}
+
+inline bool add(const Value& lhs, const Value& rhs, Value& out) {
+    if (lhs.isInt() && rhs.isInt()) {
+        return makeInt(lhs.rawPayload() + rhs.rawPayload(), out);
+    }
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Float(toDouble(lhs) + toDouble(rhs));
+    return true;
+}
+
+inline bool sub(const Value& lhs, const Value& rhs, Value& out) {
+    if (lhs.isInt() && rhs.isInt()) {
+        return makeInt(lhs.rawPayload() - rhs.rawPayload(), out);
+    }
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Float(toDouble(lhs) - toDouble(rhs));
+    return true;
+}
+
+inline bool mul(const Value& lhs, const Value& rhs, Value& out) {
+    if (lhs.isInt() && rhs.isInt()) {
+        return makeInt(lhs.rawPayload() * rhs.rawPayload(), out);
+    }
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Float(toDouble(lhs) * toDouble(rhs));
+    return true;
+}
+
+inline bool div(const Value& lhs, const Value& rhs, Value& out) {
+    if (!number(lhs) || !number(rhs) || !nonZero(toDouble(rhs))) {
+        return false;
+    }
+    out = Value::Float(toDouble(lhs) / toDouble(rhs));
+    return true;
+}
+
+inline bool floorDiv(const Value& lhs, const Value& rhs, Value& out) {
+    if (!number(lhs) || !number(rhs) || !nonZero(toDouble(rhs))) {
+        return false;
+    }
+    return makeInt(static_cast<std::int64_t>(std::floor(toDouble(lhs) / toDouble(rhs))), out);
+}
+
+inline bool mod(const Value& lhs, const Value& rhs, Value& out) {
+    if (lhs.isInt() && rhs.isInt()) {
+        return rhs.rawPayload() != 0 && makeInt(lhs.rawPayload() % rhs.rawPayload(), out);
+    }
+    if (!number(lhs) || !number(rhs) || !nonZero(toDouble(rhs))) {
+        return false;
+    }
+    out = Value::Float(std::fmod(toDouble(lhs), toDouble(rhs)));
+    return true;
+}
+
+inline bool pow(const Value& lhs, const Value& rhs, Value& out) {
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Float(std::pow(toDouble(lhs), toDouble(rhs)));
+    return true;
+}
+
+inline bool lessThan(const Value& lhs, const Value& rhs, Value& out) {
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Int(toDouble(lhs) < toDouble(rhs) ? 1 : 0);
+    return true;
+}
+
+inline bool greaterThan(const Value& lhs, const Value& rhs, Value& out) {
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Int(toDouble(lhs) > toDouble(rhs) ? 1 : 0);
+    return true;
+}
+
+inline bool lessEqual(const Value& lhs, const Value& rhs, Value& out) {
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Int(toDouble(lhs) <= toDouble(rhs) ? 1 : 0);
+    return true;
+}
+
+inline bool greaterEqual(const Value& lhs, const Value& rhs, Value& out) {
+    if (!number(lhs) || !number(rhs)) {
+        return false;
+    }
+    out = Value::Int(toDouble(lhs) >= toDouble(rhs) ? 1 : 0);
+    return true;
+}
+
+// Strings and objects compare through the interpreter.
+inline bool equal(const Value& lhs, const Value& rhs, Value& out) {
+    if (!scalar(lhs) || !scalar(rhs)) {
+        return false;
+    }
+    bool same = false;
+    if (number(lhs) && number(rhs)) {
+        same = std::abs(toDouble(lhs) - toDouble(rhs)) <= std::numeric_limits<double>::epsilon();
+    } else {
+        same = lhs.valueType() == rhs.valueType() && lhs.rawPayload() == rhs.rawPayload();
+    }
+    out = Value::Int(same ? 1 : 0);
+    return true;
+}
+
+inline bool notEqual(const Value& lhs, const Value& rhs, Value& out) {
+    if (!equal(lhs, rhs, out)) {
+        return false;
+    }
+    out = Value::Int(out.rawPayload() == 0 ? 1 : 0);
+    return true;
+}
+
+inline bool is(const Value& lhs, const Value& rhs, Value& out) {
+    if (!scalar(lhs) || !scalar(rhs)) {
+        return false;
+    }
+    out = Value::Int(lhs.valueType() == rhs.valueType() && lhs.rawPayload() == rhs.rawPayload() ? 1 : 0);
+    return true;
+}
+
+inline bool isNot(const Value& lhs, const Value& rhs, Value& out) {
+    if (!is(lhs, rhs, out)) {
+        return false;
+    }
+    out = Value::Int(out.rawPayload() == 0 ? 1 : 0);
+    return true;
+}
+
+inline bool bitAnd(const Value& lhs, const Value& rhs, Value& out) {
+    return lhs.isInt() && rhs.isInt() && makeInt(lhs.rawPayload() & rhs.rawPayload(), out);
+}
+
+inline bool bitOr(const Value& lhs, const Value& rhs, Value& out) {
+    return lhs.isInt() && rhs.isInt() && makeInt(lhs.rawPayload() | rhs.rawPayload(), out);
+}
+
+inline bool bitXor(const Value& lhs, const Value& rhs, Value& out) {
+    return lhs.isInt() && rhs.isInt() && makeInt(lhs.rawPayload() ^ rhs.rawPayload(), out);
+}
+
+inline bool shiftLeft(const Value& lhs, const Value& rhs, Value& out) {
+    return lhs.isInt() && rhs.isInt() && makeInt(lhs.rawPayload() << rhs.rawPayload(), out);
+}
+
+inline bool shiftRight(const Value& lhs, const Value& rhs, Value& out) {
+    return lhs.isInt() && rhs.isInt() && makeInt(lhs.rawPayload() >> rhs.rawPayload(), out);
+}
+
+inline bool logicalAnd(const Value& lhs, const Value& rhs, Value& out) {
+    out = Value::Int(truthy(lhs) && truthy(rhs) ? 1 : 0);
+    return true;
+}
+
+inline bool logicalOr(const Value& lhs, const Value& rhs, Value& out) {
+    out = Value::Int(truthy(lhs) || truthy(rhs) ? 1 : 0);
+    return true;
+}
+
+inline bool negate(const Value& operand, Value& out) {
+    if (operand.isInt()) {
+        return makeInt(-operand.rawPayload(), out);
+    }
+    if (!operand.isFloat()) {
+        return false;
+    }
+    out = Value::Float(-operand.asFloat());
+    return true;
+}
+
+inline bool logicalNot(const Value& operand, Value& out) {
+    out = Value::Int(truthy(operand) ? 0 : 1);
+    return true;
+}
+
+inline bool bitNot(const Value& operand, Value& out) {
+    return operand.isInt() && makeInt(~operand.rawPayload(), out);
+}
+
+// The interpreter's linked-name fast path; unlinked names and unassigned globals are resolved
+// by the interpreter.
+inline bool loadName(const Frame& frame, std::int32_t nameIndex, Value& out) {
+    const ModuleGlobals* globals = frame.globals;
+    const auto index = static_cast<std::size_t>(nameIndex);
+    if (!globals || index >= globals->names.size()) {
+        return false;
+    }
+    const NameSlot& slot = globals->names[index];
+    if (slot.kind == NameSlot::Kind::Value) {
+        out = slot.value;
+        return true;
+    }
+    if (slot.kind == NameSlot::Kind::Global && globals->assigned[slot.global]) {
+        out = globals->values[slot.global];
+        return true;
+    }
+    return false;
+}
+
+// Writes through to a plain local; a captured local (an upvalue cell) needs a write barrier.
+inline bool storeLocal(Value& local, const Value& value) {
+    if (local.isRef() && isUpvalueCell(local.asRef())) {
+        return false;
+    }
+    local = value;
+    return true;
+}
+
+} // namespace aot
+
+} // namespace gs
@@ -4,8 +4,11 @@
 #include "gs/bytecode.hpp"
 #include "gs/type_system.hpp"  // Required for Object, Type
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -34,22 +37,56 @@ public:
     virtual std::string typeName(const Value& value) = 0;
     virtual std::uint64_t objectId(const Value& ref) = 0;
     virtual Value collectGarbage(std::int64_t generation) = 0;
+    virtual std::size_t memoryUsage() = 0;
+    // Lowers the context's quota (`system.setMemoryLimit`); a maxObjects of 0 keeps the current
+    // object limit. Throws when a limit would rise above the current one or fall below usage.
+    virtual void setMemoryLimits(std::size_t maxBytes, std::size_t maxObjects) = 0;
     virtual void ensureModuleInitialized(const Value& moduleRef) = 0;
     virtual bool tryGetCachedModuleObject(const std::string& moduleKey, Value& outModuleRef) = 0;
     virtual void cacheModuleObject(const std::string& moduleKey, const Value& moduleRef) = 0;
+    // Runs script callable `callable` over `items` on the task pool and returns a list of the
+    // results in order; with `fold`, one left fold per chunk of items (the `parallel` module).
+    virtual Value parallelApply(const Value& callable, const std::vector<Value>& items, bool fold) = 0;
+    // Spawned tasks by handle (`await_all`, `await_any`, `poll`). awaitTasks returns a list of
+    // their results in handle order; awaitAnyTask returns the result of the first to finish and
+    // its position in `handles`. A task's uncaught exception is rethrown.
+    virtual Value awaitTasks(const std::vector<Value>& handles) = 0;
+    virtual Value awaitAnyTask(const std::vector<Value>& handles, std::size_t& position) = 0;
+    virtual bool pollTask(const Value& handle) = 0;
 };
 
 using HostFunction = std::function<Value(HostContext& context, const std::vector<Value>&)>;
 
+// Span calling convention: `args` points at the caller's operand stack and stays valid for the
+// duration of the call, so CallHost passes arguments without copying them.
+using HostSpanFunction = std::function<Value(HostContext& context, const Value* args, std::size_t argc)>;
+
+// Stable index of a host function in its HostRegistry, resolved once per call site. Rebinding a
+// name keeps its handle.
+using HostHandle = std::uint32_t;
+inline constexpr HostHandle kInvalidHostHandle = ~HostHandle{0};
+
 // ============================================================================
-// HostRegistry (unchanged from original)
+// HostRegistry
 // ============================================================================
 
+// Builtins by name. Functions may be bound while scripts run on other threads: readers never
+// take the registry's lock. The name table is an immutable map that a writer copies, edits and
+// publishes with one atomic pointer store under the write mutex; readers load that pointer. Each
+// handle points at an immutable FunctionSlot, so a rebind publishes a new slot and the call path
+// (functionSlot) is two acquire loads. Readers hold a ReadGuard while they use either (the VM
+// holds one per execute() slice), and a replaced map or slot is freed by a later write once
+// every guard entered before the replacement has been released.
 class GS_API HostRegistry {
 public:
     HostRegistry();
+    ~HostRegistry();
+
+    HostRegistry(const HostRegistry&) = delete;
+    HostRegistry& operator=(const HostRegistry&) = delete;
 
     void bind(const std::string& name, HostFunction fn);
+    void bindSpan(const std::string& name, HostSpanFunction fn);
     void defineModule(const std::string& moduleName);
     void bindModuleFunction(const std::string& moduleName,
                             const std::string& exportName,
@@ -57,6 +94,33 @@ public:
     bool has(const std::string& name) const;
     bool hasModule(const std::string& name) const;
     Value invoke(const std::string& name, HostContext& context, const std::vector<Value>& args) const;
+
+    struct FunctionSlot {
+        std::string name;
+        HostFunction function;         // set by bind()
+        HostSpanFunction spanFunction; // set by bindSpan()
+    };
+
+    // Epoch-based read section. Entering counts the reader under the current epoch; a writer
+    // only advances the epoch once the readers of the epoch before the current one have left, and
+    // frees what it replaced two epochs later. Guards may nest.
+    class GS_API ReadGuard {
+    public:
+        explicit ReadGuard(const HostRegistry& registry);
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        const HostRegistry& registry_;
+        std::uint64_t epoch_;
+    };
+
+    // kInvalidHostHandle when `name` is not a bound function.
+    HostHandle resolveHandle(const std::string& name) const;
+    // The function bound to `handle` when this is called; valid while the caller holds a ReadGuard.
+    const FunctionSlot& functionSlot(HostHandle handle) const;
     Value resolveBuiltin(const std::string& name,
                          HostContext& context,
                          NativeFunctionType& nativeFunctionType,
@@ -70,11 +134,44 @@ private:
         };
 
         Kind kind{Kind::Function};
-        HostFunction function;
+        HostHandle handle{kInvalidHostHandle}; // index into the slot table for Kind::Function
         std::unordered_map<std::string, HostFunction> moduleFunctions;
     };
 
-    std::unordered_map<std::string, BuiltinEntry> builtins_;
+    // Entries are shared between snapshots; an edit replaces the entry it changes.
+    using BuiltinMap = std::unordered_map<std::string, std::shared_ptr<const BuiltinEntry>>;
+
+    // Slot chunk k holds kFirstSlotChunk << k handles; chunks are allocated on demand and never move.
+    static constexpr std::size_t kFirstSlotChunk = 64;
+    static constexpr std::size_t kSlotChunkCount = 16;
+
+    // A map or slot a writer replaced, with the epoch it was replaced in.
+    struct Retired {
+        std::uint64_t epoch{0};
+        std::unique_ptr<const BuiltinMap> map;
+        std::unique_ptr<const FunctionSlot> slot;
+    };
+
+    // Readers need a ReadGuard; writers hold writeMutex_.
+    const BuiltinMap& snapshot() const { return *builtins_.load(std::memory_order_acquire); }
+    const BuiltinEntry* findEntry(const BuiltinMap& builtins, const std::string& name) const;
+    void publishSlot(const std::string& name, FunctionSlot slot);
+    void publishMap(std::unique_ptr<const BuiltinMap> next);
+    void reclaimRetired();
+    std::atomic<const FunctionSlot*>& slotAt(HostHandle handle) const;
+    HostFunction callableFor(const FunctionSlot& slot) const;
+
+    std::atomic<const BuiltinMap*> builtins_;
+    std::array<std::atomic<std::atomic<const FunctionSlot*>*>, kSlotChunkCount> slotChunks_{};
+
+    // Readers entered under each epoch parity; only writers advance epoch_.
+    alignas(64) mutable std::atomic<std::uint64_t> epoch_{0};
+    mutable std::array<std::atomic<std::uint32_t>, 2> readers_{};
+
+    // Writers only, under writeMutex_.
+    alignas(64) std::mutex writeMutex_;
+    HostHandle slotCount_{0};
+    std::vector<Retired> retired_;
 };
 
 // ============================================================================
@@ -202,11 +299,31 @@ std::tuple<Args...> unpackArgs(HostContext& ctx, const std::vector<Value>& args,
     return std::make_tuple(TypeConverter<Args>::fromValue(ctx, args[Is])...);
 }
 
+template<typename... Args, std::size_t... Is>
+std::tuple<Args...> unpackArgs(HostContext& ctx, const Value* args, std::size_t argc, std::index_sequence<Is...>) {
+    if (argc != sizeof...(Args)) {
+        throw std::runtime_error("Argument count mismatch");
+    }
+    return std::make_tuple(TypeConverter<Args>::fromValue(ctx, args[Is])...);
+}
+
 // Function wrapper
 template<typename R, typename... Args>
 struct FunctionWrapper {
     using FuncType = std::function<R(Args...)>;
     
+    template<typename F>
+    static Value invoke(HostContext& ctx, const Value* args, std::size_t argc, const F& func) {
+        auto argTuple = unpackArgs<Args...>(ctx, args, argc, std::index_sequence_for<Args...>{});
+        if constexpr (std::is_void_v<R>) {
+            std::apply(func, argTuple);
+            return TypeConverter<void>::toValue(ctx);
+        } else {
+            R result = std::apply(func, argTuple);
+            return TypeConverter<R>::toValue(ctx, result);
+        }
+    }
+
     static Value invoke(HostContext& ctx, const std::vector<Value>& args, FuncType func) {
         auto argTuple = unpackArgs<Args...>(ctx, args, std::index_sequence_for<Args...>{});
         if constexpr (std::is_void_v<R>) {
@@ -322,17 +439,16 @@ public:
     // Bind global function pointer
     template<typename R, typename... Args>
     void function(const std::string& name, R (*func)(Args...)) {
-        using FuncType = std::function<R(Args...)>;
-        registry_.bind(name, [func](HostContext& ctx, const std::vector<Value>& args) {
-            return detail::FunctionWrapper<R, Args...>::invoke(ctx, args, FuncType(func));
+        registry_.bindSpan(name, [func](HostContext& ctx, const Value* args, std::size_t argc) {
+            return detail::FunctionWrapper<R, Args...>::invoke(ctx, args, argc, func);
         });
     }
     
     // Bind std::function
     template<typename R, typename... Args>
     void function(const std::string& name, std::function<R(Args...)> func) {
-        registry_.bind(name, [func](HostContext& ctx, const std::vector<Value>& args) {
-            return detail::FunctionWrapper<R, Args...>::invoke(ctx, args, func);
+        registry_.bindSpan(name, [func](HostContext& ctx, const Value* args, std::size_t argc) {
+            return detail::FunctionWrapper<R, Args...>::invoke(ctx, args, argc, func);
         });
     }
     
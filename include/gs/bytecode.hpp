@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace gs {
@@ -25,6 +33,199 @@ enum class ValueType : std::uint8_t {
     Module
 };
 
+// Value has two layouts selected at build time. The default is a ValueType tag plus an
+// 8-byte payload (16 bytes with padding). With GS_COMPACT_VALUE the same API is backed
+// by a single NaN-boxed 64-bit word: doubles are stored as-is (NaNs canonicalized), and
+// every other kind lives in the negative quiet-NaN space with a 3-bit tag and a 48-bit
+// payload. Compact mode narrows integers to 48-bit signed; Value::Int throws when a
+// result does not fit. Code outside this header must go through the accessors below
+// (valueType()/rawPayload()/FromRaw()) rather than touching the storage directly.
+#if defined(GS_COMPACT_VALUE)
+struct Value {
+    static constexpr std::int64_t kCompactIntMin = -(std::int64_t{1} << 47);
+    static constexpr std::int64_t kCompactIntMax = (std::int64_t{1} << 47) - 1;
+
+    Value() : bits_(kBoxPrefix) {}
+
+    static Value Nil() { return {}; }
+    static Value Bool(bool v) { return boxed(ValueType::Bool, v ? 1 : 0); }
+    static Value Int(std::int64_t v) {
+        if (v < kCompactIntMin || v > kCompactIntMax) {
+            throw std::runtime_error("Integer out of range for compact value: " + std::to_string(v));
+        }
+        return boxed(ValueType::Int, v);
+    }
+    static Value String(std::int64_t index) { return boxed(ValueType::String, index); }
+    static Value Float(double v) {
+        static_assert(sizeof(double) == sizeof(std::uint64_t), "double size must match compact value word");
+        Value out;
+        if (v != v) {
+            out.bits_ = kCanonicalNaN;
+        } else {
+            std::memcpy(&out.bits_, &v, sizeof(double));
+        }
+        return out;
+    }
+    static Value Ref(Object* ptr) {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        if ((static_cast<std::uint64_t>(address) & ~kPayloadMask) != 0) {
+            throw std::runtime_error("Object address does not fit in compact value");
+        }
+        return boxed(ValueType::Ref, static_cast<std::int64_t>(address));
+    }
+    static Value Function(std::int64_t functionIndex) { return boxed(ValueType::Function, functionIndex); }
+    static Value Class(std::int64_t classIndex) { return boxed(ValueType::Class, classIndex); }
+    static Value Module(std::int64_t moduleIndex) { return boxed(ValueType::Module, moduleIndex); }
+    static Value FromRaw(ValueType type, std::int64_t payload) {
+        switch (type) {
+        case ValueType::Nil:
+            return Nil();
+        case ValueType::Float: {
+            double value = 0.0;
+            std::memcpy(&value, &payload, sizeof(double));
+            return Float(value);
+        }
+        case ValueType::Int:
+            return Int(payload);
+        default:
+            return boxed(type, payload);
+        }
+    }
+
+    ValueType valueType() const {
+        if ((bits_ & kBoxPrefix) != kBoxPrefix) {
+            return ValueType::Float;
+        }
+        return tagToType(static_cast<std::uint8_t>((bits_ >> kTagShift) & kTagMask));
+    }
+    // Integer view of the payload: sign-extended for Int, the IEEE bits for Float, the
+    // address for Ref and the index for the remaining kinds.
+    std::int64_t rawPayload() const {
+        if ((bits_ & kBoxPrefix) != kBoxPrefix) {
+            return static_cast<std::int64_t>(bits_);
+        }
+        const std::uint64_t low = bits_ & kPayloadMask;
+        return static_cast<std::int64_t>(low << 16) >> 16;
+    }
+
+    bool isBool() const { return hasTag(ValueType::Bool); }
+    bool isInt() const { return hasTag(ValueType::Int); }
+    bool isFloat() const { return (bits_ & kBoxPrefix) != kBoxPrefix; }
+    // Keep isString() for compatibility with existing call sites.
+    bool isString() const { return hasTag(ValueType::String); }
+    bool isLegacyStringLiteral() const { return hasTag(ValueType::String); }
+    bool isRef() const { return hasTag(ValueType::Ref); }
+    bool isFunction() const { return hasTag(ValueType::Function); }
+    bool isClass() const { return hasTag(ValueType::Class); }
+    bool isModule() const { return hasTag(ValueType::Module); }
+    bool isNil() const { return bits_ == kBoxPrefix; }
+
+    bool asBool() const {
+        if (!isBool()) {
+            throw std::runtime_error("Value is not boolean");
+        }
+        return (bits_ & kPayloadMask) != 0;
+    }
+
+    std::int64_t asInt() const {
+        if (!isInt()) {
+            throw std::runtime_error("Value is not integer");
+        }
+        return rawPayload();
+    }
+
+    double asFloat() const {
+        if (!isFloat()) {
+            throw std::runtime_error("Value is not float");
+        }
+        double out = 0.0;
+        std::memcpy(&out, &bits_, sizeof(double));
+        return out;
+    }
+
+    Object* asRef() const {
+        if (!isRef()) {
+            throw std::runtime_error("Value is not reference");
+        }
+        return reinterpret_cast<Object*>(static_cast<std::uintptr_t>(bits_ & kPayloadMask));
+    }
+
+    std::int64_t asStringIndex() const {
+        if (!isLegacyStringLiteral()) {
+            throw std::runtime_error("Value is not string");
+        }
+        return rawPayload();
+    }
+
+    std::int64_t asFunctionIndex() const {
+        if (!isFunction()) {
+            throw std::runtime_error("Value is not function");
+        }
+        return rawPayload();
+    }
+
+    std::int64_t asClassIndex() const {
+        if (!isClass()) {
+            throw std::runtime_error("Value is not class");
+        }
+        return rawPayload();
+    }
+
+    std::int64_t asModuleIndex() const {
+        if (!isModule()) {
+            throw std::runtime_error("Value is not module");
+        }
+        return rawPayload();
+    }
+
+private:
+    // Top 13 bits set: a negative quiet NaN. Float() never produces this pattern because
+    // every NaN is canonicalized to the positive kCanonicalNaN.
+    static constexpr std::uint64_t kBoxPrefix = 0xFFF8000000000000ULL;
+    static constexpr std::uint64_t kCanonicalNaN = 0x7FF8000000000000ULL;
+    static constexpr std::uint64_t kPayloadMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr std::uint64_t kTagMask = 0x7;
+    static constexpr int kTagShift = 48;
+
+    // Nil takes tag 0 so that the default word is the bare box prefix.
+    static std::uint8_t typeToTag(ValueType type) {
+        switch (type) {
+        case ValueType::Nil: return 0;
+        case ValueType::Bool: return 1;
+        case ValueType::Int: return 2;
+        case ValueType::String: return 3;
+        case ValueType::Ref: return 4;
+        case ValueType::Function: return 5;
+        case ValueType::Class: return 6;
+        case ValueType::Module: return 7;
+        case ValueType::Float: break;
+        }
+        throw std::runtime_error("Float values are not boxed");
+    }
+
+    static ValueType tagToType(std::uint8_t tag) {
+        static constexpr ValueType kTypes[] = {ValueType::Nil,      ValueType::Bool,  ValueType::Int,
+                                               ValueType::String,   ValueType::Ref,   ValueType::Function,
+                                               ValueType::Class,    ValueType::Module};
+        return kTypes[tag];
+    }
+
+    static Value boxed(ValueType type, std::int64_t payload) {
+        Value out;
+        out.bits_ = kBoxPrefix | (static_cast<std::uint64_t>(typeToTag(type)) << kTagShift) |
+                    (static_cast<std::uint64_t>(payload) & kPayloadMask);
+        return out;
+    }
+
+    bool hasTag(ValueType type) const {
+        return (bits_ & ~kPayloadMask) == (kBoxPrefix | (static_cast<std::uint64_t>(typeToTag(type)) << kTagShift));
+    }
+
+    std::uint64_t bits_;
+};
+
+static_assert(sizeof(Value) == 8, "compact Value must be a single 64-bit word");
+#else
 struct Value {
     ValueType type{ValueType::Nil};
     union {
@@ -86,6 +287,15 @@ struct Value {
         out.payload = moduleIndex;
         return out;
     }
+    static Value FromRaw(ValueType type, std::int64_t payload) {
+        Value out;
+        out.type = type;
+        out.payload = payload;
+        return out;
+    }
+
+    ValueType valueType() const { return type; }
+    std::int64_t rawPayload() const { return type == ValueType::Ref ? reinterpret_cast<std::intptr_t>(object) : payload; }
 
     bool isBool() const { return type == ValueType::Bool; }
     bool isInt() const { return type == ValueType::Int; }
@@ -157,35 +367,36 @@ struct Value {
         return payload;
     }
 };
+#endif
 
 inline std::ostream& operator<<(std::ostream& os, const Value& value) {
-    switch (value.type) {
+    switch (value.valueType()) {
     case ValueType::Nil:
         os << "null";
         break;
     case ValueType::Bool:
-        os << (value.payload ? "true" : "false");
+        os << (value.rawPayload() ? "true" : "false");
         break;
     case ValueType::Int:
-        os << value.payload;
+        os << value.rawPayload();
         break;
     case ValueType::Float:
         os << value.asFloat();
         break;
     case ValueType::String:
-        os << "str(" << value.payload << ')';
+        os << "str(" << value.rawPayload() << ')';
         break;
     case ValueType::Ref:
-        os << "ref(" << static_cast<const void*>(value.object) << ')';
+        os << "ref(" << static_cast<const void*>(value.asRef()) << ')';
         break;
     case ValueType::Function:
-        os << "fn(" << value.payload << ')';
+        os << "fn(" << value.rawPayload() << ')';
         break;
     case ValueType::Class:
-        os << "class(" << value.payload << ')';
+        os << "class(" << value.rawPayload() << ')';
         break;
     case ValueType::Module:
-        os << "module(" << value.payload << ')';
+        os << "module(" << value.rawPayload() << ')';
         break;
     }
     return os;
@@ -261,7 +472,14 @@ enum class OpCode : std::uint8_t {
     StoreLocalFromReg,
     StoreNameFromReg,
     PushLocal,
-    PushName
+    PushName,
+    // Pops a value and performs `local[a] = local[a] + value`, extending a string the
+    // instruction produced earlier in place (see LoopAccumulatorAnalysis in compiler.cpp).
+    AppendLocal,
+    // Ends in-place appends to the string currently held by local[a].
+    SealLocal,
+    // Pushes Module::importSymbols[a], resolved against the imported module once per context.
+    LoadImport
 };
 
 //struct Instruction {
@@ -290,6 +508,77 @@ struct Instruction {
     std::size_t column{0};  // Source column number for debugging
 };
 
+// Body of a function that is produced on its first call: still encoded in a mapped GSBC3 image,
+// or still a parsed declaration awaiting code generation (see bytecode_image.hpp).
+class LazyFunctionBody;
+
+// Copyable atomic "body is ready" bit. Eagerly compiled functions start ready; functions loaded
+// from a GSBC3 image or compiled lazily start pending and are materialized on first call.
+class BodyReadyFlag {
+public:
+    BodyReadyFlag() = default;
+    BodyReadyFlag(const BodyReadyFlag& other) noexcept : ready_(other.ready()) {}
+    BodyReadyFlag& operator=(const BodyReadyFlag& other) noexcept {
+        ready_.store(other.ready(), std::memory_order_release);
+        return *this;
+    }
+
+    bool ready() const { return ready_.load(std::memory_order_acquire); }
+    void set(bool ready) const { ready_.store(ready, std::memory_order_release); }
+
+private:
+    mutable std::atomic<bool> ready_{true};
+};
+
+// Copyable atomic link from a function or class that a hot reload superseded to the entry that
+// replaced it (see patchModuleSource). Negative while the entry is current.
+class ReplacementLink {
+public:
+    ReplacementLink() = default;
+    ReplacementLink(const ReplacementLink& other) noexcept : index_(other.get()) {}
+    ReplacementLink& operator=(const ReplacementLink& other) noexcept {
+        index_.store(other.get(), std::memory_order_release);
+        return *this;
+    }
+
+    std::int64_t get() const { return index_.load(std::memory_order_acquire); }
+    void set(std::size_t index) const { index_.store(static_cast<std::int64_t>(index), std::memory_order_release); }
+
+private:
+    mutable std::atomic<std::int64_t> index_{-1};
+};
+
+struct Frame;
+
+// Native body generated by generateAotCpp (see aot.hpp). It runs the frame from `frame.ip` and
+// returns at the first instruction it leaves to the interpreter; `code` is the function's code.
+using AotFunction = void (*)(Frame& frame, const Instruction* code);
+
+// Copyable atomic link to a function's native body, looked up once on its first call.
+class AotBodyLink {
+public:
+    AotBodyLink() = default;
+    AotBodyLink(const AotBodyLink& other) noexcept
+        : body_(other.body_.load(std::memory_order_acquire)),
+          resolved_(other.resolved()) {}
+    AotBodyLink& operator=(const AotBodyLink& other) noexcept {
+        body_.store(other.body_.load(std::memory_order_acquire), std::memory_order_release);
+        resolved_.store(other.resolved(), std::memory_order_release);
+        return *this;
+    }
+
+    AotFunction get() const { return body_.load(std::memory_order_acquire); }
+    bool resolved() const { return resolved_.load(std::memory_order_acquire); }
+    void resolve(AotFunction body) const {
+        body_.store(body, std::memory_order_release);
+        resolved_.store(true, std::memory_order_release);
+    }
+
+private:
+    mutable std::atomic<AotFunction> body_{nullptr};
+    mutable std::atomic<bool> resolved_{false};
+};
+
 struct FunctionBytecode {
     std::string name;
     std::vector<std::string> params;
@@ -298,6 +587,19 @@ struct FunctionBytecode {
     std::size_t localCount{0};
     std::size_t stackSlotCount{0};
     std::vector<std::string> localTypeNames;
+    // Sorted instruction indices whose allocation may live in the frame region (see FrameRegion).
+    std::vector<std::uint32_t> nonEscapingAllocSites;
+    // Set for functions loaded from a GSBC3 image or compiled lazily: `code`, `stackSlotCount`,
+    // the local tables and `nonEscapingAllocSites` are only valid once ensureFunctionDecoded()
+    // has run. The name and parameters are always set.
+    std::shared_ptr<const LazyFunctionBody> lazyBody;
+    BodyReadyFlag bodyReady;
+    // Hash of the declaration's tokens when compiled from source, else 0. Hot reload compares it
+    // to find the functions an edit touched.
+    std::uint64_t sourceFingerprint{0};
+    // Set when a hot reload appended a newer version of this function; new calls run that one.
+    ReplacementLink replacedBy;
+    AotBodyLink aotBody;
 };
 
 struct ClassMethodBinding {
@@ -317,6 +619,13 @@ struct ClassBytecode {
     std::string baseNativeTypeName;
     std::vector<ClassAttributeBinding> attributes;
     std::vector<ClassMethodBinding> methods;
+    // Set when a hot reload appended a version of this class with another attribute or method
+    // list. The first entry of a class stays its identity (instances, `is`, base links); its
+    // layout is read from the last version.
+    ReplacementLink replacedBy;
+    // Attributes the previous version declared and this one does not; instances migrated to
+    // this version drop them.
+    std::vector<std::string> retiredAttributes;
 };
 
 struct GlobalBinding {
@@ -325,13 +634,256 @@ struct GlobalBinding {
     std::string declaredTypeName;
 };
 
+// One `import` / `from ... import` declaration. The runtime links it before the module's
+// __module_init__ runs and stores the result in the module global `localName`.
+struct ModuleImport {
+    std::string moduleSpec;
+    std::string localName;
+    // Requested exports; empty binds the whole module.
+    std::vector<std::string> symbols;
+    // `from m import f`: bind the single export in `symbols` instead of a module object.
+    bool bindsSymbol{false};
+};
+
+// An export of an imported module referenced by LoadImport.
+struct ImportSymbol {
+    std::uint32_t importIndex{0};
+    std::string name;
+};
+
+// Growable array whose elements never move once appended. Lazily compiled function bodies
+// extend a module's tables while frames hold references into them and other threads index them,
+// so those tables use this instead of std::vector. Appends must be serialized by the caller; an
+// index may be read once the append that produced it is visible, which for bytecode operands is
+// guaranteed by FunctionBytecode::bodyReady.
+template <typename T>
+class StableVector {
+    // Chunk k holds kFirstChunk << k elements; chunks are allocated on demand and never moved.
+    static constexpr std::size_t kFirstChunk = 16;
+    static constexpr std::size_t kChunkCount = 40;
+
+    static std::size_t chunkOf(std::size_t index) {
+        return static_cast<std::size_t>(std::bit_width(index / kFirstChunk + 1)) - 1;
+    }
+    static std::size_t chunkStart(std::size_t chunk) {
+        return kFirstChunk * ((std::size_t{1} << chunk) - 1);
+    }
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using owner_type = std::conditional_t<Const, const StableVector, StableVector>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+
+        Iterator() = default;
+        Iterator(owner_type* owner, std::size_t index) : owner_(owner), index_(index) {}
+        operator Iterator<true>() const { return {owner_, index_}; }
+
+        reference operator*() const { return (*owner_)[index_]; }
+        pointer operator->() const { return &(*owner_)[index_]; }
+        reference operator[](difference_type n) const { return (*owner_)[index_ + n]; }
+        Iterator& operator++() { ++index_; return *this; }
+        Iterator operator++(int) { Iterator copy = *this; ++index_; return copy; }
+        Iterator& operator--() { --index_; return *this; }
+        Iterator operator--(int) { Iterator copy = *this; --index_; return copy; }
+        Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+        Iterator operator+(difference_type n) const { return {owner_, index_ + n}; }
+        Iterator operator-(difference_type n) const { return {owner_, index_ - n}; }
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+        difference_type operator-(const Iterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        auto operator<=>(const Iterator& other) const { return index_ <=> other.index_; }
+
+    private:
+        owner_type* owner_{nullptr};
+        std::size_t index_{0};
+    };
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    StableVector() = default;
+    StableVector(std::initializer_list<T> values) {
+        for (const auto& value : values) {
+            emplace_back(value);
+        }
+    }
+    StableVector(const StableVector& other) {
+        for (const auto& value : other) {
+            emplace_back(value);
+        }
+    }
+    StableVector(StableVector&& other) noexcept { steal(other); }
+    StableVector& operator=(const StableVector& other) {
+        if (this != &other) {
+            clear();
+            for (const auto& value : other) {
+                emplace_back(value);
+            }
+        }
+        return *this;
+    }
+    StableVector& operator=(StableVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            steal(other);
+        }
+        return *this;
+    }
+    ~StableVector() { clear(); }
+
+    std::size_t size() const { return size_.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+
+    T& operator[](std::size_t index) {
+        const std::size_t chunk = chunkOf(index);
+        return chunks_[chunk].load(std::memory_order_acquire)[index - chunkStart(chunk)];
+    }
+    const T& operator[](std::size_t index) const {
+        const std::size_t chunk = chunkOf(index);
+        return chunks_[chunk].load(std::memory_order_acquire)[index - chunkStart(chunk)];
+    }
+    T& at(std::size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("StableVector index out of range");
+        }
+        return (*this)[index];
+    }
+    const T& at(std::size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("StableVector index out of range");
+        }
+        return (*this)[index];
+    }
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[size() - 1]; }
+    const T& back() const { return (*this)[size() - 1]; }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        const std::size_t index = size_.load(std::memory_order_relaxed);
+        const std::size_t chunk = chunkOf(index);
+        T* storage = chunks_[chunk].load(std::memory_order_relaxed);
+        if (!storage) {
+            storage = std::allocator<T>().allocate(kFirstChunk << chunk);
+            chunks_[chunk].store(storage, std::memory_order_release);
+        }
+        T* slot = std::construct_at(storage + (index - chunkStart(chunk)), std::forward<Args>(args)...);
+        size_.store(index + 1, std::memory_order_release);
+        return *slot;
+    }
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void reserve(std::size_t) {}
+    void resize(std::size_t count) {
+        while (size() > count) {
+            const std::size_t last = size() - 1;
+            std::destroy_at(&(*this)[last]);
+            size_.store(last, std::memory_order_release);
+        }
+        while (size() < count) {
+            emplace_back();
+        }
+    }
+    void clear() {
+        resize(0);
+        for (std::size_t chunk = 0; chunk < kChunkCount; ++chunk) {
+            if (T* storage = chunks_[chunk].exchange(nullptr, std::memory_order_relaxed)) {
+                std::allocator<T>().deallocate(storage, kFirstChunk << chunk);
+            }
+        }
+    }
+
+    friend bool operator==(const StableVector& lhs, const StableVector& rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            if (!(lhs[i] == rhs[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void steal(StableVector& other) {
+        for (std::size_t chunk = 0; chunk < kChunkCount; ++chunk) {
+            chunks_[chunk].store(other.chunks_[chunk].exchange(nullptr, std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+        }
+        size_.store(other.size_.exchange(0, std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    std::array<std::atomic<T*>, kChunkCount> chunks_{};
+    std::atomic<std::size_t> size_{0};
+};
+
+class ModuleImage;
+
+// Owns a Module's ModuleImage: runtime objects built once per loaded module and shared read-only
+// by every context that runs it (vm.cpp). Created on first use; a copied module builds its own.
+class ModuleImageHandle {
+public:
+    ModuleImageHandle() = default;
+    ModuleImageHandle(const ModuleImageHandle&) noexcept {}
+    ModuleImageHandle& operator=(const ModuleImageHandle&) noexcept;
+    ~ModuleImageHandle();
+
+    ModuleImage& get() const;
+
+private:
+    mutable std::atomic<ModuleImage*> image_{nullptr};
+};
+
 struct Module {
     std::string sourcePath;
-    std::vector<Value> constants;
-    std::vector<std::string> strings;
-    std::vector<FunctionBytecode> functions;
-    std::vector<ClassBytecode> classes;
-    std::vector<GlobalBinding> globals;
+    // Lazily compiled bodies append to the tables below except `imports`, and hot reload also
+    // appends classes and globals (see StableVector).
+    StableVector<Value> constants;
+    StableVector<std::string> strings;
+    StableVector<FunctionBytecode> functions;
+    StableVector<ClassBytecode> classes;
+    StableVector<GlobalBinding> globals;
+    std::vector<ModuleImport> imports;
+    StableVector<ImportSymbol> importSymbols;
+    ModuleImageHandle image;
 };
 
+// The version of functions[index] that new calls run: the entry itself unless a hot reload
+// replaced it.
+inline std::size_t currentFunctionIndex(const Module& module, std::size_t index) {
+    for (std::int64_t next = module.functions.at(index).replacedBy.get(); next >= 0;
+         next = module.functions[index].replacedBy.get()) {
+        index = static_cast<std::size_t>(next);
+    }
+    return index;
+}
+
+// The layout (attributes, methods) of class `index`, following hot-reload versions.
+inline const ClassBytecode& currentClass(const Module& module, std::size_t index) {
+    const ClassBytecode* cls = &module.classes.at(index);
+    for (std::int64_t next = cls->replacedBy.get(); next >= 0; next = cls->replacedBy.get()) {
+        cls = &module.classes[static_cast<std::size_t>(next)];
+    }
+    return *cls;
+}
+
 } // namespace gs
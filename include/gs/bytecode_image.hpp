@@ -0,0 +1,78 @@
+#pragma once
+
+#include "gs/export.hpp"
+#include "gs/bytecode.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace gs {
+
+// GSBC3 is a little-endian binary container: a fixed header, a section table, then 8-byte
+// aligned sections of fixed-size records (string pool, constants, functions, code, line
+// table, classes, globals, ...). The file is mapped read-only and used in place: loading
+// only copies names and metadata, and each function body is decoded on its first call.
+// See docs/features/BYTECODE_FORMAT.md for the layout.
+inline constexpr char kBytecodeImageMagic[8] = {'G', 'S', 'B', 'C', '3', '\0', '\r', '\n'};
+// Revision 2 added the import table; revision 1 images still load, without imports.
+inline constexpr std::uint32_t kBytecodeImageRevision = 2;
+
+// Read-only view of a GSBC3 file, either memory-mapped or owned in memory.
+class GS_API BytecodeImage {
+public:
+    // Maps `path` read-only. Falls back to reading the file where mmap is unavailable.
+    static std::shared_ptr<const BytecodeImage> mapFile(const std::string& path);
+    static std::shared_ptr<const BytecodeImage> fromBytes(std::string bytes);
+
+    ~BytecodeImage();
+    BytecodeImage(const BytecodeImage&) = delete;
+    BytecodeImage& operator=(const BytecodeImage&) = delete;
+
+    const std::uint8_t* data() const;
+    std::size_t size() const;
+    bool isMapped() const;
+    // Serializes lazy decoding of the functions that live in this image.
+    std::mutex& decodeMutex() const;
+
+private:
+    BytecodeImage() = default;
+
+    const std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+    void* mapping_{nullptr};
+    std::string owned_;
+    mutable std::mutex decodeMutex_;
+};
+
+// Producer of a deferred function body. Image bodies decode a range of a mapped GSBC3 file;
+// compiler bodies generate code from the parsed declaration (compileSource with lazy function
+// compilation). materialize() runs at most once per function, under mutex(), and may append to
+// the module's StableVector tables.
+class GS_API LazyFunctionBody {
+public:
+    virtual ~LazyFunctionBody() = default;
+    virtual std::mutex& mutex() const = 0;
+    virtual void materialize(Module& module, FunctionBytecode& fn) const = 0;
+};
+
+GS_API bool isBytecodeImage(const void* data, std::size_t size);
+GS_API std::string serializeModuleBinary(const Module& module);
+// Builds a module whose function bodies stay in `image` until first use.
+GS_API Module loadModuleImage(std::shared_ptr<const BytecodeImage> image);
+// Loads a .gsbc file: GSBC3 is mapped, GSBC1/GSBC2 text goes through deserializeModuleText.
+GS_API Module loadBytecodeModule(const std::string& path);
+
+// `fn` must belong to `module`, which must have been created non-const.
+GS_API void decodeFunctionBody(const Module& module, const FunctionBytecode& fn);
+GS_API void decodeAllFunctionBodies(const Module& module);
+
+inline void ensureFunctionDecoded(const Module& module, const FunctionBytecode& fn) {
+    if (!fn.bodyReady.ready()) {
+        decodeFunctionBody(module, fn);
+    }
+}
+
+} // namespace gs
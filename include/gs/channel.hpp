@@ -0,0 +1,78 @@
+#pragma once
+
+#include "gs/task_system.hpp"
+#include "gs/value_transfer.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace gs {
+
+// A bounded multi-producer multi-consumer queue of values between tasks: the state behind the
+// script `Channel`, shared by the ChannelObjects of every context the channel was passed to.
+// Values travel as TransferredValues, so each receiver rebuilds them in its own heap.
+//
+// The ring is Vyukov's bounded queue: each cell carries the position it may next be written
+// (sequence == 2 * position) or read (sequence == 2 * position + 1) at, so a send or receive
+// that finds room or an item takes no lock; the doubled stamps keep the two apart even with a
+// capacity of 1. A side that would block parks: parkSender() and parkReceiver() return a
+// TaskParker whose callback runs once the other side has made progress or the channel is
+// closed. The wait mutex is only taken while someone is parked.
+class Channel : public std::enable_shared_from_this<Channel> {
+public:
+    explicit Channel(std::size_t capacity);
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    std::size_t capacity() const { return capacity_; }
+    // Values queued; exact only while no send or receive is in progress.
+    std::size_t size() const;
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    // Queues `value` and returns true, or returns false when the channel is full. Throws once the
+    // channel is closed.
+    bool trySend(TransferredValues& value);
+    // Takes the oldest value and returns true, or returns false when none is queued.
+    bool tryRecv(TransferredValues& value);
+    // Later sends fail; receivers drain what is queued. Returns false if already closed.
+    bool close();
+
+    // For a sender that found the channel full / a receiver that found it empty. The callback
+    // runs at once if that has changed since.
+    TaskParker parkSender();
+    TaskParker parkReceiver();
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        TransferredValues value;
+    };
+
+    struct Waiters {
+        // Parked callbacks plus parkers between their count and their readiness check.
+        std::atomic<std::size_t> count{0};
+        std::deque<std::function<void()>> resumes;
+    };
+
+    bool canSend() const;
+    bool canRecv() const;
+    void park(Waiters& waiters, bool sender, std::function<void()> resume);
+    void wakeOne(Waiters& waiters);
+    void wakeAll(Waiters& waiters);
+
+    const std::size_t capacity_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> sendPos_{0};
+    alignas(64) std::atomic<std::size_t> recvPos_{0};
+    std::atomic<bool> closed_{false};
+    std::mutex waitMutex_;
+    Waiters senders_;
+    Waiters receivers_;
+};
+
+} // namespace gs
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "gs/export.hpp"
+#include "gs/bytecode.hpp"
+
+#include <optional>
+#include <string>
+
+namespace gs {
+
+// Content-addressed on-disk cache of compiled modules. An entry is a GSBC3 image named by a
+// 128-bit hash of the script source and compilerVersion(), so any edit to a script produces a
+// new key. Imports are only recorded in the module's import table, so imported modules are
+// compiled and cached separately when they are linked. compileSourceFile() consults it, which covers
+// Runtime::loadSourceFile, loadModule() and gsc.
+//
+// The cache is off until a directory is configured, either with setCompileCacheDirectory() or
+// through the GS_COMPILE_CACHE_DIR environment variable. Unreadable or stale entries are ignored
+// and rewritten; entries are written to a temporary file and renamed into place, so concurrent
+// processes can share a directory.
+GS_API void setCompileCacheDirectory(const std::string& directory);
+GS_API std::string compileCacheDirectory();
+
+// Identifies the code generator; part of every cache key.
+GS_API const char* compilerVersion();
+GS_API std::string compileCacheKey(const std::string& source);
+
+GS_API std::optional<Module> loadCachedModule(const std::string& source);
+GS_API bool storeCachedModule(const std::string& source, const Module& module);
+
+} // namespace gs
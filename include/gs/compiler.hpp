@@ -5,25 +5,81 @@
 #include "gs/ir.hpp"
 #include "gs/parser.hpp"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace gs {
 
+class ThreadPool;
+
+// compile() keeps all of its state in a per-call session, so separate Compiler instances can
+// run concurrently on different threads.
 class GS_API Compiler {
 public:
     Module compile(const Program& program);
+    // Compiles class attributes and __module_init__ now and every function and method body on
+    // its first call (see LazyFunctionBody). The module keeps `program` alive; lastFunctionIR()
+    // covers only what was compiled eagerly.
+    Module compileLazy(std::shared_ptr<const Program> program);
     const std::vector<FunctionIR>& lastFunctionIR() const;
 
 private:
     std::vector<FunctionIR> lastFunctionIR_;
 };
 
+// Both compile function bodies lazily unless setLazyFunctionCompilationEnabled(false) was called
+// or the disassembly dump is on, in which case the whole module is compiled up front.
 GS_API Module compileSource(const std::string& source);
+// Imports are not expanded: the module records them in Module::imports and the runtime links
+// them when the module is initialized. With `dumpTransformedSource` the source is written next
+// to the script as `.gst`, prefixed with the import table.
 GS_API Module compileSourceFile(const std::string& path,
                                 const std::vector<std::string>& searchPaths = {},
                                 bool dumpTransformedSource = false);
+
+// What patchModuleSource() did. When `patched` is false the module was left untouched and
+// `reason` says why; the caller should load the source afresh instead.
+struct ModulePatchResult {
+    bool patched{false};
+    std::string reason;
+    std::size_t functionsReplaced{0}; // functions and methods whose declaration changed
+    std::size_t functionsAdded{0};
+    std::size_t classesReshaped{0};   // classes with another attribute or method list
+    std::size_t classesAdded{0};
+    std::size_t globalsAdded{0};
+};
+
+// Hot reload: applies a new revision of the source `live` was compiled from to `live` itself.
+// Edited functions and methods get a new version that every later call runs (frames already
+// running finish on the old code); classes get a new layout that their instances migrate to on
+// their next attribute access; new globals are added. Contexts running the module keep their
+// globals and heap, and new contexts run the new __module_init__. Only edited bodies are
+// compiled, on their first call. Removed functions, classes and globals stay in the module.
+// A revision that changes the import list, the base of a class or the kind of a top-level
+// name, or a module loaded from bytecode, is not patched. Compile errors throw and leave `live`
+// unchanged.
+GS_API ModulePatchResult patchModuleSource(Module& live, const std::string& path);
+
+struct CompiledModule {
+    std::string path;                      // canonical source path
+    std::vector<std::string> dependencies; // canonical paths of the script modules it imports
+    std::shared_ptr<Module> module;        // null when compilation failed
+    std::string error;
+};
+
+// Compiles `entryPaths` and every script module reachable through their imports. Each module
+// is compiled as its own task on `pool`; the modules named in its import table are queued as
+// soon as it finishes. Results are in discovery order, entries first; a failing module reports
+// its error without stopping the others.
+GS_API std::vector<CompiledModule> compileModuleGraph(const std::vector<std::string>& entryPaths,
+                                                      ThreadPool& pool,
+                                                      const std::vector<std::string>& searchPaths = {});
+
 GS_API void setCompileDisassemblyDumpEnabled(bool enabled);
 GS_API bool compileDisassemblyDumpEnabled();
+GS_API void setLazyFunctionCompilationEnabled(bool enabled);
+GS_API bool lazyFunctionCompilationEnabled();
 GS_API std::string serializeModuleText(const Module& module);
 GS_API Module deserializeModuleText(const std::string& text);
 GS_API std::string generateAotCpp(const Module& module, const std::string& variableName);
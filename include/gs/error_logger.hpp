@@ -6,6 +6,7 @@
 #include <chrono>
 #include <ctime>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
 
 namespace gs {
@@ -52,6 +53,8 @@ private:
     std::string getTimestamp() const;
     void writeToFile(const std::string& content);
 
+    // Errors are logged from worker threads and the script watcher as well as the caller.
+    std::mutex mutex_;
     std::string logPath_ = "Error.log";
     std::vector<std::pair<std::string, std::string>> contextItems_;
 };
@@ -3,8 +3,17 @@
 #include "gs/export.hpp"
 #include "gs/binding.hpp"
 
+#include <memory>
+#include <string>
+
 namespace gs {
 
 GS_API void bindGlobalModule(HostRegistry& host);
 
+// Script modules compiled for loadModule(), shared by every runtime in the process and keyed by
+// canonical path. A context links the module published when it first imports the path, so
+// replacing an entry affects contexts created afterwards and leaves running ones alone.
+GS_API std::shared_ptr<Module> findScriptModule(const std::string& canonicalPath);
+GS_API void publishScriptModule(const std::string& canonicalPath, std::shared_ptr<Module> module, bool replace);
+
 } // namespace gs
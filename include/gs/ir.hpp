@@ -28,6 +28,8 @@ struct FunctionIR {
     std::size_t localCount{0};
     std::vector<std::string> localDebugNames;
     std::vector<std::string> localTypeNames;
+    // Indices of Add/CallValue/CallHost/MakeClosure instructions whose result never outlives the frame.
+    std::vector<std::uint32_t> nonEscapingAllocSites;
 };
 
 inline int stackDelta(const IRInstruction& instruction) {
@@ -41,6 +43,7 @@ inline int stackDelta(const IRInstruction& instruction) {
     case OpCode::CaptureLocal:
     case OpCode::PushCapture:
     case OpCode::LoadCapture:
+    case OpCode::LoadImport:
         return 1;
     case OpCode::MakeClosure:
         return 1 - instruction.b;
@@ -49,6 +52,7 @@ inline int stackDelta(const IRInstruction& instruction) {
     case OpCode::StoreCapture:
     case OpCode::JumpIfFalse:
     case OpCode::Pop:
+    case OpCode::AppendLocal:
         return -1;
     case OpCode::JumpIfFalseReg:
         return 0;
@@ -119,6 +123,7 @@ inline int stackDelta(const IRInstruction& instruction) {
     case OpCode::LoadConst:
     case OpCode::StoreLocalFromReg:
     case OpCode::StoreNameFromReg:
+    case OpCode::SealLocal:
         return 0;
     }
     return 0;
@@ -145,6 +150,10 @@ inline FunctionBytecode lowerFunctionIR(const FunctionIR& ir) {
     out.localCount = ir.localCount;
     out.localTypeNames = ir.localTypeNames;
     out.stackSlotCount = estimateStackSlots(ir);
+    out.nonEscapingAllocSites = ir.nonEscapingAllocSites;
+    std::sort(out.nonEscapingAllocSites.begin(), out.nonEscapingAllocSites.end());
+    out.nonEscapingAllocSites.erase(std::unique(out.nonEscapingAllocSites.begin(), out.nonEscapingAllocSites.end()),
+                                    out.nonEscapingAllocSites.end());
     out.code.reserve(ir.code.size());
     for (const auto& instruction : ir.code) {
         out.code.push_back({instruction.op,
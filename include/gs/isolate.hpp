@@ -0,0 +1,131 @@
+#pragma once
+
+#include "gs/export.hpp"
+#include "gs/binding.hpp"
+#include "gs/script_call.hpp"
+#include "gs/task_system.hpp"
+#include "gs/thread_pool.hpp"
+#include "gs/value_transfer.hpp"
+#include "gs/vm.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gs {
+
+class IsolateScheduler;
+
+// An independent script context on a loaded module: its own heap and globals, which persist from
+// one call to the next, sharing the compiled module and host registry with every other isolate
+// of the runtime. Calls are queued with post() and run in order by the IsolateScheduler, a slice
+// of instructions at a time, so thousands of isolates can share the pool's threads.
+//
+// The isolate keeps the module it was created with; hot reloads reach isolates created later.
+// Arguments and results cross as TransferredValues, as for spawned tasks: the result is copied
+// out of the isolate's heap before the future is set, so the host never holds a pointer into a
+// heap that a later call may be running on. Drop isolates before the Runtime that created them.
+class GS_API Isolate : public std::enable_shared_from_this<Isolate> {
+public:
+    Isolate(IsolateScheduler& scheduler,
+            std::shared_ptr<const Module> module,
+            const HostRegistry& hosts,
+            TaskSystem& tasks,
+            const MemoryLimits& limits);
+    ~Isolate();
+
+    Isolate(const Isolate&) = delete;
+    Isolate& operator=(const Isolate&) = delete;
+
+    // Queues a call of the module function `functionName`. The future receives its return
+    // value (TransferredValues::value()), or a std::runtime_error with the exception the script
+    // did not catch. Arguments given as Values must be immediates; objects go in `args` packets,
+    // which are unpacked into the isolate's heap when the call starts.
+    std::future<TransferredValues> post(const std::string& functionName, const std::vector<Value>& args = {});
+    std::future<TransferredValues> post(const std::string& functionName, TransferredValues args);
+    // post() and wait for the result.
+    TransferredValues call(const std::string& functionName, const std::vector<Value>& args = {});
+
+    // Limits the run time of each call, summed over its slices (see CallWatchdog): the call
+    // raises TimeoutException, and is stopped if it is still running a tenth of the limit (at
+    // least 1 ms) later. Zero removes the limit. Applies to calls started afterwards.
+    void setCallTimeout(std::chrono::microseconds limit);
+
+    // Calls queued or running.
+    std::size_t pendingCalls() const;
+    // Slices the scheduler has run for this isolate.
+    std::uint64_t slicesRun() const;
+
+private:
+    friend class IsolateScheduler;
+
+    struct PendingCall {
+        std::string functionName;
+        TransferredValues args;
+        std::promise<TransferredValues> result;
+    };
+
+    // Runs the front call for up to `stepBudget` instructions. Returns true while calls are left.
+    bool runSlice(std::size_t stepBudget);
+    // Fails every queued call; the scheduler is shutting down.
+    void cancelCalls();
+
+    IsolateScheduler& scheduler_;
+    VirtualMachine vm_;
+    // Declared after vm_: its objects refer to the VM's types.
+    ExecutionContext context_;
+    mutable std::mutex mutex_;
+    std::deque<PendingCall> calls_;
+    // The front call has been started in context_.
+    bool callStarted_{false};
+    CallWatchdog watchdog_;
+    std::chrono::microseconds callTimeout_{0};
+    // In the scheduler's run queue or running a slice.
+    bool scheduled_{false};
+    std::uint64_t slicesRun_{0};
+};
+
+// Runs isolates on a ThreadPool. Isolates with calls to run wait in one FIFO queue; a pool task
+// takes the isolate at the front, runs a slice of at most sliceSteps() instructions and puts it at
+// the back if its calls are not done, so a long call cannot hold a worker while others wait. An
+// isolate runs on one thread at a time.
+class GS_API IsolateScheduler {
+public:
+    explicit IsolateScheduler(ThreadPool& pool, std::size_t sliceSteps = 1000);
+    // Fails the calls still queued and waits for running slices.
+    ~IsolateScheduler();
+
+    IsolateScheduler(const IsolateScheduler&) = delete;
+    IsolateScheduler& operator=(const IsolateScheduler&) = delete;
+
+    void setSliceSteps(std::size_t steps);
+    std::size_t sliceSteps() const;
+
+    // Blocks until no isolate has a call queued or running.
+    void waitIdle();
+    std::uint64_t slicesRun() const;
+
+private:
+    friend class Isolate;
+
+    void schedule(std::shared_ptr<Isolate> isolate);
+    void runNext();
+
+    ThreadPool& pool_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::deque<std::shared_ptr<Isolate>> runQueue_;
+    std::size_t running_{0};
+    std::size_t sliceSteps_;
+    std::uint64_t slicesRun_{0};
+    bool stopping_{false};
+};
+
+} // namespace gs
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "gs/binding.hpp"
+
+namespace gs {
+
+// parallel.map(list, fn), parallel.for_range(n, fn), parallel.reduce(list, fn[, initial]):
+// run a script function or lambda over many items on the task pool. Each chunk of items runs in
+// a pooled task context of its own, as `spawn` does, and results come back in item order.
+void registerParallelModule(HostRegistry& host);
+
+} // namespace gs
@@ -118,6 +118,9 @@ struct FunctionDecl {
     std::vector<std::string> params;
     std::vector<std::string> paramTypeNames;
     std::vector<Stmt> body;
+    // Hash of the declaration's tokens, with lines relative to its first line, so moving a
+    // function within the file keeps its fingerprint. Hot reload uses it to detect edits.
+    std::uint64_t fingerprint{0};
 };
 
 struct ClassAttrDecl {
@@ -137,7 +140,20 @@ struct ClassDecl {
     std::vector<FunctionDecl> methods;
 };
 
+// `import a.b [as x]`, `from a.b import f [as g]`, `from a.b import f, g [as x]` or
+// `from a.b import * as x`. `names` is empty for whole-module imports.
+struct ImportDecl {
+    std::size_t line{0};
+    std::size_t column{0};
+    std::string moduleSpec;
+    std::string alias;
+    std::vector<std::string> names;
+    bool isFrom{false};
+    bool isWildcard{false};
+};
+
 struct Program {
+    std::vector<ImportDecl> imports;
     std::vector<ClassDecl> classes;
     std::vector<FunctionDecl> functions;
     std::vector<Stmt> topLevelStatements;
@@ -156,6 +172,9 @@ private:
     bool match(TokenType type);
     const Token& consume(TokenType type, const char* message);
 
+    bool isImportStart() const;
+    ImportDecl parseImport();
+    std::string parseModuleSpec();
     ClassDecl parseClass();
     FunctionDecl parseFunction();
     Stmt parseStatement();
@@ -3,10 +3,14 @@
 #include "gs/export.hpp"
 #include "gs/binding.hpp"
 #include "gs/compiler.hpp"
+#include "gs/isolate.hpp"
+#include "gs/script_call.hpp"
+#include "gs/script_watcher.hpp"
 #include "gs/task_system.hpp"
 #include "gs/thread_pool.hpp"
 #include "gs/vm.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -23,23 +27,61 @@ public:
 
     bool loadSourceFile(const std::string& path, const std::vector<std::string>& searchPaths = {});
     bool loadBytecodeFile(const std::string& path);
+    // Applies an edited revision of the loaded source to the running module in place (see
+    // patchModuleSource): calls already running and heap objects they hold keep working, and
+    // later calls see the new code. Falls back to loadSourceFile() when the revision cannot be
+    // patched or a different file is named; lastHotReload() tells which happened.
     bool hotReloadSource(const std::string& path);
-    const std::string& lastError() const;
+    const ModulePatchResult& lastHotReload() const;
+    // Starts background recompilation of the loaded source and the script modules it imports
+    // (found through the search paths given to loadSourceFile). When a watched file changes,
+    // the module graph is recompiled on the runtime's thread pool, bodies included, and the
+    // changed modules and their importers are published for the next call(); the calling thread
+    // never compiles. A revision that fails to compile is reported through lastError() and the
+    // ErrorLogger, and the previous module stays in use.
+    bool watchSources(const ScriptWatcherOptions& options = {});
+    void stopWatchingSources();
+    // Number of module graphs published by the watcher so far.
+    std::uint64_t sourceRevision() const;
+    // Thread-safe copy: the watcher reports compile errors from its own thread.
+    std::string lastError() const;
     void setDumpTransformedSource(bool enabled);
     bool dumpTransformedSourceEnabled() const;
+    // Quota applied to every execution context created by call() and by tasks it spawns.
+    void setMemoryLimits(const MemoryLimits& limits);
+    MemoryLimits memoryLimits() const;
 
     Value call(const std::string& functionName, const std::vector<Value>& args = {});
+    // Starts a call that the host runs with ScriptCall::resume(), a budget at a time.
+    std::unique_ptr<ScriptCall> startCall(const std::string& functionName, const std::vector<Value>& args = {});
+    // A new isolate on the loaded module with the current memory limits, run by isolates().
+    std::shared_ptr<Isolate> createIsolate();
+    IsolateScheduler& isolates();
 
     bool saveBytecode(const std::string& path) const;
 
 private:
+    void setLastError(std::string message);
+    void recompileWatchedSources(const std::vector<std::string>& changedPaths);
+
     mutable std::mutex moduleMutex_;
     std::shared_ptr<Module> module_;
     std::string lastError_;
+    // Entry file and import search paths of the last loadSourceFile(); empty after a bytecode load.
+    std::string sourceEntry_;
+    std::vector<std::string> sourceSearchPaths_;
+    std::uint64_t sourceRevision_{0};
+    ModulePatchResult lastHotReload_;
+    // module_ was hot-patched, so it holds superseded versions that saveBytecode() must not write.
+    bool modulePatched_{false};
     bool dumpTransformedSource_{true};
+    MemoryLimits memoryLimits_;
     HostRegistry hosts_;
     ThreadPool pool_;
     TaskSystem tasks_;
+    IsolateScheduler isolates_;
+    // Declared last: its thread compiles on pool_ and must stop before the pool goes away.
+    std::unique_ptr<ScriptWatcher> watcher_;
 };
 
 } // namespace gs
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "gs/export.hpp"
+#include "gs/binding.hpp"
+#include "gs/task_system.hpp"
+#include "gs/vm.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gs {
+
+// How far one resume may run a call: at most `steps` instructions and about `time` of wall
+// clock (checked every few hundred instructions). A zero field is no limit; both zero runs the
+// call to its end.
+struct CallBudget {
+    std::size_t steps{0};
+    std::chrono::microseconds time{0};
+};
+
+enum class CallStatus : std::uint8_t {
+    Suspended, // the budget ran out; resume() continues where the call stopped
+    Done,      // the function returned; see result()
+    Failed     // the script threw and did not catch it, or the call was stopped; see error()
+};
+
+// Run-time limit of one call, summed over the slices that ran it. Once `limit` is used up the
+// call raises TimeoutException where it stands, which the script may catch to clean up. A call
+// still running `grace` after that is stopped and fails with the same exception.
+struct CallWatchdog {
+    std::chrono::microseconds limit{0};
+    std::chrono::microseconds grace{0};
+    std::chrono::nanoseconds used{0};
+    bool raised{false};
+};
+
+// Runs the call started in ctx (VirtualMachine::startCall) within `budget`, charging the time to
+// `watchdog` when it has a limit. Returns true once the call has returned; throws what the
+// script did not catch.
+GS_API bool runCallSlice(VirtualMachine& vm, ExecutionContext& ctx, const CallBudget& budget, CallWatchdog& watchdog);
+
+// A script call the host runs a budget at a time (Runtime::startCall), so a long script can be
+// spread over frames instead of blocking the thread that drives it. The call gets a context of
+// its own, like Runtime::call(); module initialization runs when the call is created.
+class GS_API ScriptCall {
+public:
+    ScriptCall(std::shared_ptr<const Module> module,
+               const HostRegistry& hosts,
+               TaskSystem& tasks,
+               const MemoryLimits& limits,
+               const std::string& functionName,
+               const std::vector<Value>& args);
+    ~ScriptCall();
+
+    ScriptCall(const ScriptCall&) = delete;
+    ScriptCall& operator=(const ScriptCall&) = delete;
+
+    // Runs the call within `budget`. Once it is Done or Failed, further resumes return that.
+    CallStatus resume(const CallBudget& budget = {});
+    CallStatus status() const;
+    // The return value once Done. Objects in it live in the call's heap, as long as the call.
+    const Value& result() const;
+    // What the script threw, or why the call was stopped, once Failed.
+    const std::string& error() const;
+
+    // Limits the run time of the call (see CallWatchdog); the grace period is a tenth of it, at
+    // least 1 ms. Zero removes the limit.
+    void setTimeout(std::chrono::microseconds limit);
+    // Time spent inside resume() so far.
+    std::chrono::microseconds runTime() const;
+
+private:
+    VirtualMachine vm_;
+    // Declared after vm_: its objects refer to the VM's types.
+    ExecutionContext context_;
+    CallWatchdog watchdog_;
+    std::chrono::nanoseconds runTime_{0};
+    CallStatus status_{CallStatus::Suspended};
+    std::string error_;
+};
+
+} // namespace gs
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "gs/export.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace gs {
+
+struct ScriptWatcherOptions {
+    // How often the files are checked without a notification; also bounds how late a change can
+    // be seen when inotify misses it (network file systems, editors that replace the directory).
+    std::chrono::milliseconds pollInterval{250};
+    // Quiet period after a notification, so a burst of writes from one save is reported once.
+    std::chrono::milliseconds settleDelay{30};
+    // Use inotify where available; false always polls.
+    bool useNotify{true};
+};
+
+// Watches a set of script files on a background thread and reports the ones whose contents
+// changed. On Linux the directories holding them are watched with inotify, which wakes the
+// thread as soon as a file is written; elsewhere the files are polled. A change is confirmed by
+// comparing modification time and size, so saves through a temporary file and a rename are seen,
+// and unrelated activity in the same directory is ignored. The handler runs on the watcher thread.
+class GS_API ScriptWatcher {
+public:
+    using ChangeHandler = std::function<void(const std::vector<std::string>& changedPaths)>;
+
+    ScriptWatcher(const ScriptWatcherOptions& options, ChangeHandler onChange);
+    ~ScriptWatcher();
+
+    ScriptWatcher(const ScriptWatcher&) = delete;
+    ScriptWatcher& operator=(const ScriptWatcher&) = delete;
+
+    // Replaces the watched set. Files already watched keep their last seen state; new ones are
+    // recorded as they are now, so only later edits are reported.
+    void setFiles(const std::vector<std::string>& paths);
+    std::vector<std::string> files() const;
+    // Runs the handler at the next wake-up even if nothing changed (with the changes, if any).
+    void requestCheck();
+    void stop();
+    bool usesNotify() const;
+
+private:
+    struct FileStamp {
+        bool exists{false};
+        std::filesystem::file_time_type modified{};
+        std::uintmax_t size{0};
+
+        bool operator==(const FileStamp& other) const = default;
+    };
+
+    static FileStamp stampOf(const std::string& path);
+    void run();
+    bool waitForActivity();
+    std::vector<std::string> collectChanges();
+    void updateNotifyWatches();
+
+    ScriptWatcherOptions options_;
+    ChangeHandler onChange_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::unordered_map<std::string, FileStamp> stamps_;
+    std::unordered_map<std::string, int> directoryWatches_;
+    bool checkRequested_{false};
+    std::atomic<bool> stopping_{false};
+    int notifyFd_{-1};
+    int wakeFd_{-1};
+    std::thread thread_;
+};
+
+} // namespace gs
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gs::simd {
+
+// Bulk kernels behind IntArray/FloatArray. Each uses SSE2 when the target provides it
+// and falls back to scalar loops otherwise; results match the scalar definition except
+// for floating-point reduction order. min/max require count > 0.
+
+void add(double* dst, const double* src, std::size_t count);
+void addScalar(double* dst, double value, std::size_t count);
+void scale(double* dst, double factor, std::size_t count);
+void clamp(double* dst, double lo, double hi, std::size_t count);
+void lerp(double* dst, const double* target, double t, std::size_t count);
+double dot(const double* lhs, const double* rhs, std::size_t count);
+double sum(const double* src, std::size_t count);
+double min(const double* src, std::size_t count);
+double max(const double* src, std::size_t count);
+
+void add(std::int64_t* dst, const std::int64_t* src, std::size_t count);
+void addScalar(std::int64_t* dst, std::int64_t value, std::size_t count);
+void scale(std::int64_t* dst, std::int64_t factor, std::size_t count);
+void clamp(std::int64_t* dst, std::int64_t lo, std::int64_t hi, std::size_t count);
+std::int64_t dot(const std::int64_t* lhs, const std::int64_t* rhs, std::size_t count);
+std::int64_t sum(const std::int64_t* src, std::size_t count);
+std::int64_t min(const std::int64_t* src, std::size_t count);
+std::int64_t max(const std::int64_t* src, std::size_t count);
+
+} // namespace gs::simd
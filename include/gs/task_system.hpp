@@ -2,27 +2,139 @@
 
 #include "gs/bytecode.hpp"
 #include "gs/thread_pool.hpp"
+#include "gs/value_transfer.hpp"
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace gs {
 
+class HostRegistry;
+class VirtualMachine;
+
+// Registers `resume` to be called once a task that cannot go on (a channel it waits on is full
+// or empty) may continue. Called after the task's step has returned, so `resume` may run it
+// again right away on another thread.
+using TaskParker = std::function<void(std::function<void()> resume)>;
+// One run of a resumable task: returns true once `result` is set, or false after setting
+// `parker`, and is called again when the parker resumes it.
+using TaskStep = std::function<bool(TransferredValues& result, TaskParker& parker)>;
+
+// Runs spawned tasks on a ThreadPool and hands out int64 handles to them. Handles index a
+// table of slots that only grows: a slot is reused once its task has been awaited, and the
+// generation counted in the handle (16 bits, wrapping) then no longer matches, so a stale handle
+// is reported instead of reaching the slot's next task. Handles fit in 47 bits. Looking up a
+// handle and publishing a task's result take no lock; the wait mutex is only used while some
+// thread sleeps on a task.
 class TaskSystem {
 public:
     explicit TaskSystem(ThreadPool& pool);
+    // Waits for tasks still running: they refer to the table.
+    ~TaskSystem();
+
+    std::int64_t enqueue(std::function<TransferredValues()> task);
+    // A task that parks instead of blocking a pool thread while it waits (spawned tasks). A
+    // parked task holds no thread; tasks still parked when the TaskSystem is destroyed, with
+    // nothing left running that could resume them, fail with "Task was cancelled".
+    std::int64_t enqueueResumable(TaskStep step);
+    // Blocks the calling thread until `parker` resumes it, running queued tasks meanwhile; the
+    // wait of a thread that is not running a resumable task.
+    void wait(const TaskParker& parker);
+    // Each handle is awaited once. await and awaitAll rethrow a C++ exception a task ended with;
+    // awaitAll does so after every handle has been collected.
+    TransferredValues await(std::int64_t handle);
+    std::vector<TransferredValues> awaitAll(const std::vector<std::int64_t>& handles);
+    // Waits for the first of `handles` to finish and collects only that one: returns its position
+    // in `handles` and its result. The other handles stay valid.
+    std::pair<std::size_t, TransferredValues> awaitAny(const std::vector<std::int64_t>& handles);
+    // Whether the task has finished, without waiting.
+    bool poll(std::int64_t handle) const;
+    std::size_t workerCount() const { return pool_.size(); }
 
-    std::int64_t enqueue(std::function<Value()> task);
-    Value await(std::int64_t handle);
+    // VMs kept between spawned tasks (OpCode::SpawnFunc), a few per pool worker plus a shared set
+    // for other threads that run tasks while they await. takeSpawnVm returns null when none is
+    // kept for the module; a VM is out of the cache while it runs, so a task that starts on a
+    // thread whose earlier task is still waiting gets its own.
+    std::unique_ptr<VirtualMachine> takeSpawnVm(const Module* module, const HostRegistry* hosts);
+    void returnSpawnVm(const Module* module, const HostRegistry* hosts, std::unique_ptr<VirtualMachine> vm);
 
 private:
+    struct SpawnVm {
+        const Module* module{nullptr};
+        const HostRegistry* hosts{nullptr};
+        std::unique_ptr<VirtualMachine> vm;
+    };
+
+    enum class SlotState : std::uint8_t { Free, Running, Done, Collecting };
+
+    struct Slot {
+        std::atomic<SlotState> state{SlotState::Free};
+        // Bumped when the slot is freed; the upper half of the handles that name it.
+        std::atomic<std::uint32_t> generation{0};
+        // Next entry of the free list while the slot is free.
+        std::atomic<std::uint32_t> nextFree{0};
+        // Written by the task before it publishes Done.
+        TransferredValues result;
+        std::exception_ptr failure;
+    };
+
+    struct ResumableTask {
+        Slot* slot{nullptr};
+        TaskStep step;
+        // Set while parked; whoever clears it (the resume or the destructor) owns the task.
+        std::atomic<bool> parked{false};
+    };
+
+    // Slot chunk k holds kFirstSlotChunk << k slots; chunks are allocated on demand and never move.
+    static constexpr std::size_t kFirstSlotChunk = 64;
+    static constexpr std::size_t kSlotChunkCount = 26;
+
+    // Takes a slot for a new task and marks it running; returns the task's handle.
+    std::int64_t startTask(Slot*& slot);
+    std::uint32_t acquireSlot();
+    void releaseSlot(std::uint32_t index);
+    Slot& slotAt(std::uint32_t index) const;
+    // The slot `handle` names, or a "Task handle not found" error.
+    Slot& resolve(std::int64_t handle) const;
+    void finish(Slot& slot, TransferredValues result, std::exception_ptr failure);
+    void wakeSleepers();
+    void runStep(const std::shared_ptr<ResumableTask>& task);
+    void resume(const std::shared_ptr<ResumableTask>& task);
+    // Fails the parked tasks once no other task is left running (destructor).
+    void cancelStrandedTasks();
+    // Helps with queued pool work, then sleeps, until `ready` holds.
+    template <typename Ready>
+    void waitUntil(Ready&& ready);
+    // Takes the result of a finished task and frees its slot.
+    TransferredValues collect(Slot& slot, std::int64_t handle);
+
+    std::vector<SpawnVm>& spawnVmSlot(std::unique_lock<std::mutex>& sharedLock);
+
     ThreadPool& pool_;
-    std::mutex mutex_;
-    std::int64_t nextId_{1};
-    std::unordered_map<std::int64_t, std::future<Value>> tasks_;
+    mutable std::array<std::atomic<Slot*>, kSlotChunkCount> slotChunks_{};
+    std::atomic<std::uint32_t> slotCount_{0};
+    // Free list head: slot index + 1 (0 = empty) in the low half, an ABA tag in the high half.
+    std::atomic<std::uint64_t> freeHead_{0};
+    std::atomic<std::size_t> running_{0};
+    std::atomic<std::size_t> sleepers_{0};
+    std::mutex waitMutex_;
+    std::condition_variable finished_;
+    // Parked resumable tasks, so the destructor can cancel those nothing will resume.
+    std::mutex parkedMutex_;
+    std::unordered_map<ResumableTask*, std::shared_ptr<ResumableTask>> parked_;
+    // spawnVms_[i] belongs to pool worker i; the last entry is shared under sharedSpawnVmMutex_.
+    std::vector<std::vector<SpawnVm>> spawnVms_;
+    std::mutex sharedSpawnVmMutex_;
 };
 
 } // namespace gs
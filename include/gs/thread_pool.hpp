@@ -1,43 +1,134 @@
 #pragma once
 
-#include <condition_variable>
+#include <atomic>
 #include <cstddef>
-#include <functional>
+#include <cstdint>
+#include <exception>
 #include <future>
-#include <mutex>
-#include <queue>
+#include <memory>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace gs {
 
+// Work-stealing pool. Each worker owns a Chase-Lev deque: tasks submitted from a worker go to
+// the bottom of its own deque and run there next (LIFO, so a task's children stay on the core
+// that produced their data) unless an idle worker steals them from the top. Tasks submitted from
+// other threads go through a lock-free injection queue. Idle workers spin briefly, then park
+// until new work is published.
+//
+// Tasks are stored in pooled nodes with inline storage for small callables, so submitting a
+// task does not allocate a std::function or a shared packaged_task.
 class ThreadPool {
 public:
+    static constexpr std::size_t kNotAWorker = static_cast<std::size_t>(-1);
+
     explicit ThreadPool(std::size_t workers = std::thread::hardware_concurrency());
     ~ThreadPool();
 
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
 
+    // Runs `fn` on the pool; the future receives its result or exception.
     template <typename F>
     auto submit(F&& fn) -> std::future<decltype(fn())> {
         using ReturnType = decltype(fn());
-        auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<F>(fn));
-        std::future<ReturnType> future = task->get_future();
-        {
-            std::scoped_lock lock(mutex_);
-            jobs_.push([task]() { (*task)(); });
-        }
-        cv_.notify_one();
+        std::promise<ReturnType> promise;
+        std::future<ReturnType> future = promise.get_future();
+        post([fn = std::forward<F>(fn), promise = std::move(promise)]() mutable {
+            try {
+                if constexpr (std::is_void_v<ReturnType>) {
+                    fn();
+                    promise.set_value();
+                } else {
+                    promise.set_value(fn());
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
         return future;
     }
 
+    // Runs `fn` on the pool without a future. An exception it throws is logged.
+    template <typename F>
+    void post(F&& fn) {
+        Task* task = Task::acquire();
+        task->emplace(std::forward<F>(fn));
+        schedule(task);
+    }
+
+    // Runs one queued task on the calling thread, if there is one. Threads that wait for pool
+    // work call it so that a wait inside a task cannot starve the task it waits for.
+    bool runPendingTask();
+
+    std::size_t size() const;
+    // Index of the calling thread among this pool's workers, or kNotAWorker.
+    std::size_t currentWorkerIndex() const;
+
+    // A queued unit of work: a type-erased callable in a recycled node.
+    class Task {
+    public:
+        static constexpr std::size_t kInlineSize = 64;
+
+        static Task* acquire();
+        static void release(Task* task);
+
+        template <typename F>
+        void emplace(F&& fn) {
+            using Fn = std::decay_t<F>;
+            if constexpr (sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+                          std::is_nothrow_move_constructible_v<Fn>) {
+                ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+                run_ = [](Task& task, bool invoke) {
+                    Fn& callable = *std::launder(reinterpret_cast<Fn*>(task.storage_));
+                    struct Destroy {
+                        Fn& callable;
+                        ~Destroy() { callable.~Fn(); }
+                    } destroy{callable};
+                    if (invoke) {
+                        callable();
+                    }
+                };
+            } else {
+                ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<F>(fn)));
+                run_ = [](Task& task, bool invoke) {
+                    std::unique_ptr<Fn> callable(*std::launder(reinterpret_cast<Fn**>(task.storage_)));
+                    if (invoke) {
+                        (*callable)();
+                    }
+                };
+            }
+        }
+
+        // Runs the callable and destroys it; `invoke` false only destroys it.
+        void run(bool invoke) { run_(*this, invoke); }
+
+    private:
+        alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+        void (*run_)(Task&, bool){nullptr};
+    };
+
 private:
-    std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> jobs_;
-    std::mutex mutex_;
-    std::condition_variable cv_;
-    bool stop_{false};
+    struct Worker;
+    class InjectionQueue;
+
+    void schedule(Task* task);
+    void workerLoop(std::size_t index);
+    Task* findWork(std::size_t self);
+    Task* steal(std::size_t self);
+    void execute(Task* task);
+    void wakeOne();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::unique_ptr<InjectionQueue> injection_;
+    std::atomic<std::uint32_t> wakeEpoch_{0};
+    std::atomic<std::size_t> sleepers_{0};
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
 };
 
 } // namespace gs
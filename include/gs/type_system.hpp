@@ -3,6 +3,8 @@
 #include "gs/type_system/type_base.hpp"
 #include "gs/type_system/list_type.hpp"
 #include "gs/type_system/tuple_type.hpp"
+#include "gs/type_system/numeric_array_type.hpp"
+#include "gs/type_system/string_builder_type.hpp"
 #include "gs/type_system/dict_type.hpp"
 #include "gs/type_system/string_type.hpp"
 #include "gs/type_system/script_callable_object.hpp"
@@ -15,3 +17,4 @@
 #include "gs/type_system/upvalue_cell_type.hpp"
 #include "gs/type_system/type_object_type.hpp"
 #include "gs/type_system/exception_type.hpp"
+#include "gs/type_system/channel_type.hpp"
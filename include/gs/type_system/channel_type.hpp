@@ -0,0 +1,40 @@
+#pragma once
+
+#include "gs/channel.hpp"
+#include "gs/type_system/type_base.hpp"
+
+#include <memory>
+
+namespace gs {
+
+// A script handle to a Channel. Passing it to a task or through a channel gives the receiver a
+// handle to the same channel. send / try_send / recv / try_recv / close are run by the VM,
+// which moves the values between heaps and parks a task that has to wait.
+class ChannelObject : public Object {
+public:
+    ChannelObject(const Type& typeRef, std::shared_ptr<Channel> channel);
+
+    const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
+    Channel& channel() const;
+    const std::shared_ptr<Channel>& shared() const;
+
+private:
+    const Type* type_;
+    std::shared_ptr<Channel> channel_;
+};
+
+class ChannelType : public Type {
+public:
+    ChannelType();
+    const char* name() const override;
+    std::string __str__(Object& self, const ValueStrInvoker& valueStr) const override;
+
+private:
+    static ChannelObject& requireChannel(Object& self);
+};
+
+// The type of every ChannelObject; channels outlive the VM that created them.
+const ChannelType& channelType();
+
+} // namespace gs
@@ -9,8 +9,8 @@ namespace gs {
 struct ValueHash {
     std::size_t operator()(const Value& v) const {
         // Combine type and payload for hash
-        std::size_t h = std::hash<std::uint8_t>{}(static_cast<std::uint8_t>(v.type));
-        h ^= std::hash<std::int64_t>{}(v.payload) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        std::size_t h = std::hash<std::uint8_t>{}(static_cast<std::uint8_t>(v.valueType()));
+        h ^= std::hash<std::int64_t>{}(v.rawPayload()) + 0x9e3779b9 + (h << 6) + (h >> 2);
         return h;
     }
 };
@@ -18,11 +18,7 @@ struct ValueHash {
 // Equality functor for Value
 struct ValueEqual {
     bool operator()(const Value& a, const Value& b) const {
-        if (a.type != b.type) return false;
-        if (a.type == ValueType::Ref) {
-            return a.object == b.object;
-        }
-        return a.payload == b.payload;
+        return a.valueType() == b.valueType() && a.rawPayload() == b.rawPayload();
     }
 };
 
@@ -36,6 +32,7 @@ public:
     DictObject(const Type& typeRef, std::unordered_map<std::int64_t, Value> intValues);
 
     const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
     MapType& data();
     const MapType& data() const;
 
@@ -85,6 +85,16 @@ public:
     UndefinedVariableExceptionObject(const Type& typeRef, std::string message);
 };
 
+class OutOfMemoryExceptionObject final : public ExceptionObject {
+public:
+    OutOfMemoryExceptionObject(const Type& typeRef, std::string message);
+};
+
+class TimeoutExceptionObject final : public ExceptionObject {
+public:
+    TimeoutExceptionObject(const Type& typeRef, std::string message);
+};
+
 class DivideByZeroExceptionType final : public ExceptionType {
 public:
     const char* name() const override;
@@ -120,6 +130,16 @@ public:
     const char* name() const override;
 };
 
+class OutOfMemoryExceptionType final : public ExceptionType {
+public:
+    const char* name() const override;
+};
+
+class TimeoutExceptionType final : public ExceptionType {
+public:
+    const char* name() const override;
+};
+
 extern const std::string_view kExceptionTypeName;
 extern const std::string_view kDivideByZeroExceptionTypeName;
 extern const std::string_view kFileNotFoundExceptionTypeName;
@@ -128,6 +148,10 @@ extern const std::string_view kPropertyNotFoundExceptionTypeName;
 extern const std::string_view kListIndexOutOfRangeExceptionTypeName;
 extern const std::string_view kDictKeyNotFoundExceptionTypeName;
 extern const std::string_view kUndefinedVariableExceptionTypeName;
+extern const std::string_view kOutOfMemoryExceptionTypeName;
+extern const std::string_view kMemoryLimitExceededMessagePrefix;
+extern const std::string_view kTimeoutExceptionTypeName;
+extern const std::string_view kScriptTimedOutMessagePrefix;
 
 bool isNativeExceptionTypeName(const std::string& nativeTypeName);
 std::string classifyRuntimeExceptionTypeName(const std::string& message);
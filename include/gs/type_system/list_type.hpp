@@ -10,6 +10,7 @@ public:
     ListObject(const Type& typeRef, std::vector<Value> values);
 
     const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
     std::vector<Value>& data();
     const std::vector<Value>& data() const;
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "gs/type_system/type_base.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <vector>
+
+namespace gs {
+
+// Contiguous unboxed storage of one element type; bulk methods run as single native calls.
+// IntArray holds int64 and FloatArray double; both share this implementation, and FloatArray
+// adds lerp.
+template <typename T>
+class NumericArrayObject : public Object {
+public:
+    NumericArrayObject(const Type& typeRef, std::vector<T> values);
+
+    const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
+    std::vector<T>& data();
+    const std::vector<T>& data() const;
+
+private:
+    const Type* type_;
+    std::vector<T> data_;
+};
+
+template <typename T>
+class NumericArrayType : public Type {
+public:
+    using MethodHandler = Value (NumericArrayType::*)(Object& self, const std::vector<Value>& args) const;
+
+    NumericArrayType();
+    const char* name() const override;
+    Value callMethod(Object& self,
+                     const std::string& method,
+                     const std::vector<Value>& args,
+                     const StringFactory& makeString,
+                     const ValueStrInvoker& valueStr) const override;
+    Value getMember(Object& self, const std::string& member) const override;
+    Value setMember(Object& self, const std::string& member, const Value& value) const override;
+    std::string __str__(Object& self, const ValueStrInvoker& valueStr) const override;
+
+    void registerMethod(const std::string& name, std::size_t argc, MethodHandler handler);
+
+    // Element access shared with the VM's get/set fast path.
+    static Value readIndex(const NumericArrayObject<T>& array, const Value& index);
+    static Value writeIndex(NumericArrayObject<T>& array, const Value& index, const Value& value);
+
+private:
+    static NumericArrayObject<T>& requireArray(Object& self);
+    static const NumericArrayObject<T>* asArray(const Value& value);
+
+    Value methodGet(Object& self, const std::vector<Value>& args) const;
+    Value methodSet(Object& self, const std::vector<Value>& args) const;
+    Value methodPush(Object& self, const std::vector<Value>& args) const;
+    Value methodSize(Object& self, const std::vector<Value>& args) const;
+    Value methodFill(Object& self, const std::vector<Value>& args) const;
+    Value methodAdd(Object& self, const std::vector<Value>& args) const;
+    Value methodScale(Object& self, const std::vector<Value>& args) const;
+    Value methodClamp(Object& self, const std::vector<Value>& args) const;
+    Value methodLerp(Object& self, const std::vector<Value>& args) const
+        requires std::floating_point<T>;
+    Value methodDot(Object& self, const std::vector<Value>& args) const;
+    Value methodSum(Object& self, const std::vector<Value>& args) const;
+    Value methodMin(Object& self, const std::vector<Value>& args) const;
+    Value methodMax(Object& self, const std::vector<Value>& args) const;
+    Value memberLengthGet(Object& self) const;
+    Value memberLengthSet(Object& self, const Value& value) const;
+};
+
+extern template class NumericArrayObject<std::int64_t>;
+extern template class NumericArrayObject<double>;
+extern template class NumericArrayType<std::int64_t>;
+extern template class NumericArrayType<double>;
+
+using IntArrayObject = NumericArrayObject<std::int64_t>;
+using IntArrayType = NumericArrayType<std::int64_t>;
+using FloatArrayObject = NumericArrayObject<double>;
+using FloatArrayType = NumericArrayType<double>;
+
+} // namespace gs
@@ -15,12 +15,17 @@ public:
                          Value nativeBaseRef = Value::Nil());
 
     const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
     std::size_t classIndex() const;
     const std::string& className() const;
     const std::shared_ptr<const Module>& modulePin() const;
     const Value& nativeBaseRef() const;
     bool hasNativeBase() const;
     void setNativeBaseRef(const Value& nativeBaseRef);
+    // Size of the module's class table when the fields last matched the class layout. Hot
+    // reload only appends classes, so a larger table means the layout may have changed.
+    std::size_t layoutStamp() const;
+    void setLayoutStamp(std::size_t stamp);
     std::unordered_map<std::string, Value>& fields();
     const std::unordered_map<std::string, Value>& fields() const;
 
@@ -30,6 +35,7 @@ private:
     std::string className_;
     std::shared_ptr<const Module> modulePin_;
     Value nativeBaseRef_{Value::Nil()};
+    std::size_t layoutStamp_{0};
     std::unordered_map<std::string, Value> fields_;
 };
 
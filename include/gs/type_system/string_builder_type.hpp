@@ -0,0 +1,72 @@
+#pragma once
+
+#include "gs/type_system/type_base.hpp"
+
+#include <string>
+#include <vector>
+
+namespace gs {
+
+// Growable text buffer; append() is amortized O(1) where `s = s + x` copies the prefix.
+class StringBuilderObject : public Object {
+public:
+    StringBuilderObject(const Type& typeRef, std::string initial);
+
+    const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
+    std::string& data();
+    const std::string& data() const;
+
+private:
+    const Type* type_;
+    std::string data_;
+};
+
+class StringBuilderType : public Type {
+public:
+    using MethodHandler = Value (StringBuilderType::*)(Object& self,
+                                                       const std::vector<Value>& args,
+                                                       const StringFactory& makeString,
+                                                       const ValueStrInvoker& valueStr) const;
+
+    StringBuilderType();
+    const char* name() const override;
+    Value callMethod(Object& self,
+                     const std::string& method,
+                     const std::vector<Value>& args,
+                     const StringFactory& makeString,
+                     const ValueStrInvoker& valueStr) const override;
+    Value getMember(Object& self, const std::string& member) const override;
+    Value setMember(Object& self, const std::string& member, const Value& value) const override;
+    std::string __str__(Object& self, const ValueStrInvoker& valueStr) const override;
+
+    void registerMethod(const std::string& name, std::size_t argc, MethodHandler handler);
+
+private:
+    static StringBuilderObject& requireBuilder(Object& self);
+
+    Value methodAppend(Object& self,
+                       const std::vector<Value>& args,
+                       const StringFactory& makeString,
+                       const ValueStrInvoker& valueStr) const;
+    Value methodAppendLine(Object& self,
+                           const std::vector<Value>& args,
+                           const StringFactory& makeString,
+                           const ValueStrInvoker& valueStr) const;
+    Value methodBuild(Object& self,
+                      const std::vector<Value>& args,
+                      const StringFactory& makeString,
+                      const ValueStrInvoker& valueStr) const;
+    Value methodClear(Object& self,
+                      const std::vector<Value>& args,
+                      const StringFactory& makeString,
+                      const ValueStrInvoker& valueStr) const;
+    Value methodSize(Object& self,
+                     const std::vector<Value>& args,
+                     const StringFactory& makeString,
+                     const ValueStrInvoker& valueStr) const;
+    Value memberLengthGet(Object& self) const;
+    Value memberLengthSet(Object& self, const Value& value) const;
+};
+
+} // namespace gs
@@ -11,6 +11,7 @@ public:
     explicit StringObject(const Type& typeRef, const std::string& text);
 
     const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
     std::string& data();
     const std::string& data() const;
     std::size_t size() const;
@@ -23,9 +24,15 @@ public:
     std::vector<std::string> split(const std::string& delimiter) const;
     std::string replace(const std::string& from, const std::string& to) const;
 
+    // Set on strings produced by OpCode::AppendLocal while only their local slot can see
+    // them; such a string may be extended in place until SealLocal clears the flag.
+    bool isAppendTarget() const;
+    void setAppendTarget(bool value);
+
 private:
     const Type* type_;
     std::string data_;
+    bool appendTarget_{false};
 };
 
 class StringType : public Type {
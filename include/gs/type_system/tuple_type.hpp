@@ -9,6 +9,7 @@ public:
     TupleObject(const Type& typeRef, std::vector<Value> values);
 
     const Type& getType() const override;
+    std::size_t memoryFootprint() const override;
     std::vector<Value>& data();
     const std::vector<Value>& data() const;
 
@@ -2,6 +2,7 @@
 
 #include "gs/bytecode.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -59,13 +60,20 @@ public:
     virtual std::string __str__(const Type::ValueStrInvoker& valueStr) const {
         return getType().__str__(const_cast<Object&>(*this), valueStr);
     }
+    // Approximate heap bytes owned by this object, including payload buffers.
+    // Used by per-context memory accounting; containers refresh it as they grow.
+    virtual std::size_t memoryFootprint() const { return sizeof(Object); }
     void setObjectId(std::uint64_t id) { objectId_ = id; }
     std::uint64_t objectId() const { return objectId_; }
     void setProtoRef(const Value& protoRef) { protoRef_ = protoRef; }
     const Value& protoRef() const { return protoRef_; }
+    // Shared objects live outside every context heap and are read by several threads at once.
+    void markShared() { shared_ = 1; }
+    bool isShared() const { return shared_ != 0; }
 
 private:
-    std::uint64_t objectId_{0};
+    std::uint64_t objectId_ : 63 {0};
+    std::uint64_t shared_ : 1 {0};
     Value protoRef_{Value::Nil()};
 };
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "gs/bytecode.hpp"
+#include "gs/type_system/type_base.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace gs {
+
+// Values on their way from one ExecutionContext to another: spawn arguments and task results.
+// The objects they reach are held here, detached from the sending heap, so the receiver does not
+// depend on the sender's context or VM staying alive. VirtualMachine builds and unpacks them
+// (exportValues / importValues); the shape of the object graph, shared references and cycles
+// included, is kept.
+struct TransferredValues {
+    // A value that is not an object, or (node >= 0) the object made from nodes[node].
+    struct Slot {
+        Value value{Value::Nil()};
+        std::int32_t node{-1};
+    };
+
+    enum class NodeKind : std::uint8_t {
+        Object, // `object` is handed over as is (string, tuple, numeric array, native exception)
+        List,
+        Dict
+    };
+
+    struct Node {
+        NodeKind kind{NodeKind::Object};
+        std::unique_ptr<Object> object;
+        // List elements, dict keys and values interleaved, or tuple elements.
+        std::vector<Slot> items;
+    };
+
+    std::vector<Slot> roots;
+    std::vector<Node> nodes;
+    // The only root is an exception the task threw; await rethrows it.
+    bool thrown{false};
+
+    // Root `index` for a host: an immediate, or a string, tuple or numeric array owned by this
+    // packet. Lists and dicts only become objects when imported; read them through `nodes`.
+    Value value(std::size_t index = 0) const {
+        const Slot& slot = roots.at(index);
+        if (slot.node < 0) {
+            return slot.value;
+        }
+        const Node& node = nodes.at(static_cast<std::size_t>(slot.node));
+        if (node.kind != NodeKind::Object) {
+            throw std::runtime_error("Transferred list or dict has no object outside a context");
+        }
+        return Value::Ref(node.object.get());
+    }
+};
+
+} // namespace gs
@@ -2,9 +2,11 @@
 
 #include "gs/binding.hpp"
 #include "gs/bytecode.hpp"
+#include "gs/export.hpp"
 #include "gs/task_system.hpp"
 #include "gs/type_system.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <array>
@@ -33,21 +35,93 @@ struct GcObjectMeta {
     std::uint8_t age{0};
     bool marked{false};
     std::uint32_t regionId{0};
+    std::size_t bytes{0};
+};
+
+// Per-context allocation quota. Zero means unlimited.
+struct MemoryLimits {
+    std::size_t maxBytes{0};
+    std::size_t maxObjects{0};
 };
 
 struct GcState {
     GcPhase phase{GcPhase::Idle};
     bool requestMajor{false};
+    bool rootsRescanned{false};
     std::size_t allocCountSinceLastCycle{0};
     std::size_t markCursor{0};
     std::size_t sweepCursor{0};
     std::vector<std::uint64_t> markQueue;
     std::vector<std::uint64_t> sweepList;
     std::unordered_set<std::uint64_t> rememberedSet;
+    std::size_t youngObjects{0};
     std::size_t minorYoungThreshold{256};
     std::size_t majorObjectThreshold{4096};
+    // Heap size that starts the next major cycle: the surviving heap scaled by
+    // majorGrowthFactor after each major, never below majorObjectThreshold.
+    std::size_t nextMajorObjects{0};
+    std::size_t majorGrowthFactor{2};
     std::size_t promotionAge{2};
     std::size_t sliceBudgetObjects{16};
+    MemoryLimits limits;
+    std::size_t liveBytes{0};
+    std::size_t emergencyBytesWatermark{0};
+    std::size_t emergencyObjectsWatermark{0};
+    std::size_t emergencyCollections{0};
+    bool limitBypass{false};
+};
+
+// Bump-allocated storage for objects the compiler proved never outlive their frame
+// (FunctionBytecode::nonEscapingAllocSites). Each site owns two generations: a new
+// occupant replaces the one before the previous, so the value a pending store is about
+// to overwrite stays valid. Everything is released when the frame returns or unwinds.
+class FrameRegion {
+public:
+    FrameRegion() = default;
+    ~FrameRegion();
+    FrameRegion(const FrameRegion&) = delete;
+    FrameRegion& operator=(const FrameRegion&) = delete;
+
+    // The occupant the next acquire/adopt for site will destroy, if any.
+    Object* retiringOccupant(std::uint32_t site) const;
+    void* acquire(std::uint32_t site, std::size_t bytes, std::size_t alignment);
+    void commit(std::uint32_t site, Object* object);
+    void adopt(std::uint32_t site, std::unique_ptr<Object> object);
+
+    template <typename Fn>
+    void forEachObject(Fn&& fn) const {
+        for (const auto& slot : slots_) {
+            for (const auto& occupant : slot.generations) {
+                if (occupant.object) {
+                    fn(*occupant.object);
+                }
+            }
+        }
+    }
+
+private:
+    struct Occupant {
+        Object* object{nullptr};
+        void* block{nullptr};
+        std::size_t blockBytes{0};
+        bool heapOwned{false};
+    };
+
+    struct Slot {
+        std::uint32_t site{0};
+        std::array<Occupant, 2> generations{};
+        std::size_t newest{0};
+    };
+
+    const Slot* findSlot(std::uint32_t site) const;
+    Slot& slotFor(std::uint32_t site);
+    static void destroy(Occupant& occupant);
+    void* bump(std::size_t bytes, std::size_t alignment);
+
+    std::vector<Slot> slots_;
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    std::size_t chunkCapacity_{0};
+    std::size_t chunkUsed_{0};
 };
 
 struct ExceptionHandler {
@@ -56,6 +130,31 @@ struct ExceptionHandler {
     std::size_t stackTop{0};
 };
 
+// Per-context link state of one module's import table (Module::imports / importSymbols).
+struct LinkedModuleImports {
+    std::vector<Value> modules;             // module object per import; Nil until linked
+    std::vector<Value> symbols;             // value per import symbol
+    std::vector<std::uint8_t> symbolLinked; // set once `symbols[i]` may be reused
+};
+
+// What a LoadName/StoreName operand (an index into Module::strings) resolved to on first use.
+// CallHost operands name strings too; their host function handle is kept alongside.
+struct NameSlot {
+    enum class Kind : std::uint8_t { Unresolved, Global, Value, Super };
+    Kind kind{Kind::Unresolved};
+    std::uint32_t global{0};   // index into Module::globals for Kind::Global
+    Value value{Value::Nil()}; // function, class or host builtin for Kind::Value
+    HostHandle host{kInvalidHostHandle};
+};
+
+// Per-context globals of one module. `values` parallels Module::globals and `names` parallels
+// Module::strings, so global reads and writes are two vector indexings once a name is linked.
+struct ModuleGlobals {
+    std::vector<Value> values;
+    std::vector<std::uint8_t> assigned; // values[i] holds the runtime value (else use initialValue)
+    std::vector<NameSlot> names;
+};
+
 struct Frame {
     std::size_t functionIndex{0};
     std::size_t ip{0};
@@ -73,6 +172,14 @@ struct Frame {
     Value activeExceptionValue{Value::Nil()};
     std::array<Value, 8> registers{Value::Nil(), Value::Nil(), Value::Nil(), Value::Nil(), Value::Nil(), Value::Nil(), Value::Nil(), Value::Nil()};
     Value registerValue{Value::Nil()};
+    std::unique_ptr<FrameRegion> region;
+    // Link state of modulePin's imports, looked up by the frame's first LoadImport.
+    LinkedModuleImports* imports{nullptr};
+    // modulePin's globals in this context, looked up by the frame's first name access.
+    ModuleGlobals* globals{nullptr};
+    // Instruction the native body (FunctionBytecode::aotBody) last left to the interpreter; the
+    // native body is not re-entered until the interpreter has moved past it.
+    std::size_t aotHandbackIp{static_cast<std::size_t>(-1)};
 };
 
 struct ExecutionContext {
@@ -80,19 +187,28 @@ struct ExecutionContext {
     Value returnValue{Value::Nil()};
     bool hasUnhandledScriptException{false};
     Value unhandledScriptExceptionValue{Value::Nil()};
+    // Set by interruptCall: the message of the exception execute raises when it next resumes.
+    std::string pendingInterrupt;
     bool deleteHooksRan{false};
     std::shared_ptr<const Module> modulePin;
-    std::vector<std::string> stringPool;
-    std::unordered_map<const Module*, std::unordered_map<std::string, Value>> moduleRuntimeGlobals;
+    std::unordered_map<const Module*, ModuleGlobals> moduleGlobals;
     std::unordered_map<const Module*, std::unordered_map<std::string, Value>> moduleTypeObjectCache;
     std::unordered_map<const Module*, Value> moduleRuntimeObjects;
     std::unordered_set<const Module*> initializedModules;
     std::unordered_set<const Module*> moduleInitInProgress;
+    std::unordered_map<const Module*, LinkedModuleImports> moduleImports;
     std::unordered_map<std::string, Value> moduleObjectCache;
     std::unordered_map<std::uint64_t, std::unique_ptr<Object>> objectHeap;
     std::unordered_map<std::uint64_t, GcObjectMeta> gcMeta;
     std::unordered_map<Object*, std::uint64_t> objectPtrToId;
     GcState gc;
+    // Values native code holds between script calls it makes in this context (parallel chunks).
+    std::vector<Value> hostRoots;
+    // Set while a spawned task runs in the context: a channel operation that would block undoes
+    // its instruction, stores the wait in `parker` and returns from execute, and the task parks
+    // (TaskSystem::enqueueResumable). Elsewhere the thread waits in TaskSystem::wait.
+    bool canPark{false};
+    TaskParker parker;
 };
 
 class VirtualMachine {
@@ -102,10 +218,86 @@ public:
                    TaskSystem& tasks);
 
     Value runFunction(const std::string& functionName, const std::vector<Value>& args = {});
+    // Runs a SpawnFunc task. The VM keeps the context between tasks and clears it after each
+    // one, so a VM that is reused for many tasks keeps its allocations. The result, or the
+    // exception the function threw, is detached into `result` before the context is cleared.
+    // Returns false when the task parked on a channel instead: `parker` is set and the call
+    // stays in the context, to be continued by the next runSpawnedFunction on this VM.
+    bool runSpawnedFunction(std::size_t functionIndex,
+                            TransferredValues& args,
+                            TransferredValues& result,
+                            TaskParker& parker);
+    // Runs one chunk of a `parallel` call in the same reused context. `payload` holds the
+    // callable's captures (captureCells[i]: capture i was an upvalue cell) and then the items.
+    // Returns callable(item) for each item, or with `fold` the items folded left with callable.
+    TransferredValues runParallelChunk(std::size_t functionIndex,
+                                       TransferredValues& payload,
+                                       const std::vector<bool>& captureCells,
+                                       bool fold);
+    // The `parallel` module: splits `items` into chunks, runs them on the task system's pool and
+    // returns the chunk results in order as a list in `context`.
+    Value runParallel(ExecutionContext& context, const Value& callable, const std::vector<Value>& items, bool fold);
+    // await_all / await_any / poll (see HostContext::awaitTasks).
+    Value awaitTasks(ExecutionContext& context, const std::vector<Value>& handles);
+    Value awaitAnyTask(ExecutionContext& context, const std::vector<Value>& handles, std::size_t& position);
+    bool pollTask(const Value& handle) const;
+    // Isolates keep one context across calls and run each call a slice at a time. startCall
+    // initializes the module in ctx on first use and pushes the call. resumeCall runs up to
+    // stepBudget instructions and returns true once the call has returned (ctx.returnValue),
+    // throwing what the script did not catch; ctx stays usable after a failed call.
+    // interruptCall makes the call raise the runtime exception `message` classifies as (for
+    // example TimeoutException) where it stands when it next resumes; the script may catch it.
+    // abortCall drops the call's frames. closeContext runs the __delete__ hooks of what is left
+    // in ctx. transferredArgs, when given, replaces args and is unpacked once the module is
+    // initialized; takeResult copies ctx.returnValue and what it reaches out of ctx, so another
+    // thread can hold it while ctx runs on (objects other than strings, tuples, numeric arrays,
+    // lists, dicts, native exceptions and channels raise "Cannot pass ... between tasks").
+    void startCall(ExecutionContext& ctx,
+                   const std::string& functionName,
+                   const std::vector<Value>& args,
+                   TransferredValues* transferredArgs = nullptr);
+    bool resumeCall(ExecutionContext& ctx, std::size_t stepBudget);
+    TransferredValues takeResult(ExecutionContext& ctx);
+    void interruptCall(ExecutionContext& ctx, std::string message);
+    void abortCall(ExecutionContext& ctx);
+    void closeContext(ExecutionContext& ctx);
     void ensureModuleInitialized(ExecutionContext& context, const std::shared_ptr<const Module>& modulePin);
+    void setMemoryLimits(const MemoryLimits& limits);
+    const MemoryLimits& memoryLimits() const;
 
 private:
     std::size_t findFunctionIndex(const std::string& name) const;
+    // functionIndex -1 looks functionName up inside the error handling. transferredArgs, when
+    // given, replaces args and is unpacked once the module is initialized. With `parked`, the
+    // call may park (ExecutionContext::canPark): *parked is set and the call left in ctx, and
+    // the next runInContext on ctx continues it.
+    Value runInContext(ExecutionContext& ctx,
+                       const std::string& functionName,
+                       std::size_t functionIndex,
+                       const std::vector<Value>& args,
+                       TransferredValues* transferredArgs = nullptr,
+                       bool* parked = nullptr);
+    // send / try_send / recv / try_recv / close on a channel. Returns false, with ctx.parker
+    // set, when the operation has to wait and ctx may park.
+    bool callChannelMethod(ExecutionContext& ctx,
+                           ChannelObject& channel,
+                           const std::string& method,
+                           const std::vector<Value>& args,
+                           Value& result);
+    // Detaches `values` and the objects they reach from ctx for another context. Lists and dicts
+    // are rebuilt by the receiver. Strings, tuples and numeric arrays are handed over without
+    // copying when `takeObjects` is set (the sender is done with ctx), and copied otherwise.
+    // Native exceptions are copied and channels are shared. Other objects cannot be transferred.
+    // Appends to `out`, so several exports can share one packet.
+    void exportValues(ExecutionContext& ctx,
+                      const std::vector<Value>& values,
+                      bool takeObjects,
+                      TransferredValues& out);
+    std::vector<Value> importValues(ExecutionContext& ctx, TransferredValues& values);
+    // The context runSpawnedFunction and runParallelChunk run in.
+    ExecutionContext& taskContext();
+    // Packs an exception a task did not catch for its awaiter.
+    TransferredValues exportThrownValue(ExecutionContext& ctx, const Value& thrown);
     bool execute(ExecutionContext& context, std::size_t stepBudget = 200);
     static void pushCallFrame(ExecutionContext& ctx,
                               std::shared_ptr<const Module> modulePin,
@@ -115,12 +307,18 @@ private:
                               Value constructorInstance = Value::Nil(),
                               std::vector<Value> captures = {});
     void runDeleteHooks(ExecutionContext& context);
+    LinkedModuleImports& linkedImports(ExecutionContext& context, const Module& module);
+    Value linkImport(ExecutionContext& context, const Module& module, std::size_t importIndex);
+    void linkModuleImports(ExecutionContext& context, const std::shared_ptr<const Module>& modulePin);
+    Value loadImportSymbol(ExecutionContext& context, Frame& frame, std::size_t symbolIndex);
+    Value loadModuleMember(ExecutionContext& context, ModuleObject& moduleObj, const std::string& name, bool* cacheable);
 
     Object& getObject(ExecutionContext& context, const Value& ref);
 
     std::shared_ptr<const Module> module_;
     const HostRegistry& hosts_;
     TaskSystem& tasks_;
+    MemoryLimits memoryLimits_;
     ListType listType_;
     DictType dictType_;
 	StringType stringType_;
@@ -132,6 +330,13 @@ private:
     ScriptInstanceType instanceType_;
     ExceptionType exceptionType_;
     UpvalueCellType upvalueCellType_;
+    // Declared after the types: its objects refer to them.
+    std::unique_ptr<ExecutionContext> spawnContext_;
 };
 
+// Spawned tasks run on VMs the TaskSystem keeps between tasks (TaskSystem::takeSpawnVm); on by
+// default. Switching it off builds a VM per task, as tools/spawn_bench does for comparison.
+GS_API void setSpawnVmReuseEnabled(bool enabled);
+GS_API bool spawnVmReuseEnabled();
+
 } // namespace gs
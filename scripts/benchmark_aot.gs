@@ -0,0 +1,59 @@
+# Numeric kernels for the AOT backend. tools/aot_bench.cpp links the C++ generated from this file
+# by `gsc --aot-cpp` and runs main() with the native bodies disabled and enabled.
+
+fn collatz_steps(limit) {
+    let total = 0;
+    let n = 1;
+    while (n < limit) {
+        let x = n;
+        while (x != 1) {
+            if (x % 2 == 0) {
+                x = x // 2;
+            } else {
+                x = 3 * x + 1;
+            }
+            total = total + 1;
+        }
+        n = n + 1;
+    }
+    return total;
+}
+
+fn integrate(steps) {
+    let sum = 0.0;
+    let dx = 1.0 / steps;
+    let i = 0;
+    while (i < steps) {
+        let x = (i + 0.5) * dx;
+        sum = sum + 4.0 / (1.0 + x * x);
+        i = i + 1;
+    }
+    return sum * dx;
+}
+
+# FNV-style mixing on a 22-bit state, so each product stays inside the 47-bit integers of the
+# compact value layout.
+fn mix_bits(rounds) {
+    let h = 1875397;
+    let i = 0;
+    while (i < rounds) {
+        h = ((h ^ (i & 255)) * 16777619) & 4194303;
+        i = i + 1;
+    }
+    return h;
+}
+
+fn fib(n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+fn main() {
+    let collatz = collatz_steps(30000);
+    let pi = integrate(400000);
+    let bits = mix_bits(400000);
+    let calls = fib(20);
+    return collatz + bits + calls + (pi * 1000000) // 1;
+}
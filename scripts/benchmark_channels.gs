@@ -0,0 +1,62 @@
+# Producer/consumer pipelines for tools/channel_bench.cpp: decode -> logic -> persist, with the
+# stages as spawned tasks joined by channels.
+
+fn decode(out, first, count) {
+    for (i in range(first, first + count)) {
+        out.send(i * 3 + 1);
+    }
+    return count;
+}
+
+fn logic(input, out) {
+    let item = input.recv();
+    while (item != null) {
+        out.send(item % 1000);
+        item = input.recv();
+    }
+    out.close();
+    return 0;
+}
+
+fn persist(input) {
+    let total = 0;
+    let item = input.recv();
+    while (item != null) {
+        total = total + item;
+        item = input.recv();
+    }
+    return total;
+}
+
+# The same work in one loop.
+fn direct(producers, perProducer) {
+    let total = 0;
+    for (i in range(0, producers * perProducer)) {
+        total = total + (i * 3 + 1) % 1000;
+    }
+    return total;
+}
+
+fn pipeline(producers, perProducer, capacity) {
+    let decoded = Channel(capacity);
+    let ruled = Channel(capacity);
+    let decoders = [];
+    for (p in range(0, producers)) {
+        let decoder = spawn decode(decoded, p * perProducer, perProducer);
+        decoders.push(decoder);
+    }
+    let logicTask = spawn logic(decoded, ruled);
+    let persistTask = spawn persist(ruled);
+    let decodedCounts = await_all(decoders);
+    decoded.close();
+    let logicDone = await logicTask;
+    let total = await persistTask;
+    return total;
+}
+
+fn main() {
+    let expected = direct(8, 100);
+    assert(pipeline(8, 100, 4) == expected, "pipeline mismatch");
+    print("benchmark_channels ok");
+    return expected;
+}
@@ -0,0 +1,24 @@
+# Host calls from pool tasks for tools/host_bind_bench.cpp, which keeps rebinding plugin_scale
+# and binding new functions on another thread while these run.
+
+fn call_host(count) {
+    let total = 0;
+    for (i in range(0, count)) {
+        total = total + plugin_scale(i);
+    }
+    return total;
+}
+
+fn call_host_tasks(tasks, count) {
+    let handles = [];
+    for (t in range(0, tasks)) {
+        let handle = spawn call_host(count);
+        handles.push(handle);
+    }
+    let totals = await_all(handles);
+    let total = 0;
+    for (part in totals) {
+        total = total + part;
+    }
+    return total;
+}
@@ -0,0 +1,40 @@
+# A player sandbox: each isolate has its own copy of these globals. tools/isolate_bench.cpp
+# runs many isolates at once on this script.
+
+let ticks = 0;
+let score = 0;
+let seen = [];
+
+# One game tick of sandbox logic; returns the ticks this sandbox has seen.
+fn tick(work) {
+    let x = ticks + 1;
+    let step = 0;
+    while (step < work) {
+        x = (x * 1103515245 + 12345) % 65536;
+        score = score + x % 7;
+        step = step + 1;
+    }
+    ticks = ticks + 1;
+    return ticks;
+}
+
+# A sandbox stuck in a long loop.
+fn spin(steps) {
+    let i = 0;
+    while (i < steps) {
+        i = i + 1;
+    }
+    return i;
+}
+
+fn fail() {
+    throw Exception("sandbox failed");
+}
+
+# Keeps the items the host sent and returns a string built in the sandbox's heap.
+fn remember(items) {
+    for (item in items) {
+        seen.push(item);
+    }
+    return "seen " + str(seen.length);
+}
@@ -0,0 +1,52 @@
+# Per-frame agent update, serially and with parallel.map. tools/parallel_bench.cpp times
+# update_serial() against update_parallel() over the same agents.
+
+fn make_agents(count) {
+    let agents = [];
+    let i = 0;
+    while (i < count) {
+        agents.push(i);
+        i = i + 1;
+    }
+    return agents;
+}
+
+# Some steering-sized arithmetic per agent. The generator keeps 16 bits of state so products
+# fit the 47-bit integers of the compact value layout.
+fn think(agent) {
+    let x = agent;
+    let score = 0;
+    let step = 0;
+    while (step < 200) {
+        x = (x * 1103515245 + 12345) % 65536;
+        score = score + x % 7;
+        step = step + 1;
+    }
+    return score;
+}
+
+fn update_serial(count) {
+    let agents = make_agents(count);
+    let total = 0;
+    for (agent in agents) {
+        total = total + think(agent);
+    }
+    return total;
+}
+
+fn add(a, b) {
+    return a + b;
+}
+
+fn update_parallel(count) {
+    let agents = make_agents(count);
+    let scores = parallel.map(agents, think);
+    return parallel.reduce(scores, add, 0);
+}
+
+fn main() {
+    let expected = update_serial(500);
+    assert(update_parallel(500) == expected, "update_parallel mismatch");
+    print("benchmark_parallel ok");
+    return expected;
+}
@@ -0,0 +1,42 @@
+# Long-running calls for tools/script_call_bench.cpp, which resumes them a frame budget at a time.
+
+# Path-finding sized work that would block a frame if it ran in one go.
+fn plan(steps) {
+    let x = 1;
+    let total = 0;
+    let i = 0;
+    while (i < steps) {
+        x = (x * 1103515245 + 12345) % 2147483648;
+        total = total + x % 7;
+        i = i + 1;
+    }
+    return total;
+}
+
+# Stops at its timeout and reports how far it got.
+fn plan_until_timeout() {
+    let i = 0;
+    try {
+        while (true) {
+            i = i + 1;
+        }
+    } catch (TimeoutException as err) {
+        return -1;
+    }
+    return i;
+}
+
+# Ignores its timeout; the host stops it.
+fn runaway() {
+    let i = 0;
+    while (true) {
+        try {
+            while (true) {
+                i = i + 1;
+            }
+        } catch (TimeoutException as err) {
+            i = 0;
+        }
+    }
+    return i;
+}
@@ -0,0 +1,80 @@
+# Per-spawn overhead. tools/spawn_bench.cpp times spawn_await(), spawn_batch() and
+# spawn_await_all() against call_direct(), which runs the same job without a task.
+
+fn job(x) {
+    return x * 2 + 1;
+}
+
+fn call_direct(count) {
+    let total = 0;
+    let i = 0;
+    while (i < count) {
+        total = total + job(i);
+        i = i + 1;
+    }
+    return total;
+}
+
+# One task in flight: spawn, then await it.
+fn spawn_await(count) {
+    let total = 0;
+    let i = 0;
+    while (i < count) {
+        let handle = spawn job(i);
+        let value = await handle;
+        total = total + value;
+        i = i + 1;
+    }
+    return total;
+}
+
+# Up to 64 tasks in flight, awaited in spawn order.
+fn spawn_batch(count) {
+    let total = 0;
+    let i = 0;
+    while (i < count) {
+        let handles = [];
+        let j = 0;
+        while (j < 64 && i < count) {
+            let handle = spawn job(i);
+            handles.push(handle);
+            i = i + 1;
+            j = j + 1;
+        }
+        for (handle in handles) {
+            let value = await handle;
+            total = total + value;
+        }
+    }
+    return total;
+}
+
+# The same batches collected with one await_all per batch.
+fn spawn_await_all(count) {
+    let total = 0;
+    let i = 0;
+    while (i < count) {
+        let handles = [];
+        let j = 0;
+        while (j < 64 && i < count) {
+            let handle = spawn job(i);
+            handles.push(handle);
+            i = i + 1;
+            j = j + 1;
+        }
+        for (value in await_all(handles)) {
+            total = total + value;
+        }
+    }
+    return total;
+}
+
+fn main() {
+    let count = 2000;
+    let expected = call_direct(count);
+    assert(spawn_await(count) == expected, "spawn_await mismatch");
+    assert(spawn_batch(count) == expected, "spawn_batch mismatch");
+    assert(spawn_await_all(count) == expected, "spawn_await_all mismatch");
+    print("benchmark_spawn ok");
+    return expected;
+}
@@ -0,0 +1,46 @@
+import system as system;
+
+# Value-heavy workload: 100k entity records stored as lists of numbers.
+# Run against a default build and a -DGS_COMPACT_VALUE=ON build to compare layouts.
+
+fn main() {
+    let count = 100000;
+    let frames = 20;
+    let start = system.getTimeMs();
+
+    let entities = [];
+    let i = 0;
+    while (i < count) {
+        entities.push([i, i * 2, 0.5, 1.5, 0]);
+        i = i + 1;
+    }
+    let built = system.getTimeMs();
+    let heapBytes = system.memoryUsage();
+
+    let checksum = 0;
+    let frame = 0;
+    while (frame < frames) {
+        i = 0;
+        while (i < count) {
+            let e = entities[i];
+            e[0] = e[0] + 1;
+            e[4] = e[4] + e[1];
+            i = i + 1;
+        }
+        frame = frame + 1;
+    }
+    i = 0;
+    while (i < count) {
+        checksum = checksum + entities[i][4];
+        i = i + 1;
+    }
+
+    let finished = system.getTimeMs();
+    print("benchmark_value_layout");
+    print("entities:", count);
+    print("heap_bytes:", heapBytes);
+    print("build_ms:", built - start);
+    print("update_ms:", finished - built);
+    print("checksum:", checksum);
+    return 0;
+}
@@ -0,0 +1,96 @@
+# Channels between tasks: bounded queues whose blocked senders and receivers park.
+
+fn produce(out, first, count) {
+    for (i in range(first, first + count)) {
+        out.send(i);
+    }
+    return count;
+}
+
+# Squares what arrives until the input is closed, then closes the output.
+fn square_stage(input, out) {
+    let seen = 0;
+    let item = input.recv();
+    while (item != null) {
+        out.send(item * item);
+        seen = seen + 1;
+        item = input.recv();
+    }
+    out.close();
+    return seen;
+}
+
+fn sum_stage(input) {
+    let total = 0;
+    let item = input.recv();
+    while (item != null) {
+        total = total + item;
+        item = input.recv();
+    }
+    return total;
+}
+
+fn reply_on(requests) {
+    let request = requests.recv();
+    let replyTo = request[0];
+    replyTo.send("pong " + request[1]);
+    return 0;
+}
+
+fn main() {
+    let ch = Channel(2);
+    assert(ch.capacity == 2 && ch.length == 0, "new channel: {}", ch);
+    ch.send([1, 2]);
+    assert(ch.try_send("two"), "room for a second value");
+    assert(!ch.try_send(3), "try_send on a full channel");
+    assert(ch.length == 2, "length: {}", ch.length);
+    let first = ch.recv();
+    assert(first[1] == 2, "values arrive in order: {}", first);
+    assert(ch.try_recv() == "two", "try_recv takes what is queued");
+    assert(ch.try_recv() == null, "try_recv on an empty channel");
+
+    # Eight producers, a squaring stage and a summing stage, all on a tiny buffer: far more
+    # tasks wait than the pool has threads, so the waits must park.
+    let numbers = Channel(1);
+    let squares = Channel(1);
+    let producers = [];
+    for (p in range(0, 8)) {
+        let producer = spawn produce(numbers, p * 25, 25);
+        producers.push(producer);
+    }
+    let squarer = spawn square_stage(numbers, squares);
+    let summer = spawn sum_stage(squares);
+    let produced = await_all(producers);
+    assert(produced.length == 8, "producers finished");
+    numbers.close();
+    let squared = await squarer;
+    let total = await summer;
+    let expected = 0;
+    for (i in range(0, 200)) {
+        expected = expected + i * i;
+    }
+    assert(squared == 200, "every value squared: {}", squared);
+    assert(total == expected, "pipeline total: {} != {}", total, expected);
+
+    assert(squares.closed, "the stage closed its output");
+    assert(!squares.close(), "closing twice reports false");
+    let rejected = "";
+    try {
+        squares.send(1);
+    } catch (Exception as err) {
+        rejected = err.message;
+    }
+    assert(rejected == "Channel is closed", "send after close: {}", rejected);
+
+    # A channel sent through a channel reaches the same queue.
+    let requests = Channel();
+    let replies = Channel(1);
+    let server = spawn reply_on(requests);
+    requests.send(Tuple(replies, "ping"));
+    let reply = replies.recv();
+    assert(reply == "pong ping", "reply over a passed channel: {}", reply);
+    let serverDone = await server;
+
+    print("channel_test ok");
+    return 0;
+}
@@ -0,0 +1,53 @@
+# Frame-scoped allocation: values that never leave their function.
+
+fn concat_loop(n) {
+    let total = 0;
+    for (i in range(0, n)) {
+        let s = str(i);
+        let label = "item-" + s;
+        total = total + (typename(label) == "string");
+        assert(label == "item-" + s, "frame-scoped string compares by value");
+    }
+    return total;
+}
+
+fn lambda_loop(n) {
+    let total = 0;
+    for (i in range(0, n)) {
+        let twice = (x) => { return x * 2 + i; };
+        total = total + twice(3);
+    }
+    return total;
+}
+
+fn tuple_destructure() {
+    let pair = Tuple(str(40), 2);
+    return pair[0] + str(pair[1]);
+}
+
+fn escaping(n) {
+    let keep = [];
+    for (i in range(0, n)) {
+        let s = "v" + str(i);
+        keep.push(s);
+    }
+    return keep;
+}
+
+fn returned() {
+    let s = "ret" + str(1);
+    return s;
+}
+
+fn main() {
+    assert(concat_loop(300) == 300, "concat loop");
+    assert(lambda_loop(100) == 5550, "lambda loop");
+    assert(tuple_destructure() == "402", "tuple destructure");
+    let kept = escaping(200);
+    assert(kept[0] == "v0" && kept[199] == "v199", "escaping strings survive");
+    assert(returned() == "ret1", "returned string survives");
+    for (i in range(0, 3)) {
+        print("line " + str(i));
+    }
+    return 0;
+}
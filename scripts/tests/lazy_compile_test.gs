@@ -0,0 +1,68 @@
+# Function and method bodies are compiled on their first call. Bodies compiled late add
+# strings, constants, lambdas and import symbols to a module that is already running.
+import module_math as mm;
+
+let calls = 0;
+
+class Counter {
+    count = 0;
+
+    fn __new__(self, start) {
+        self.count = start;
+    }
+
+    fn bump(self, by) {
+        self.count = self.count + by;
+        return self.count;
+    }
+}
+
+fn never_called() {
+    let unused = "only referenced by a body that is never compiled";
+    return unused;
+}
+
+fn make_adder(n) {
+    return (x) => {
+        return x + n;
+    };
+}
+
+fn late_strings() {
+    calls = calls + 1;
+    let label = "late-" + str(calls);
+    return label;
+}
+
+fn late_import(a, b) {
+    return mm.add(a, b);
+}
+
+fn fib(n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+fn main() {
+    assert(fib(15) == 610, "recursive call of a deferred body");
+
+    let counter = Counter(5);
+    assert(counter.bump(3) == 8, "method compiled on first call");
+    assert(counter.bump(2) == 10, "method reused");
+
+    let add10 = make_adder(10);
+    assert(add10(5) == 15, "lambda created by a deferred body");
+    assert(make_adder(1)(1) == 2, "second closure from the same body");
+
+    assert(late_strings() == "late-1", "strings added after start");
+    assert(late_strings() == "late-2", "global updated from a deferred body");
+
+    let total = 0;
+    for (i in range(0, 1000)) {
+        total = late_import(total, i);
+    }
+    assert(total == 499500, "import symbol added by a deferred body: {}", total);
+    return total;
+}
@@ -0,0 +1,59 @@
+import system as system;
+
+fn fill(limitItems) {
+    let items = [];
+    let i = 0;
+    while (i < limitItems) {
+        items.push("payload-" + str(i) + "-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+        i = i + 1;
+    }
+    return items.size();
+}
+
+fn main() {
+    system.setMemoryLimit(256 * 1024);
+
+    let caught = 0;
+    try {
+        fill(1000000);
+    } catch (OutOfMemoryException as err) {
+        caught = 1;
+        print("caught:", err.name);
+    }
+    assert(caught == 1, "expected OutOfMemoryException");
+
+    # The abandoned list is garbage now; the emergency collection must make room again.
+    let count = fill(100);
+    assert(count == 100, "allocation after recovery failed, count={}", count);
+    assert(system.memoryUsage() <= 256 * 1024, "usage above limit: {}", system.memoryUsage());
+
+    # The limit is a ceiling: a script can lower it but never raise or clear it.
+    let refused = 0;
+    try {
+        system.setMemoryLimit(512 * 1024);
+    } catch (Exception as err) {
+        refused = refused + 1;
+    }
+    try {
+        system.setMemoryLimit(0);
+    } catch (Exception as err) {
+        refused = refused + 1;
+    }
+    try {
+        system.setMemoryLimit(16);
+    } catch (Exception as err) {
+        refused = refused + 1;
+    }
+    assert(refused == 3, "raising, clearing or going below usage must fail, refused={}", refused);
+    system.setMemoryLimit(200 * 1024);
+    caught = 0;
+    try {
+        fill(1000000);
+    } catch (OutOfMemoryException as err) {
+        caught = 1;
+    }
+    assert(caught == 1, "the lowered limit still applies");
+
+    print("memory_limit_test ok");
+    return 0;
+}
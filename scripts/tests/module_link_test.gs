@@ -0,0 +1,31 @@
+# Imports are linked through the module's import table: each imported script is compiled
+# on its own and its exports are resolved when first used.
+import module_math as mm;
+import module_globals as mg;
+from module_math import add as plus;
+from module_math import add, hello as pair;
+from module_math import * as ns;
+from module_globals import getG, getDouble;
+
+fn apply(f, a, b) {
+    return f(a, b);
+}
+
+fn main() {
+    assert(mm.add(1, 2) == 3, "alias call");
+    assert(plus(3, 4) == 7, "from-import with alias");
+    assert(pair.add(2, 2) == 4, "projected import");
+    assert(ns.add(5, 5) == 10, "wildcard namespace");
+    assert(apply(mm.add, 6, 7) == 13, "module function as value");
+
+    let total = 0;
+    for (i in range(0, 1000)) {
+        total = mm.add(total, i);
+    }
+    assert(total == 499500, "linked call in loop: {}", total);
+
+    assert(mg.G == 123, "module global");
+    assert(getG() == 123, "from-import of several names");
+    assert(getDouble() == 246, "from-import of several names");
+    return total;
+}
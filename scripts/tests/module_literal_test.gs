@@ -0,0 +1,39 @@
+# String literals are shared, read-only objects of the loaded module.
+
+fn tag() {
+    return "agent";
+}
+
+fn main() {
+    let table = {};
+    table["hp"] = 10;
+    table["mp"] = 4;
+    assert(table["hp"] == 10 && table["mp"] == 4, "literal keys: {}", table);
+
+    let first = tag();
+    let second = tag();
+    assert(first == second && first == "agent", "literal value: {}", first);
+
+    # Appending starts from a fresh string, never the literal itself.
+    let name = "agent";
+    let i = 0;
+    while (i < 3) {
+        name = name + "!";
+        i = i + 1;
+    }
+    assert(name == "agent!!!", "appended: {}", name);
+    assert(tag() == "agent", "literal unchanged: {}", tag());
+
+    # Shared literals get ordinary ids, which are valid integers in both Value layouts.
+    let literalId = id(tag());
+    assert(literalId > 0 && literalId == id(tag()), "literal id: {}", literalId);
+    let heapId = id(name);
+    assert(heapId > 0 && heapId != literalId, "heap string id: {}", heapId);
+
+    let task = spawn tag();
+    let fromTask = await task;
+    assert(fromTask == "agent", "literal from a task: {}", fromTask);
+
+    print("module_literal_test ok");
+    return 0;
+}
@@ -0,0 +1,72 @@
+fn near(a, b) {
+    let d = a - b;
+    return d < 0.000001 && d > -0.000001;
+}
+
+fn test_int_array() {
+    let a = IntArray([1, 2, 3, 4, 5]);
+    assert(typename(a) == "IntArray", "typename: {}", typename(a));
+    assert(a.size() == 5 && a.length == 5, "size");
+    assert(a[0] == 1 && a[4] == 5, "index read");
+    a[2] = 30;
+    assert(a[2] == 30, "index write");
+
+    let b = IntArray(5, 2);
+    a.add(b).scale(3);
+    assert(a[0] == 9 && a[2] == 96, "add/scale: {}", a);
+    assert(a.sum() == 9 + 12 + 96 + 18 + 21, "sum");
+    assert(a.min() == 9 && a.max() == 96, "min/max");
+    assert(a.dot(b) == 2 * a.sum(), "dot");
+    a.clamp(10, 20);
+    assert(a[0] == 10 && a[2] == 20 && a[3] == 18, "clamp: {}", a);
+    a.add(-10);
+    assert(a.sum() == 0 + 2 + 10 + 8 + 10, "scalar add");
+
+    let grown = IntArray(0);
+    for (i in range(0, 7)) {
+        grown.push(i);
+    }
+    assert(grown.sum() == 21, "push/sum with odd tail");
+
+    let caught = 0;
+    try {
+        let x = a[5];
+    } catch (Exception as err) {
+        caught = 1;
+    }
+    assert(caught == 1, "out of range read must throw");
+}
+
+fn test_float_array() {
+    let n = 10001;
+    let pos = FloatArray(n, 1.5);
+    let vel = FloatArray(n);
+    for (i in range(0, n)) {
+        vel[i] = i * 0.5;
+    }
+    pos.add(vel).scale(2);
+    assert(near(pos[0], 3.0) && near(pos[10000], 10003.0), "add/scale");
+    assert(near(pos.min(), 3.0) && near(pos.max(), 10003.0), "min/max");
+    assert(near(vel.sum(), 0.5 * (n - 1) * n / 2), "sum");
+
+    let ones = FloatArray(n, 1);
+    assert(near(pos.dot(ones), pos.sum()), "dot");
+
+    let target = FloatArray(n, 100.0);
+    let from = FloatArray(n, 0.0);
+    from.lerp(target, 0.25);
+    assert(near(from[1234], 25.0) && near(from.sum(), 25.0 * n), "lerp");
+
+    pos.clamp(10.0, 20.0);
+    assert(near(pos.min(), 10.0) && near(pos.max(), 20.0), "clamp");
+
+    let small = FloatArray(Tuple(1, 2.5));
+    assert(str(small) == "FloatArray[1.0, 2.5]" || str(small) == "FloatArray[1, 2.5]", "str: {}", small);
+}
+
+fn main() {
+    test_int_array();
+    test_float_array();
+    print("numeric_array_test ok");
+    return 0;
+}
@@ -0,0 +1,68 @@
+let calls = 0;
+
+fn square(x) {
+    calls = calls + 1;
+    return x * x;
+}
+
+fn add(a, b) {
+    return a + b;
+}
+
+fn describe(agent) {
+    return [agent[0], agent[1] * 2];
+}
+
+fn fail_on(x) {
+    if (x == 37) {
+        throw Exception("bad item " + str(x));
+    }
+    return x;
+}
+
+fn main() {
+    let values = [];
+    for (i in range(0, 1000)) {
+        values.push(i);
+    }
+
+    let squares = parallel.map(values, square);
+    assert(squares.length == 1000, "map length: {}", squares.length);
+    assert(squares[0] == 0 && squares[999] == 998001, "map order");
+    assert(calls == 0, "tasks do not share the caller's globals");
+
+    let scale = 3;
+    let scaled = parallel.map(values, (x) => {
+        return x * scale;
+    });
+    assert(scaled[10] == 30 && scaled[999] == 2997, "lambda captures");
+
+    let agents = [];
+    for (i in range(0, 50)) {
+        agents.push(Tuple("agent" + str(i), i));
+    }
+    let updated = parallel.map(agents, describe);
+    assert(updated[49][0] == "agent49" && updated[49][1] == 98, "objects in and out: {}", updated[49]);
+
+    assert(parallel.reduce(values, add) == 499500, "reduce");
+    assert(parallel.reduce(values, add, 500) == 500000, "reduce with initial");
+    assert(parallel.reduce([], add, 7) == 7, "reduce of empty list");
+    assert(parallel.reduce([5], add) == 5, "reduce of one item");
+
+    parallel.for_range(100, square);
+    parallel.for_range(0, square);
+
+    let empty = parallel.map([], square);
+    assert(empty.length == 0, "map of empty list");
+
+    let caught = "";
+    try {
+        let failed = parallel.map(values, fail_on);
+    } catch (Exception as err) {
+        caught = err.message;
+    }
+    assert(caught == "bad item 37", "task exception: {}", caught);
+
+    print("parallel_test ok");
+    return 0;
+}
@@ -0,0 +1,66 @@
+let counter = 0;
+
+fn square(x) {
+    return x * x;
+}
+
+# Each task starts from the module's initial globals, even on a reused VM.
+fn bump() {
+    counter = counter + 1;
+    return counter;
+}
+
+fn sum_squares(n) {
+    let handles = [];
+    let i = 0;
+    while (i < n) {
+        let handle = spawn square(i);
+        handles.push(handle);
+        i = i + 1;
+    }
+    let total = 0;
+    for (handle in handles) {
+        let value = await handle;
+        total = total + value;
+    }
+    return total;
+}
+
+fn main() {
+    let first = spawn square(7);
+    let result = await first;
+    assert(result == 49, "square(7) = {}", result);
+
+    let i = 0;
+    while (i < 20) {
+        let task = spawn bump();
+        let seen = await task;
+        assert(seen == 1, "task saw counter {}", seen);
+        i = i + 1;
+    }
+    assert(counter == 0, "spawned tasks changed the caller's global");
+
+    # Tasks that spawn and await tasks of their own.
+    let outer = [];
+    i = 0;
+    while (i < 8) {
+        let handle = spawn sum_squares(10);
+        outer.push(handle);
+        i = i + 1;
+    }
+    for (handle in outer) {
+        let value = await handle;
+        assert(value == 285, "sum_squares(10) = {}", value);
+    }
+
+    let base = 12;
+    let later = () => {
+        let handle = spawn square(base);
+        let value = await handle;
+        return value;
+    };
+    assert(later() == 144, "spawn inside a lambda");
+
+    print("spawn_test ok");
+    return 0;
+}
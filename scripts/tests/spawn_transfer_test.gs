@@ -0,0 +1,119 @@
+# Objects passed to spawned tasks and returned from them are rebuilt in the receiving task.
+
+class Point {
+    x = 0;
+
+    fn __new__(self, x) {
+        self.x = x;
+    }
+}
+
+fn total(values) {
+    let sum = 0;
+    for (v in values) {
+        sum = sum + v;
+    }
+    return sum;
+}
+
+fn make_record(n) {
+    let items = [];
+    for (i in range(0, n)) {
+        items.push(i * i);
+    }
+    let record = {};
+    record[1] = items;
+    record[2] = items;
+    record[3] = Tuple("label", str(n), items);
+    record[4] = IntArray([n, n + 1]);
+    return record;
+}
+
+fn make_cycle() {
+    let node = [1];
+    node.push(node);
+    return node;
+}
+
+fn echo(value) {
+    return value;
+}
+
+fn fail(message) {
+    throw Exception(message);
+}
+
+fn fail_with_value() {
+    throw 42;
+}
+
+fn make_point() {
+    return Point(1);
+}
+
+fn main() {
+    let handle = spawn total([1, 2, 3, 4]);
+    let sum = await handle;
+    assert(sum == 10, "list argument: {}", sum);
+
+    let recordTask = spawn make_record(5);
+    let record = await recordTask;
+    let items = record[1];
+    assert(items.length == 5 && items[4] == 16, "returned list: {}", items);
+    items.push(99);
+    assert(record[2].length == 6, "shared reference kept");
+    let tuple = record[3];
+    assert(tuple[0] == "label" && tuple[1] == "5", "returned tuple: {}", tuple);
+    assert(tuple[2].length == 6, "tuple element shares the list");
+    assert(record[4][1] == 6, "returned IntArray: {}", record[4]);
+
+    let cycleTask = spawn make_cycle();
+    let node = await cycleTask;
+    assert(node[0] == 1 && node[1][1][0] == 1, "cycle kept");
+
+    let text = "round" + "trip";
+    let sent = [text, Tuple(1, text)];
+    let echoTask = spawn echo(sent);
+    let back = await echoTask;
+    assert(back[0] == "roundtrip" && back[1][1] == "roundtrip", "echoed: {}", back);
+    back[0] = "changed";
+    assert(sent[0] == "roundtrip", "arguments are copies");
+
+    let caught = "";
+    let failTask = spawn fail("task failed");
+    try {
+        let failed = await failTask;
+    } catch (Exception as err) {
+        caught = err.message;
+    }
+    assert(caught == "task failed", "task exception: {}", caught);
+
+    let thrown = 0;
+    let throwTask = spawn fail_with_value();
+    try {
+        let thrownResult = await throwTask;
+    } catch (any as err) {
+        thrown = err;
+    }
+    assert(thrown == 42, "thrown value: {}", thrown);
+
+    let rejected = 0;
+    let pointTask = spawn make_point();
+    try {
+        let point = await pointTask;
+    } catch (Exception as err) {
+        rejected = 1;
+    }
+    assert(rejected == 1, "class instances cannot leave a task");
+
+    rejected = 0;
+    try {
+        let rejectedTask = spawn echo(Point(1));
+    } catch (Exception as err) {
+        rejected = 1;
+    }
+    assert(rejected == 1, "class instances cannot enter a task");
+
+    print("spawn_transfer_test ok");
+    return 0;
+}
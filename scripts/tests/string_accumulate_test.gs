@@ -0,0 +1,140 @@
+fn join_digits(n) {
+    let s = "";
+    let i = 0;
+    while (i < n) {
+        s = s + i;
+        i = i + 1;
+    }
+    return s;
+}
+
+fn test_basic_accumulation() {
+    assert(join_digits(5) == "01234", "while accumulation: {}", join_digits(5));
+    let long = join_digits(1000);
+    assert(long.length == 10 + 90 * 2 + 900 * 3, "long accumulation length");
+
+    let line = "log:";
+    for (i in range(0, 3)) {
+        line = line + " " + i;
+    }
+    assert(line == "log: 0 1 2", "for-range accumulation: {}", line);
+}
+
+fn test_alias_before_loop_is_untouched() {
+    let s = "a";
+    let before = s;
+    for (i in range(0, 3)) {
+        s = s + "b";
+    }
+    assert(s == "abbb", "accumulated: {}", s);
+    assert(before == "a", "alias taken before the loop changed: {}", before);
+}
+
+fn test_escape_between_loop_entries() {
+    let rows = [];
+    let row = "";
+    for (r in range(0, 3)) {
+        for (c in range(0, 2)) {
+            row = row + c;
+        }
+        rows.push(row);
+    }
+    assert(rows[0] == "01", "first row mutated: {}", rows[0]);
+    assert(rows[1] == "0101", "second row: {}", rows[1]);
+    assert(rows[2] == "010101", "third row: {}", rows[2]);
+}
+
+fn test_loop_variable_is_not_extended_in_place() {
+    let first = "";
+    for (i in range(0, 2)) {
+        first = first + "x";
+    }
+    let items = [first, "y"];
+    for (item in items) {
+        item = item + "!";
+    }
+    assert(items[0] == "xx" && items[1] == "y", "list elements mutated: {}", items);
+}
+
+fn test_numeric_accumulation_stays_numeric() {
+    let total = 0;
+    for (i in range(0, 5)) {
+        total = total + i;
+    }
+    assert(typename(total) == "int" && total == 10, "int sum: {}", total);
+
+    let mixed = 1;
+    for (i in range(0, 2)) {
+        mixed = mixed + "a";
+    }
+    assert(mixed == "1aa", "int then string: {}", mixed);
+}
+
+fn test_reads_inside_loop_see_each_step() {
+    let s = "";
+    let seen = [];
+    for (i in range(0, 3)) {
+        s = s + i;
+        seen.push(s);
+    }
+    assert(seen[0] == "0" && seen[1] == "01" && seen[2] == "012", "snapshots: {}", seen);
+}
+
+fn test_captured_accumulator() {
+    let s = "";
+    let peek = () => {
+        return s;
+    };
+    for (i in range(0, 3)) {
+        s = s + i;
+    }
+    assert(peek() == "012", "closure view: {}", peek());
+}
+
+fn test_exception_keeps_partial_value() {
+    let s = "";
+    try {
+        for (i in range(0, 5)) {
+            s = s + i;
+            if (i == 2) {
+                throw Exception("stop");
+            }
+        }
+    } catch (err) {
+        assert(s == "012", "partial accumulation: {}", s);
+    }
+    assert(s == "012", "after catch: {}", s);
+}
+
+fn test_string_builder() {
+    let sb = StringBuilder("[");
+    for (i in range(0, 3)) {
+        if (i > 0) {
+            sb.append(", ");
+        }
+        sb.append(i);
+    }
+    sb.append("]");
+    assert(typename(sb) == "StringBuilder", "typename: {}", typename(sb));
+    assert(sb.build() == "[0, 1, 2]", "build: {}", sb.build());
+    assert(sb.length == 9 && sb.size() == 9, "length");
+    assert(str(sb) == "[0, 1, 2]", "str()");
+
+    sb.clear().appendLine("a").append("b");
+    assert(sb.build() == "a\nb", "appendLine/clear");
+    assert(StringBuilder().build() == "", "empty builder");
+}
+
+fn main() {
+    test_basic_accumulation();
+    test_alias_before_loop_is_untouched();
+    test_escape_between_loop_entries();
+    test_loop_variable_is_not_extended_in_place();
+    test_numeric_accumulation_stays_numeric();
+    test_reads_inside_loop_see_each_step();
+    test_captured_accumulator();
+    test_exception_keeps_partial_value();
+    test_string_builder();
+    print("string_accumulate_test ok");
+    return 0;
+}
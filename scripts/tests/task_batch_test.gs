@@ -0,0 +1,104 @@
+# await_all, await_any and poll over spawned task handles.
+
+fn square(n) {
+    return n * n;
+}
+
+fn spin(n) {
+    let total = 0;
+    for (i in range(0, n)) {
+        total = total + i;
+    }
+    return total;
+}
+
+fn fail(message) {
+    throw Exception(message);
+}
+
+fn main() {
+    let handles = [];
+    for (i in range(0, 32)) {
+        let handle = spawn square(i);
+        handles.push(handle);
+    }
+    let squares = await_all(handles);
+    assert(squares.length == 32, "await_all length: {}", squares.length);
+    for (i in range(0, 32)) {
+        assert(squares[i] == i * i, "await_all keeps handle order: {}", squares);
+    }
+
+    let empty = await_all([]);
+    assert(empty.length == 0, "await_all of nothing");
+
+    let slow = spawn spin(200000);
+    let quick = spawn square(7);
+    let first = await_any([slow, quick]);
+    let position = first[0];
+    let value = first[1];
+    assert((position == 1 && value == 49) || (position == 0 && value == 19999900000), "await_any: {}", first);
+    let other = slow;
+    let otherExpected = 19999900000;
+    if (position == 0) {
+        other = quick;
+        otherExpected = 49;
+    }
+    let rest = await other;
+    assert(rest == otherExpected, "the other handle stays valid: {}", rest);
+
+    let polled = spawn square(3);
+    while (!poll(polled)) {
+    }
+    assert(poll(polled), "poll is repeatable");
+    let polledValue = await polled;
+    assert(polledValue == 9, "polled task result");
+
+    let stale = "";
+    try {
+        let again = await polled;
+    } catch (Exception as err) {
+        stale = err.message;
+    }
+    assert(stale == "Task handle not found", "stale handle: {}", stale);
+
+    stale = "";
+    try {
+        let reused = spawn square(4);
+        let stillStale = poll(polled);
+        let reusedValue = await reused;
+    } catch (Exception as err) {
+        stale = err.message;
+    }
+    assert(stale == "Task handle not found", "a reused slot does not answer for a stale handle: {}", stale);
+
+    let caught = "";
+    let ok = spawn square(5);
+    let failing = spawn fail("batch failed");
+    try {
+        let results = await_all([ok, failing]);
+    } catch (Exception as err) {
+        caught = err.message;
+    }
+    assert(caught == "batch failed", "await_all rethrows: {}", caught);
+
+    caught = "";
+    try {
+        let none = await_any([]);
+    } catch (Exception as err) {
+        caught = err.message;
+    }
+    assert(caught == "await_any needs at least one task handle", "await_any of nothing: {}", caught);
+
+    # A slot is reused by each spawn after its task is awaited; its handle must stay a valid
+    # script integer well past 2^15 reuses, where a compact build's 48-bit integers end.
+    let reuses = 0;
+    for (i in range(0, 40000)) {
+        let repeat = spawn square(1);
+        let got = await repeat;
+        reuses = reuses + got;
+    }
+    assert(reuses == 40000, "spawn/await loop: {}", reuses);
+
+    print("task_batch_test ok");
+    return 0;
+}
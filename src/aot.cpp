@@ -0,0 +1,594 @@
+#include "gs/aot.hpp"
+#include "gs/type_system/upvalue_cell_type.hpp"
+
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+
+namespace gs {
+
+namespace {
+
+struct AotRegistry {
+    std::mutex mutex;
+    std::unordered_multimap<std::uint64_t, AotFunctionEntry> entries;
+    std::atomic<std::size_t> size{0};
+    std::atomic<std::size_t> linked{0};
+    std::atomic<bool> enabled{true};
+};
+
+AotRegistry& registry() {
+    static AotRegistry instance;
+    return instance;
+}
+
+std::uint64_t mix(std::uint64_t hash, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xffu;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool isTyped(const FunctionBytecode& fn, std::int32_t local) {
+    return local >= 0 && static_cast<std::size_t>(local) < fn.localTypeNames.size() &&
+           !fn.localTypeNames[static_cast<std::size_t>(local)].empty();
+}
+
+bool isBinaryOp(OpCode op) {
+    switch (op) {
+    case OpCode::Add:
+    case OpCode::Sub:
+    case OpCode::Mul:
+    case OpCode::Div:
+    case OpCode::FloorDiv:
+    case OpCode::Mod:
+    case OpCode::Pow:
+    case OpCode::LessThan:
+    case OpCode::GreaterThan:
+    case OpCode::Equal:
+    case OpCode::NotEqual:
+    case OpCode::LessEqual:
+    case OpCode::GreaterEqual:
+    case OpCode::Is:
+    case OpCode::IsNot:
+    case OpCode::BitwiseAnd:
+    case OpCode::BitwiseOr:
+    case OpCode::BitwiseXor:
+    case OpCode::ShiftLeft:
+    case OpCode::ShiftRight:
+    case OpCode::LogicalAnd:
+    case OpCode::LogicalOr:
+        return true;
+    default:
+        return false;
+    }
+}
+
+const char* helperName(OpCode op) {
+    switch (op) {
+    case OpCode::Add: return "add";
+    case OpCode::Sub: return "sub";
+    case OpCode::Mul: return "mul";
+    case OpCode::Div: return "div";
+    case OpCode::FloorDiv: return "floorDiv";
+    case OpCode::Mod: return "mod";
+    case OpCode::Pow: return "pow";
+    case OpCode::LessThan: return "lessThan";
+    case OpCode::GreaterThan: return "greaterThan";
+    case OpCode::Equal: return "equal";
+    case OpCode::NotEqual: return "notEqual";
+    case OpCode::LessEqual: return "lessEqual";
+    case OpCode::GreaterEqual: return "greaterEqual";
+    case OpCode::Is: return "is";
+    case OpCode::IsNot: return "isNot";
+    case OpCode::BitwiseAnd: return "bitAnd";
+    case OpCode::BitwiseOr: return "bitOr";
+    case OpCode::BitwiseXor: return "bitXor";
+    case OpCode::ShiftLeft: return "shiftLeft";
+    case OpCode::ShiftRight: return "shiftRight";
+    case OpCode::LogicalAnd: return "logicalAnd";
+    case OpCode::LogicalOr: return "logicalOr";
+    case OpCode::Negate: return "negate";
+    case OpCode::Not: return "logicalNot";
+    case OpCode::BitwiseNot: return "bitNot";
+    default: return nullptr;
+    }
+}
+
+// Emits the native body of one function. Instructions it does not cover become hand-backs, so
+// every instruction index has a label the entry switch can jump to.
+class FunctionEmitter {
+public:
+    FunctionEmitter(const Module& module, const FunctionBytecode& fn, std::ostringstream& out)
+        : module_(module),
+          fn_(fn),
+          out_(out) {}
+
+    // Returns false, writing nothing, when no instruction of the function runs natively.
+    bool emit(const std::string& symbol) {
+        std::ostringstream body;
+        std::size_t nativeCount = 0;
+        for (std::size_t ip = 0; ip < fn_.code.size(); ++ip) {
+            std::ostringstream ins;
+            const bool native = emitInstruction(ip, fn_.code[ip], ins);
+            nativeCount += native ? 1 : 0;
+            body << "L" << ip << ":";
+            if (native) {
+                body << " {\n" << ins.str() << "    }\n";
+            } else {
+                body << "\n    return aot::handback(frame, sp, " << ip << ");\n";
+            }
+        }
+        if (nativeCount == 0) {
+            return false;
+        }
+
+        out_ << "// " << fn_.name << "\n";
+        out_ << "void " << symbol << "(gs::Frame& frame, [[maybe_unused]] const gs::Instruction* code) {\n";
+        out_ << "    [[maybe_unused]] gs::Value* const locals = frame.locals.data();\n";
+        out_ << "    [[maybe_unused]] gs::Value* const stack = frame.stack.data();\n";
+        out_ << "    [[maybe_unused]] const std::size_t capacity = frame.stack.size();\n";
+        out_ << "    [[maybe_unused]] std::uint32_t fuel = aot::kLoopFuel;\n";
+        out_ << "    [[maybe_unused]] gs::Value out;\n";
+        out_ << "    std::size_t sp = frame.stackTop;\n";
+        out_ << "    switch (frame.ip) {\n";
+        for (std::size_t ip = 0; ip < fn_.code.size(); ++ip) {
+            out_ << "    case " << ip << ": goto L" << ip << ";\n";
+        }
+        out_ << "    default: return aot::handback(frame, sp, frame.ip);\n";
+        out_ << "    }\n";
+        out_ << body.str();
+        // Past the last instruction: the interpreter reports the range error.
+        if (endTargeted_) {
+            out_ << "L" << fn_.code.size() << ":\n";
+        }
+        out_ << "    return aot::handback(frame, sp, " << fn_.code.size() << ");\n";
+        out_ << "}\n\n";
+        return true;
+    }
+
+private:
+    std::string handback(std::size_t ip) const {
+        return "return aot::handback(frame, sp, " + std::to_string(ip) + ");";
+    }
+
+    std::optional<std::string> constant(std::int32_t index) const {
+        if (index < 0 || static_cast<std::size_t>(index) >= module_.constants.size()) {
+            return std::nullopt;
+        }
+        const Value value = module_.constants[static_cast<std::size_t>(index)];
+        switch (value.valueType()) {
+        case ValueType::Nil:
+            return std::string("gs::Value::Nil()");
+        case ValueType::Bool:
+            return std::string(value.rawPayload() != 0 ? "gs::Value::Bool(true)" : "gs::Value::Bool(false)");
+        case ValueType::Int:
+            if (value.rawPayload() == std::numeric_limits<std::int64_t>::min()) {
+                return std::string("gs::Value::Int(std::numeric_limits<std::int64_t>::min())");
+            }
+            return "gs::Value::Int(std::int64_t{" + std::to_string(value.rawPayload()) + "})";
+        case ValueType::Float: {
+            std::ostringstream literal;
+            literal << "gs::Value::Float(std::bit_cast<double>(std::uint64_t{0x" << std::hex
+                    << std::bit_cast<std::uint64_t>(value.asFloat()) << "}))";
+            return literal.str();
+        }
+        default:
+            // Strings, functions and classes become objects when loaded.
+            return std::nullopt;
+        }
+    }
+
+    bool validLocal(std::int32_t index) const {
+        return index >= 0 && static_cast<std::size_t>(index) < fn_.localCount;
+    }
+
+    static bool validRegister(std::int32_t index) {
+        return index >= 0 && index < 8;
+    }
+
+    bool validTarget(std::int32_t target) const {
+        return target >= 0 && static_cast<std::size_t>(target) <= fn_.code.size();
+    }
+
+    // Declares `name` as the value of a slot operand; `guards` collects checks that must pass
+    // before it is used in a truth test.
+    bool operand(SlotType slotType, std::int32_t index, const char* name, bool truthTest, std::ostringstream& ins,
+                 std::string& guards) const {
+        switch (slotType) {
+        case SlotType::Local:
+            if (!validLocal(index)) {
+                return false;
+            }
+            ins << "        const gs::Value& " << name << " = locals[" << index << "];\n";
+            if (truthTest) {
+                // A captured local is a cell holding the value the interpreter would test.
+                guards += std::string(guards.empty() ? "" : " || ") + name + ".isRef()";
+            }
+            return true;
+        case SlotType::Constant: {
+            const auto literal = constant(index);
+            if (!literal) {
+                return false;
+            }
+            ins << "        const gs::Value " << name << " = " << *literal << ";\n";
+            return true;
+        }
+        case SlotType::Register:
+            if (!validRegister(index)) {
+                return false;
+            }
+            ins << "        const gs::Value& " << name << " = aot::reg(frame, " << index << ");\n";
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void push(const std::string& value, std::size_t ip, std::ostringstream& ins) const {
+        ins << "        if (sp == capacity) " << handback(ip) << "\n";
+        ins << "        stack[sp++] = " << value << ";\n";
+    }
+
+    // Stores `value` into local `index`; hands back for captured locals and, in checked builds,
+    // for locals with a declared type.
+    void store(std::int32_t index, const std::string& value, std::size_t ip, std::ostringstream& ins) const {
+        if (isTyped(fn_, index)) {
+            ins << "        if constexpr (aot::kCheckDeclaredTypes) " << handback(ip) << "\n";
+        }
+        ins << "        if (!aot::storeLocal(locals[" << index << "], " << value << ")) " << handback(ip) << "\n";
+    }
+
+    void jump(std::size_t ip, std::int32_t target, std::ostringstream& ins, const char* indent) {
+        endTargeted_ = endTargeted_ || static_cast<std::size_t>(target) == fn_.code.size();
+        if (static_cast<std::size_t>(target) <= ip) {
+            ins << indent << "if (--fuel == 0) return aot::handback(frame, sp, " << target << ");\n";
+        }
+        ins << indent << "goto L" << target << ";\n";
+    }
+
+    bool emitInstruction(std::size_t ip, const Instruction& ins, std::ostringstream& code) {
+        const bool slotForm = ins.aSlotType != SlotType::None || ins.bSlotType != SlotType::None;
+        if (isBinaryOp(ins.op)) {
+            const bool truthTest = ins.op == OpCode::LogicalAnd || ins.op == OpCode::LogicalOr;
+            const std::string call = std::string("aot::") + helperName(ins.op);
+            if (!slotForm) {
+                code << "        if (sp < 2 || !" << call << "(stack[sp - 2], stack[sp - 1], out)) " << handback(ip)
+                     << "\n";
+                code << "        stack[sp - 2] = out;\n";
+                code << "        --sp;\n";
+                return true;
+            }
+            std::string guards;
+            if (!operand(ins.aSlotType, ins.a, "lhs", truthTest, code, guards) ||
+                !operand(ins.bSlotType, ins.b, "rhs", truthTest, code, guards)) {
+                return false;
+            }
+            if (!guards.empty()) {
+                code << "        if (" << guards << ") " << handback(ip) << "\n";
+            }
+            code << "        if (!" << call << "(lhs, rhs, out)) " << handback(ip) << "\n";
+            code << "        aot::setReg(frame, 0, out);\n";
+            return true;
+        }
+
+        switch (ins.op) {
+        case OpCode::Negate:
+        case OpCode::Not:
+        case OpCode::BitwiseNot: {
+            const std::string call = std::string("aot::") + helperName(ins.op);
+            if (ins.aSlotType == SlotType::None) {
+                code << "        if (sp == 0 || !" << call << "(stack[sp - 1], out)) " << handback(ip) << "\n";
+                code << "        stack[sp - 1] = out;\n";
+                return true;
+            }
+            std::string guards;
+            if (!operand(ins.aSlotType, ins.a, "operand", ins.op == OpCode::Not, code, guards)) {
+                return false;
+            }
+            if (!guards.empty()) {
+                code << "        if (" << guards << ") " << handback(ip) << "\n";
+            }
+            code << "        if (!" << call << "(operand, out)) " << handback(ip) << "\n";
+            code << "        aot::setReg(frame, 0, out);\n";
+            return true;
+        }
+        case OpCode::PushConst: {
+            const auto literal = constant(ins.a);
+            if (!literal) {
+                return false;
+            }
+            push(*literal, ip, code);
+            return true;
+        }
+        case OpCode::ConstToReg: {
+            const auto literal = constant(ins.a);
+            if (!literal || !validRegister(ins.b)) {
+                return false;
+            }
+            code << "        aot::setReg(frame, " << ins.b << ", " << *literal << ");\n";
+            return true;
+        }
+        case OpCode::LoadConst: {
+            const auto literal = constant(ins.a);
+            if (!literal || !validLocal(ins.b)) {
+                return false;
+            }
+            store(ins.b, *literal, ip, code);
+            return true;
+        }
+        case OpCode::LoadLocal:
+        case OpCode::PushLocal:
+            if (!validLocal(ins.a)) {
+                return false;
+            }
+            code << "        if (!aot::plain(locals[" << ins.a << "])) " << handback(ip) << "\n";
+            push("locals[" + std::to_string(ins.a) + "]", ip, code);
+            return true;
+        case OpCode::MoveLocalToReg:
+            if (!validLocal(ins.a) || !validRegister(ins.b)) {
+                return false;
+            }
+            code << "        if (!aot::plain(locals[" << ins.a << "])) " << handback(ip) << "\n";
+            code << "        aot::setReg(frame, " << ins.b << ", locals[" << ins.a << "]);\n";
+            return true;
+        case OpCode::LoadName:
+        case OpCode::PushName:
+            // The name index is read from the loaded code, which owns the string table.
+            code << "        if (!aot::loadName(frame, code[" << ip << "].a, out)) " << handback(ip) << "\n";
+            push("out", ip, code);
+            return true;
+        case OpCode::MoveNameToReg:
+            if (!validRegister(ins.b)) {
+                return false;
+            }
+            code << "        if (!aot::loadName(frame, code[" << ip << "].a, out)) " << handback(ip) << "\n";
+            code << "        aot::setReg(frame, " << ins.b << ", out);\n";
+            return true;
+        case OpCode::PushReg:
+            if (!validRegister(ins.a)) {
+                return false;
+            }
+            push("aot::reg(frame, " + std::to_string(ins.a) + ")", ip, code);
+            return true;
+        case OpCode::StoreLocal:
+            if (!validLocal(ins.a)) {
+                return false;
+            }
+            code << "        if (sp == 0) " << handback(ip) << "\n";
+            store(ins.a, "stack[sp - 1]", ip, code);
+            code << "        --sp;\n";
+            return true;
+        case OpCode::StoreLocalFromReg:
+            if (!validLocal(ins.a) || !validRegister(ins.b)) {
+                return false;
+            }
+            store(ins.a, "aot::reg(frame, " + std::to_string(ins.b) + ")", ip, code);
+            return true;
+        case OpCode::AppendLocal:
+            // Numbers only; string accumulation stays in the interpreter.
+            if (!validLocal(ins.a)) {
+                return false;
+            }
+            if (isTyped(fn_, ins.a)) {
+                code << "        if constexpr (aot::kCheckDeclaredTypes) " << handback(ip) << "\n";
+            }
+            code << "        if (sp == 0 || locals[" << ins.a << "].isRef() || !aot::add(locals[" << ins.a
+                 << "], stack[sp - 1], out)) " << handback(ip) << "\n";
+            code << "        locals[" << ins.a << "] = out;\n";
+            code << "        --sp;\n";
+            return true;
+        case OpCode::SealLocal:
+            if (!validLocal(ins.a)) {
+                return false;
+            }
+            code << "        if (locals[" << ins.a << "].isRef()) " << handback(ip) << "\n";
+            return true;
+        case OpCode::Pop:
+            code << "        if (sp == 0) " << handback(ip) << "\n";
+            code << "        --sp;\n";
+            return true;
+        case OpCode::Jump:
+            if (!validTarget(ins.a)) {
+                return false;
+            }
+            jump(ip, ins.a, code, "        ");
+            return true;
+        case OpCode::JumpIfFalse:
+            if (!validTarget(ins.a)) {
+                return false;
+            }
+            code << "        if (sp == 0) " << handback(ip) << "\n";
+            code << "        if (!aot::truthy(stack[--sp])) {\n";
+            jump(ip, ins.a, code, "            ");
+            code << "        }\n";
+            return true;
+        case OpCode::JumpIfFalseReg:
+            if (!validTarget(ins.a)) {
+                return false;
+            }
+            code << "        if (!aot::truthy(frame.registerValue)) {\n";
+            jump(ip, ins.a, code, "            ");
+            code << "        }\n";
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    const Module& module_;
+    const FunctionBytecode& fn_;
+    std::ostringstream& out_;
+    bool endTargeted_{false};
+};
+
+} // namespace
+
+bool isUpvalueCell(const Object* object) {
+    return object && dynamic_cast<const UpvalueCellObject*>(object) != nullptr;
+}
+
+// Covers everything a generated body depends on: the frame shape, which locals are typed, the
+// opcodes, and the operands of the instructions it runs natively, with constants by value. The
+// operands it leaves to the interpreter or reads from the loaded code (names, call targets) are
+// left out: lazy compilation numbers constants and strings in call order, so those indices are
+// not stable between `gsc` and the running module.
+std::uint64_t aotFunctionKey(const Module& module, const FunctionBytecode& fn) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = mix(hash, fn.params.size());
+    hash = mix(hash, fn.localCount);
+    for (std::size_t i = 0; i < fn.localCount; ++i) {
+        hash = mix(hash, isTyped(fn, static_cast<std::int32_t>(i)) ? 1 : 0);
+    }
+    hash = mix(hash, fn.code.size());
+    auto mixOperand = [&](bool isConstant, std::int32_t index) {
+        if (!isConstant) {
+            hash = mix(hash, static_cast<std::uint32_t>(index));
+            return;
+        }
+        if (index < 0 || static_cast<std::size_t>(index) >= module.constants.size()) {
+            hash = mix(hash, ~std::uint64_t{0});
+            return;
+        }
+        // Only scalars are compiled in; other constants are loaded by the interpreter.
+        const Value& value = module.constants[static_cast<std::size_t>(index)];
+        hash = mix(hash, static_cast<std::uint64_t>(value.valueType()));
+        if (aot::scalar(value)) {
+            hash = mix(hash, static_cast<std::uint64_t>(value.rawPayload()));
+        }
+    };
+    for (const auto& ins : fn.code) {
+        hash = mix(hash, static_cast<std::uint64_t>(ins.op) | (static_cast<std::uint64_t>(ins.aSlotType) << 8) |
+                             (static_cast<std::uint64_t>(ins.bSlotType) << 16));
+        if (isBinaryOp(ins.op) || ins.op == OpCode::Negate || ins.op == OpCode::Not || ins.op == OpCode::BitwiseNot) {
+            mixOperand(ins.aSlotType == SlotType::Constant, ins.a);
+            mixOperand(ins.bSlotType == SlotType::Constant, ins.b);
+            continue;
+        }
+        switch (ins.op) {
+        case OpCode::PushConst:
+        case OpCode::ConstToReg:
+        case OpCode::LoadConst:
+            mixOperand(true, ins.a);
+            mixOperand(false, ins.b);
+            break;
+        case OpCode::MoveNameToReg:
+            mixOperand(false, ins.b);
+            break;
+        case OpCode::LoadLocal:
+        case OpCode::PushLocal:
+        case OpCode::MoveLocalToReg:
+        case OpCode::PushReg:
+        case OpCode::StoreLocal:
+        case OpCode::StoreLocalFromReg:
+        case OpCode::AppendLocal:
+        case OpCode::SealLocal:
+        case OpCode::Jump:
+        case OpCode::JumpIfFalse:
+        case OpCode::JumpIfFalseReg:
+            mixOperand(false, ins.a);
+            mixOperand(false, ins.b);
+            break;
+        default:
+            break;
+        }
+    }
+    return hash;
+}
+
+void registerAotFunctions(const AotFunctionEntry* entries, std::size_t count) {
+    auto& reg = registry();
+    std::scoped_lock lock(reg.mutex);
+    for (std::size_t i = 0; i < count; ++i) {
+        reg.entries.emplace(entries[i].key, entries[i]);
+    }
+    reg.size.store(reg.entries.size(), std::memory_order_release);
+}
+
+void unregisterAotFunctions(const AotFunctionEntry* entries, std::size_t count) {
+    auto& reg = registry();
+    std::scoped_lock lock(reg.mutex);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto [first, last] = reg.entries.equal_range(entries[i].key);
+        for (auto it = first; it != last; ++it) {
+            if (it->second.body == entries[i].body) {
+                reg.entries.erase(it);
+                break;
+            }
+        }
+    }
+    reg.size.store(reg.entries.size(), std::memory_order_release);
+}
+
+std::size_t registeredAotFunctionCount() {
+    return registry().size.load(std::memory_order_acquire);
+}
+
+std::size_t linkedAotFunctionCount() {
+    return registry().linked.load(std::memory_order_relaxed);
+}
+
+void setAotFunctionsEnabled(bool enabled) {
+    registry().enabled.store(enabled, std::memory_order_release);
+}
+
+bool aotFunctionsEnabled() {
+    return registry().enabled.load(std::memory_order_acquire);
+}
+
+void resolveAotBody(const Module& module, const FunctionBytecode& fn) {
+    auto& reg = registry();
+    if (!reg.enabled.load(std::memory_order_acquire) || reg.size.load(std::memory_order_acquire) == 0) {
+        fn.aotBody.resolve(nullptr);
+        return;
+    }
+    const std::uint64_t key = aotFunctionKey(module, fn);
+    AotFunction body = nullptr;
+    {
+        std::scoped_lock lock(reg.mutex);
+        auto [first, last] = reg.entries.equal_range(key);
+        for (auto it = first; it != last; ++it) {
+            if (it->second.codeSize == fn.code.size()) {
+                body = it->second.body;
+                break;
+            }
+        }
+    }
+    if (body) {
+        reg.linked.fetch_add(1, std::memory_order_relaxed);
+    }
+    fn.aotBody.resolve(body);
+}
+
+std::string generateAotFunctions(const Module& module) {
+    std::ostringstream functions;
+    std::ostringstream table;
+    std::size_t emitted = 0;
+    for (std::size_t i = 0; i < module.functions.size(); ++i) {
+        const FunctionBytecode& fn = module.functions[i];
+        const std::string symbol = "aot_fn_" + std::to_string(i);
+        if (!FunctionEmitter(module, fn, functions).emit(symbol)) {
+            continue;
+        }
+        table << "    {0x" << std::hex << aotFunctionKey(module, fn) << std::dec << "ULL, " << fn.code.size() << ", &"
+              << symbol << "},\n";
+        ++emitted;
+    }
+
+    std::ostringstream out;
+    out << "namespace {\n\n";
+    out << "namespace aot = gs::aot;\n\n";
+    out << functions.str();
+    if (emitted > 0) {
+        out << "const gs::AotFunctionEntry kAotFunctions[] = {\n" << table.str() << "};\n\n";
+        out << "const gs::AotRegistration kAotRegistration(kAotFunctions, std::size(kAotFunctions));\n\n";
+    }
+    out << "} // namespace\n\n";
+    return out.str();
+}
+
+} // namespace gs
@@ -5,6 +5,7 @@
 #include "gs/type_system/native_function_type.hpp"
 #include "gs/type_system/type_base.hpp"
 
+#include <bit>
 #include <stdexcept>
 #include <typeindex>
 
@@ -36,33 +37,145 @@ const Type* getNativeType(const std::type_info& typeInfo) {
 // HostRegistry Implementation
 // ============================================================================
 
-HostRegistry::HostRegistry() {
+HostRegistry::HostRegistry() : builtins_(new BuiltinMap()) {
     bindGlobalModule(*this);
 }
 
+HostRegistry::~HostRegistry() {
+    delete builtins_.load(std::memory_order_acquire);
+    for (HostHandle handle = 0; handle < slotCount_; ++handle) {
+        delete slotAt(handle).load(std::memory_order_acquire);
+    }
+    for (auto& chunk : slotChunks_) {
+        delete[] chunk.load(std::memory_order_acquire);
+    }
+}
+
+HostRegistry::ReadGuard::ReadGuard(const HostRegistry& registry) : registry_(registry) {
+    // Counting ourselves and re-reading the epoch pairs with reclaimRetired() reading the count
+    // and then advancing: either the writer sees this reader, or the reader sees the new epoch
+    // and retries under it.
+    for (;;) {
+        epoch_ = registry_.epoch_.load(std::memory_order_acquire);
+        auto& readers = registry_.readers_[epoch_ & 1];
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        if (registry_.epoch_.load(std::memory_order_seq_cst) == epoch_) {
+            return;
+        }
+        readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+HostRegistry::ReadGuard::~ReadGuard() {
+    registry_.readers_[epoch_ & 1].fetch_sub(1, std::memory_order_release);
+}
+
+std::atomic<const HostRegistry::FunctionSlot*>& HostRegistry::slotAt(HostHandle handle) const {
+    const auto chunk = static_cast<std::size_t>(std::bit_width(handle / kFirstSlotChunk + 1)) - 1;
+    const std::size_t offset = handle - kFirstSlotChunk * ((std::size_t{1} << chunk) - 1);
+    return slotChunks_[chunk].load(std::memory_order_acquire)[offset];
+}
+
+const HostRegistry::FunctionSlot& HostRegistry::functionSlot(HostHandle handle) const {
+    return *slotAt(handle).load(std::memory_order_acquire);
+}
+
+const HostRegistry::BuiltinEntry* HostRegistry::findEntry(const BuiltinMap& builtins, const std::string& name) const {
+    auto it = builtins.find(name);
+    return it == builtins.end() ? nullptr : it->second.get();
+}
+
+// Something replaced in epoch E was visible only to readers that entered in E or earlier. The
+// epoch moves from E to E + 1 once the readers of E - 1 (which share E + 1's counter) have left,
+// so when it reaches E + 2 the readers of E have left too and the replaced object can go.
+void HostRegistry::reclaimRetired() {
+    std::uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+    for (int step = 0; step < 2 && readers_[(epoch + 1) & 1].load(std::memory_order_seq_cst) == 0; ++step) {
+        epoch_.store(++epoch, std::memory_order_seq_cst);
+    }
+    std::erase_if(retired_, [epoch](const Retired& retired) { return retired.epoch + 2 <= epoch; });
+}
+
+void HostRegistry::publishMap(std::unique_ptr<const BuiltinMap> next) {
+    const BuiltinMap* previous = builtins_.exchange(next.release(), std::memory_order_acq_rel);
+    retired_.push_back(Retired{epoch_.load(std::memory_order_relaxed), std::unique_ptr<const BuiltinMap>(previous), {}});
+}
+
+// A rebound name keeps its handle, so call sites that resolved it see the new function; a new
+// name gets the next handle and a new copy of the name table.
+void HostRegistry::publishSlot(const std::string& name, FunctionSlot slot) {
+    std::scoped_lock lock(writeMutex_);
+    const BuiltinMap& current = snapshot();
+    const BuiltinEntry* existing = findEntry(current, name);
+    HostHandle handle = existing && existing->kind == BuiltinEntry::Kind::Function ? existing->handle
+                                                                                   : kInvalidHostHandle;
+    if (handle == kInvalidHostHandle) {
+        if (slotCount_ >= kFirstSlotChunk * ((std::size_t{1} << kSlotChunkCount) - 1)) {
+            throw std::runtime_error("Too many host functions: " + name);
+        }
+        handle = slotCount_;
+        const auto chunk = static_cast<std::size_t>(std::bit_width(handle / kFirstSlotChunk + 1)) - 1;
+        if (!slotChunks_[chunk].load(std::memory_order_relaxed)) {
+            slotChunks_[chunk].store(new std::atomic<const FunctionSlot*>[kFirstSlotChunk << chunk](),
+                                     std::memory_order_release);
+        }
+        ++slotCount_;
+    }
+
+    auto fresh = std::make_unique<const FunctionSlot>(std::move(slot));
+    if (const FunctionSlot* previous = slotAt(handle).exchange(fresh.release(), std::memory_order_acq_rel)) {
+        retired_.push_back(Retired{epoch_.load(std::memory_order_relaxed), {}, std::unique_ptr<const FunctionSlot>(previous)});
+    }
+    if (!existing || existing->handle != handle) {
+        auto entry = std::make_shared<BuiltinEntry>();
+        entry->kind = BuiltinEntry::Kind::Function;
+        entry->handle = handle;
+        auto next = std::make_unique<BuiltinMap>(current);
+        (*next)[name] = std::move(entry);
+        publishMap(std::move(next));
+    }
+    reclaimRetired();
+}
+
 void HostRegistry::bind(const std::string& name, HostFunction fn) {
     if (!fn) {
         throw std::runtime_error("Host function callback is empty: " + name);
     }
+    publishSlot(name, FunctionSlot{name, std::move(fn), {}});
+}
 
-    BuiltinEntry entry;
-    entry.kind = BuiltinEntry::Kind::Function;
-    entry.function = std::move(fn);
-    builtins_[name] = std::move(entry);
+void HostRegistry::bindSpan(const std::string& name, HostSpanFunction fn) {
+    if (!fn) {
+        throw std::runtime_error("Host function callback is empty: " + name);
+    }
+    publishSlot(name, FunctionSlot{name, {}, std::move(fn)});
+}
+
+HostFunction HostRegistry::callableFor(const FunctionSlot& slot) const {
+    if (slot.function) {
+        return slot.function;
+    }
+    return [fn = slot.spanFunction](HostContext& context, const std::vector<Value>& args) {
+        return fn(context, args.data(), args.size());
+    };
 }
 
 void HostRegistry::defineModule(const std::string& moduleName) {
-    auto it = builtins_.find(moduleName);
-    if (it != builtins_.end()) {
-        if (it->second.kind != BuiltinEntry::Kind::Module) {
+    std::scoped_lock lock(writeMutex_);
+    const BuiltinMap& current = snapshot();
+    if (const BuiltinEntry* existing = findEntry(current, moduleName)) {
+        if (existing->kind != BuiltinEntry::Kind::Module) {
             throw std::runtime_error("Builtin name already used by function: " + moduleName);
         }
         return;
     }
 
-    BuiltinEntry entry;
-    entry.kind = BuiltinEntry::Kind::Module;
-    builtins_[moduleName] = std::move(entry);
+    auto entry = std::make_shared<BuiltinEntry>();
+    entry->kind = BuiltinEntry::Kind::Module;
+    auto next = std::make_unique<BuiltinMap>(current);
+    (*next)[moduleName] = std::move(entry);
+    publishMap(std::move(next));
+    reclaimRetired();
 }
 
 void HostRegistry::bindModuleFunction(const std::string& moduleName,
@@ -72,54 +185,77 @@ void HostRegistry::bindModuleFunction(const std::string& moduleName,
         throw std::runtime_error("Module function callback is empty: " + moduleName + "." + exportName);
     }
 
-    defineModule(moduleName);
-    auto& entry = builtins_.at(moduleName);
-    if (entry.kind != BuiltinEntry::Kind::Module) {
+    std::scoped_lock lock(writeMutex_);
+    const BuiltinMap& current = snapshot();
+    const BuiltinEntry* existing = findEntry(current, moduleName);
+    if (existing && existing->kind != BuiltinEntry::Kind::Module) {
         throw std::runtime_error("Builtin is not a module: " + moduleName);
     }
 
-    entry.moduleFunctions[exportName] = std::move(fn);
+    auto entry = existing ? std::make_shared<BuiltinEntry>(*existing) : std::make_shared<BuiltinEntry>();
+    entry->kind = BuiltinEntry::Kind::Module;
+    entry->moduleFunctions[exportName] = std::move(fn);
+    auto next = std::make_unique<BuiltinMap>(current);
+    (*next)[moduleName] = std::move(entry);
+    publishMap(std::move(next));
+    reclaimRetired();
 }
 
 bool HostRegistry::has(const std::string& name) const {
-    return builtins_.contains(name);
+    const ReadGuard guard(*this);
+    return snapshot().contains(name);
 }
 
 bool HostRegistry::hasModule(const std::string& name) const {
-    auto it = builtins_.find(name);
-    if (it == builtins_.end()) {
-        return false;
-    }
-    return it->second.kind == BuiltinEntry::Kind::Module;
+    const ReadGuard guard(*this);
+    const BuiltinEntry* entry = findEntry(snapshot(), name);
+    return entry && entry->kind == BuiltinEntry::Kind::Module;
 }
 
 Value HostRegistry::invoke(const std::string& name, HostContext& context, const std::vector<Value>& args) const {
-    auto it = builtins_.find(name);
-    if (it == builtins_.end()) {
-        throw std::runtime_error("Host function not found: " + name);
-    }
+    const ReadGuard guard(*this);
+    const HostHandle handle = [&] {
+        const BuiltinEntry* entry = findEntry(snapshot(), name);
+        if (!entry) {
+            throw std::runtime_error("Host function not found: " + name);
+        }
+        if (entry->kind != BuiltinEntry::Kind::Function) {
+            throw std::runtime_error("Builtin is not a function: " + name);
+        }
+        return entry->handle;
+    }();
 
-    if (it->second.kind != BuiltinEntry::Kind::Function) {
-        throw std::runtime_error("Builtin is not a function: " + name);
+    const auto& slot = functionSlot(handle);
+    if (slot.spanFunction) {
+        return slot.spanFunction(context, args.data(), args.size());
     }
+    return slot.function(context, args);
+}
 
-    return it->second.function(context, args);
+HostHandle HostRegistry::resolveHandle(const std::string& name) const {
+    const ReadGuard guard(*this);
+    const BuiltinEntry* entry = findEntry(snapshot(), name);
+    if (!entry || entry->kind != BuiltinEntry::Kind::Function) {
+        return kInvalidHostHandle;
+    }
+    return entry->handle;
 }
 
 Value HostRegistry::resolveBuiltin(const std::string& name,
                                    HostContext& context,
                                    NativeFunctionType& nativeFunctionType,
                                    ModuleType& moduleType) const {
-    auto it = builtins_.find(name);
-    if (it == builtins_.end()) {
+    const ReadGuard guard(*this);
+    const BuiltinEntry* found = findEntry(snapshot(), name);
+    if (!found) {
         throw std::runtime_error("Builtin not found: " + name);
     }
 
-    const auto& entry = it->second;
+    const auto& entry = *found;
     if (entry.kind == BuiltinEntry::Kind::Function) {
         return context.createObject(std::make_unique<NativeFunctionObject>(nativeFunctionType,
                                                                             name,
-                                                                            entry.function));
+                                                                            callableFor(functionSlot(entry.handle))));
     }
 
     auto moduleObject = std::make_unique<ModuleObject>(moduleType, name);
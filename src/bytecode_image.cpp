@@ -0,0 +1,804 @@
+#include "gs/bytecode_image.hpp"
+#include "gs/compiler.hpp"
+
+#include <bit>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gs {
+
+namespace {
+
+enum class SectionKind : std::uint32_t {
+    StringPool = 1,
+    Strings,
+    Constants,
+    NameLists,
+    Functions,
+    Code,
+    LineTable,
+    AllocSites,
+    Classes,
+    ClassAttributes,
+    ClassMethods,
+    Globals,
+    Imports,
+    ImportSymbols,
+};
+
+constexpr std::size_t kHeaderSize = 24;       // magic[8], revision u32, sectionCount u32, fileSize u64
+constexpr std::size_t kSectionEntrySize = 24; // kind u32, reserved u32, offset u64, size u64
+constexpr std::size_t kSectionPrefixSize = 8; // count u32, stride u32
+
+constexpr std::uint32_t kConstantStride = 16;
+constexpr std::uint32_t kFunctionStride = 64;
+constexpr std::uint32_t kInstructionStride = 12;
+constexpr std::uint32_t kLineStride = 8;
+constexpr std::uint32_t kClassStride = 32;
+constexpr std::uint32_t kAttributeStride = 24;
+constexpr std::uint32_t kMethodStride = 16;
+constexpr std::uint32_t kGlobalStride = 24;
+constexpr std::uint32_t kImportStride = 24;
+constexpr std::uint32_t kImportSymbolStride = 8;
+constexpr std::uint32_t kImportBindsSymbol = 1;
+
+template <typename T>
+T byteSwap(T value) {
+    T result{};
+    auto* src = reinterpret_cast<const std::uint8_t*>(&value);
+    auto* dst = reinterpret_cast<std::uint8_t*>(&result);
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        dst[i] = src[sizeof(T) - 1 - i];
+    }
+    return result;
+}
+
+template <typename T>
+T loadLE(const std::uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = byteSwap(value);
+    }
+    return value;
+}
+
+[[noreturn]] void throwInvalidImage(const std::string& reason) {
+    throw std::runtime_error("Invalid GSBC3 image: " + reason);
+}
+
+std::uint32_t toU32(std::size_t value, const char* what) {
+    if (value > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error(std::string("GSBC3 limit exceeded: ") + what);
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+class ByteWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        if constexpr (std::endian::native == std::endian::big) {
+            value = byteSwap(value);
+        }
+        bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void pad(std::size_t count) { bytes_.append(count, '\0'); }
+    void append(const std::string& data) { bytes_ += data; }
+    const std::string& bytes() const { return bytes_; }
+
+private:
+    std::string bytes_;
+};
+
+// A section is `count u32, stride u32` followed by `count` records of `stride` bytes.
+class SectionWriter : public ByteWriter {
+public:
+    explicit SectionWriter(std::uint32_t stride) : stride_(stride) {}
+
+    void endRecord() { ++count_; }
+    std::uint32_t count() const { return count_; }
+
+    std::string finish() const {
+        ByteWriter prefix;
+        prefix.put<std::uint32_t>(count_);
+        prefix.put<std::uint32_t>(stride_);
+        return prefix.bytes() + bytes();
+    }
+
+private:
+    std::uint32_t stride_;
+    std::uint32_t count_{0};
+};
+
+class StringPoolWriter {
+public:
+    std::uint32_t intern(const std::string& text) {
+        auto it = indices_.find(text);
+        if (it != indices_.end()) {
+            return it->second;
+        }
+        const auto index = toU32(offsets_.size(), "string pool entries");
+        offsets_.push_back(toU32(data_.size(), "string pool bytes"));
+        data_ += text;
+        indices_.emplace(text, index);
+        return index;
+    }
+
+    // `count + 1` offsets (the last one is the end sentinel), then the concatenated bytes.
+    std::string finish() const {
+        SectionWriter section(4);
+        for (auto offset : offsets_) {
+            section.put<std::uint32_t>(offset);
+            section.endRecord();
+        }
+        section.put<std::uint32_t>(toU32(data_.size(), "string pool bytes"));
+        section.append(data_);
+        return section.finish();
+    }
+
+private:
+    std::unordered_map<std::string, std::uint32_t> indices_;
+    std::vector<std::uint32_t> offsets_;
+    std::string data_;
+};
+
+void putValue(SectionWriter& out, const Value& value) {
+    out.put<std::uint8_t>(static_cast<std::uint8_t>(value.valueType()));
+    out.pad(7);
+    out.put<std::int64_t>(value.rawPayload());
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+struct SectionView {
+    const std::uint8_t* records{nullptr};
+    std::uint32_t count{0};
+    std::uint32_t stride{0};
+    std::size_t offset{0}; // absolute offset of records[0] in the image
+
+    const std::uint8_t* at(std::size_t index) const { return records + index * stride; }
+};
+
+class ImageReader {
+public:
+    explicit ImageReader(const BytecodeImage& image) : data_(image.data()), size_(image.size()) {
+        if (!isBytecodeImage(data_, size_)) {
+            throwInvalidImage("bad magic");
+        }
+        if (size_ < kHeaderSize) {
+            throwInvalidImage("truncated header");
+        }
+        const auto revision = loadLE<std::uint32_t>(data_ + 8);
+        if (revision == 0 || revision > kBytecodeImageRevision) {
+            throwInvalidImage("unsupported revision " + std::to_string(revision));
+        }
+        const auto sectionCount = loadLE<std::uint32_t>(data_ + 12);
+        const auto fileSize = loadLE<std::uint64_t>(data_ + 16);
+        if (fileSize != size_) {
+            throwInvalidImage("truncated file");
+        }
+        if (sectionCount > (size_ - kHeaderSize) / kSectionEntrySize) {
+            throwInvalidImage("section table out of range");
+        }
+        for (std::uint32_t i = 0; i < sectionCount; ++i) {
+            const auto* entry = data_ + kHeaderSize + i * kSectionEntrySize;
+            const auto kind = loadLE<std::uint32_t>(entry);
+            const auto offset = loadLE<std::uint64_t>(entry + 8);
+            const auto length = loadLE<std::uint64_t>(entry + 16);
+            if (offset > size_ || length > size_ - offset || length < kSectionPrefixSize) {
+                throwInvalidImage("section " + std::to_string(kind) + " out of range");
+            }
+            SectionView view;
+            view.count = loadLE<std::uint32_t>(data_ + offset);
+            view.stride = loadLE<std::uint32_t>(data_ + offset + 4);
+            view.offset = static_cast<std::size_t>(offset) + kSectionPrefixSize;
+            view.records = data_ + view.offset;
+            const std::size_t available = static_cast<std::size_t>(length) - kSectionPrefixSize;
+            const std::size_t entries = static_cast<SectionKind>(kind) == SectionKind::StringPool
+                                            ? static_cast<std::size_t>(view.count) + 1
+                                            : view.count;
+            if (view.stride != 0 && entries > available / view.stride) {
+                throwInvalidImage("section " + std::to_string(kind) + " records out of range");
+            }
+            sections_[kind] = view;
+            if (static_cast<SectionKind>(kind) == SectionKind::StringPool) {
+                if (view.stride != 4) {
+                    throwInvalidImage("string pool has stride " + std::to_string(view.stride));
+                }
+                poolOffsets_ = view.records;
+                poolCount_ = view.count;
+                poolBytes_ = view.records + (static_cast<std::size_t>(view.count) + 1) * 4;
+                poolSize_ = available - (static_cast<std::size_t>(view.count) + 1) * 4;
+                if (loadLE<std::uint32_t>(poolBytes_ - 4) > poolSize_) {
+                    throwInvalidImage("string pool out of range");
+                }
+            }
+        }
+    }
+
+    // Missing sections read as empty so later revisions can drop unused ones.
+    SectionView section(SectionKind kind, std::uint32_t expectedStride) const {
+        auto it = sections_.find(static_cast<std::uint32_t>(kind));
+        if (it == sections_.end()) {
+            SectionView empty;
+            empty.stride = expectedStride;
+            return empty;
+        }
+        if (it->second.stride != expectedStride) {
+            throwInvalidImage("section " + std::to_string(static_cast<std::uint32_t>(kind)) + " has stride " +
+                              std::to_string(it->second.stride));
+        }
+        return it->second;
+    }
+
+    std::string string(std::uint32_t index) const {
+        if (index >= poolCount_) {
+            throwInvalidImage("string index out of range");
+        }
+        const auto begin = loadLE<std::uint32_t>(poolOffsets_ + static_cast<std::size_t>(index) * 4);
+        const auto end = loadLE<std::uint32_t>(poolOffsets_ + (static_cast<std::size_t>(index) + 1) * 4);
+        if (begin > end || end > poolSize_) {
+            throwInvalidImage("string pool offsets out of range");
+        }
+        return std::string(reinterpret_cast<const char*>(poolBytes_ + begin), end - begin);
+    }
+
+    static void checkRange(const SectionView& view, std::uint32_t first, std::uint32_t count, const char* what) {
+        if (first > view.count || count > view.count - first) {
+            throwInvalidImage(std::string(what) + " out of range");
+        }
+    }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::unordered_map<std::uint32_t, SectionView> sections_;
+    const std::uint8_t* poolOffsets_{nullptr};
+    const std::uint8_t* poolBytes_{nullptr};
+    std::size_t poolSize_{0};
+    std::uint32_t poolCount_{0};
+};
+
+// Constants and initializers are immediates; a Ref would carry a pointer out of the file.
+Value readValue(const std::uint8_t* p) {
+    const auto type = loadLE<std::uint8_t>(p);
+    if (type > static_cast<std::uint8_t>(ValueType::Module)) {
+        throwInvalidImage("unknown value type " + std::to_string(type));
+    }
+    if (type == static_cast<std::uint8_t>(ValueType::Ref)) {
+        throwInvalidImage("object reference stored as a value");
+    }
+    return Value::FromRaw(static_cast<ValueType>(type), loadLE<std::int64_t>(p + 8));
+}
+
+// String, function and class values index module tables, which are all read by the time this runs.
+void checkValueIndex(const Module& module, const Value& value, const char* what) {
+    std::size_t limit = 0;
+    switch (value.valueType()) {
+    case ValueType::String:
+        limit = module.strings.size();
+        break;
+    case ValueType::Function:
+        limit = module.functions.size();
+        break;
+    case ValueType::Class:
+        limit = module.classes.size();
+        break;
+    default:
+        return;
+    }
+    if (value.rawPayload() < 0 || static_cast<std::uint64_t>(value.rawPayload()) >= limit) {
+        throwInvalidImage(std::string(what) + " index out of range");
+    }
+}
+
+std::vector<std::string> readNameList(const ImageReader& reader,
+                                      const SectionView& names,
+                                      std::uint32_t first,
+                                      std::uint32_t count) {
+    ImageReader::checkRange(names, first, count, "name list");
+    std::vector<std::string> out;
+    out.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        out.push_back(reader.string(loadLE<std::uint32_t>(names.at(first + i))));
+    }
+    return out;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return {};
+    }
+    return std::string((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+// A function's instructions, line table and allocation sites inside a mapped image.
+class ImageFunctionBody final : public LazyFunctionBody {
+public:
+    std::shared_ptr<const BytecodeImage> image;
+    std::size_t codeOffset{0};
+    std::size_t lineOffset{0};
+    std::size_t codeCount{0};
+    std::size_t siteOffset{0};
+    std::size_t siteCount{0};
+
+    std::mutex& mutex() const override {
+        return image->decodeMutex();
+    }
+
+    void materialize(Module&, FunctionBytecode& target) const override {
+        const auto* base = image->data();
+        target.code.resize(codeCount);
+        for (std::size_t i = 0; i < codeCount; ++i) {
+            const auto* rec = base + codeOffset + i * kInstructionStride;
+            const auto* line = base + lineOffset + i * kLineStride;
+            if (rec[0] > static_cast<std::uint8_t>(OpCode::LoadImport)) {
+                throwInvalidImage("unknown opcode " + std::to_string(rec[0]));
+            }
+            if (rec[1] > SlotType::UpValue || rec[2] > SlotType::UpValue) {
+                throwInvalidImage("unknown operand slot type");
+            }
+            auto& ins = target.code[i];
+            ins.op = static_cast<OpCode>(rec[0]);
+            ins.aSlotType = static_cast<SlotType>(rec[1]);
+            ins.bSlotType = static_cast<SlotType>(rec[2]);
+            ins.a = loadLE<std::int32_t>(rec + 4);
+            ins.b = loadLE<std::int32_t>(rec + 8);
+            ins.line = loadLE<std::uint32_t>(line);
+            ins.column = loadLE<std::uint32_t>(line + 4);
+        }
+        target.nonEscapingAllocSites.resize(siteCount);
+        for (std::size_t i = 0; i < siteCount; ++i) {
+            target.nonEscapingAllocSites[i] = loadLE<std::uint32_t>(base + siteOffset + i * 4);
+        }
+    }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// BytecodeImage
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const BytecodeImage> BytecodeImage::mapFile(const std::string& path) {
+    std::shared_ptr<BytecodeImage> image(new BytecodeImage());
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Bytecode file not found: " + path);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("Bytecode file not found or empty: " + path);
+    }
+    const auto length = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping != MAP_FAILED) {
+        image->mapping_ = mapping;
+        image->data_ = static_cast<const std::uint8_t*>(mapping);
+        image->size_ = length;
+        return image;
+    }
+#endif
+    image->owned_ = readFile(path);
+    if (image->owned_.empty()) {
+        throw std::runtime_error("Bytecode file not found or empty: " + path);
+    }
+    image->data_ = reinterpret_cast<const std::uint8_t*>(image->owned_.data());
+    image->size_ = image->owned_.size();
+    return image;
+}
+
+std::shared_ptr<const BytecodeImage> BytecodeImage::fromBytes(std::string bytes) {
+    std::shared_ptr<BytecodeImage> image(new BytecodeImage());
+    image->owned_ = std::move(bytes);
+    image->data_ = reinterpret_cast<const std::uint8_t*>(image->owned_.data());
+    image->size_ = image->owned_.size();
+    return image;
+}
+
+BytecodeImage::~BytecodeImage() {
+#ifndef _WIN32
+    if (mapping_) {
+        ::munmap(mapping_, size_);
+    }
+#endif
+}
+
+const std::uint8_t* BytecodeImage::data() const {
+    return data_;
+}
+
+std::size_t BytecodeImage::size() const {
+    return size_;
+}
+
+bool BytecodeImage::isMapped() const {
+    return mapping_ != nullptr;
+}
+
+std::mutex& BytecodeImage::decodeMutex() const {
+    return decodeMutex_;
+}
+
+bool isBytecodeImage(const void* data, std::size_t size) {
+    return size >= sizeof(kBytecodeImageMagic) &&
+           std::memcmp(data, kBytecodeImageMagic, sizeof(kBytecodeImageMagic)) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Serialization
+// ---------------------------------------------------------------------------
+
+std::string serializeModuleBinary(const Module& module) {
+    decodeAllFunctionBodies(module);
+
+    StringPoolWriter pool;
+    SectionWriter strings(4);
+    SectionWriter constants(kConstantStride);
+    SectionWriter names(4);
+    SectionWriter functions(kFunctionStride);
+    SectionWriter code(kInstructionStride);
+    SectionWriter lines(kLineStride);
+    SectionWriter sites(4);
+    SectionWriter classes(kClassStride);
+    SectionWriter attributes(kAttributeStride);
+    SectionWriter methods(kMethodStride);
+    SectionWriter globals(kGlobalStride);
+    SectionWriter imports(kImportStride);
+    SectionWriter importSymbols(kImportSymbolStride);
+
+    for (const auto& s : module.strings) {
+        strings.put<std::uint32_t>(pool.intern(s));
+        strings.endRecord();
+    }
+    for (const auto& c : module.constants) {
+        putValue(constants, c);
+        constants.endRecord();
+    }
+
+    auto putNames = [&](const std::vector<std::string>& list) {
+        const auto first = names.count();
+        for (const auto& name : list) {
+            names.put<std::uint32_t>(pool.intern(name));
+            names.endRecord();
+        }
+        return first;
+    };
+
+    for (const auto& fn : module.functions) {
+        const auto paramFirst = putNames(fn.params);
+        const auto paramTypeFirst = putNames(fn.paramTypeNames);
+        const auto localTypeFirst = putNames(fn.localTypeNames);
+        const auto codeFirst = code.count();
+        for (const auto& ins : fn.code) {
+            code.put<std::uint8_t>(static_cast<std::uint8_t>(ins.op));
+            code.put<std::uint8_t>(static_cast<std::uint8_t>(ins.aSlotType));
+            code.put<std::uint8_t>(static_cast<std::uint8_t>(ins.bSlotType));
+            code.pad(1);
+            code.put<std::int32_t>(ins.a);
+            code.put<std::int32_t>(ins.b);
+            code.endRecord();
+            lines.put<std::uint32_t>(toU32(ins.line, "line number"));
+            lines.put<std::uint32_t>(toU32(ins.column, "column number"));
+            lines.endRecord();
+        }
+        const auto siteFirst = sites.count();
+        for (auto site : fn.nonEscapingAllocSites) {
+            sites.put<std::uint32_t>(site);
+            sites.endRecord();
+        }
+
+        functions.put<std::uint32_t>(pool.intern(fn.name));
+        functions.put<std::uint32_t>(paramFirst);
+        functions.put<std::uint32_t>(toU32(fn.params.size(), "parameters"));
+        functions.put<std::uint32_t>(paramTypeFirst);
+        functions.put<std::uint32_t>(toU32(fn.paramTypeNames.size(), "parameter types"));
+        functions.put<std::uint32_t>(localTypeFirst);
+        functions.put<std::uint32_t>(toU32(fn.localTypeNames.size(), "local types"));
+        functions.put<std::uint32_t>(codeFirst);
+        functions.put<std::uint32_t>(toU32(fn.code.size(), "instructions"));
+        functions.put<std::uint32_t>(siteFirst);
+        functions.put<std::uint32_t>(toU32(fn.nonEscapingAllocSites.size(), "allocation sites"));
+        functions.pad(4);
+        functions.put<std::uint64_t>(fn.localCount);
+        functions.put<std::uint64_t>(fn.stackSlotCount);
+        functions.endRecord();
+    }
+
+    for (const auto& cls : module.classes) {
+        const auto attrFirst = attributes.count();
+        for (const auto& attr : cls.attributes) {
+            attributes.put<std::uint32_t>(pool.intern(attr.name));
+            attributes.put<std::uint32_t>(pool.intern(attr.declaredTypeName));
+            putValue(attributes, attr.defaultValue);
+            attributes.endRecord();
+        }
+        const auto methodFirst = methods.count();
+        for (const auto& method : cls.methods) {
+            methods.put<std::uint32_t>(pool.intern(method.name));
+            methods.pad(4);
+            methods.put<std::uint64_t>(method.functionIndex);
+            methods.endRecord();
+        }
+        classes.put<std::uint32_t>(pool.intern(cls.name));
+        classes.put<std::int32_t>(cls.baseClassIndex);
+        classes.put<std::uint32_t>(pool.intern(cls.baseNativeTypeName));
+        classes.put<std::uint32_t>(attrFirst);
+        classes.put<std::uint32_t>(toU32(cls.attributes.size(), "class attributes"));
+        classes.put<std::uint32_t>(methodFirst);
+        classes.put<std::uint32_t>(toU32(cls.methods.size(), "class methods"));
+        classes.pad(4);
+        classes.endRecord();
+    }
+
+    for (const auto& global : module.globals) {
+        globals.put<std::uint32_t>(pool.intern(global.name));
+        globals.put<std::uint32_t>(pool.intern(global.declaredTypeName));
+        putValue(globals, global.initialValue);
+        globals.endRecord();
+    }
+
+    for (const auto& entry : module.imports) {
+        const auto symbolFirst = putNames(entry.symbols);
+        imports.put<std::uint32_t>(pool.intern(entry.moduleSpec));
+        imports.put<std::uint32_t>(pool.intern(entry.localName));
+        imports.put<std::uint32_t>(symbolFirst);
+        imports.put<std::uint32_t>(toU32(entry.symbols.size(), "import symbols"));
+        imports.put<std::uint32_t>(entry.bindsSymbol ? kImportBindsSymbol : 0);
+        imports.pad(4);
+        imports.endRecord();
+    }
+    for (const auto& symbol : module.importSymbols) {
+        importSymbols.put<std::uint32_t>(symbol.importIndex);
+        importSymbols.put<std::uint32_t>(pool.intern(symbol.name));
+        importSymbols.endRecord();
+    }
+
+    const std::vector<std::pair<SectionKind, std::string>> sections = {
+        {SectionKind::StringPool, pool.finish()},
+        {SectionKind::Strings, strings.finish()},
+        {SectionKind::Constants, constants.finish()},
+        {SectionKind::NameLists, names.finish()},
+        {SectionKind::Functions, functions.finish()},
+        {SectionKind::Code, code.finish()},
+        {SectionKind::LineTable, lines.finish()},
+        {SectionKind::AllocSites, sites.finish()},
+        {SectionKind::Classes, classes.finish()},
+        {SectionKind::ClassAttributes, attributes.finish()},
+        {SectionKind::ClassMethods, methods.finish()},
+        {SectionKind::Globals, globals.finish()},
+        {SectionKind::Imports, imports.finish()},
+        {SectionKind::ImportSymbols, importSymbols.finish()},
+    };
+
+    auto align8 = [](std::size_t n) { return (n + 7) & ~std::size_t{7}; };
+
+    std::size_t offset = kHeaderSize + sections.size() * kSectionEntrySize;
+    ByteWriter table;
+    std::string body;
+    for (const auto& [kind, bytes] : sections) {
+        offset = align8(offset);
+        table.put<std::uint32_t>(static_cast<std::uint32_t>(kind));
+        table.put<std::uint32_t>(0);
+        table.put<std::uint64_t>(offset);
+        table.put<std::uint64_t>(bytes.size());
+        body.resize(offset - kHeaderSize - sections.size() * kSectionEntrySize, '\0');
+        body += bytes;
+        offset += bytes.size();
+    }
+
+    ByteWriter header;
+    header.append(std::string(kBytecodeImageMagic, sizeof(kBytecodeImageMagic)));
+    header.put<std::uint32_t>(kBytecodeImageRevision);
+    header.put<std::uint32_t>(static_cast<std::uint32_t>(sections.size()));
+    header.put<std::uint64_t>(offset);
+    return header.bytes() + table.bytes() + body;
+}
+
+// ---------------------------------------------------------------------------
+// Loading
+// ---------------------------------------------------------------------------
+
+Module loadModuleImage(std::shared_ptr<const BytecodeImage> image) {
+    if (!image) {
+        throw std::runtime_error("Bytecode image is null");
+    }
+    const ImageReader reader(*image);
+    Module module;
+
+    const auto strings = reader.section(SectionKind::Strings, 4);
+    module.strings.reserve(strings.count);
+    for (std::uint32_t i = 0; i < strings.count; ++i) {
+        module.strings.push_back(reader.string(loadLE<std::uint32_t>(strings.at(i))));
+    }
+
+    const auto constants = reader.section(SectionKind::Constants, kConstantStride);
+    module.constants.reserve(constants.count);
+    for (std::uint32_t i = 0; i < constants.count; ++i) {
+        module.constants.push_back(readValue(constants.at(i)));
+    }
+
+    const auto names = reader.section(SectionKind::NameLists, 4);
+    const auto functions = reader.section(SectionKind::Functions, kFunctionStride);
+    const auto code = reader.section(SectionKind::Code, kInstructionStride);
+    const auto lines = reader.section(SectionKind::LineTable, kLineStride);
+    const auto sites = reader.section(SectionKind::AllocSites, 4);
+    if (lines.count != code.count) {
+        throwInvalidImage("line table does not match code section");
+    }
+
+    module.functions.resize(functions.count);
+    for (std::uint32_t i = 0; i < functions.count; ++i) {
+        const auto* rec = functions.at(i);
+        auto& fn = module.functions[i];
+        fn.name = reader.string(loadLE<std::uint32_t>(rec));
+        fn.params = readNameList(reader, names, loadLE<std::uint32_t>(rec + 4), loadLE<std::uint32_t>(rec + 8));
+        fn.paramTypeNames =
+            readNameList(reader, names, loadLE<std::uint32_t>(rec + 12), loadLE<std::uint32_t>(rec + 16));
+        fn.localTypeNames =
+            readNameList(reader, names, loadLE<std::uint32_t>(rec + 20), loadLE<std::uint32_t>(rec + 24));
+        fn.localCount = static_cast<std::size_t>(loadLE<std::uint64_t>(rec + 48));
+        fn.stackSlotCount = static_cast<std::size_t>(loadLE<std::uint64_t>(rec + 56));
+
+        const auto codeFirst = loadLE<std::uint32_t>(rec + 28);
+        const auto codeCount = loadLE<std::uint32_t>(rec + 32);
+        const auto siteFirst = loadLE<std::uint32_t>(rec + 36);
+        const auto siteCount = loadLE<std::uint32_t>(rec + 40);
+        ImageReader::checkRange(code, codeFirst, codeCount, "function code");
+        ImageReader::checkRange(sites, siteFirst, siteCount, "allocation sites");
+
+        auto body = std::make_shared<ImageFunctionBody>();
+        body->image = image;
+        body->codeOffset = code.offset + static_cast<std::size_t>(codeFirst) * kInstructionStride;
+        body->lineOffset = lines.offset + static_cast<std::size_t>(codeFirst) * kLineStride;
+        body->codeCount = codeCount;
+        body->siteOffset = sites.offset + static_cast<std::size_t>(siteFirst) * 4;
+        body->siteCount = siteCount;
+        fn.lazyBody = std::move(body);
+        fn.bodyReady.set(false);
+    }
+
+    const auto classes = reader.section(SectionKind::Classes, kClassStride);
+    const auto attributes = reader.section(SectionKind::ClassAttributes, kAttributeStride);
+    const auto methods = reader.section(SectionKind::ClassMethods, kMethodStride);
+    module.classes.resize(classes.count);
+    for (std::uint32_t i = 0; i < classes.count; ++i) {
+        const auto* rec = classes.at(i);
+        auto& cls = module.classes[i];
+        cls.name = reader.string(loadLE<std::uint32_t>(rec));
+        cls.baseClassIndex = loadLE<std::int32_t>(rec + 4);
+        if (cls.baseClassIndex < -1 || cls.baseClassIndex >= static_cast<std::int64_t>(classes.count)) {
+            throwInvalidImage("base class index out of range");
+        }
+        cls.baseNativeTypeName = reader.string(loadLE<std::uint32_t>(rec + 8));
+
+        const auto attrFirst = loadLE<std::uint32_t>(rec + 12);
+        const auto attrCount = loadLE<std::uint32_t>(rec + 16);
+        ImageReader::checkRange(attributes, attrFirst, attrCount, "class attributes");
+        cls.attributes.resize(attrCount);
+        for (std::uint32_t a = 0; a < attrCount; ++a) {
+            const auto* attrRec = attributes.at(attrFirst + a);
+            cls.attributes[a].name = reader.string(loadLE<std::uint32_t>(attrRec));
+            cls.attributes[a].declaredTypeName = reader.string(loadLE<std::uint32_t>(attrRec + 4));
+            cls.attributes[a].defaultValue = readValue(attrRec + 8);
+        }
+
+        const auto methodFirst = loadLE<std::uint32_t>(rec + 20);
+        const auto methodCount = loadLE<std::uint32_t>(rec + 24);
+        ImageReader::checkRange(methods, methodFirst, methodCount, "class methods");
+        cls.methods.resize(methodCount);
+        for (std::uint32_t m = 0; m < methodCount; ++m) {
+            const auto* methodRec = methods.at(methodFirst + m);
+            cls.methods[m].name = reader.string(loadLE<std::uint32_t>(methodRec));
+            const auto functionIndex = loadLE<std::uint64_t>(methodRec + 8);
+            if (functionIndex >= module.functions.size()) {
+                throwInvalidImage("method function index out of range");
+            }
+            cls.methods[m].functionIndex = static_cast<std::size_t>(functionIndex);
+        }
+    }
+
+    const auto globals = reader.section(SectionKind::Globals, kGlobalStride);
+    module.globals.resize(globals.count);
+    for (std::uint32_t i = 0; i < globals.count; ++i) {
+        const auto* rec = globals.at(i);
+        module.globals[i].name = reader.string(loadLE<std::uint32_t>(rec));
+        module.globals[i].declaredTypeName = reader.string(loadLE<std::uint32_t>(rec + 4));
+        module.globals[i].initialValue = readValue(rec + 8);
+    }
+
+    const auto imports = reader.section(SectionKind::Imports, kImportStride);
+    module.imports.resize(imports.count);
+    for (std::uint32_t i = 0; i < imports.count; ++i) {
+        const auto* rec = imports.at(i);
+        auto& entry = module.imports[i];
+        entry.moduleSpec = reader.string(loadLE<std::uint32_t>(rec));
+        entry.localName = reader.string(loadLE<std::uint32_t>(rec + 4));
+        entry.symbols = readNameList(reader, names, loadLE<std::uint32_t>(rec + 8), loadLE<std::uint32_t>(rec + 12));
+        entry.bindsSymbol = (loadLE<std::uint32_t>(rec + 16) & kImportBindsSymbol) != 0;
+    }
+
+    const auto importSymbols = reader.section(SectionKind::ImportSymbols, kImportSymbolStride);
+    module.importSymbols.resize(importSymbols.count);
+    for (std::uint32_t i = 0; i < importSymbols.count; ++i) {
+        const auto* rec = importSymbols.at(i);
+        module.importSymbols[i].importIndex = loadLE<std::uint32_t>(rec);
+        if (module.importSymbols[i].importIndex >= module.imports.size()) {
+            throwInvalidImage("import symbol refers to a missing import");
+        }
+        module.importSymbols[i].name = reader.string(loadLE<std::uint32_t>(rec + 4));
+    }
+
+    for (const auto& constant : module.constants) {
+        checkValueIndex(module, constant, "constant");
+    }
+    for (const auto& cls : module.classes) {
+        for (const auto& attr : cls.attributes) {
+            checkValueIndex(module, attr.defaultValue, "attribute default");
+        }
+    }
+    for (const auto& global : module.globals) {
+        checkValueIndex(module, global.initialValue, "global initializer");
+    }
+
+    return module;
+}
+
+Module loadBytecodeModule(const std::string& path) {
+    auto image = BytecodeImage::mapFile(path);
+    if (isBytecodeImage(image->data(), image->size())) {
+        return loadModuleImage(std::move(image));
+    }
+    return deserializeModuleText(
+        std::string(reinterpret_cast<const char*>(image->data()), image->size()));
+}
+
+void decodeFunctionBody(const Module& module, const FunctionBytecode& fn) {
+    if (fn.bodyReady.ready()) {
+        return;
+    }
+    const auto& body = *fn.lazyBody;
+    std::scoped_lock lock(body.mutex());
+    if (fn.bodyReady.ready()) {
+        return;
+    }
+
+    // Modules holding lazy bodies are always created non-const, by loadModuleImage() or the
+    // compiler; the body is written once, under the body's mutex, before the ready flag is
+    // published.
+    body.materialize(const_cast<Module&>(module), const_cast<FunctionBytecode&>(fn));
+    fn.bodyReady.set(true);
+}
+
+void decodeAllFunctionBodies(const Module& module) {
+    for (const auto& fn : module.functions) {
+        ensureFunctionDecoded(module, fn);
+    }
+}
+
+} // namespace gs
@@ -0,0 +1,156 @@
+#include "gs/channel.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace gs {
+
+Channel::Channel(std::size_t capacity) : capacity_(capacity), cells_(std::make_unique<Cell[]>(capacity)) {
+    if (capacity_ == 0) {
+        throw std::runtime_error("Channel capacity must be at least 1");
+    }
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        cells_[i].sequence.store(2 * i, std::memory_order_relaxed);
+    }
+}
+
+std::size_t Channel::size() const {
+    const std::size_t received = recvPos_.load(std::memory_order_acquire);
+    const std::size_t sent = sendPos_.load(std::memory_order_acquire);
+    return sent > received ? sent - received : 0;
+}
+
+bool Channel::trySend(TransferredValues& value) {
+    if (closed_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Channel is closed");
+    }
+    std::size_t pos = sendPos_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+        cell = &cells_[pos % capacity_];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence - 2 * pos);
+        if (diff == 0) {
+            if (sendPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = sendPos_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(2 * pos + 1, std::memory_order_release);
+    // Paired with the fence in park(): a receiver parking now either sees this value or is seen.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeOne(receivers_);
+    return true;
+}
+
+bool Channel::tryRecv(TransferredValues& value) {
+    std::size_t pos = recvPos_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+        cell = &cells_[pos % capacity_];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence - (2 * pos + 1));
+        if (diff == 0) {
+            if (recvPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = recvPos_.load(std::memory_order_relaxed);
+        }
+    }
+    value = std::move(cell->value);
+    cell->value = TransferredValues{};
+    cell->sequence.store(2 * (pos + capacity_), std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeOne(senders_);
+    return true;
+}
+
+bool Channel::close() {
+    if (closed_.exchange(true, std::memory_order_seq_cst)) {
+        return false;
+    }
+    wakeAll(senders_);
+    wakeAll(receivers_);
+    return true;
+}
+
+bool Channel::canSend() const {
+    if (closed_.load(std::memory_order_seq_cst)) {
+        return true;
+    }
+    const std::size_t pos = sendPos_.load(std::memory_order_seq_cst);
+    return cells_[pos % capacity_].sequence.load(std::memory_order_seq_cst) == 2 * pos;
+}
+
+bool Channel::canRecv() const {
+    if (closed_.load(std::memory_order_seq_cst)) {
+        return true;
+    }
+    const std::size_t pos = recvPos_.load(std::memory_order_seq_cst);
+    return cells_[pos % capacity_].sequence.load(std::memory_order_seq_cst) == 2 * pos + 1;
+}
+
+TaskParker Channel::parkSender() {
+    return [self = shared_from_this()](std::function<void()> resume) {
+        self->park(self->senders_, true, std::move(resume));
+    };
+}
+
+TaskParker Channel::parkReceiver() {
+    return [self = shared_from_this()](std::function<void()> resume) {
+        self->park(self->receivers_, false, std::move(resume));
+    };
+}
+
+void Channel::park(Waiters& waiters, bool sender, std::function<void()> resume) {
+    waiters.count.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock lock(waitMutex_);
+        if (!(sender ? canSend() : canRecv())) {
+            waiters.resumes.push_back(std::move(resume));
+            return;
+        }
+        waiters.count.fetch_sub(1, std::memory_order_relaxed);
+    }
+    resume();
+}
+
+void Channel::wakeOne(Waiters& waiters) {
+    if (waiters.count.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    std::function<void()> resume;
+    {
+        std::scoped_lock lock(waitMutex_);
+        if (waiters.resumes.empty()) {
+            return;
+        }
+        resume = std::move(waiters.resumes.front());
+        waiters.resumes.pop_front();
+        waiters.count.fetch_sub(1, std::memory_order_relaxed);
+    }
+    resume();
+}
+
+void Channel::wakeAll(Waiters& waiters) {
+    std::deque<std::function<void()>> resumes;
+    {
+        std::scoped_lock lock(waitMutex_);
+        resumes.swap(waiters.resumes);
+        waiters.count.fetch_sub(resumes.size(), std::memory_order_relaxed);
+    }
+    for (auto& resume : resumes) {
+        resume();
+    }
+}
+
+} // namespace gs
@@ -0,0 +1,154 @@
+#include "gs/compile_cache.hpp"
+#include "gs/bytecode_image.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+namespace gs {
+
+namespace {
+
+// Bump whenever code generation or the GSBC3 layout changes, so existing cache entries miss.
+constexpr const char* kCompilerVersion = "gamescript-compiler/3 gsbc3-r2"
+#if defined(GS_COMPACT_VALUE)
+                                         " compact-value"
+#endif
+    ;
+
+std::mutex g_cacheMutex;
+bool g_cacheConfigured = false;
+std::string g_cacheDirectory;
+
+std::uint64_t fnv1a64(std::string_view text, std::uint64_t hash) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Second, independent lane: 64-bit multiply/xorshift mix over 8-byte words.
+std::uint64_t mixHash64(std::string_view text, std::uint64_t hash) {
+    auto mix = [](std::uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    };
+    std::size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, text.data() + i, 8);
+        hash = mix(hash ^ word) + 0x9e3779b97f4a7c15ULL;
+    }
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, text.data() + i, text.size() - i);
+    return mix(hash ^ tail ^ (static_cast<std::uint64_t>(text.size()) << 3));
+}
+
+std::string toHex(std::uint64_t value) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        out[static_cast<std::size_t>(i)] = digits[value & 0xF];
+        value >>= 4;
+    }
+    return out;
+}
+
+std::string entryPath(const std::string& directory, const std::string& source) {
+    return (std::filesystem::path(directory) / (compileCacheKey(source) + ".gsbc")).string();
+}
+
+} // namespace
+
+void setCompileCacheDirectory(const std::string& directory) {
+    std::scoped_lock lock(g_cacheMutex);
+    g_cacheDirectory = directory;
+    g_cacheConfigured = true;
+}
+
+std::string compileCacheDirectory() {
+    std::scoped_lock lock(g_cacheMutex);
+    if (!g_cacheConfigured) {
+        const char* env = std::getenv("GS_COMPILE_CACHE_DIR");
+        g_cacheDirectory = env ? env : "";
+        g_cacheConfigured = true;
+    }
+    return g_cacheDirectory;
+}
+
+const char* compilerVersion() {
+    return kCompilerVersion;
+}
+
+std::string compileCacheKey(const std::string& source) {
+    const std::string_view version(kCompilerVersion);
+    std::uint64_t lane1 = fnv1a64(version, 0xcbf29ce484222325ULL);
+    lane1 = fnv1a64(std::string_view("\0", 1), lane1);
+    lane1 = fnv1a64(source, lane1);
+    const std::uint64_t lane2 = mixHash64(source, mixHash64(version, 0x243f6a8885a308d3ULL));
+    return toHex(lane1) + toHex(lane2);
+}
+
+std::optional<Module> loadCachedModule(const std::string& source) {
+    const std::string directory = compileCacheDirectory();
+    if (directory.empty()) {
+        return std::nullopt;
+    }
+    const std::string path = entryPath(directory, source);
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        return std::nullopt;
+    }
+    try {
+        return loadModuleImage(BytecodeImage::mapFile(path));
+    } catch (const std::exception&) {
+        // Corrupt or truncated entry: fall back to compiling and let the store replace it.
+        return std::nullopt;
+    }
+}
+
+bool storeCachedModule(const std::string& source, const Module& module) {
+    const std::string directory = compileCacheDirectory();
+    if (directory.empty()) {
+        return false;
+    }
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+
+    const std::string path = entryPath(directory, source);
+    const auto unique = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                        static_cast<std::size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    const std::string tempPath = path + ".tmp" + toHex(unique);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out << serializeModuleBinary(module);
+        if (!out) {
+            out.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace gs
@@ -1,14 +1,22 @@
 #include "gs/compiler.hpp"
+#include "gs/aot.hpp"
+#include "gs/bytecode_image.hpp"
+#include "gs/compile_cache.hpp"
+#include "gs/thread_pool.hpp"
 
 #include "gs/tokenizer.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -48,7 +56,8 @@ bool defaultCompileDisassemblyDumpEnabled() {
 #endif
 }
 
-bool g_compileDisassemblyDumpEnabled = defaultCompileDisassemblyDumpEnabled();
+std::atomic<bool> g_compileDisassemblyDumpEnabled{defaultCompileDisassemblyDumpEnabled()};
+std::atomic<bool> g_lazyFunctionCompilationEnabled{true};
 
 class CompilerException final : public std::exception {
 public:
@@ -163,12 +172,15 @@ const char* opcodeName(OpCode op) {
     case OpCode::StoreNameFromReg: return "StoreNameFromReg";
     case OpCode::PushLocal: return "PushLocal";
     case OpCode::PushName: return "PushName";
+    case OpCode::AppendLocal: return "AppendLocal";
+    case OpCode::SealLocal: return "SealLocal";
+    case OpCode::LoadImport: return "LoadImport";
     }
     return "Unknown";
 }
 
 std::string valueForDis(const Module& module, const Value& value) {
-    switch (value.type) {
+    switch (value.valueType()) {
     case ValueType::Nil:
     case ValueType::Bool:
     case ValueType::Int:
@@ -280,11 +292,24 @@ std::string bytecodeOperandHint(const Module& module, const Instruction& ins, co
     case OpCode::MoveLocalToReg:
     case OpCode::CaptureLocal:
     case OpCode::StoreLocalFromReg:
+    case OpCode::AppendLocal:
+    case OpCode::SealLocal:
         return formatLocalSlotForDis(ins.a, ir);
     case OpCode::PushCapture:
     case OpCode::LoadCapture:
     case OpCode::StoreCapture:
         return std::string("capture[") + std::to_string(ins.a) + "]";
+    case OpCode::LoadImport: {
+        const auto index = static_cast<std::size_t>(ins.a);
+        if (index < module.importSymbols.size()) {
+            const auto& symbol = module.importSymbols[index];
+            const std::string spec = symbol.importIndex < module.imports.size()
+                                         ? module.imports[symbol.importIndex].moduleSpec
+                                         : std::string("?");
+            return std::string("import[") + std::to_string(ins.a) + "]=" + spec + "." + symbol.name;
+        }
+        return std::string("import[") + std::to_string(ins.a) + "]";
+    }
     case OpCode::MakeClosure:
         return std::string("fn=") + std::to_string(ins.a) + " capture_count=" + std::to_string(ins.b);
     case OpCode::LoadConst: {
@@ -492,369 +517,121 @@ std::vector<std::string> splitLines(const std::string& source) {
     return lines;
 }
 
-std::string normalizeModuleSpecToPath(const std::string& moduleSpec) {
-    std::string candidate = moduleSpec;
-    if (candidate.find('/') == std::string::npos && candidate.find('\\') == std::string::npos) {
-        for (char& c : candidate) {
-            if (c == '.') {
-                c = '/';
-            }
-        }
-    }
-    return candidate;
-}
-
-std::string resolveImportPath(const std::string& moduleSpec,
-                              const std::string& currentFile,
-                              const std::vector<std::string>& searchPaths) {
-    namespace fs = std::filesystem;
-
-    std::vector<std::string> candidates;
-    const std::string normalized = normalizeModuleSpecToPath(moduleSpec);
-    candidates.push_back(normalized);
-    if (normalized.size() < 3 || normalized.substr(normalized.size() - 3) != ".gs") {
-        candidates.push_back(normalized + ".gs");
-    }
-
-    const fs::path currentDir = fs::path(currentFile).parent_path();
-    for (const auto& candidate : candidates) {
-        fs::path pathCandidate(candidate);
-        if (pathCandidate.is_absolute() && fs::exists(pathCandidate)) {
-            return fs::weakly_canonical(pathCandidate).string();
-        }
-
-        fs::path local = currentDir / pathCandidate;
-        if (fs::exists(local)) {
-            return fs::weakly_canonical(local).string();
-        }
-
-        for (const auto& base : searchPaths) {
-            fs::path searchCandidate = fs::path(base) / pathCandidate;
-            if (fs::exists(searchCandidate)) {
-                return fs::weakly_canonical(searchCandidate).string();
-            }
-        }
-    }
-
-    return {};
-}
-
-std::string replaceAllRegex(const std::string& input,
-                            const std::string& pattern,
-                            const std::string& replacement) {
-    return std::regex_replace(input, std::regex(pattern), replacement);
-}
-
-struct ImportStatement {
-    std::string moduleSpec;
-    std::vector<std::string> importNames;
-    std::string alias;
-    bool valid{false};
-    bool isFrom{false};
-    bool isWildcard{false};
-};
-
-struct ModuleAliasBinding {
-    std::string alias;
-    std::string moduleSpec;
-    std::vector<std::string> exports;
-};
-
-struct ProcessedModule {
-    std::string source;
-    std::vector<std::string> exports;
-};
-
-std::string formatCompilerError(const std::string& message,
-                                const std::string& functionName,
-                                std::size_t line,
-                                std::size_t column);
-
+// Local name bound by `import a.b.c` without an alias: the last spec segment.
 std::string defaultModuleAlias(const std::string& moduleSpec) {
-    const std::size_t slash = moduleSpec.find_last_of("/\\");
-    const std::size_t dot = moduleSpec.find_last_of('.');
-    std::size_t split = std::string::npos;
-    if (slash != std::string::npos && dot != std::string::npos) {
-        split = std::max(slash, dot);
-    } else if (slash != std::string::npos) {
-        split = slash;
-    } else if (dot != std::string::npos) {
-        split = dot;
-    }
+    const std::size_t split = moduleSpec.find_last_of("/\\.");
     if (split == std::string::npos || split + 1 >= moduleSpec.size()) {
         return moduleSpec;
     }
     return moduleSpec.substr(split + 1);
 }
 
-void appendUnique(std::vector<std::string>& target, const std::string& value) {
-    for (const auto& existing : target) {
-        if (existing == value) {
-            return;
-        }
-    }
-    target.push_back(value);
-}
+struct LoopContext {
+    std::vector<std::size_t> breakJumps;
+    std::vector<std::size_t> continueJumps;
+    std::size_t continueTarget{0};
+};
 
-std::vector<std::string> extractExportsFromSource(const std::string& source) {
-    std::vector<std::string> exports;
-    static const std::regex fnRe(R"(^\s*fn\s+([A-Za-z_][A-Za-z0-9_]*)\s*\()");
-    static const std::regex classRe(R"(^\s*class\s+([A-Za-z_][A-Za-z0-9_]*)\b)");
+// All mutable state of one Compiler::compile() call. The code generator is a set of free
+// functions, so the active session is published through a thread-local pointer that
+// CompileSessionScope saves and restores: compiles on different threads never share state, and
+// a nested compile on one thread gets its own session.
+struct CompileSession {
+    std::unordered_map<std::string, std::size_t> funcIndex;
+    std::unordered_map<std::string, std::size_t> classIndex;
+    std::size_t lambdaOrdinal{0};
+    std::vector<FunctionIR>* functionIrs{nullptr};
+    // Frame-scoped let declarations of the function currently being compiled.
+    const std::unordered_set<const Stmt*>* frameScopedLets{nullptr};
+    // Accumulation sites already claimed by a loop of the function currently being compiled.
+    std::unordered_set<const Stmt*>* loopAccumulators{nullptr};
+    // Import bindings by local name: module aliases map to their Module::imports entry and
+    // `from`-imported names to their Module::importSymbols slot.
+    std::unordered_map<std::string, std::size_t> importAliases;
+    std::unordered_map<std::string, std::size_t> importedNames;
+};
 
-    for (const auto& line : splitLines(source)) {
-        std::smatch m;
-        if (std::regex_search(line, m, fnRe)) {
-            appendUnique(exports, m[1].str());
-        }
-        if (std::regex_search(line, m, classRe)) {
-            appendUnique(exports, m[1].str());
-        }
-    }
-    return exports;
-}
+thread_local CompileSession* g_session = nullptr;
 
-std::string buildModuleAliasInitBlock(const ModuleAliasBinding& binding) {
-    std::ostringstream out;
-    out << "let " << binding.alias << " = loadModule(\"" << binding.moduleSpec << "\"); ";
-    for (const auto& symbol : binding.exports) {
-        out << binding.alias << "." << symbol << " = " << symbol << "; ";
+struct CompileSessionScope {
+    explicit CompileSessionScope(CompileSession& session) : previous(g_session) {
+        g_session = &session;
     }
-    return out.str();
-}
-
-std::string makeInternalAlias(const std::string& moduleSpec, std::size_t index) {
-    std::string out = "__m" + std::to_string(index) + "_";
-    for (char c : moduleSpec) {
-        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
-            out.push_back(c);
-        } else {
-            out.push_back('_');
-        }
-    }
-    return out;
-}
-
-std::string injectIntoFunctionBodies(const std::string& source, const std::string& injectionBlock) {
-    if (injectionBlock.empty()) {
-        return source;
+    ~CompileSessionScope() {
+        g_session = previous;
     }
+    CompileSessionScope(const CompileSessionScope&) = delete;
+    CompileSessionScope& operator=(const CompileSessionScope&) = delete;
 
-    static const std::regex fnHeaderRe(R"((^\s*fn\s+[A-Za-z_][A-Za-z0-9_]*\s*\([^)]*\)\s*\{))");
-    const auto injectLines = splitLines(injectionBlock);
-    std::ostringstream out;
-    for (const auto& line : splitLines(source)) {
-        if (!std::regex_search(line, fnHeaderRe)) {
-            out << line << '\n';
-            continue;
-        }
+    CompileSession* previous;
+};
 
-        out << line << '\n';
-        std::size_t indentWidth = 0;
-        while (indentWidth < line.size() && std::isspace(static_cast<unsigned char>(line[indentWidth]))) {
-            ++indentWidth;
-        }
-        const std::string indent = line.substr(0, indentWidth) + "    ";
-        for (const auto& injectLine : injectLines) {
-            if (injectLine.empty()) {
-                continue;
-            }
-            out << indent << injectLine << '\n';
-        }
+CompileSession& activeSession() {
+    if (!g_session) {
+        throw std::runtime_error("Internal compiler session is not initialized");
     }
-    return out.str();
+    return *g_session;
 }
 
-ImportStatement parseImportLine(const std::string& rawLine, std::size_t lineNo = 0) {
-    ImportStatement stmt;
-    std::string line = trimCopy(rawLine);
-    if (line.empty()) {
-        return stmt;
-    }
-    if (line.rfind("#", 0) == 0 || line.rfind("//", 0) == 0) {
-        return stmt;
-    }
-    if (!line.empty() && line.back() == ';') {
-        line.pop_back();
-        line = trimCopy(line);
-    }
-
-    std::smatch match;
-    static const std::regex importRe(R"(^import\s+([A-Za-z_][A-Za-z0-9_./]*)\s*(?:as\s+([A-Za-z_][A-Za-z0-9_]*))?$)");
-
-    if (std::regex_match(line, match, importRe)) {
-        stmt.valid = true;
-        stmt.isFrom = false;
-        stmt.moduleSpec = match[1].str();
-        if (match.size() > 2) {
-            stmt.alias = match[2].str();
+std::int32_t importSymbolSlot(Module& module, std::size_t importIndex, const std::string& name) {
+    for (std::size_t i = 0; i < module.importSymbols.size(); ++i) {
+        const auto& symbol = module.importSymbols[i];
+        if (symbol.importIndex == importIndex && symbol.name == name) {
+            return static_cast<std::int32_t>(i);
         }
-        stmt.isWildcard = true;
-        return stmt;
     }
+    module.importSymbols.push_back({static_cast<std::uint32_t>(importIndex), name});
+    return static_cast<std::int32_t>(module.importSymbols.size() - 1);
+}
 
-    if (line.rfind("from ", 0) == 0) {
-        const std::size_t importPos = line.find(" import ");
-        if (importPos == std::string::npos) {
-            return stmt;
-        }
-
-        const std::string moduleSpec = trimCopy(line.substr(5, importPos - 5));
-        if (moduleSpec.empty()) {
-            return stmt;
-        }
-
-        std::string importSpec = trimCopy(line.substr(importPos + 8));
-        std::string alias;
-        static const std::regex identRe(R"(^[A-Za-z_][A-Za-z0-9_]*$)");
-
-        const std::size_t asPos = importSpec.rfind(" as ");
-        if (asPos != std::string::npos) {
-            const std::string aliasCandidate = trimCopy(importSpec.substr(asPos + 4));
-            if (aliasCandidate.empty() || !std::regex_match(aliasCandidate, identRe)) {
-                return stmt;
-            }
-            alias = aliasCandidate;
-            importSpec = trimCopy(importSpec.substr(0, asPos));
-        }
-
-        stmt.valid = true;
-        stmt.isFrom = true;
-        stmt.moduleSpec = moduleSpec;
-        stmt.alias = alias;
-
-        if (importSpec == "*") {
-            stmt.isWildcard = true;
-            return stmt;
-        }
-
-        std::istringstream namesIn(importSpec);
-        std::string segment;
-        while (std::getline(namesIn, segment, ',')) {
-            std::string name = trimCopy(segment);
-            if (name.empty() || !std::regex_match(name, identRe)) {
-                throwCompilerError(formatCompilerError("Invalid import symbol in line: " + rawLine,
-                                                             "<module>",
-                                                             lineNo,
-                                                             1));
-            }
-            stmt.importNames.push_back(name);
-        }
+bool isShadowedByLocal(const std::string& name,
+                       const std::unordered_map<std::string, std::size_t>& locals,
+                       const std::unordered_map<std::string, std::size_t>* captureIndexByName) {
+    return locals.contains(name) || (captureIndexByName && captureIndexByName->contains(name));
+}
 
-        if (stmt.importNames.empty()) {
-            throwCompilerError(formatCompilerError("from-import requires at least one symbol",
-                                                         "<module>",
-                                                         lineNo,
-                                                         1));
-        }
-        return stmt;
+// LoadImport slot for a reference to a `from`-imported name.
+bool tryResolveImportedName(const std::string& name,
+                            const std::unordered_map<std::string, std::size_t>& locals,
+                            const std::unordered_map<std::string, std::size_t>* captureIndexByName,
+                            std::int32_t& outSlot) {
+    const auto& importedNames = activeSession().importedNames;
+    auto it = importedNames.find(name);
+    if (it == importedNames.end() || isShadowedByLocal(name, locals, captureIndexByName)) {
+        return false;
     }
-
-    return stmt;
+    outSlot = static_cast<std::int32_t>(it->second);
+    return true;
 }
 
-ProcessedModule preprocessImportsRecursive(const std::string& filePath,
-                                           const std::vector<std::string>& searchPaths,
-                                           std::unordered_map<std::string, ProcessedModule>& cache,
-                                           std::unordered_set<std::string>& visiting) {
-    (void)searchPaths;
-    const std::string canonical = std::filesystem::weakly_canonical(filePath).string();
-    auto cached = cache.find(canonical);
-    if (cached != cache.end()) {
-        return cached->second;
-    }
-    if (visiting.contains(canonical)) {
-        throwCompilerError(formatCompilerError("Cyclic import detected: " + canonical,
-                                                     "<module>",
-                                                     1,
-                                                     1));
+// LoadImport slot for `alias.member` on an imported module. Members outside an explicit
+// `from m import a, b as alias` list keep the ordinary attribute lookup (and its error).
+bool tryResolveImportMember(const Expr& object,
+                            const std::string& member,
+                            Module& module,
+                            const std::unordered_map<std::string, std::size_t>& locals,
+                            const std::unordered_map<std::string, std::size_t>* captureIndexByName,
+                            std::int32_t& outSlot) {
+    if (object.type != ExprType::Variable) {
+        return false;
     }
-
-    const std::string source = readFileText(canonical);
-    if (source.empty()) {
-        throwCompilerError(formatCompilerError("Failed to read script file: " + canonical,
-                                                     "<module>",
-                                                     1,
-                                                     1));
+    const auto& importAliases = activeSession().importAliases;
+    auto it = importAliases.find(object.name);
+    if (it == importAliases.end() || isShadowedByLocal(object.name, locals, captureIndexByName)) {
+        return false;
     }
-
-    visiting.insert(canonical);
-
-    std::ostringstream bodySource;
-    std::size_t importTempIndex = 0;
-
-    const auto lines = splitLines(source);
-    for (std::size_t lineIndex = 0; lineIndex < lines.size(); ++lineIndex) {
-        const auto& line = lines[lineIndex];
-        const std::size_t lineNo = lineIndex + 1;
-        ImportStatement stmt = parseImportLine(line, lineNo);
-        if (!stmt.valid) {
-            bodySource << line << '\n';
-            continue;
-        }
-
-        if (!stmt.isFrom) {
-            const std::string alias = stmt.alias.empty() ? defaultModuleAlias(stmt.moduleSpec) : stmt.alias;
-            bodySource << "let " << alias << " = loadModule(\"" << stmt.moduleSpec << "\");\n";
-            continue;
-        }
-
-        if (stmt.isWildcard) {
-            if (stmt.alias.empty()) {
-                throwCompilerError(formatCompilerError("from " + stmt.moduleSpec + " import * requires alias in strict module mode",
-                                                             "<module>",
-                                                             lineNo,
-                                                             1));
-            }
-            bodySource << "let " << stmt.alias << " = loadModule(\"" << stmt.moduleSpec << "\");\n";
-            continue;
-        }
-
-        if (stmt.importNames.size() > 1) {
-            if (stmt.alias.empty()) {
-                throwCompilerError(formatCompilerError("from " + stmt.moduleSpec + " import a,b requires alias in strict module mode",
-                                                             "<module>",
-                                                             lineNo,
-                                                             1));
-            }
-
-            bodySource << "let " << stmt.alias << " = loadModule(\"" << stmt.moduleSpec << "\"";
-            for (const auto& symbol : stmt.importNames) {
-                bodySource << ", \"" << symbol << "\"";
-            }
-            bodySource << ");\n";
-            continue;
-        }
-
-        const std::string importedName = stmt.importNames.front();
-        const std::string localName = stmt.alias.empty() ? importedName : stmt.alias;
-        static const std::regex identRe(R"(^[A-Za-z_][A-Za-z0-9_]*$)");
-        if (!std::regex_match(localName, identRe)) {
-            throwCompilerError(formatCompilerError("Invalid local alias generated for from-import: " + localName,
-                                                         "<module>",
-                                                         lineNo,
-                                                         1));
-        }
-                                bodySource << "let " << localName << " = loadModule(\"" << stmt.moduleSpec << "\", \"" << importedName << "\");\n";
+    const auto& symbols = module.imports[it->second].symbols;
+    if (!symbols.empty() && std::find(symbols.begin(), symbols.end(), member) == symbols.end()) {
+        return false;
     }
-
-    visiting.erase(canonical);
-
-    ProcessedModule processed;
-    processed.source = bodySource.str();
-    processed.exports = extractExportsFromSource(processed.source);
-    cache.emplace(canonical, processed);
-    return processed;
+    outSlot = importSymbolSlot(module, it->second, member);
+    return true;
 }
 
-struct LoopContext {
-    std::vector<std::size_t> breakJumps;
-    std::vector<std::size_t> continueJumps;
-    std::size_t continueTarget{0};
-};
-
-thread_local std::unordered_map<std::string, std::size_t>* g_mutableFuncIndex = nullptr;
-thread_local std::size_t* g_lambdaOrdinal = nullptr;
-thread_local std::vector<FunctionIR>* g_allFunctionIrs = nullptr;
+bool isImportBinding(const std::string& name) {
+    const auto& session = activeSession();
+    return session.importAliases.contains(name) || session.importedNames.contains(name);
+}
 
 void collectCapturedNamesInExpr(const Expr& expr,
                                 const std::unordered_map<std::string, std::size_t>& outerLocals,
@@ -1007,10 +784,20 @@ void collectCapturedNamesInStatements(const std::vector<Stmt>& statements,
         case StmtType::Throw:
             collectCapturedNamesInExpr(stmt.expr, outerLocals, lambdaLocals, outCaptureNames, dedup);
             break;
+        case StmtType::LetSpawn:
+            for (const auto& arg : stmt.call.args) {
+                collectCapturedNamesInExpr(arg, outerLocals, lambdaLocals, outCaptureNames, dedup);
+            }
+            break;
+        case StmtType::LetAwait: {
+            Expr source;
+            source.type = ExprType::Variable;
+            source.name = stmt.awaitSource;
+            collectCapturedNamesInExpr(source, outerLocals, lambdaLocals, outCaptureNames, dedup);
+            break;
+        }
         case StmtType::Break:
         case StmtType::Continue:
-        case StmtType::LetSpawn:
-        case StmtType::LetAwait:
         case StmtType::Sleep:
         case StmtType::Yield:
             break;
@@ -1032,6 +819,16 @@ std::string formatCompilerError(const std::string& message,
     return out.str();
 }
 
+// Import bindings are linked once by the runtime, so scripts may not rebind them.
+void rejectImportBindingStore(const std::string& name,
+                              const std::string& functionName,
+                              std::size_t line,
+                              std::size_t column) {
+    if (isImportBinding(name)) {
+        throwCompilerError(formatCompilerError("Cannot assign to import binding: " + name, functionName, line, column));
+    }
+}
+
 std::string normalizeTypeAnnotationName(std::string typeName) {
     typeName = trimCopy(typeName);
     if (typeName.empty()) {
@@ -1116,6 +913,480 @@ SymbolLookupResult resolveSymbol(const std::unordered_map<std::string, std::size
     return result;
 }
 
+// Escape analysis for frame-scoped allocation. `let v = <site>` stays inside its frame when
+// the site allocates (string concatenation, str(), Tuple(), a lambda) and every use of `v`
+// only reads it: operators, indexing, calling it, or handing it to a builtin that keeps no
+// reference. Storing, returning, capturing or passing `v` to anything else is an escape.
+bool isNonRetainingBuiltin(const std::string& name) {
+    return name == "print" || name == "printf" || name == "str" || name == "typename" || name == "id" ||
+           name == "assert";
+}
+
+bool isFrameScopedAllocBuiltin(const std::string& name) {
+    return name == "str" || name == "Tuple";
+}
+
+bool isGlobalSymbolName(const Module& module,
+                        const std::unordered_map<std::string, std::size_t>& funcIndex,
+                        const std::unordered_map<std::string, std::size_t>& classIndex,
+                        const std::string& name) {
+    Value ignored = Value::Nil();
+    return resolveNamedValue(module, funcIndex, classIndex, name, ignored);
+}
+
+// A callee that is not a local, capture or module-level symbol (imports are module globals) can
+// only name a host builtin, so the call compiles to CallHost and the VM resolves a handle for it.
+bool isHostCallTarget(const std::string& name,
+                      const Module& module,
+                      const std::unordered_map<std::string, std::size_t>& locals,
+                      const std::unordered_map<std::string, std::size_t>& funcIndex,
+                      const std::unordered_map<std::string, std::size_t>& classIndex,
+                      const std::unordered_map<std::string, std::size_t>* captureIndexByName) {
+    return name != "super" && !locals.contains(name) && !(captureIndexByName && captureIndexByName->contains(name)) &&
+           !isGlobalSymbolName(module, funcIndex, classIndex, name);
+}
+
+bool isFrameScopedAllocExpr(const Expr& expr, const std::function<bool(const std::string&)>& isBuiltinName) {
+    switch (expr.type) {
+    case ExprType::Lambda:
+        return true;
+    case ExprType::Binary:
+        return expr.binaryOp == TokenType::Plus;
+    case ExprType::Call:
+        return expr.callee && expr.callee->type == ExprType::Variable &&
+               isFrameScopedAllocBuiltin(expr.callee->name) && isBuiltinName(expr.callee->name);
+    default:
+        return false;
+    }
+}
+
+// Records the outermost allocation emitted for an expression compiled into [begin, end).
+void markNonEscapingAllocSite(FunctionIR& out, std::size_t begin) {
+    for (std::size_t i = out.code.size(); i > begin; --i) {
+        const OpCode op = out.code[i - 1].op;
+        if (op == OpCode::Add || op == OpCode::CallValue || op == OpCode::CallHost || op == OpCode::MakeClosure) {
+            out.nonEscapingAllocSites.push_back(static_cast<std::uint32_t>(i - 1));
+            return;
+        }
+    }
+}
+
+class FrameScopedLetAnalysis {
+public:
+    FrameScopedLetAnalysis(const Module& module,
+                           const std::unordered_map<std::string, std::size_t>& funcIndex,
+                           const std::unordered_map<std::string, std::size_t>& classIndex,
+                           const std::unordered_map<std::string, std::size_t>* outerLocals)
+        : module_(module), funcIndex_(funcIndex), classIndex_(classIndex), outerLocals_(outerLocals) {}
+
+    std::unordered_set<const Stmt*> run(const std::vector<Stmt>& body, const std::vector<std::string>& params) {
+        for (const auto& param : params) {
+            declaredNames_.insert(param);
+            escapedNames_.insert(param);
+        }
+        collectDeclaredNames(body);
+        walkStatements(body);
+
+        std::unordered_set<const Stmt*> result;
+        for (const Stmt* stmt : candidates_) {
+            if (!escapedNames_.contains(stmt->name)) {
+                result.insert(stmt);
+            }
+        }
+        return result;
+    }
+
+    bool isBuiltinName(const std::string& name) const {
+        if (declaredNames_.contains(name)) {
+            return false;
+        }
+        if (outerLocals_ && outerLocals_->contains(name)) {
+            return false;
+        }
+        return !isGlobalSymbolName(module_, funcIndex_, classIndex_, name);
+    }
+
+private:
+    void collectDeclaredNames(const std::vector<Stmt>& statements) {
+        for (const auto& stmt : statements) {
+            if (stmt.type == StmtType::LetExpr || stmt.type == StmtType::LetSpawn || stmt.type == StmtType::LetAwait) {
+                declaredNames_.insert(stmt.name);
+            }
+            // Loop and catch variables are rebound by the VM, never by the candidate site.
+            for (const auto* rebound : {&stmt.iterKey, &stmt.iterValue}) {
+                if (!rebound->empty()) {
+                    declaredNames_.insert(*rebound);
+                    escapedNames_.insert(*rebound);
+                }
+            }
+            for (const auto& errorName : stmt.catchErrorNames) {
+                declaredNames_.insert(errorName);
+                escapedNames_.insert(errorName);
+            }
+            collectDeclaredNames(stmt.body);
+            collectDeclaredNames(stmt.elseBody);
+            for (const auto& branchBody : stmt.branchBodies) {
+                collectDeclaredNames(branchBody);
+            }
+            for (const auto& catchBody : stmt.catchBodies) {
+                collectDeclaredNames(catchBody);
+            }
+            collectDeclaredNames(stmt.finallyBody);
+        }
+    }
+
+    void walkStatements(const std::vector<Stmt>& statements) {
+        for (const auto& stmt : statements) {
+            switch (stmt.type) {
+            case StmtType::LetExpr:
+                if (insideLambda_) {
+                    escapedNames_.insert(stmt.name);
+                } else if (isFrameScopedAllocExpr(stmt.expr, [this](const std::string& name) { return isBuiltinName(name); })) {
+                    candidates_.push_back(&stmt);
+                }
+                walkExpr(stmt.expr, true);
+                break;
+            case StmtType::LetSpawn:
+            case StmtType::LetAwait:
+                escapedNames_.insert(stmt.name);
+                escapedNames_.insert(stmt.awaitSource);
+                for (const auto& arg : stmt.call.args) {
+                    walkExpr(arg, true);
+                }
+                break;
+            case StmtType::ForRange:
+                walkExpr(stmt.rangeStart, true);
+                walkExpr(stmt.rangeEnd, true);
+                walkStatements(stmt.body);
+                break;
+            case StmtType::ForList:
+            case StmtType::ForDict:
+                walkExpr(stmt.iterable, true);
+                walkStatements(stmt.body);
+                break;
+            case StmtType::If:
+                for (const auto& cond : stmt.branchConditions) {
+                    walkExpr(cond, true);
+                }
+                for (const auto& body : stmt.branchBodies) {
+                    walkStatements(body);
+                }
+                walkStatements(stmt.elseBody);
+                break;
+            case StmtType::While:
+                walkExpr(stmt.condition, true);
+                walkStatements(stmt.body);
+                break;
+            case StmtType::Try:
+                walkStatements(stmt.body);
+                for (const auto& catchBody : stmt.catchBodies) {
+                    walkStatements(catchBody);
+                }
+                walkStatements(stmt.finallyBody);
+                break;
+            case StmtType::Expr:
+                walkExpr(stmt.expr, false);
+                break;
+            case StmtType::Return:
+            case StmtType::Throw:
+                walkExpr(stmt.expr, true);
+                break;
+            case StmtType::Break:
+            case StmtType::Continue:
+            case StmtType::Sleep:
+            case StmtType::Yield:
+                break;
+            }
+        }
+    }
+
+    void walkExpr(const Expr& expr, bool escapes) {
+        switch (expr.type) {
+        case ExprType::Number:
+        case ExprType::BoolLiteral:
+        case ExprType::NullLiteral:
+        case ExprType::StringLiteral:
+            return;
+        case ExprType::Variable:
+            if (escapes || insideLambda_) {
+                escapedNames_.insert(expr.name);
+            }
+            return;
+        case ExprType::AssignVariable:
+            if (insideLambda_) {
+                escapedNames_.insert(expr.name);
+            }
+            walkOptional(expr.right, true);
+            return;
+        case ExprType::AssignProperty:
+            walkOptional(expr.object, true);
+            walkOptional(expr.right, true);
+            return;
+        case ExprType::AssignIndex:
+            walkOptional(expr.object, true);
+            walkOptional(expr.index, true);
+            walkOptional(expr.right, true);
+            return;
+        case ExprType::Unary:
+            walkOptional(expr.right, false);
+            return;
+        case ExprType::Binary: {
+            // `a && b` / `a || b` yield one of their operands.
+            const bool operandEscapes =
+                (expr.binaryOp == TokenType::AmpAmp || expr.binaryOp == TokenType::PipePipe) && escapes;
+            walkOptional(expr.left, operandEscapes);
+            walkOptional(expr.right, operandEscapes);
+            return;
+        }
+        case ExprType::ListLiteral:
+            for (const auto& element : expr.listElements) {
+                walkExpr(element, true);
+            }
+            return;
+        case ExprType::DictLiteral:
+            for (const auto& entry : expr.dictEntries) {
+                walkOptional(entry.key, true);
+                walkOptional(entry.value, true);
+            }
+            return;
+        case ExprType::Call: {
+            const bool argsEscape = !(expr.callee && expr.callee->type == ExprType::Variable &&
+                                      isNonRetainingBuiltin(expr.callee->name) && isBuiltinName(expr.callee->name));
+            walkOptional(expr.callee, false);
+            for (const auto& arg : expr.args) {
+                walkExpr(arg, argsEscape);
+            }
+            return;
+        }
+        case ExprType::MethodCall:
+            walkOptional(expr.object, true);
+            for (const auto& arg : expr.args) {
+                walkExpr(arg, true);
+            }
+            return;
+        case ExprType::PropertyAccess:
+            walkOptional(expr.object, true);
+            return;
+        case ExprType::IndexAccess:
+            walkOptional(expr.object, false);
+            walkOptional(expr.index, true);
+            return;
+        case ExprType::Lambda: {
+            // Anything a lambda body mentions may be captured into an upvalue cell.
+            const bool wasInsideLambda = insideLambda_;
+            insideLambda_ = true;
+            if (expr.lambdaDecl) {
+                walkStatements(expr.lambdaDecl->body);
+            }
+            insideLambda_ = wasInsideLambda;
+            return;
+        }
+        }
+    }
+
+    void walkOptional(const std::unique_ptr<Expr>& expr, bool escapes) {
+        if (expr) {
+            walkExpr(*expr, escapes);
+        }
+    }
+
+    const Module& module_;
+    const std::unordered_map<std::string, std::size_t>& funcIndex_;
+    const std::unordered_map<std::string, std::size_t>& classIndex_;
+    const std::unordered_map<std::string, std::size_t>* outerLocals_;
+    std::unordered_set<std::string> declaredNames_;
+    std::unordered_set<std::string> escapedNames_;
+    std::vector<const Stmt*> candidates_;
+    bool insideLambda_{false};
+};
+
+struct FrameScopedLetsGuard {
+    explicit FrameScopedLetsGuard(const std::unordered_set<const Stmt*>* next)
+        : session(activeSession()), previous(session.frameScopedLets) {
+        session.frameScopedLets = next;
+    }
+    ~FrameScopedLetsGuard() {
+        session.frameScopedLets = previous;
+    }
+    FrameScopedLetsGuard(const FrameScopedLetsGuard&) = delete;
+    FrameScopedLetsGuard& operator=(const FrameScopedLetsGuard&) = delete;
+
+    CompileSession& session;
+    const std::unordered_set<const Stmt*>* previous;
+};
+
+// Finds `name = name + expr` statements in a loop whose target the loop touches nowhere
+// else (condition, other statements, nested lambdas). Nothing can observe the partial
+// value while the loop runs, so the statement compiles to AppendLocal and a string result
+// is extended in place instead of being copied on every iteration.
+class LoopAccumulatorAnalysis {
+public:
+    std::vector<const Stmt*> run(const Expr* condition, const std::vector<Stmt>& body) {
+        collectSites(body);
+        if (sites_.empty()) {
+            return {};
+        }
+        if (condition) {
+            countExpr(*condition);
+        }
+        countStatements(body);
+
+        std::vector<const Stmt*> result;
+        for (const Stmt* site : sites_) {
+            const std::string& name = site->expr.name;
+            // Each site accounts for exactly two references: the target and the left operand.
+            if (references_[name] == 2 * siteCounts_[name]) {
+                result.push_back(site);
+            }
+        }
+        return result;
+    }
+
+private:
+    static bool isAccumulation(const Stmt& stmt) {
+        if (stmt.type != StmtType::Expr || stmt.expr.type != ExprType::AssignVariable || !stmt.expr.right) {
+            return false;
+        }
+        const Expr& rhs = *stmt.expr.right;
+        return rhs.type == ExprType::Binary && rhs.binaryOp == TokenType::Plus && rhs.left && rhs.right &&
+               rhs.left->type == ExprType::Variable && rhs.left->name == stmt.expr.name;
+    }
+
+    void collectSites(const std::vector<Stmt>& statements) {
+        for (const auto& stmt : statements) {
+            if (isAccumulation(stmt)) {
+                sites_.push_back(&stmt);
+                ++siteCounts_[stmt.expr.name];
+            }
+            collectSites(stmt.body);
+            collectSites(stmt.elseBody);
+            for (const auto& branchBody : stmt.branchBodies) {
+                collectSites(branchBody);
+            }
+            for (const auto& catchBody : stmt.catchBodies) {
+                collectSites(catchBody);
+            }
+            collectSites(stmt.finallyBody);
+        }
+    }
+
+    void countStatements(const std::vector<Stmt>& statements) {
+        for (const auto& stmt : statements) {
+            // Declarations and loop/catch bindings rebind the slot outside the pattern.
+            if (stmt.type == StmtType::LetExpr || stmt.type == StmtType::LetSpawn || stmt.type == StmtType::LetAwait) {
+                touch(stmt.name);
+                touch(stmt.awaitSource);
+            }
+            touch(stmt.iterKey);
+            touch(stmt.iterValue);
+            for (const auto& errorName : stmt.catchErrorNames) {
+                touch(errorName);
+            }
+
+            countExpr(stmt.expr);
+            for (const auto& arg : stmt.call.args) {
+                countExpr(arg);
+            }
+            countExpr(stmt.rangeStart);
+            countExpr(stmt.rangeEnd);
+            countExpr(stmt.iterable);
+            countExpr(stmt.condition);
+            for (const auto& cond : stmt.branchConditions) {
+                countExpr(cond);
+            }
+            countStatements(stmt.body);
+            countStatements(stmt.elseBody);
+            for (const auto& branchBody : stmt.branchBodies) {
+                countStatements(branchBody);
+            }
+            for (const auto& catchBody : stmt.catchBodies) {
+                countStatements(catchBody);
+            }
+            countStatements(stmt.finallyBody);
+        }
+    }
+
+    void countExpr(const Expr& expr) {
+        switch (expr.type) {
+        case ExprType::Number:
+        case ExprType::BoolLiteral:
+        case ExprType::NullLiteral:
+        case ExprType::StringLiteral:
+            return;
+        case ExprType::Variable:
+        case ExprType::AssignVariable:
+            touch(expr.name);
+            break;
+        case ExprType::ListLiteral:
+            for (const auto& element : expr.listElements) {
+                countExpr(element);
+            }
+            return;
+        case ExprType::DictLiteral:
+            for (const auto& entry : expr.dictEntries) {
+                countOptional(entry.key);
+                countOptional(entry.value);
+            }
+            return;
+        case ExprType::Lambda:
+            if (expr.lambdaDecl) {
+                countStatements(expr.lambdaDecl->body);
+            }
+            return;
+        case ExprType::Unary:
+        case ExprType::Binary:
+        case ExprType::Call:
+        case ExprType::MethodCall:
+        case ExprType::PropertyAccess:
+        case ExprType::IndexAccess:
+        case ExprType::AssignProperty:
+        case ExprType::AssignIndex:
+            break;
+        }
+        countOptional(expr.left);
+        countOptional(expr.right);
+        countOptional(expr.callee);
+        countOptional(expr.object);
+        countOptional(expr.index);
+        for (const auto& arg : expr.args) {
+            countExpr(arg);
+        }
+    }
+
+    void countOptional(const std::unique_ptr<Expr>& expr) {
+        if (expr) {
+            countExpr(*expr);
+        }
+    }
+
+    void touch(const std::string& name) {
+        if (!name.empty() && siteCounts_.contains(name)) {
+            ++references_[name];
+        }
+    }
+
+    std::vector<const Stmt*> sites_;
+    std::unordered_map<std::string, std::size_t> siteCounts_;
+    std::unordered_map<std::string, std::size_t> references_;
+};
+
+// Owns the claimed accumulation sites of one function. A nested loop leaves claimed sites
+// alone so the enclosing loop's SealLocal stays the only point where in-place appends restart.
+struct LoopAccumulatorScope {
+    LoopAccumulatorScope() : session(activeSession()), previous(session.loopAccumulators) {
+        session.loopAccumulators = &claimed;
+    }
+    ~LoopAccumulatorScope() {
+        session.loopAccumulators = previous;
+    }
+    LoopAccumulatorScope(const LoopAccumulatorScope&) = delete;
+    LoopAccumulatorScope& operator=(const LoopAccumulatorScope&) = delete;
+
+    CompileSession& session;
+    std::unordered_set<const Stmt*> claimed;
+    std::unordered_set<const Stmt*>* previous;
+};
+
 void validateLocalUsageInExpr(const Expr& expr,
                               const std::unordered_set<std::string>& localNames,
                               const std::unordered_set<std::string>& declaredNames,
@@ -1425,6 +1696,16 @@ Value evalGlobalInit(const Expr& expr,
                                                  expr.column));
 }
 
+// Moves a lowered body into a declared function. The name and parameters are left alone:
+// other threads may read them while a deferred body is being compiled.
+void installFunctionBody(FunctionBytecode& target, FunctionBytecode lowered) {
+    target.code = std::move(lowered.code);
+    target.localCount = lowered.localCount;
+    target.stackSlotCount = lowered.stackSlotCount;
+    target.localTypeNames = std::move(lowered.localTypeNames);
+    target.nonEscapingAllocSites = std::move(lowered.nonEscapingAllocSites);
+}
+
 std::int32_t addConstant(Module& module, Value value) {
     module.constants.push_back(value);
     return static_cast<std::int32_t>(module.constants.size() - 1);
@@ -1552,6 +1833,9 @@ bool tryCompileExprToRegister(const Expr& expr,
         if (captureIndexByName && captureIndexByName->contains(expr.name)) {
             return false;
         }
+        if (std::int32_t importSlot = -1; tryResolveImportedName(expr.name, locals, captureIndexByName, importSlot)) {
+            return false;
+        }
         const SymbolLookupResult resolved = resolveSymbol(locals,
                                                           module,
                                                           funcIndex,
@@ -1751,7 +2035,7 @@ bool tryExtractConstValue(const Expr& expr, Module& module, Value& outValue) {
 }
 
 std::string makeConstTempKey(const Value& value) {
-    return std::to_string(static_cast<int>(value.type)) + ":" + std::to_string(value.payload);
+    return std::to_string(static_cast<int>(value.valueType())) + ":" + std::to_string(value.rawPayload());
 }
 
 std::size_t ensureConstTempLocalSlot(const Value& value,
@@ -2152,8 +2436,11 @@ void compileExpr(const Expr& expr,
                                                           funcIndex,
                                                           classIndex,
                                                           expr.name);
+        std::int32_t importSlot = -1;
         if (resolved.found) {
             emitLocalValueToStack(code, resolved.localSlot);
+        } else if (tryResolveImportedName(expr.name, locals, captureIndexByName, importSlot)) {
+            emit(code, OpCode::LoadImport, importSlot, 0);
         } else {
             emitNameValueToStack(code, addString(module, expr.name));
         }
@@ -2229,6 +2516,7 @@ void compileExpr(const Expr& expr,
                 emitLocalValueToStack(code, resolved.localSlot);
             }
         } else {
+            rejectImportBindingStore(expr.name, currentFunctionName, expr.line, expr.column);
             const auto nameIdx = addString(module, expr.name);
             if (compiledToReg) {
                 emit(code, OpCode::StoreNameFromReg, nameIdx, 0);
@@ -2411,16 +2699,34 @@ void compileExpr(const Expr& expr,
                                                               calleeName);
 
             if (!resolved.found) {
-                emit(code, OpCode::LoadName, addString(module, calleeName), 0);
+                const bool hostCall =
+                    isHostCallTarget(calleeName, module, locals, funcIndex, classIndex, captureIndexByName);
+                std::int32_t importSlot = -1;
+                if (hostCall) {
+                    // The callee is named by CallHost itself.
+                } else if (tryResolveImportedName(calleeName, locals, captureIndexByName, importSlot)) {
+                    emit(code, OpCode::LoadImport, importSlot, 0);
+                } else {
+                    emit(code, OpCode::LoadName, addString(module, calleeName), 0);
+                }
                 for (const auto& arg : expr.args) {
                     compileExpr(arg, module, locals, funcIndex, classIndex, currentFunctionName, code, captureIndexByName);
                 }
-                emit(code,
-                     OpCode::CallValue,
-                     static_cast<std::int32_t>(expr.args.size()),
-                     0,
-                     expr.line,
-                     expr.column);
+                if (hostCall) {
+                    emit(code,
+                         OpCode::CallHost,
+                         addString(module, calleeName),
+                         static_cast<std::int32_t>(expr.args.size()),
+                         expr.line,
+                         expr.column);
+                } else {
+                    emit(code,
+                         OpCode::CallValue,
+                         static_cast<std::int32_t>(expr.args.size()),
+                         0,
+                         expr.line,
+                         expr.column);
+                }
                 return;
             }
 
@@ -2456,6 +2762,21 @@ void compileExpr(const Expr& expr,
                                                          expr.line,
                                                          expr.column));
         }
+        if (std::int32_t importSlot = -1;
+            tryResolveImportMember(*expr.object, expr.methodName, module, locals, captureIndexByName, importSlot)) {
+            // alias.f(args) calls the linked export directly.
+            emit(code, OpCode::LoadImport, importSlot, 0);
+            for (const auto& arg : expr.args) {
+                compileExpr(arg, module, locals, funcIndex, classIndex, currentFunctionName, code, captureIndexByName);
+            }
+            emit(code,
+                 OpCode::CallValue,
+                 static_cast<std::int32_t>(expr.args.size()),
+                 0,
+                 expr.line,
+                 expr.column);
+            return;
+        }
         compileExpr(*expr.object, module, locals, funcIndex, classIndex, currentFunctionName, code, captureIndexByName);
         for (const auto& arg : expr.args) {
             compileExpr(arg, module, locals, funcIndex, classIndex, currentFunctionName, code, captureIndexByName);
@@ -2474,6 +2795,11 @@ void compileExpr(const Expr& expr,
                                                          expr.line,
                                                          expr.column));
         }
+        if (std::int32_t importSlot = -1;
+            tryResolveImportMember(*expr.object, expr.propertyName, module, locals, captureIndexByName, importSlot)) {
+            emit(code, OpCode::LoadImport, importSlot, 0);
+            return;
+        }
         compileExpr(*expr.object, module, locals, funcIndex, classIndex, currentFunctionName, code, captureIndexByName);
         emit(code, OpCode::LoadAttr, addString(module, expr.propertyName), 0);
         return;
@@ -2495,7 +2821,7 @@ void compileExpr(const Expr& expr,
                                                          expr.line,
                                                          expr.column));
         }
-        if (!g_mutableFuncIndex || !g_lambdaOrdinal || !g_allFunctionIrs) {
+        if (!g_session || !g_session->functionIrs) {
             throwCompilerError(formatCompilerError("Internal compiler lambda context is not initialized",
                                                          currentFunctionName,
                                                          expr.line,
@@ -2521,9 +2847,10 @@ void compileExpr(const Expr& expr,
             lambdaCaptureIndex[captureNames[i]] = i;
         }
 
-        const std::string lambdaName = "__lambda_" + std::to_string((*g_lambdaOrdinal)++);
+        CompileSession& session = *g_session;
+        const std::string lambdaName = "__lambda_" + std::to_string(session.lambdaOrdinal++);
         const std::size_t lambdaIndex = module.functions.size();
-        (*g_mutableFuncIndex)[lambdaName] = lambdaIndex;
+        session.funcIndex[lambdaName] = lambdaIndex;
 
         FunctionBytecode lambdaBytecode;
         lambdaBytecode.name = lambdaName;
@@ -2547,10 +2874,14 @@ void compileExpr(const Expr& expr,
         lambdaIr.localTypeNames.assign(lambdaIr.localCount, "");
 
         std::unordered_map<std::string, std::size_t> lambdaConstTempSlots;
+        const auto frameScopedLets = FrameScopedLetAnalysis(module, session.funcIndex, classIndex, &locals)
+                                         .run(expr.lambdaDecl->body, expr.lambdaDecl->params);
+        FrameScopedLetsGuard frameScopedGuard(&frameScopedLets);
+        LoopAccumulatorScope loopAccumulatorScope;
         compileStatements(expr.lambdaDecl->body,
                           module,
                           lambdaLocalsMap,
-                          *g_mutableFuncIndex,
+                          session.funcIndex,
                           classIndex,
                           lambdaName,
                           false,
@@ -2564,8 +2895,8 @@ void compileExpr(const Expr& expr,
             emit(lambdaIr.code, OpCode::Return);
         }
 
-        g_allFunctionIrs->push_back(lambdaIr);
-        module.functions[lambdaIndex] = lowerFunctionIR(lambdaIr);
+        session.functionIrs->push_back(lambdaIr);
+        installFunctionBody(module.functions[lambdaIndex], lowerFunctionIR(lambdaIr));
 
         for (const auto& captureName : captureNames) {
             const auto localIt = locals.find(captureName);
@@ -2594,6 +2925,32 @@ void compileStatements(const std::vector<Stmt>& statements,
                        LoopContext* loopContext,
                        std::unordered_map<std::string, std::size_t>& constTempSlots,
                        const std::unordered_map<std::string, std::size_t>* captureIndexByName) {
+    // Claims the loop's accumulation sites and seals their locals once before the loop.
+    // The loop's own iteration variables are rebound from outside on every pass, so they
+    // never qualify.
+    const auto sealLoopAccumulators = [&](const Stmt& loop, const Expr* condition) {
+        if (!g_session || !g_session->loopAccumulators) {
+            return;
+        }
+        auto& claimedSites = *g_session->loopAccumulators;
+        std::vector<std::size_t> sealedSlots;
+        for (const Stmt* site : LoopAccumulatorAnalysis().run(condition, loop.body)) {
+            const std::string& name = site->expr.name;
+            if (name == loop.iterKey || name == loop.iterValue ||
+                (captureIndexByName && captureIndexByName->contains(name))) {
+                continue;
+            }
+            const auto localIt = locals.find(name);
+            if (localIt == locals.end() || !claimedSites.insert(site).second) {
+                continue;
+            }
+            if (std::find(sealedSlots.begin(), sealedSlots.end(), localIt->second) == sealedSlots.end()) {
+                sealedSlots.push_back(localIt->second);
+                emit(out.code, OpCode::SealLocal, static_cast<std::int32_t>(localIt->second), 0);
+            }
+        }
+    };
+
     auto compileCallLikeExprWithLoweredArgs = [&](const Expr& expr) -> bool {
         if (expr.type == ExprType::Call) {
             if (!expr.callee) {
@@ -2603,7 +2960,25 @@ void compileStatements(const std::vector<Stmt>& statements,
                                                              expr.column));
             }
 
-            if (expr.callee->type == ExprType::Variable) {
+            const auto isBuiltinName = [&](const std::string& name) {
+                return !locals.contains(name) && !(captureIndexByName && captureIndexByName->contains(name)) &&
+                       !isGlobalSymbolName(module, funcIndex, classIndex, name);
+            };
+            const bool argsFrameScoped = expr.callee->type == ExprType::Variable &&
+                                         isNonRetainingBuiltin(expr.callee->name) &&
+                                         isBuiltinName(expr.callee->name);
+
+            const bool hostCall = expr.callee->type == ExprType::Variable &&
+                                  isHostCallTarget(expr.callee->name,
+                                                   module,
+                                                   locals,
+                                                   funcIndex,
+                                                   classIndex,
+                                                   captureIndexByName);
+
+            if (hostCall) {
+                // The callee is named by CallHost itself.
+            } else if (expr.callee->type == ExprType::Variable) {
                 const std::string& calleeName = expr.callee->name;
                 if (captureIndexByName && captureIndexByName->contains(calleeName)) {
                     emit(out.code,
@@ -2617,10 +2992,13 @@ void compileStatements(const std::vector<Stmt>& statements,
                                                                       classIndex,
                                                                       calleeName);
 
-                    if (!resolved.found) {
-                        emit(out.code, OpCode::LoadName, addString(module, calleeName), 0);
-                    } else {
+                    std::int32_t importSlot = -1;
+                    if (resolved.found) {
                         emitLocalValueToStack(out.code, resolved.localSlot);
+                    } else if (tryResolveImportedName(calleeName, locals, captureIndexByName, importSlot)) {
+                        emit(out.code, OpCode::LoadImport, importSlot, 0);
+                    } else {
+                        emit(out.code, OpCode::LoadName, addString(module, calleeName), 0);
                     }
                 }
             } else {
@@ -2635,6 +3013,7 @@ void compileStatements(const std::vector<Stmt>& statements,
             }
 
             for (const auto& arg : expr.args) {
+                const std::size_t argBegin = out.code.size();
                 if (tryLowerBinaryExprToRegWithTempLocals(arg,
                                                           module,
                                                           locals,
@@ -2655,9 +3034,21 @@ void compileStatements(const std::vector<Stmt>& statements,
                                 out.code,
                                 captureIndexByName);
                 }
+                // print("n=" + str(n)): the argument dies with the call.
+                if (argsFrameScoped && arg.type != ExprType::Lambda &&
+                    isFrameScopedAllocExpr(arg, isBuiltinName)) {
+                    markNonEscapingAllocSite(out, argBegin);
+                }
             }
 
-            emit(out.code, OpCode::CallValue, static_cast<std::int32_t>(expr.args.size()), 0);
+            if (hostCall) {
+                emit(out.code,
+                     OpCode::CallHost,
+                     addString(module, expr.callee->name),
+                     static_cast<std::int32_t>(expr.args.size()));
+            } else {
+                emit(out.code, OpCode::CallValue, static_cast<std::int32_t>(expr.args.size()), 0);
+            }
             return true;
         }
 
@@ -2669,14 +3060,21 @@ void compileStatements(const std::vector<Stmt>& statements,
                                                              expr.column));
             }
 
-            compileExpr(*expr.object,
-                        module,
-                        locals,
-                        funcIndex,
-                        classIndex,
-                        currentFunctionName,
-                        out.code,
-                        captureIndexByName);
+            std::int32_t importSlot = -1;
+            const bool importCall =
+                tryResolveImportMember(*expr.object, expr.methodName, module, locals, captureIndexByName, importSlot);
+            if (importCall) {
+                emit(out.code, OpCode::LoadImport, importSlot, 0);
+            } else {
+                compileExpr(*expr.object,
+                            module,
+                            locals,
+                            funcIndex,
+                            classIndex,
+                            currentFunctionName,
+                            out.code,
+                            captureIndexByName);
+            }
 
             for (const auto& arg : expr.args) {
                 if (tryLowerBinaryExprToRegWithTempLocals(arg,
@@ -2701,10 +3099,14 @@ void compileStatements(const std::vector<Stmt>& statements,
                 }
             }
 
-            emit(out.code,
-                 OpCode::CallMethod,
-                 addString(module, expr.methodName),
-                 static_cast<std::int32_t>(expr.args.size()));
+            if (importCall) {
+                emit(out.code, OpCode::CallValue, static_cast<std::int32_t>(expr.args.size()), 0);
+            } else {
+                emit(out.code,
+                     OpCode::CallMethod,
+                     addString(module, expr.methodName),
+                     static_cast<std::int32_t>(expr.args.size()));
+            }
             return true;
         }
 
@@ -2797,6 +3199,7 @@ void compileStatements(const std::vector<Stmt>& statements,
 
         switch (stmt.type) {
         case StmtType::LetExpr: {
+            const std::size_t siteBegin = out.code.size();
             const bool loweredBinaryToReg = tryLowerBinaryExprToRegWithTempLocals(stmt.expr,
                                                                                    module,
                                                                                    locals,
@@ -2854,22 +3257,59 @@ void compileStatements(const std::vector<Stmt>& statements,
                     compileExpr(stmt.expr, module, locals, funcIndex, classIndex, currentFunctionName, out.code, captureIndexByName);
                     emit(out.code, OpCode::StoreLocal, static_cast<std::int32_t>(slot));
                 }
+                if (g_session && g_session->frameScopedLets && g_session->frameScopedLets->contains(&stmt)) {
+                    markNonEscapingAllocSite(out, siteBegin);
+                }
             }
             break;
         }
-        case StmtType::LetSpawn: {
-            throwCompilerError(formatCompilerError("'spawn' is temporarily disabled. Coroutine features are not enabled.",
-                                                         currentFunctionName,
-                                                         stmt.line,
-                                                         stmt.column));
-        }
+        case StmtType::LetSpawn:
         case StmtType::LetAwait: {
-            throwCompilerError(formatCompilerError("'await' is temporarily disabled. Coroutine features are not enabled.",
+            if (isModuleInit) {
+                throwCompilerError(formatCompilerError(std::string(stmt.type == StmtType::LetSpawn ? "'spawn'" : "'await'") +
+                                                             " is only supported inside functions",
                                                          currentFunctionName,
                                                          stmt.line,
                                                          stmt.column));
+            }
+            if (stmt.type == StmtType::LetSpawn) {
+                // The task runs `callee` by name in a context of its own, so only module-level
+                // functions can be spawned.
+                const auto calleeIt = funcIndex.find(stmt.call.callee);
+                if (calleeIt == funcIndex.end()) {
+                    throwCompilerError(formatCompilerError("spawn target must be a module function: " + stmt.call.callee,
+                                                                 currentFunctionName,
+                                                                 stmt.line,
+                                                                 stmt.column));
+                }
+                for (const auto& arg : stmt.call.args) {
+                    compileExpr(arg, module, locals, funcIndex, classIndex, currentFunctionName, out.code, captureIndexByName);
+                }
+                emit(out.code,
+                     OpCode::SpawnFunc,
+                     static_cast<std::int32_t>(calleeIt->second),
+                     static_cast<std::int32_t>(stmt.call.args.size()));
+            } else {
+                Expr source;
+                source.type = ExprType::Variable;
+                source.line = stmt.line;
+                source.column = stmt.column;
+                source.name = stmt.awaitSource;
+                compileExpr(source, module, locals, funcIndex, classIndex, currentFunctionName, out.code, captureIndexByName);
+                emit(out.code, OpCode::Await);
+            }
+            if (locals.contains(stmt.name)) {
+                throwCompilerError(formatCompilerError("Duplicate let declaration in scope: " + stmt.name,
+                                                             currentFunctionName,
+                                                             stmt.line,
+                                                             stmt.column));
+            }
+            const auto slot = ensureLocal(locals, out.localCount, stmt.name, &out);
+            emit(out.code, OpCode::StoreLocal, static_cast<std::int32_t>(slot));
+            break;
         }
         case StmtType::ForRange: {
+            sealLoopAccumulators(stmt, nullptr);
             const auto iterSlot = ensureLocal(locals, out.localCount, stmt.iterKey, &out);
             const auto endSlot = ensureLocal(locals, out.localCount, "__for_end_" + stmt.iterKey + std::to_string(out.code.size()), &out);
             const auto oneSlot = ensureConstTempLocalSlot(Value::Int(1),
@@ -2930,6 +3370,7 @@ void compileStatements(const std::vector<Stmt>& statements,
             break;
         }
         case StmtType::ForList: {
+            sealLoopAccumulators(stmt, nullptr);
             const auto itemSlot = ensureLocal(locals, out.localCount, stmt.iterKey, &out);
             const auto listSlot = ensureLocal(locals, out.localCount, "__for_list_" + stmt.iterKey + std::to_string(out.code.size()), &out);
             const auto indexSlot = ensureLocal(locals, out.localCount, "__for_idx_" + stmt.iterKey + std::to_string(out.code.size()), &out);
@@ -3003,6 +3444,7 @@ void compileStatements(const std::vector<Stmt>& statements,
             break;
         }
         case StmtType::ForDict: {
+            sealLoopAccumulators(stmt, nullptr);
             const auto keySlot = ensureLocal(locals, out.localCount, stmt.iterKey, &out);
             const auto valueSlot = ensureLocal(locals, out.localCount, stmt.iterValue, &out);
             const auto dictSlot = ensureLocal(locals, out.localCount, "__for_dict_" + stmt.iterKey + std::to_string(out.code.size()), &out);
@@ -3121,6 +3563,7 @@ void compileStatements(const std::vector<Stmt>& statements,
             break;
         }
         case StmtType::While: {
+            sealLoopAccumulators(stmt, &stmt.condition);
             LoopContext localLoop;
             const std::size_t loopStart = out.code.size();
             localLoop.continueTarget = loopStart;
@@ -3291,6 +3734,20 @@ void compileStatements(const std::vector<Stmt>& statements,
                 }
             };
 
+            if (g_session && g_session->loopAccumulators && g_session->loopAccumulators->contains(&stmt)) {
+                compileExpr(*stmt.expr.right->right,
+                            module,
+                            locals,
+                            funcIndex,
+                            classIndex,
+                            currentFunctionName,
+                            out.code,
+                            captureIndexByName);
+                emit(out.code, OpCode::AppendLocal, static_cast<std::int32_t>(locals.at(stmt.expr.name)), 0);
+                annotateExprStmtLines();
+                break;
+            }
+
             if (stmt.expr.type == ExprType::AssignVariable && stmt.expr.right) {
                 const bool loweredAssignRhs = tryLowerBinaryExprToRegWithTempLocals(*stmt.expr.right,
                                                                                      module,
@@ -3322,6 +3779,7 @@ void compileStatements(const std::vector<Stmt>& statements,
                              static_cast<std::int32_t>(resolved.localSlot),
                              0);
                     } else {
+                        rejectImportBindingStore(stmt.expr.name, currentFunctionName, stmt.line, stmt.column);
                         emit(out.code, OpCode::StoreNameFromReg, addString(module, stmt.expr.name), 0);
                     }
                     annotateExprStmtLines();
@@ -3457,46 +3915,273 @@ void compileStatements(const std::vector<Stmt>& statements,
             } else {
                 compileExpr(stmt.expr, module, locals, funcIndex, classIndex, currentFunctionName, out.code, captureIndexByName);
             }
-            emit(out.code, OpCode::Return);
-            break;
-        case StmtType::Sleep:
-            throwCompilerError(formatCompilerError("'sleep' is temporarily disabled. Coroutine features are not enabled.",
-                                                         currentFunctionName,
-                                                         stmt.line,
-                                                         stmt.column));
-        case StmtType::Yield:
-            throwCompilerError(formatCompilerError("'yield' is temporarily disabled. Coroutine features are not enabled.",
-                                                         currentFunctionName,
-                                                         stmt.line,
-                                                         stmt.column));
+            emit(out.code, OpCode::Return);
+            break;
+        case StmtType::Sleep:
+            throwCompilerError(formatCompilerError("'sleep' is temporarily disabled. Coroutine features are not enabled.",
+                                                         currentFunctionName,
+                                                         stmt.line,
+                                                         stmt.column));
+        case StmtType::Yield:
+            throwCompilerError(formatCompilerError("'yield' is temporarily disabled. Coroutine features are not enabled.",
+                                                         currentFunctionName,
+                                                         stmt.line,
+                                                         stmt.column));
+        }
+
+        annotateStmtLines();
+    }
+}
+
+} // namespace
+
+namespace {
+
+// Generates the body of a function or method whose stub (name, parameters) the declaration
+// pass of compileProgram() created as `out`.
+void compileFunctionBody(const FunctionDecl& decl,
+                         const std::string& scopeName,
+                         FunctionBytecode& out,
+                         Module& module,
+                         const std::unordered_map<std::string, std::size_t>& funcIndex,
+                         const std::unordered_map<std::string, std::size_t>& classIndex) {
+    validateScopeLocalRules(decl.body, out.params, scopeName);
+    FunctionIR functionIr;
+    functionIr.name = out.name;
+    functionIr.params = out.params;
+    functionIr.paramTypeNames = out.paramTypeNames;
+    functionIr.localCount = out.params.size();
+    std::unordered_map<std::string, std::size_t> locals;
+    for (std::size_t i = 0; i < functionIr.params.size(); ++i) {
+        locals[functionIr.params[i]] = i;
+    }
+    functionIr.localDebugNames = functionIr.params;
+    functionIr.localTypeNames = functionIr.paramTypeNames;
+    if (functionIr.localTypeNames.size() < functionIr.localCount) {
+        functionIr.localTypeNames.resize(functionIr.localCount);
+    }
+    std::unordered_map<std::string, std::size_t> constTempSlots;
+    const auto frameScopedLets =
+        FrameScopedLetAnalysis(module, funcIndex, classIndex, nullptr).run(decl.body, decl.params);
+    FrameScopedLetsGuard frameScopedGuard(&frameScopedLets);
+    LoopAccumulatorScope loopAccumulatorScope;
+    compileStatements(decl.body,
+                      module,
+                      locals,
+                      funcIndex,
+                      classIndex,
+                      scopeName,
+                      false,
+                      functionIr,
+                      nullptr,
+                      constTempSlots);
+
+    if (functionIr.code.empty() || functionIr.code.back().op != OpCode::Return) {
+        emit(functionIr.code, OpCode::PushConst, addConstant(module, Value::Nil()));
+        emit(functionIr.code, OpCode::Return);
+    }
+
+    activeSession().functionIrs->push_back(functionIr);
+    installFunctionBody(out, lowerFunctionIR(functionIr));
+}
+
+// What the deferred bodies of one module share: the parsed program their declarations live in
+// and the session built by the declaration pass. Lambdas compiled later extend the session, so
+// bodies compile one at a time under `mutex`. A hot reload adds a unit for the new revision to
+// the same module; it shares the module's mutex, because both append to the module's tables.
+struct DeferredCompileUnit {
+    std::shared_ptr<const Program> program;
+    CompileSession session;
+    std::vector<FunctionIR> functionIrs;
+    std::shared_ptr<std::mutex> mutex = std::make_shared<std::mutex>();
+};
+
+// A function or method body compiled on its first call. A compile error is kept and rethrown
+// by every later call instead of compiling the body again.
+class DeferredFunctionBody final : public LazyFunctionBody {
+public:
+    DeferredFunctionBody(std::shared_ptr<DeferredCompileUnit> unit, const FunctionDecl& decl, std::string scopeName)
+        : unit_(std::move(unit)), decl_(decl), scopeName_(std::move(scopeName)) {}
+
+    std::mutex& mutex() const override {
+        return *unit_->mutex;
+    }
+
+    const std::shared_ptr<DeferredCompileUnit>& unit() const {
+        return unit_;
+    }
+
+    void materialize(Module& module, FunctionBytecode& fn) const override {
+        if (!error_.empty()) {
+            throwCompilerError(error_);
+        }
+        CompileSessionScope sessionScope(unit_->session);
+        try {
+            compileFunctionBody(decl_, scopeName_, fn, module, unit_->session.funcIndex, unit_->session.classIndex);
+        } catch (const std::exception& ex) {
+            error_ = attachSourceFileToDiagnostic(module.sourcePath, ex.what());
+            unit_->functionIrs.clear();
+            throwCompilerError(error_);
+        }
+        unit_->functionIrs.clear();
+    }
+
+private:
+    std::shared_ptr<DeferredCompileUnit> unit_;
+    const FunctionDecl& decl_;
+    std::string scopeName_;
+    mutable std::string error_;
+};
+
+void deferFunctionBody(const std::shared_ptr<DeferredCompileUnit>& unit,
+                       const FunctionDecl& decl,
+                       const std::string& scopeName,
+                       FunctionBytecode& out) {
+    out.lazyBody = std::make_shared<DeferredFunctionBody>(unit, decl, scopeName);
+    out.bodyReady.set(false);
+}
+
+// The stub of a function or method: name, parameters and fingerprint, without a body.
+FunctionBytecode declareFunction(const FunctionDecl& decl, const std::string& name) {
+    FunctionBytecode compiled;
+    compiled.name = name;
+    compiled.params = decl.params;
+    compiled.paramTypeNames = decl.paramTypeNames;
+    if (compiled.paramTypeNames.size() < compiled.params.size()) {
+        compiled.paramTypeNames.resize(compiled.params.size());
+    }
+    for (auto& typeName : compiled.paramTypeNames) {
+        typeName = normalizeTypeAnnotationName(typeName);
+    }
+    compiled.localCount = decl.params.size();
+    compiled.localTypeNames.assign(compiled.localCount, "");
+    compiled.sourceFingerprint = decl.fingerprint;
+    return compiled;
+}
+
+// The Module::imports entries of `program`, in declaration order.
+std::vector<ModuleImport> importEntriesOf(const Program& program, std::vector<const ImportDecl*>* origins = nullptr) {
+    std::vector<ModuleImport> entries;
+    auto add = [&](const ImportDecl& decl, ModuleImport entry) {
+        entries.push_back(std::move(entry));
+        if (origins) {
+            origins->push_back(&decl);
+        }
+    };
+    for (const auto& decl : program.imports) {
+        if (decl.names.empty()) {
+            add(decl, {decl.moduleSpec, decl.alias.empty() ? defaultModuleAlias(decl.moduleSpec) : decl.alias, {}, false});
+        } else if (decl.names.size() > 1 && !decl.alias.empty()) {
+            add(decl, {decl.moduleSpec, decl.alias, decl.names, false});
+        } else {
+            for (const auto& name : decl.names) {
+                add(decl, {decl.moduleSpec, decl.alias.empty() ? name : decl.alias, {name}, true});
+            }
+        }
+    }
+    return entries;
+}
+
+// Binds the session's import names to `module.imports`: module aliases to their entry and
+// `from`-imported names to their import symbol slot.
+void bindImportNames(CompileSession& session, Module& module) {
+    for (std::size_t i = 0; i < module.imports.size(); ++i) {
+        const auto& entry = module.imports[i];
+        if (entry.bindsSymbol) {
+            session.importedNames[entry.localName] =
+                static_cast<std::size_t>(importSymbolSlot(module, i, entry.symbols.front()));
+        } else {
+            session.importAliases[entry.localName] = i;
+        }
+    }
+}
+
+// Compiles the top-level statements of `program` into a __module_init__ body.
+FunctionBytecode compileModuleInit(const Program& program,
+                                   Module& module,
+                                   const std::unordered_map<std::string, std::size_t>& funcIndex,
+                                   const std::unordered_map<std::string, std::size_t>& classIndex) {
+    const std::string moduleInitName = "__module_init__";
+    std::size_t moduleInitAnchorLine = 0;
+    std::size_t moduleInitAnchorColumn = 0;
+    for (const auto& stmt : program.topLevelStatements) {
+        if (stmt.line > 0) {
+            moduleInitAnchorLine = stmt.line;
+            moduleInitAnchorColumn = stmt.column;
+            break;
+        }
+    }
+    if (moduleInitAnchorLine == 0) {
+        for (const auto& fn : program.functions) {
+            if (fn.line > 0) {
+                moduleInitAnchorLine = fn.line;
+                moduleInitAnchorColumn = fn.column;
+                break;
+            }
+        }
+    }
+    if (moduleInitAnchorLine == 0) {
+        for (const auto& cls : program.classes) {
+            if (cls.line > 0) {
+                moduleInitAnchorLine = cls.line;
+                moduleInitAnchorColumn = cls.column;
+                break;
+            }
         }
+    }
+    if (moduleInitAnchorLine == 0) {
+        moduleInitAnchorLine = 1;
+    }
+    if (moduleInitAnchorColumn == 0) {
+        moduleInitAnchorColumn = 1;
+    }
 
-        annotateStmtLines();
+    validateScopeLocalRules(program.topLevelStatements, {}, moduleInitName);
+    FunctionIR functionIr;
+    functionIr.name = moduleInitName;
+    std::unordered_map<std::string, std::size_t> locals;
+    std::unordered_map<std::string, std::size_t> constTempSlots;
+    compileStatements(program.topLevelStatements,
+                      module,
+                      locals,
+                      funcIndex,
+                      classIndex,
+                      moduleInitName,
+                      true,
+                      functionIr,
+                      nullptr,
+                      constTempSlots);
+    if (functionIr.code.empty() || functionIr.code.back().op != OpCode::Return) {
+        emit(functionIr.code,
+             OpCode::PushConst,
+             addConstant(module, Value::Nil()),
+             0,
+             moduleInitAnchorLine,
+             moduleInitAnchorColumn);
+        emit(functionIr.code, OpCode::Return, 0, 0, moduleInitAnchorLine, moduleInitAnchorColumn);
     }
+    activeSession().functionIrs->push_back(functionIr);
+    return lowerFunctionIR(functionIr);
 }
 
-} // namespace
-
-Module Compiler::compile(const Program& program) {
-    lastFunctionIR_.clear();
+// Declares every function, method and class of `program`, compiles class attributes and
+// __module_init__, then compiles each function and method body now or, when `deferred` holds the
+// program, attaches a DeferredFunctionBody that compiles it on its first call.
+Module compileProgram(const Program& program,
+                      std::shared_ptr<const Program> deferred,
+                      std::vector<FunctionIR>& functionIrs) {
     Module module;
-    std::unordered_map<std::string, std::size_t> funcIndex;
-    std::unordered_map<std::string, std::size_t> classIndex;
-    std::size_t lambdaOrdinal = 0;
-    struct LambdaContextGuard {
-        std::unordered_map<std::string, std::size_t>* prevFuncIndex{nullptr};
-        std::size_t* prevLambdaOrdinal{nullptr};
-        std::vector<FunctionIR>* prevIrs{nullptr};
-        ~LambdaContextGuard() {
-            g_mutableFuncIndex = prevFuncIndex;
-            g_lambdaOrdinal = prevLambdaOrdinal;
-            g_allFunctionIrs = prevIrs;
-        }
-    } guard{g_mutableFuncIndex, g_lambdaOrdinal, g_allFunctionIrs};
-
-    g_mutableFuncIndex = &funcIndex;
-    g_lambdaOrdinal = &lambdaOrdinal;
-    g_allFunctionIrs = &lastFunctionIR_;
+    std::shared_ptr<DeferredCompileUnit> unit;
+    CompileSession eagerSession;
+    if (deferred) {
+        unit = std::make_shared<DeferredCompileUnit>();
+        unit->program = std::move(deferred);
+    }
+    CompileSession& session = unit ? unit->session : eagerSession;
+    session.functionIrs = &functionIrs;
+    CompileSessionScope sessionScope(session);
+    auto& funcIndex = session.funcIndex;
+    auto& classIndex = session.classIndex;
 
     for (const auto& cls : program.classes) {
         if (classIndex.contains(cls.name)) {
@@ -3518,21 +4203,8 @@ Module Compiler::compile(const Program& program) {
                                                          fn.line,
                                                          fn.column));
         }
-        FunctionBytecode compiled;
-        compiled.name = fn.name;
-        compiled.params = fn.params;
-        compiled.paramTypeNames = fn.paramTypeNames;
-        if (compiled.paramTypeNames.size() < compiled.params.size()) {
-            compiled.paramTypeNames.resize(compiled.params.size());
-        }
-        for (auto& typeName : compiled.paramTypeNames) {
-            typeName = normalizeTypeAnnotationName(typeName);
-        }
-        compiled.localCount = fn.params.size();
-        compiled.localTypeNames.assign(compiled.localCount, "");
-
         funcIndex[fn.name] = module.functions.size();
-        module.functions.push_back(std::move(compiled));
+        module.functions.push_back(declareFunction(fn, fn.name));
     }
 
     const std::string moduleInitName = "__module_init__";
@@ -3546,12 +4218,29 @@ Module Compiler::compile(const Program& program) {
     }
 
     std::unordered_set<std::string> declaredModuleGlobals;
+    // The import table: each binding becomes a module global that the runtime fills in before
+    // __module_init__ runs; `alias.member` and imported names compile to LoadImport slots.
+    std::vector<const ImportDecl*> importOrigins;
+    for (auto& entry : importEntriesOf(program, &importOrigins)) {
+        const ImportDecl& decl = *importOrigins[module.imports.size()];
+        if (funcIndex.contains(entry.localName) || classIndex.contains(entry.localName) ||
+            !declaredModuleGlobals.insert(entry.localName).second) {
+            throwCompilerError(formatCompilerError("Duplicate top-level symbol name: " + entry.localName,
+                                                   "<module>",
+                                                   decl.line,
+                                                   decl.column));
+        }
+        module.globals.push_back({entry.localName, Value::Nil(), ""});
+        module.imports.push_back(std::move(entry));
+    }
+    bindImportNames(session, module);
+
     for (const auto& stmt : program.topLevelStatements) {
         if (stmt.type != StmtType::LetExpr) {
             continue;
         }
 
-        if (funcIndex.contains(stmt.name) || classIndex.contains(stmt.name)) {
+        if (funcIndex.contains(stmt.name) || classIndex.contains(stmt.name) || isImportBinding(stmt.name)) {
             throwCompilerError(formatCompilerError("Duplicate top-level symbol name: " + stmt.name,
                                                          "<module>",
                                                          stmt.line,
@@ -3564,40 +4253,6 @@ Module Compiler::compile(const Program& program) {
         }
     }
 
-    std::size_t moduleInitAnchorLine = 0;
-    std::size_t moduleInitAnchorColumn = 0;
-    for (const auto& stmt : program.topLevelStatements) {
-        if (stmt.line > 0) {
-            moduleInitAnchorLine = stmt.line;
-            moduleInitAnchorColumn = stmt.column;
-            break;
-        }
-    }
-    if (moduleInitAnchorLine == 0) {
-        for (const auto& fn : program.functions) {
-            if (fn.line > 0) {
-                moduleInitAnchorLine = fn.line;
-                moduleInitAnchorColumn = fn.column;
-                break;
-            }
-        }
-    }
-    if (moduleInitAnchorLine == 0) {
-        for (const auto& cls : program.classes) {
-            if (cls.line > 0) {
-                moduleInitAnchorLine = cls.line;
-                moduleInitAnchorColumn = cls.column;
-                break;
-            }
-        }
-    }
-    if (moduleInitAnchorLine == 0) {
-        moduleInitAnchorLine = 1;
-    }
-    if (moduleInitAnchorColumn == 0) {
-        moduleInitAnchorColumn = 1;
-    }
-
     for (const auto& cls : program.classes) {
         auto& classBc = module.classes[classIndex.at(cls.name)];
         if (!cls.baseName.empty()) {
@@ -3638,21 +4293,9 @@ Module Compiler::compile(const Program& program) {
                                                              method.line,
                                                              method.column));
             }
-            FunctionBytecode compiled;
-            compiled.name = mangled;
-            compiled.params = method.params;
-            compiled.paramTypeNames = method.paramTypeNames;
-            if (compiled.paramTypeNames.size() < compiled.params.size()) {
-                compiled.paramTypeNames.resize(compiled.params.size());
-            }
-            for (auto& typeName : compiled.paramTypeNames) {
-                typeName = normalizeTypeAnnotationName(typeName);
-            }
-            compiled.localCount = method.params.size();
-            compiled.localTypeNames.assign(compiled.localCount, "");
             const std::size_t idx = module.functions.size();
             funcIndex[mangled] = idx;
-            module.functions.push_back(std::move(compiled));
+            module.functions.push_back(declareFunction(method, mangled));
             classBc.methods.push_back({method.name, idx});
         }
 
@@ -3665,130 +4308,285 @@ Module Compiler::compile(const Program& program) {
     }
 
     for (const auto& fn : program.functions) {
-        const std::size_t functionIndex = funcIndex.at(fn.name);
-        FunctionBytecode& out = module.functions[functionIndex];
-        validateScopeLocalRules(fn.body, out.params, fn.name);
-        FunctionIR functionIr;
-        functionIr.name = out.name;
-        functionIr.params = out.params;
-        functionIr.paramTypeNames = out.paramTypeNames;
-        functionIr.localCount = out.params.size();
-        std::unordered_map<std::string, std::size_t> locals;
-        for (std::size_t i = 0; i < functionIr.params.size(); ++i) {
-            locals[functionIr.params[i]] = i;
-        }
-        functionIr.localDebugNames = functionIr.params;
-        functionIr.localTypeNames = functionIr.paramTypeNames;
-        if (functionIr.localTypeNames.size() < functionIr.localCount) {
-            functionIr.localTypeNames.resize(functionIr.localCount);
-        }
-        std::unordered_map<std::string, std::size_t> constTempSlots;
-        compileStatements(fn.body,
-                          module,
-                          locals,
-                          funcIndex,
-                          classIndex,
-                          fn.name,
-                          false,
-                          functionIr,
-                          nullptr,
-                          constTempSlots);
-
-        if (functionIr.code.empty() || functionIr.code.back().op != OpCode::Return) {
-            emit(functionIr.code, OpCode::PushConst, addConstant(module, Value::Nil()));
-            emit(functionIr.code, OpCode::Return);
+        FunctionBytecode& out = module.functions[funcIndex.at(fn.name)];
+        if (unit) {
+            deferFunctionBody(unit, fn, fn.name, out);
+        } else {
+            compileFunctionBody(fn, fn.name, out, module, funcIndex, classIndex);
         }
-
-        lastFunctionIR_.push_back(functionIr);
-        module.functions[functionIndex] = lowerFunctionIR(functionIr);
     }
 
     for (const auto& cls : program.classes) {
         for (const auto& method : cls.methods) {
-            const std::string mangled = mangleMethodName(cls.name, method.name);
-            const std::size_t functionIndex = funcIndex.at(mangled);
-            FunctionBytecode& out = module.functions[functionIndex];
-            validateScopeLocalRules(method.body, out.params, cls.name + "::" + method.name);
-            FunctionIR functionIr;
-            functionIr.name = out.name;
-            functionIr.params = out.params;
-            functionIr.paramTypeNames = out.paramTypeNames;
-            functionIr.localCount = out.params.size();
-            std::unordered_map<std::string, std::size_t> locals;
-            for (std::size_t i = 0; i < functionIr.params.size(); ++i) {
-                locals[functionIr.params[i]] = i;
-            }
-            functionIr.localDebugNames = functionIr.params;
-            functionIr.localTypeNames = functionIr.paramTypeNames;
-            if (functionIr.localTypeNames.size() < functionIr.localCount) {
-                functionIr.localTypeNames.resize(functionIr.localCount);
-            }
-            std::unordered_map<std::string, std::size_t> constTempSlots;
-
-            compileStatements(method.body,
-                              module,
-                              locals,
-                              funcIndex,
-                              classIndex,
-                              cls.name + "::" + method.name,
-                              false,
-                              functionIr,
-                              nullptr,
-                              constTempSlots);
-
-            if (functionIr.code.empty() || functionIr.code.back().op != OpCode::Return) {
-                emit(functionIr.code, OpCode::PushConst, addConstant(module, Value::Nil()));
-                emit(functionIr.code, OpCode::Return);
+            FunctionBytecode& out = module.functions[funcIndex.at(mangleMethodName(cls.name, method.name))];
+            const std::string scopeName = cls.name + "::" + method.name;
+            if (unit) {
+                deferFunctionBody(unit, method, scopeName, out);
+            } else {
+                compileFunctionBody(method, scopeName, out, module, funcIndex, classIndex);
             }
+        }
+    }
+
+    module.functions[funcIndex.at(moduleInitName)] = compileModuleInit(program, module, funcIndex, classIndex);
+
+    if (unit) {
+        // Later bodies report their lambdas' IR to the unit, which discards it.
+        session.functionIrs = &unit->functionIrs;
+    }
+    return module;
+}
+
+
+bool sameClassLayout(const ClassBytecode& lhs, const ClassBytecode& rhs) {
+    if (lhs.attributes.size() != rhs.attributes.size() || lhs.methods.size() != rhs.methods.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.attributes.size(); ++i) {
+        const auto& a = lhs.attributes[i];
+        const auto& b = rhs.attributes[i];
+        if (a.name != b.name || a.declaredTypeName != b.declaredTypeName ||
+            a.defaultValue.valueType() != b.defaultValue.valueType() ||
+            a.defaultValue.rawPayload() != b.defaultValue.rawPayload()) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < lhs.methods.size(); ++i) {
+        if (lhs.methods[i].name != rhs.methods[i].name ||
+            lhs.methods[i].functionIndex != rhs.methods[i].functionIndex) {
+            return false;
+        }
+    }
+    return true;
+}
 
-            lastFunctionIR_.push_back(functionIr);
-            module.functions[functionIndex] = lowerFunctionIR(functionIr);
+std::string baseNameOf(const Module& module, const ClassBytecode& cls) {
+    if (cls.baseClassIndex >= 0) {
+        return module.classes.at(static_cast<std::size_t>(cls.baseClassIndex)).name;
+    }
+    return cls.baseNativeTypeName;
+}
+
+// The mutex that serializes appends to `module`: the one its deferred bodies already use, or a
+// new one when nothing in it is compiled lazily.
+std::shared_ptr<std::mutex> moduleAppendMutex(const Module& module) {
+    for (const auto& fn : module.functions) {
+        if (const auto* body = dynamic_cast<const DeferredFunctionBody*>(fn.lazyBody.get())) {
+            return body->unit()->mutex;
         }
     }
+    return std::make_shared<std::mutex>();
+}
 
+// Applies `program`, a new revision of the source `live` was compiled from, to `live` in place.
+// Functions and methods whose fingerprint changed, and new ones, are appended with a deferred
+// body and the old entry is linked to them (FunctionBytecode::replacedBy), so frames already
+// running keep their code and every new call compiles and runs the new one. Classes whose
+// attribute or method list changed get a new version the same way; globals and classes are only
+// ever added. Unchanged functions are not touched, so the cost after parsing is a declaration
+// pass plus the new __module_init__.
+ModulePatchResult patchModule(Module& live, const std::shared_ptr<const Program>& program) {
+    ModulePatchResult result;
+    const Program& revision = *program;
+
+    // Report compile errors (duplicates, bad class declarations, module-level code) before
+    // touching the live module: a scratch declaration pass fails exactly where a load would.
     {
-        const std::size_t functionIndex = funcIndex.at(moduleInitName);
-        FunctionBytecode& out = module.functions[functionIndex];
-        validateScopeLocalRules(program.topLevelStatements, {}, moduleInitName);
-        FunctionIR functionIr;
-        functionIr.name = out.name;
-        functionIr.params = out.params;
-        functionIr.paramTypeNames = out.paramTypeNames;
-        functionIr.localCount = out.localCount;
-        functionIr.localTypeNames = out.localTypeNames;
-        std::unordered_map<std::string, std::size_t> locals;
-        std::unordered_map<std::string, std::size_t> constTempSlots;
-        compileStatements(program.topLevelStatements,
-                          module,
-                          locals,
-                          funcIndex,
-                          classIndex,
-                          moduleInitName,
-                          true,
-                          functionIr,
-                  nullptr,
-                  constTempSlots);
-        if (functionIr.code.empty() || functionIr.code.back().op != OpCode::Return) {
-              emit(functionIr.code,
-                  OpCode::PushConst,
-                  addConstant(module, Value::Nil()),
-                  0,
-                  moduleInitAnchorLine,
-                  moduleInitAnchorColumn);
-              emit(functionIr.code,
-                  OpCode::Return,
-                  0,
-                  0,
-                  moduleInitAnchorLine,
-                  moduleInitAnchorColumn);
+        Compiler scratch;
+        (void)scratch.compileLazy(program);
+    }
+
+    // The first entry of a name is its identity; later entries are versions of it.
+    std::unordered_map<std::string, std::size_t> liveFunctions;
+    std::unordered_map<std::string, std::size_t> liveClasses;
+    std::unordered_set<std::string> liveGlobals;
+    for (std::size_t i = 0; i < live.functions.size(); ++i) {
+        liveFunctions.try_emplace(live.functions[i].name, i);
+    }
+    for (std::size_t i = 0; i < live.classes.size(); ++i) {
+        liveClasses.try_emplace(live.classes[i].name, i);
+    }
+    for (const auto& global : live.globals) {
+        liveGlobals.insert(global.name);
+    }
+
+    auto refuse = [&result](std::string reason) {
+        result.reason = std::move(reason);
+        return result;
+    };
+    const auto revisionImports = importEntriesOf(revision);
+    if (revisionImports.size() != live.imports.size() ||
+        !std::equal(revisionImports.begin(), revisionImports.end(), live.imports.begin(), [](const auto& a, const auto& b) {
+            return a.moduleSpec == b.moduleSpec && a.localName == b.localName && a.symbols == b.symbols &&
+                   a.bindsSymbol == b.bindsSymbol;
+        })) {
+        return refuse("the import list changed");
+    }
+    for (const auto& fn : revision.functions) {
+        auto it = liveFunctions.find(fn.name);
+        if (it != liveFunctions.end() && live.functions[it->second].sourceFingerprint == 0) {
+            return refuse("the module was not compiled from source");
+        }
+        if (liveClasses.contains(fn.name) || liveGlobals.contains(fn.name)) {
+            return refuse("'" + fn.name + "' is no longer a function");
+        }
+    }
+    for (const auto& cls : revision.classes) {
+        auto it = liveClasses.find(cls.name);
+        if (liveFunctions.contains(cls.name) || liveGlobals.contains(cls.name)) {
+            return refuse("'" + cls.name + "' is no longer a class");
+        }
+        if (it != liveClasses.end() && baseNameOf(live, live.classes[it->second]) != cls.baseName) {
+            return refuse("the base of class '" + cls.name + "' changed");
+        }
+    }
+    for (const auto& stmt : revision.topLevelStatements) {
+        if (stmt.type == StmtType::LetExpr && (liveFunctions.contains(stmt.name) || liveClasses.contains(stmt.name))) {
+            return refuse("'" + stmt.name + "' is no longer a global");
+        }
+    }
+
+    const std::shared_ptr<std::mutex> appendMutex = moduleAppendMutex(live);
+    std::scoped_lock lock(*appendMutex);
+    auto unit = std::make_shared<DeferredCompileUnit>();
+    unit->program = program;
+    unit->mutex = appendMutex;
+    CompileSession& session = unit->session;
+    session.funcIndex = liveFunctions;
+    session.classIndex = liveClasses;
+    session.lambdaOrdinal = live.functions.size();
+    session.functionIrs = &unit->functionIrs;
+    CompileSessionScope sessionScope(session);
+    bindImportNames(session, live);
+
+    // Classes added by this revision are appended after every existing entry, in source order.
+    std::size_t nextClassIndex = live.classes.size();
+    for (const auto& cls : revision.classes) {
+        if (!liveClasses.contains(cls.name)) {
+            session.classIndex[cls.name] = nextClassIndex++;
+        }
+    }
+
+    // Returns the identity index of the function `name` after the patch.
+    auto patchFunction = [&](const FunctionDecl& decl, const std::string& name, const std::string& scopeName) {
+        auto it = liveFunctions.find(name);
+        std::size_t current = 0;
+        if (it != liveFunctions.end()) {
+            current = currentFunctionIndex(live, it->second);
+            if (live.functions[current].sourceFingerprint == decl.fingerprint) {
+                return it->second;
+            }
+        }
+        FunctionBytecode stub = declareFunction(decl, name);
+        deferFunctionBody(unit, decl, scopeName, stub);
+        const std::size_t index = live.functions.size();
+        live.functions.push_back(std::move(stub));
+        if (it == liveFunctions.end()) {
+            session.funcIndex[name] = index;
+            ++result.functionsAdded;
+            return index;
+        }
+        live.functions[current].replacedBy.set(index);
+        ++result.functionsReplaced;
+        return it->second;
+    };
+
+    for (const auto& fn : revision.functions) {
+        patchFunction(fn, fn.name, fn.name);
+    }
+    std::vector<std::vector<ClassMethodBinding>> classMethods;
+    for (const auto& cls : revision.classes) {
+        auto& methods = classMethods.emplace_back();
+        for (const auto& method : cls.methods) {
+            methods.push_back({method.name,
+                               patchFunction(method, mangleMethodName(cls.name, method.name), cls.name + "::" + method.name)});
         }
-        lastFunctionIR_.push_back(functionIr);
-        module.functions[functionIndex] = lowerFunctionIR(functionIr);
     }
 
-    return module;
+    for (const auto& stmt : revision.topLevelStatements) {
+        if (stmt.type == StmtType::LetExpr && liveGlobals.insert(stmt.name).second) {
+            live.globals.push_back({stmt.name, Value::Nil(), normalizeTypeAnnotationName(stmt.declaredTypeName)});
+            ++result.globalsAdded;
+        }
+    }
+
+    // New classes first, so their indices match the ones reserved above; then new versions.
+    std::vector<std::pair<std::size_t, ClassBytecode>> reshaped;
+    for (std::size_t c = 0; c < revision.classes.size(); ++c) {
+        const auto& cls = revision.classes[c];
+        ClassBytecode classBc;
+        classBc.name = cls.name;
+        if (!cls.baseName.empty()) {
+            auto it = session.classIndex.find(cls.baseName);
+            if (it != session.classIndex.end()) {
+                classBc.baseClassIndex = static_cast<std::int32_t>(it->second);
+            } else {
+                classBc.baseNativeTypeName = cls.baseName;
+            }
+        }
+        for (const auto& attr : cls.attributes) {
+            classBc.attributes.push_back(
+                {attr.name,
+                 evalClassFieldInit(attr.initializer, live, session.funcIndex, session.classIndex, cls.name + "::<attr>"),
+                 normalizeTypeAnnotationName(attr.declaredTypeName)});
+        }
+        classBc.methods = std::move(classMethods[c]);
+
+        auto it = liveClasses.find(cls.name);
+        if (it == liveClasses.end()) {
+            live.classes.push_back(std::move(classBc));
+            ++result.classesAdded;
+            continue;
+        }
+        const ClassBytecode& current = currentClass(live, it->second);
+        if (sameClassLayout(current, classBc)) {
+            continue;
+        }
+        for (const auto& attr : current.attributes) {
+            if (std::none_of(classBc.attributes.begin(), classBc.attributes.end(), [&](const auto& kept) {
+                    return kept.name == attr.name;
+                })) {
+                classBc.retiredAttributes.push_back(attr.name);
+            }
+        }
+        reshaped.emplace_back(it->second, std::move(classBc));
+    }
+    for (auto& [identity, version] : reshaped) {
+        const ClassBytecode& current = currentClass(live, identity);
+        const std::size_t index = live.classes.size();
+        live.classes.push_back(std::move(version));
+        current.replacedBy.set(index);
+        ++result.classesReshaped;
+    }
+
+    // New contexts initialize the module with the new top-level code; contexts that already ran
+    // __module_init__ keep their globals.
+    const std::size_t moduleInit = liveFunctions.at("__module_init__");
+    FunctionBytecode init = compileModuleInit(revision, live, session.funcIndex, session.classIndex);
+    const std::size_t currentInit = currentFunctionIndex(live, moduleInit);
+    live.functions.push_back(std::move(init));
+    live.functions[currentInit].replacedBy.set(live.functions.size() - 1);
+
+    // Later bodies report their lambdas' IR to the unit, which discards it.
+    unit->functionIrs.clear();
+    result.patched = true;
+    return result;
+}
+
+} // namespace
+
+Module Compiler::compile(const Program& program) {
+    lastFunctionIR_.clear();
+    return compileProgram(program, nullptr, lastFunctionIR_);
 }
 
+Module Compiler::compileLazy(std::shared_ptr<const Program> program) {
+    lastFunctionIR_.clear();
+    const Program& declarations = *program;
+    return compileProgram(declarations, std::move(program), lastFunctionIR_);
+}
+
+
 const std::vector<FunctionIR>& Compiler::lastFunctionIR() const {
     return lastFunctionIR_;
 }
@@ -3797,12 +4595,15 @@ Module compileSource(const std::string& source) {
     Tokenizer tokenizer(source);
     Parser parser(tokenizer.tokenize());
     Compiler compiler;
-    Module module = compiler.compile(parser.parseProgram());
+    Module module = g_lazyFunctionCompilationEnabled
+                        ? compiler.compileLazy(std::make_shared<const Program>(parser.parseProgram()))
+                        : compiler.compile(parser.parseProgram());
     module.sourcePath = "<memory>";
     return module;
 }
 
-void dumpTransformedSourceFile(const std::string& sourcePath, const std::string& transformedSource) {
+// Writes the source prefixed with the module's import table as `#` comments.
+void dumpTransformedSourceFile(const std::string& sourcePath, const std::string& source, const Module& module) {
     namespace fs = std::filesystem;
     fs::path outputPath(sourcePath);
     outputPath.replace_extension(".gst");
@@ -3811,7 +4612,24 @@ void dumpTransformedSourceFile(const std::string& sourcePath, const std::string&
     if (!output) {
         throwCompilerError("error: failed to dump transformed source to " + outputPath.string() + " [function: <module>]");
     }
-    output << transformedSource;
+    if (!module.imports.empty()) {
+        output << "# import table (linked before __module_init__)\n";
+        for (std::size_t i = 0; i < module.imports.size(); ++i) {
+            const auto& entry = module.imports[i];
+            output << "#   [" << i << "] " << entry.localName << " = " << entry.moduleSpec;
+            if (entry.bindsSymbol) {
+                output << "." << entry.symbols.front();
+            } else if (!entry.symbols.empty()) {
+                output << " {";
+                for (std::size_t k = 0; k < entry.symbols.size(); ++k) {
+                    output << (k ? ", " : "") << entry.symbols[k];
+                }
+                output << "}";
+            }
+            output << "\n";
+        }
+    }
+    output << source;
     if (!output) {
         throwCompilerError("error: failed to write transformed source to " + outputPath.string() + " [function: <module>]");
     }
@@ -3885,29 +4703,175 @@ std::string tryFillFunctionContext(const std::string& diagnostic, const std::str
 Module compileSourceFile(const std::string& path,
                          const std::vector<std::string>& searchPaths,
                          bool dumpTransformedSource) {
-    std::string mergedSource;
+    (void)searchPaths; // imports are resolved when the runtime links the module
+    std::string source;
     try {
-        std::unordered_map<std::string, ProcessedModule> cache;
-        std::unordered_set<std::string> visiting;
-        const auto processed = preprocessImportsRecursive(path, searchPaths, cache, visiting);
-        mergedSource = processed.source;
-        if (dumpTransformedSource) {
-            dumpTransformedSourceFile(path, mergedSource);
+        source = readFileText(path);
+        if (source.empty()) {
+            throwCompilerError(formatCompilerError("Failed to read script file: " + path, "<module>", 1, 1));
+        }
+        const std::string canonicalPath = std::filesystem::weakly_canonical(path).string();
+        std::optional<Module> cached = loadCachedModule(source);
+        Module module;
+        if (cached) {
+            module = std::move(*cached);
+        } else {
+            Tokenizer tokenizer(source);
+            Parser parser(tokenizer.tokenize());
+            Compiler compiler;
+            if (g_compileDisassemblyDumpEnabled) {
+                module = compiler.compile(parser.parseProgram());
+                dumpCompilerDebugFiles(path, module, compiler.lastFunctionIR());
+            } else if (g_lazyFunctionCompilationEnabled) {
+                module = compiler.compileLazy(std::make_shared<const Program>(parser.parseProgram()));
+            } else {
+                module = compiler.compile(parser.parseProgram());
+            }
+            // A cache entry is a complete image, so storing it compiles any deferred bodies.
+            storeCachedModule(source, module);
         }
-        Tokenizer tokenizer(mergedSource);
-        Parser parser(tokenizer.tokenize());
-        Compiler compiler;
-        Module module = compiler.compile(parser.parseProgram());
-        module.sourcePath = std::filesystem::weakly_canonical(path).string();
-        if (g_compileDisassemblyDumpEnabled) {
-            dumpCompilerDebugFiles(path, module, compiler.lastFunctionIR());
+        module.sourcePath = canonicalPath;
+        if (dumpTransformedSource) {
+            dumpTransformedSourceFile(path, source, module);
         }
         return module;
     } catch (const CompilerException& ex) {
-        throwCompilerError(path, tryFillFunctionContext(ex.what(), mergedSource));
+        throwCompilerError(path, tryFillFunctionContext(ex.what(), source));
+    } catch (const std::exception& ex) {
+        throwCompilerError(path, tryFillFunctionContext(ex.what(), source));
+    }
+}
+
+ModulePatchResult patchModuleSource(Module& live, const std::string& path) {
+    std::string source;
+    try {
+        source = readFileText(path);
+        if (source.empty()) {
+            throwCompilerError(formatCompilerError("Failed to read script file: " + path, "<module>", 1, 1));
+        }
+        Tokenizer tokenizer(source);
+        Parser parser(tokenizer.tokenize());
+        return patchModule(live, std::make_shared<const Program>(parser.parseProgram()));
+    } catch (const CompilerException& ex) {
+        throwCompilerError(path, tryFillFunctionContext(ex.what(), source));
     } catch (const std::exception& ex) {
-        throwCompilerError(path, tryFillFunctionContext(ex.what(), mergedSource));
+        throwCompilerError(path, tryFillFunctionContext(ex.what(), source));
+    }
+}
+
+namespace {
+
+// Mirrors the runtime lookup in loadModule(): dotted specs become paths, ".gs" is optional.
+// The importing file's directory and the caller's search paths are tried before the working
+// directory and its `scripts` folders.
+std::string resolveImportPath(const std::string& moduleSpec,
+                              const std::filesystem::path& importerDir,
+                              const std::vector<std::string>& searchPaths) {
+    namespace fs = std::filesystem;
+    std::string normalized = moduleSpec;
+    if (normalized.find('/') == std::string::npos && normalized.find('\\') == std::string::npos) {
+        std::replace(normalized.begin(), normalized.end(), '.', '/');
     }
+    std::vector<std::string> candidates = {normalized};
+    if (!normalized.ends_with(".gs")) {
+        candidates.push_back(normalized + ".gs");
+    }
+
+    std::vector<fs::path> roots = {importerDir};
+    for (const auto& base : searchPaths) {
+        roots.emplace_back(base);
+    }
+    roots.push_back(fs::current_path());
+    roots.push_back(fs::current_path() / "scripts");
+    roots.push_back(fs::current_path().parent_path() / "scripts");
+
+    std::error_code ec;
+    for (const auto& candidate : candidates) {
+        for (const auto& root : roots) {
+            const fs::path path = root / candidate;
+            if (fs::is_regular_file(path, ec)) {
+                return fs::weakly_canonical(path).string();
+            }
+        }
+    }
+    return {};
+}
+
+} // namespace
+
+std::vector<CompiledModule> compileModuleGraph(const std::vector<std::string>& entryPaths,
+                                               ThreadPool& pool,
+                                               const std::vector<std::string>& searchPaths) {
+    struct GraphState {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t pending{0};
+        std::unordered_map<std::string, std::size_t> indexByPath;
+        std::vector<CompiledModule> results;
+    };
+    auto state = std::make_shared<GraphState>();
+
+    // Queues `path` once; later requests for an already scheduled module are no-ops.
+    std::function<void(const std::string&)> schedule;
+    schedule = [state, &pool, &searchPaths, &schedule](const std::string& path) {
+        {
+            std::scoped_lock lock(state->mutex);
+            if (!state->indexByPath.emplace(path, state->results.size()).second) {
+                return;
+            }
+            CompiledModule entry;
+            entry.path = path;
+            state->results.push_back(std::move(entry));
+            ++state->pending;
+        }
+        pool.post([state, path, &searchPaths, &schedule]() {
+            CompiledModule outcome;
+            outcome.path = path;
+            try {
+                outcome.module = std::make_shared<Module>(compileSourceFile(path, searchPaths));
+                // Specs that do not resolve to a file are host modules.
+                const auto importerDir = std::filesystem::path(path).parent_path();
+                for (const auto& entry : outcome.module->imports) {
+                    const std::string resolved = resolveImportPath(entry.moduleSpec, importerDir, searchPaths);
+                    if (!resolved.empty() && std::find(outcome.dependencies.begin(),
+                                                       outcome.dependencies.end(),
+                                                       resolved) == outcome.dependencies.end()) {
+                        outcome.dependencies.push_back(resolved);
+                    }
+                }
+                for (const auto& dependency : outcome.dependencies) {
+                    schedule(dependency);
+                }
+            } catch (const std::exception& ex) {
+                outcome.error = ex.what();
+            }
+
+            std::scoped_lock lock(state->mutex);
+            state->results[state->indexByPath.at(path)] = std::move(outcome);
+            if (--state->pending == 0) {
+                state->done.notify_all();
+            }
+        });
+    };
+
+    for (const auto& entry : entryPaths) {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(entry, ec)) {
+            CompiledModule missing;
+            missing.path = entry;
+            missing.error = "Source file not found: " + entry;
+            std::scoped_lock lock(state->mutex);
+            if (state->indexByPath.emplace(entry, state->results.size()).second) {
+                state->results.push_back(std::move(missing));
+            }
+            continue;
+        }
+        schedule(std::filesystem::weakly_canonical(entry).string());
+    }
+
+    std::unique_lock lock(state->mutex);
+    state->done.wait(lock, [&state]() { return state->pending == 0; });
+    return std::move(state->results);
 }
 
 void setCompileDisassemblyDumpEnabled(bool enabled) {
@@ -3918,12 +4882,21 @@ bool compileDisassemblyDumpEnabled() {
     return g_compileDisassemblyDumpEnabled;
 }
 
+void setLazyFunctionCompilationEnabled(bool enabled) {
+    g_lazyFunctionCompilationEnabled = enabled;
+}
+
+bool lazyFunctionCompilationEnabled() {
+    return g_lazyFunctionCompilationEnabled;
+}
+
 std::string serializeModuleText(const Module& module) {
+    decodeAllFunctionBodies(module);
     std::ostringstream out;
     out << "GSBC2\n";
     out << module.constants.size() << "\n";
     for (auto c : module.constants) {
-        out << static_cast<int>(c.type) << ' ' << c.payload << "\n";
+        out << static_cast<int>(c.valueType()) << ' ' << c.rawPayload() << "\n";
     }
 
     out << module.strings.size() << "\n";
@@ -3964,8 +4937,8 @@ std::string serializeModuleText(const Module& module) {
         out << std::quoted(cls.baseNativeTypeName) << "\n";
         out << cls.attributes.size() << "\n";
         for (const auto& attr : cls.attributes) {
-            out << std::quoted(attr.name) << " " << static_cast<int>(attr.defaultValue.type) << " "
-                << attr.defaultValue.payload << " " << std::quoted(attr.declaredTypeName) << "\n";
+            out << std::quoted(attr.name) << " " << static_cast<int>(attr.defaultValue.valueType()) << " "
+                << attr.defaultValue.rawPayload() << " " << std::quoted(attr.declaredTypeName) << "\n";
         }
         out << cls.methods.size() << "\n";
         for (const auto& method : cls.methods) {
@@ -3975,8 +4948,23 @@ std::string serializeModuleText(const Module& module) {
 
     out << module.globals.size() << "\n";
     for (const auto& global : module.globals) {
-        out << std::quoted(global.name) << " " << static_cast<int>(global.initialValue.type)
-            << " " << global.initialValue.payload << " " << std::quoted(global.declaredTypeName) << "\n";
+        out << std::quoted(global.name) << " " << static_cast<int>(global.initialValue.valueType())
+            << " " << global.initialValue.rawPayload() << " " << std::quoted(global.declaredTypeName) << "\n";
+    }
+
+    // Import table; absent in files written before modules were linked.
+    out << module.imports.size() << "\n";
+    for (const auto& entry : module.imports) {
+        out << std::quoted(entry.moduleSpec) << " " << std::quoted(entry.localName) << " "
+            << (entry.bindsSymbol ? 1 : 0) << " " << entry.symbols.size();
+        for (const auto& symbol : entry.symbols) {
+            out << " " << std::quoted(symbol);
+        }
+        out << "\n";
+    }
+    out << module.importSymbols.size() << "\n";
+    for (const auto& symbol : module.importSymbols) {
+        out << symbol.importIndex << " " << std::quoted(symbol.name) << "\n";
     }
 
     return out.str();
@@ -3997,10 +4985,9 @@ Module deserializeModuleText(const std::string& text) {
     in >> count;
     for (std::size_t i = 0; i < count; ++i) {
         int t = 0;
-        Value v;
-        in >> t >> v.payload;
-        v.type = static_cast<ValueType>(t);
-        module.constants.push_back(v);
+        std::int64_t payload = 0;
+        in >> t >> payload;
+        module.constants.push_back(Value::FromRaw(static_cast<ValueType>(t), payload));
     }
 
     in >> count;
@@ -4093,11 +5080,12 @@ Module deserializeModuleText(const std::string& text) {
         for (std::size_t a = 0; a < attrCount; ++a) {
             ClassAttributeBinding attr;
             int type = 0;
-            in >> std::quoted(attr.name) >> type >> attr.defaultValue.payload;
+            std::int64_t payload = 0;
+            in >> std::quoted(attr.name) >> type >> payload;
             if (hasTypeMetadata) {
                 in >> std::quoted(attr.declaredTypeName);
             }
-            attr.defaultValue.type = static_cast<ValueType>(type);
+            attr.defaultValue = Value::FromRaw(static_cast<ValueType>(type), payload);
             cls.attributes.push_back(std::move(attr));
         }
 
@@ -4117,70 +5105,129 @@ Module deserializeModuleText(const std::string& text) {
     for (std::size_t i = 0; i < count; ++i) {
         GlobalBinding global;
         int type = 0;
-        in >> std::quoted(global.name) >> type >> global.initialValue.payload;
+        std::int64_t payload = 0;
+        in >> std::quoted(global.name) >> type >> payload;
         if (hasTypeMetadata) {
             in >> std::quoted(global.declaredTypeName);
         }
-        global.initialValue.type = static_cast<ValueType>(type);
+        global.initialValue = Value::FromRaw(static_cast<ValueType>(type), payload);
         module.globals.push_back(std::move(global));
     }
 
+    if (in >> count) {
+        module.imports.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            ModuleImport entry;
+            int bindsSymbol = 0;
+            std::size_t symbolCount = 0;
+            in >> std::quoted(entry.moduleSpec) >> std::quoted(entry.localName) >> bindsSymbol >> symbolCount;
+            entry.bindsSymbol = bindsSymbol != 0;
+            entry.symbols.resize(symbolCount);
+            for (auto& symbol : entry.symbols) {
+                in >> std::quoted(symbol);
+            }
+            module.imports.push_back(std::move(entry));
+        }
+        in >> count;
+        module.importSymbols.resize(count);
+        for (auto& symbol : module.importSymbols) {
+            in >> symbol.importIndex >> std::quoted(symbol.name);
+        }
+    }
+
     return module;
 }
 
+namespace {
+
+// A C++ string literal for `text`; std::quoted leaves newlines and control bytes unescaped.
+std::string cppStringLiteral(const std::string& text) {
+    std::ostringstream out;
+    out << '"';
+    for (const unsigned char c : text) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (c < 0x20 || c == 0x7f) {
+                // Octal escapes stop after three digits, unlike hex ones.
+                out << '\\' << static_cast<char>('0' + ((c >> 6) & 7)) << static_cast<char>('0' + ((c >> 3) & 7))
+                    << static_cast<char>('0' + (c & 7));
+            } else {
+                out << static_cast<char>(c);
+            }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+} // namespace
+
 std::string generateAotCpp(const Module& module, const std::string& variableName) {
+    decodeAllFunctionBodies(module);
     std::ostringstream out;
+    out << "#include \"gs/aot.hpp\"\n";
     out << "#include \"gs/bytecode.hpp\"\n\n";
+    out << "#include <bit>\n";
+    out << "#include <cstddef>\n";
+    out << "#include <cstdint>\n";
+    out << "#include <iterator>\n";
+    out << "#include <limits>\n\n";
+    out << generateAotFunctions(module);
     out << "gs::Module " << variableName << "() {\n";
     out << "    gs::Module m;\n";
 
     for (auto c : module.constants) {
         out << "    m.constants.push_back(";
-        switch (c.type) {
+        switch (c.valueType()) {
         case ValueType::Nil:
             out << "gs::Value::Nil()";
             break;
         case ValueType::Int:
-            out << "gs::Value::Int(" << c.payload << ")";
+            out << "gs::Value::Int(" << c.rawPayload() << ")";
             break;
         case ValueType::Float:
             out << "gs::Value::Float(" << std::setprecision(17) << c.asFloat() << ")";
             break;
         case ValueType::String:
-            out << "gs::Value::String(" << c.payload << ")";
+            out << "gs::Value::String(" << c.rawPayload() << ")";
             break;
         case ValueType::Ref:
             throwCompilerError("AOT generation does not support runtime Ref values in constants");
         case ValueType::Function:
-            out << "gs::Value::Function(" << c.payload << ")";
+            out << "gs::Value::Function(" << c.rawPayload() << ")";
             break;
         case ValueType::Class:
-            out << "gs::Value::Class(" << c.payload << ")";
+            out << "gs::Value::Class(" << c.rawPayload() << ")";
             break;
         case ValueType::Module:
-            out << "gs::Value::Module(" << c.payload << ")";
+            out << "gs::Value::Module(" << c.rawPayload() << ")";
             break;
         }
         out << ");\n";
     }
     for (const auto& s : module.strings) {
-        out << "    m.strings.push_back(" << std::quoted(s) << ");\n";
+        out << "    m.strings.push_back(" << cppStringLiteral(s) << ");\n";
     }
 
     for (const auto& fn : module.functions) {
         out << "    {\n";
         out << "        gs::FunctionBytecode f;\n";
-        out << "        f.name = " << std::quoted(fn.name) << ";\n";
+        out << "        f.name = " << cppStringLiteral(fn.name) << ";\n";
         for (const auto& p : fn.params) {
-            out << "        f.params.push_back(" << std::quoted(p) << ");\n";
+            out << "        f.params.push_back(" << cppStringLiteral(p) << ");\n";
         }
         for (const auto& t : fn.paramTypeNames) {
-            out << "        f.paramTypeNames.push_back(" << std::quoted(t) << ");\n";
+            out << "        f.paramTypeNames.push_back(" << cppStringLiteral(t) << ");\n";
         }
         out << "        f.localCount = " << fn.localCount << ";\n";
         out << "        f.stackSlotCount = " << fn.stackSlotCount << ";\n";
         for (const auto& t : fn.localTypeNames) {
-            out << "        f.localTypeNames.push_back(" << std::quoted(t) << ");\n";
+            out << "        f.localTypeNames.push_back(" << cppStringLiteral(t) << ");\n";
         }
         for (const auto& ins : fn.code) {
             out << "        f.code.push_back(gs::Instruction{gs::OpCode::";
@@ -4211,42 +5258,42 @@ std::string generateAotCpp(const Module& module, const std::string& variableName
     for (const auto& cls : module.classes) {
         out << "    {\n";
         out << "        gs::ClassBytecode c;\n";
-        out << "        c.name = " << std::quoted(cls.name) << ";\n";
+        out << "        c.name = " << cppStringLiteral(cls.name) << ";\n";
         out << "        c.baseClassIndex = " << cls.baseClassIndex << ";\n";
-        out << "        c.baseNativeTypeName = " << std::quoted(cls.baseNativeTypeName) << ";\n";
+        out << "        c.baseNativeTypeName = " << cppStringLiteral(cls.baseNativeTypeName) << ";\n";
         for (const auto& attr : cls.attributes) {
-            out << "        c.attributes.push_back(gs::ClassAttributeBinding{" << std::quoted(attr.name)
+            out << "        c.attributes.push_back(gs::ClassAttributeBinding{" << cppStringLiteral(attr.name)
                 << ", ";
-            switch (attr.defaultValue.type) {
+            switch (attr.defaultValue.valueType()) {
             case ValueType::Nil:
                 out << "gs::Value::Nil()";
                 break;
             case ValueType::Int:
-                out << "gs::Value::Int(" << attr.defaultValue.payload << ")";
+                out << "gs::Value::Int(" << attr.defaultValue.rawPayload() << ")";
                 break;
             case ValueType::Float:
                 out << "gs::Value::Float(" << std::setprecision(17) << attr.defaultValue.asFloat() << ")";
                 break;
             case ValueType::String:
-                out << "gs::Value::String(" << attr.defaultValue.payload << ")";
+                out << "gs::Value::String(" << attr.defaultValue.rawPayload() << ")";
                 break;
             case ValueType::Ref:
                 throwCompilerError("AOT generation does not support runtime Ref values in class attributes");
                 break;
             case ValueType::Function:
-                out << "gs::Value::Function(" << attr.defaultValue.payload << ")";
+                out << "gs::Value::Function(" << attr.defaultValue.rawPayload() << ")";
                 break;
             case ValueType::Class:
-                out << "gs::Value::Class(" << attr.defaultValue.payload << ")";
+                out << "gs::Value::Class(" << attr.defaultValue.rawPayload() << ")";
                 break;
             case ValueType::Module:
-                out << "gs::Value::Module(" << attr.defaultValue.payload << ")";
+                out << "gs::Value::Module(" << attr.defaultValue.rawPayload() << ")";
                 break;
             }
-            out << ", " << std::quoted(attr.declaredTypeName) << "});\n";
+            out << ", " << cppStringLiteral(attr.declaredTypeName) << "});\n";
         }
         for (const auto& method : cls.methods) {
-            out << "        c.methods.push_back(gs::ClassMethodBinding{" << std::quoted(method.name)
+            out << "        c.methods.push_back(gs::ClassMethodBinding{" << cppStringLiteral(method.name)
                 << ", " << method.functionIndex << "});\n";
         }
         out << "        m.classes.push_back(std::move(c));\n";
@@ -4254,35 +5301,48 @@ std::string generateAotCpp(const Module& module, const std::string& variableName
     }
 
     for (const auto& global : module.globals) {
-        out << "    m.globals.push_back(gs::GlobalBinding{" << std::quoted(global.name)
+        out << "    m.globals.push_back(gs::GlobalBinding{" << cppStringLiteral(global.name)
             << ", ";
-        switch (global.initialValue.type) {
+        switch (global.initialValue.valueType()) {
         case ValueType::Nil:
             out << "gs::Value::Nil()";
             break;
         case ValueType::Int:
-            out << "gs::Value::Int(" << global.initialValue.payload << ")";
+            out << "gs::Value::Int(" << global.initialValue.rawPayload() << ")";
             break;
         case ValueType::Float:
             out << "gs::Value::Float(" << std::setprecision(17) << global.initialValue.asFloat() << ")";
             break;
         case ValueType::String:
-            out << "gs::Value::String(" << global.initialValue.payload << ")";
+            out << "gs::Value::String(" << global.initialValue.rawPayload() << ")";
             break;
         case ValueType::Ref:
             throwCompilerError("AOT generation does not support runtime Ref values in globals");
             break;
         case ValueType::Function:
-            out << "gs::Value::Function(" << global.initialValue.payload << ")";
+            out << "gs::Value::Function(" << global.initialValue.rawPayload() << ")";
             break;
         case ValueType::Class:
-            out << "gs::Value::Class(" << global.initialValue.payload << ")";
+            out << "gs::Value::Class(" << global.initialValue.rawPayload() << ")";
             break;
         case ValueType::Module:
-            out << "gs::Value::Module(" << global.initialValue.payload << ")";
+            out << "gs::Value::Module(" << global.initialValue.rawPayload() << ")";
             break;
         }
-        out << ", " << std::quoted(global.declaredTypeName) << "});\n";
+        out << ", " << cppStringLiteral(global.declaredTypeName) << "});\n";
+    }
+
+    for (const auto& entry : module.imports) {
+        out << "    m.imports.push_back(gs::ModuleImport{" << cppStringLiteral(entry.moduleSpec) << ", "
+            << cppStringLiteral(entry.localName) << ", {";
+        for (std::size_t i = 0; i < entry.symbols.size(); ++i) {
+            out << (i ? ", " : "") << cppStringLiteral(entry.symbols[i]);
+        }
+        out << "}, " << (entry.bindsSymbol ? "true" : "false") << "});\n";
+    }
+    for (const auto& symbol : module.importSymbols) {
+        out << "    m.importSymbols.push_back(gs::ImportSymbol{" << symbol.importIndex << ", "
+            << cppStringLiteral(symbol.name) << "});\n";
     }
 
     out << "    return m;\n";
@@ -50,6 +50,7 @@ void ErrorLogger::logError(const std::string& errorMessage,
                            const std::string& functionName,
                            const std::string& fileName,
                            int lineNumber) {
+    std::scoped_lock lock(mutex_);
     std::ostringstream oss;
     oss << "\n";
     oss << "================================================================================\n";
@@ -104,7 +105,7 @@ void ErrorLogger::logError(const std::string& errorMessage,
     oss << "================================================================================\n\n";
     
     writeToFile(oss.str());
-    clearContext();
+    contextItems_.clear();
 }
 
 void ErrorLogger::logVmError(const std::string& errorMessage,
@@ -112,6 +113,7 @@ void ErrorLogger::logVmError(const std::string& errorMessage,
                              std::size_t lineNumber,
                              const std::vector<std::string>& callStack,
                              const std::string& additionalContext) {
+    std::scoped_lock lock(mutex_);
     std::ostringstream oss;
     oss << "\n";
     oss << "================================================================================\n";
@@ -227,11 +229,12 @@ void ErrorLogger::logVmError(const std::string& errorMessage,
     oss << "================================================================================\n\n";
     
     writeToFile(oss.str());
-    clearContext();
+    contextItems_.clear();
 }
 
 void ErrorLogger::logException(const std::exception& ex,
                                const std::string& context) {
+    std::scoped_lock lock(mutex_);
     std::ostringstream oss;
     oss << "\n";
     oss << "================================================================================\n";
@@ -281,18 +284,21 @@ void ErrorLogger::logException(const std::exception& ex,
     oss << "================================================================================\n\n";
     
     writeToFile(oss.str());
-    clearContext();
+    contextItems_.clear();
 }
 
 void ErrorLogger::addContext(const std::string& key, const std::string& value) {
+    std::scoped_lock lock(mutex_);
     contextItems_.emplace_back(key, value);
 }
 
 void ErrorLogger::clearContext() {
+    std::scoped_lock lock(mutex_);
     contextItems_.clear();
 }
 
 void ErrorLogger::setLogPath(const std::string& path) {
+    std::scoped_lock lock(mutex_);
     logPath_ = path;
 }
 
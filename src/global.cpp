@@ -2,6 +2,7 @@
 #include "gs/compiler.hpp"
 #include "gs/type_system.hpp"
 #include "gs/os_module.hpp"
+#include "gs/parallel_module.hpp"
 #include "gs/string_module.hpp"
 
 #include <chrono>
@@ -11,6 +12,7 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <unordered_map>
@@ -19,6 +21,9 @@ namespace gs {
 
 namespace {
 
+std::mutex g_scriptModulesMutex;
+std::unordered_map<std::string, std::shared_ptr<Module>> g_scriptModules;
+
 std::string resolveModulePath(const std::string& moduleSpec) {
     namespace fs = std::filesystem;
     std::string normalized = moduleSpec;
@@ -453,6 +458,20 @@ void resolveRequestedExports(HostContext& context,
 // Module Loading (loadModule function)
 // ============================================================================
 
+std::shared_ptr<Module> findScriptModule(const std::string& canonicalPath) {
+    std::scoped_lock lock(g_scriptModulesMutex);
+    auto it = g_scriptModules.find(canonicalPath);
+    return it != g_scriptModules.end() ? it->second : nullptr;
+}
+
+void publishScriptModule(const std::string& canonicalPath, std::shared_ptr<Module> module, bool replace) {
+    std::scoped_lock lock(g_scriptModulesMutex);
+    auto [it, inserted] = g_scriptModules.emplace(canonicalPath, module);
+    if (!inserted && replace) {
+        it->second = std::move(module);
+    }
+}
+
 Value handleLoadModuleBuiltin(HostRegistry& host,
                                HostContext& context,
                                const std::string& moduleName,
@@ -498,12 +517,11 @@ Value handleLoadModuleFile(HostContext& context,
                             ModuleType& moduleType,
                             FunctionType& functionType,
                             ClassType& classType) {
-    static std::unordered_map<std::string, std::shared_ptr<Module>> moduleCache;
-    
-    auto it = moduleCache.find(modulePath);
-    if (it == moduleCache.end()) {
-        auto compiled = std::make_shared<Module>(compileSourceFile(modulePath));
-        it = moduleCache.emplace(modulePath, std::move(compiled)).first;
+    std::shared_ptr<Module> module = findScriptModule(modulePath);
+    if (!module) {
+        // Compiled outside the lock; when two contexts race, the first one published wins.
+        publishScriptModule(modulePath, std::make_shared<Module>(compileSourceFile(modulePath)), false);
+        module = findScriptModule(modulePath);
     }
 
     const std::string moduleKey = "file:" + modulePath;
@@ -522,7 +540,7 @@ Value handleLoadModuleFile(HostContext& context,
         return cached;
     }
 
-    Value moduleRef = context.createObject(std::make_unique<ModuleObject>(moduleType, moduleName, it->second));
+    Value moduleRef = context.createObject(std::make_unique<ModuleObject>(moduleType, moduleName, module));
     context.cacheModuleObject(moduleKey, moduleRef);
     context.ensureModuleInitialized(moduleRef);
     resolveRequestedExports(context, moduleRef, moduleName, requestedExports, functionType, classType);
@@ -600,6 +618,117 @@ Value impl_Tuple(HostContext& context, const std::vector<Value>& args) {
     return context.createObject(std::make_unique<TupleObject>(tupleType, std::move(values)));
 }
 
+std::vector<Value> taskHandleList(HostContext& context, const std::vector<Value>& args, const char* functionName) {
+    if (args.size() == 1 && args[0].isRef()) {
+        Object& object = context.getObject(args[0]);
+        if (auto* list = dynamic_cast<ListObject*>(&object)) {
+            return list->data();
+        }
+        if (auto* tuple = dynamic_cast<TupleObject*>(&object)) {
+            return tuple->data();
+        }
+    }
+    throw std::runtime_error(std::string(functionName) + "() requires one List or Tuple of task handles");
+}
+
+Value impl_await_all(HostContext& context, const std::vector<Value>& args) {
+    return context.awaitTasks(taskHandleList(context, args, "await_all"));
+}
+
+// Returns Tuple(position, result) for the first task to finish.
+Value impl_await_any(HostContext& context, const std::vector<Value>& args) {
+    std::size_t position = 0;
+    const Value result = context.awaitAnyTask(taskHandleList(context, args, "await_any"), position);
+    return impl_Tuple(context, {Value::Int(static_cast<std::int64_t>(position)), result});
+}
+
+Value impl_poll(HostContext& context, const std::vector<Value>& args) {
+    if (args.size() != 1) {
+        throw std::runtime_error("poll() requires exactly one task handle");
+    }
+    return Value::Bool(context.pollTask(args[0]));
+}
+
+// Channel([capacity]): a bounded queue between tasks, 64 values by default.
+Value impl_Channel(HostContext& context, const std::vector<Value>& args) {
+    if (args.size() > 1 || (args.size() == 1 && (!args[0].isInt() || args[0].asInt() < 1))) {
+        throw std::runtime_error("Channel() expects an optional capacity (Int >= 1)");
+    }
+    const std::int64_t capacity = args.empty() ? 64 : args[0].asInt();
+    return context.createObject(
+        std::make_unique<ChannelObject>(channelType(), std::make_shared<Channel>(static_cast<std::size_t>(capacity))));
+}
+
+// Shared argument handling for IntArray(length[, fill]) and IntArray(listOrTuple).
+template <typename T, typename Convert>
+std::vector<T> buildNumericArrayValues(HostContext& context,
+                                       const std::vector<Value>& args,
+                                       const std::string& typeName,
+                                       Convert convert) {
+    if (args.empty() || args.size() > 2) {
+        throw std::runtime_error(typeName + "() expects (length[, fill]) or (list)");
+    }
+    if (args[0].isRef()) {
+        if (args.size() != 1) {
+            throw std::runtime_error(typeName + "() expects a single list or tuple argument");
+        }
+        Object& source = context.getObject(args[0]);
+        const std::vector<Value>* items = nullptr;
+        if (auto* list = dynamic_cast<ListObject*>(&source)) {
+            items = &list->data();
+        } else if (auto* tuple = dynamic_cast<TupleObject*>(&source)) {
+            items = &tuple->data();
+        } else {
+            throw std::runtime_error(typeName + "() expects a list or tuple, got " + context.typeName(args[0]));
+        }
+        std::vector<T> values;
+        values.reserve(items->size());
+        for (const auto& item : *items) {
+            values.push_back(convert(item));
+        }
+        return values;
+    }
+    if (!args[0].isInt() || args[0].asInt() < 0) {
+        throw std::runtime_error(typeName + "() length must be a non-negative integer");
+    }
+    const T fill = args.size() == 2 ? convert(args[1]) : T{};
+    return std::vector<T>(static_cast<std::size_t>(args[0].asInt()), fill);
+}
+
+Value impl_IntArray(HostContext& context, const std::vector<Value>& args) {
+    static IntArrayType intArrayType;
+    auto values = buildNumericArrayValues<std::int64_t>(context, args, "IntArray", [](const Value& value) {
+        if (!value.isInt()) {
+            throw std::runtime_error("IntArray elements must be integers");
+        }
+        return value.asInt();
+    });
+    return context.createObject(std::make_unique<IntArrayObject>(intArrayType, std::move(values)));
+}
+
+Value impl_FloatArray(HostContext& context, const std::vector<Value>& args) {
+    static FloatArrayType floatArrayType;
+    auto values = buildNumericArrayValues<double>(context, args, "FloatArray", [](const Value& value) {
+        if (value.isFloat()) {
+            return value.asFloat();
+        }
+        if (value.isInt()) {
+            return static_cast<double>(value.asInt());
+        }
+        throw std::runtime_error("FloatArray elements must be numbers");
+    });
+    return context.createObject(std::make_unique<FloatArrayObject>(floatArrayType, std::move(values)));
+}
+
+Value impl_StringBuilder(HostContext& context, const std::vector<Value>& args) {
+    static StringBuilderType stringBuilderType;
+    if (args.size() > 1) {
+        throw std::runtime_error("StringBuilder() expects at most one argument");
+    }
+    std::string initial = args.empty() ? std::string() : context.__str__(args[0]);
+    return context.createObject(std::make_unique<StringBuilderObject>(stringBuilderType, std::move(initial)));
+}
+
 // Helper to create a dummy type instance for a given type name
 const Type& getDummyTypeForName(const std::string& typeName) {
     // These are dummy type instances just to satisfy TypeObject's constructor
@@ -702,6 +831,26 @@ Value impl_system_gc(HostContext& context, const std::vector<Value>& args) {
     return context.collectGarbage(generation);
 }
 
+Value impl_system_memoryUsage(HostContext& context, const std::vector<Value>& args) {
+    (void)args;
+    return Value::Int(static_cast<std::int64_t>(context.memoryUsage()));
+}
+
+Value impl_system_setMemoryLimit(HostContext& context, const std::vector<Value>& args) {
+    // setMemoryLimit(maxBytes[, maxObjects]) tightens the context's quota; an omitted maxObjects
+    // keeps the current object limit. The host's limits are a ceiling scripts cannot lift.
+    if (args.empty() || args.size() > 2 || !args[0].isInt() || (args.size() == 2 && !args[1].isInt())) {
+        throw std::runtime_error("system.setMemoryLimit(maxBytes[, maxObjects]) expects integer arguments");
+    }
+    const std::int64_t maxBytes = args[0].asInt();
+    const std::int64_t maxObjects = args.size() == 2 ? args[1].asInt() : 0;
+    if (maxBytes <= 0 || maxObjects < 0 || (args.size() == 2 && maxObjects == 0)) {
+        throw std::runtime_error("system.setMemoryLimit limits must be positive");
+    }
+    context.setMemoryLimits(static_cast<std::size_t>(maxBytes), static_cast<std::size_t>(maxObjects));
+    return Value::Nil();
+}
+
 Value impl_match_exception_type(HostContext& context, const std::vector<Value>& args) {
     if (args.size() != 2) {
         throw std::runtime_error("__match_exception_type(value, typeName) requires exactly 2 arguments");
@@ -777,12 +926,22 @@ void bindGlobalModule(HostRegistry& host) {
         return impl_system_gc(ctx, args);
     });
 
+    host.bindModuleFunction("system", "memoryUsage", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_system_memoryUsage(ctx, args);
+    });
+
+    host.bindModuleFunction("system", "setMemoryLimit", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_system_setMemoryLimit(ctx, args);
+    });
+
     // Register os module  
     registerOsModule(host);
 
     // Register string module
     registerStringModule(host);
 
+    registerParallelModule(host);
+
     host.bind("print", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
         return impl_print(ctx, args);
     });
@@ -799,6 +958,34 @@ void bindGlobalModule(HostRegistry& host) {
         return impl_Tuple(ctx, args);
     });
 
+    host.bind("await_all", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_await_all(ctx, args);
+    });
+
+    host.bind("await_any", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_await_any(ctx, args);
+    });
+
+    host.bind("poll", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_poll(ctx, args);
+    });
+
+    host.bind("Channel", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_Channel(ctx, args);
+    });
+
+    host.bind("IntArray", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_IntArray(ctx, args);
+    });
+
+    host.bind("FloatArray", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_FloatArray(ctx, args);
+    });
+
+    host.bind("StringBuilder", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_StringBuilder(ctx, args);
+    });
+
     host.bind("type", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
         return impl_type(ctx, args);
     });
@@ -0,0 +1,212 @@
+#include "gs/isolate.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace gs {
+
+Isolate::Isolate(IsolateScheduler& scheduler,
+                 std::shared_ptr<const Module> module,
+                 const HostRegistry& hosts,
+                 TaskSystem& tasks,
+                 const MemoryLimits& limits)
+    : scheduler_(scheduler), vm_(std::move(module), hosts, tasks) {
+    vm_.setMemoryLimits(limits);
+}
+
+Isolate::~Isolate() {
+    try {
+        vm_.closeContext(context_);
+    } catch (...) {
+        // A __delete__ hook failed; the heap goes away regardless.
+    }
+}
+
+std::future<TransferredValues> Isolate::post(const std::string& functionName, const std::vector<Value>& args) {
+    TransferredValues packed;
+    packed.roots.reserve(args.size());
+    for (const auto& arg : args) {
+        if (arg.isRef()) {
+            throw std::runtime_error("Isolate call arguments passed as Values must not be objects: " + functionName);
+        }
+        packed.roots.push_back(TransferredValues::Slot{arg, -1});
+    }
+    return post(functionName, std::move(packed));
+}
+
+std::future<TransferredValues> Isolate::post(const std::string& functionName, TransferredValues args) {
+    std::future<TransferredValues> future;
+    bool schedule = false;
+    {
+        std::scoped_lock lock(mutex_);
+        calls_.push_back(PendingCall{functionName, std::move(args), {}});
+        future = calls_.back().result.get_future();
+        schedule = !scheduled_;
+        scheduled_ = true;
+    }
+    if (schedule) {
+        scheduler_.schedule(shared_from_this());
+    }
+    return future;
+}
+
+TransferredValues Isolate::call(const std::string& functionName, const std::vector<Value>& args) {
+    std::future<TransferredValues> future = post(functionName, args);
+    // As in TaskSystem::await: a pool worker helps with queued work instead of holding its thread.
+    ThreadPool& pool = scheduler_.pool_;
+    if (pool.currentWorkerIndex() != ThreadPool::kNotAWorker) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!pool.runPendingTask()) {
+                future.wait_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+    return future.get();
+}
+
+void Isolate::setCallTimeout(std::chrono::microseconds limit) {
+    std::scoped_lock lock(mutex_);
+    callTimeout_ = limit;
+}
+
+std::size_t Isolate::pendingCalls() const {
+    std::scoped_lock lock(mutex_);
+    return calls_.size();
+}
+
+std::uint64_t Isolate::slicesRun() const {
+    std::scoped_lock lock(mutex_);
+    return slicesRun_;
+}
+
+bool Isolate::runSlice(std::size_t stepBudget) {
+    PendingCall* call = nullptr;
+    std::chrono::microseconds timeout{0};
+    {
+        std::scoped_lock lock(mutex_);
+        // Only the thread running the slice removes calls, and deque::push_back keeps references.
+        call = &calls_.front();
+        ++slicesRun_;
+        timeout = callTimeout_;
+    }
+    try {
+        if (!callStarted_) {
+            callStarted_ = true;
+            watchdog_ = CallWatchdog{};
+            watchdog_.limit = timeout;
+            watchdog_.grace = std::max<std::chrono::microseconds>(timeout / 10, std::chrono::milliseconds(1));
+            vm_.startCall(context_, call->functionName, {}, &call->args);
+        }
+        if (!runCallSlice(vm_, context_, CallBudget{stepBudget, {}}, watchdog_)) {
+            return true;
+        }
+        call->result.set_value(vm_.takeResult(context_));
+    } catch (...) {
+        call->result.set_exception(std::current_exception());
+    }
+
+    std::scoped_lock lock(mutex_);
+    calls_.pop_front();
+    callStarted_ = false;
+    scheduled_ = !calls_.empty();
+    return scheduled_;
+}
+
+void Isolate::cancelCalls() {
+    std::deque<PendingCall> cancelled;
+    {
+        std::scoped_lock lock(mutex_);
+        cancelled.swap(calls_);
+        scheduled_ = false;
+    }
+    for (auto& call : cancelled) {
+        call.result.set_exception(std::make_exception_ptr(std::runtime_error("Isolate scheduler stopped")));
+    }
+}
+
+IsolateScheduler::IsolateScheduler(ThreadPool& pool, std::size_t sliceSteps)
+    : pool_(pool), sliceSteps_(std::max<std::size_t>(1, sliceSteps)) {}
+
+IsolateScheduler::~IsolateScheduler() {
+    std::unique_lock lock(mutex_);
+    stopping_ = true;
+    idle_.wait(lock, [this] { return runQueue_.empty() && running_ == 0; });
+}
+
+void IsolateScheduler::setSliceSteps(std::size_t steps) {
+    std::scoped_lock lock(mutex_);
+    sliceSteps_ = std::max<std::size_t>(1, steps);
+}
+
+std::size_t IsolateScheduler::sliceSteps() const {
+    std::scoped_lock lock(mutex_);
+    return sliceSteps_;
+}
+
+void IsolateScheduler::waitIdle() {
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return runQueue_.empty() && running_ == 0; });
+}
+
+std::uint64_t IsolateScheduler::slicesRun() const {
+    std::scoped_lock lock(mutex_);
+    return slicesRun_;
+}
+
+void IsolateScheduler::schedule(std::shared_ptr<Isolate> isolate) {
+    {
+        std::scoped_lock lock(mutex_);
+        if (!stopping_) {
+            runQueue_.push_back(std::move(isolate));
+            // One pool task per queue entry; each runs whichever isolate is at the front.
+            pool_.post([this] { runNext(); });
+            return;
+        }
+    }
+    isolate->cancelCalls();
+}
+
+void IsolateScheduler::runNext() {
+    std::shared_ptr<Isolate> isolate;
+    std::size_t steps = 0;
+    bool stopping = false;
+    {
+        std::scoped_lock lock(mutex_);
+        if (runQueue_.empty()) {
+            return;
+        }
+        isolate = std::move(runQueue_.front());
+        runQueue_.pop_front();
+        ++running_;
+        steps = sliceSteps_;
+        stopping = stopping_;
+    }
+
+    bool more = false;
+    if (stopping) {
+        isolate->cancelCalls();
+    } else {
+        more = isolate->runSlice(steps);
+    }
+    if (!more) {
+        // Released before running_ drops: the last reference runs the isolate's __delete__ hooks,
+        // which need the task system the destructor's owner is about to destroy.
+        isolate.reset();
+    }
+
+    std::scoped_lock lock(mutex_);
+    --running_;
+    if (!stopping) {
+        ++slicesRun_;
+    }
+    if (more) {
+        runQueue_.push_back(std::move(isolate));
+        pool_.post([this] { runNext(); });
+    } else if (runQueue_.empty() && running_ == 0) {
+        idle_.notify_all();
+    }
+}
+
+} // namespace gs
@@ -0,0 +1,91 @@
+#include "gs/parallel_module.hpp"
+#include "gs/type_system/list_type.hpp"
+#include "gs/type_system/tuple_type.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gs {
+
+namespace {
+
+std::vector<Value> itemsOf(HostContext& ctx, const Value& source, const char* functionName) {
+    if (source.isRef()) {
+        Object& object = ctx.getObject(source);
+        if (auto* list = dynamic_cast<ListObject*>(&object)) {
+            return list->data();
+        }
+        if (auto* tuple = dynamic_cast<TupleObject*>(&object)) {
+            return tuple->data();
+        }
+    }
+    throw std::runtime_error(std::string("parallel.") + functionName + "() expects a List or Tuple, got " +
+                             ctx.typeName(source));
+}
+
+std::vector<Value>& listData(HostContext& ctx, const Value& list) {
+    return dynamic_cast<ListObject&>(ctx.getObject(list)).data();
+}
+
+Value impl_parallel_map(HostContext& ctx, const std::vector<Value>& args) {
+    if (args.size() != 2) {
+        throw std::runtime_error("parallel.map() requires 2 arguments: list, fn");
+    }
+    return ctx.parallelApply(args[1], itemsOf(ctx, args[0], "map"), false);
+}
+
+Value impl_parallel_for_range(HostContext& ctx, const std::vector<Value>& args) {
+    if (args.size() != 2 || !args[0].isInt()) {
+        throw std::runtime_error("parallel.for_range() requires 2 arguments: count (Int), fn");
+    }
+    std::vector<Value> indices;
+    indices.reserve(static_cast<std::size_t>(std::max<std::int64_t>(0, args[0].asInt())));
+    for (std::int64_t i = 0; i < args[0].asInt(); ++i) {
+        indices.push_back(Value::Int(i));
+    }
+    if (!indices.empty()) {
+        (void)ctx.parallelApply(args[1], indices, false);
+    }
+    return Value::Nil();
+}
+
+// Chunks are folded in parallel and their results folded again until one value is left, so
+// `fn` must be associative; `initial` is folded in front of the first item.
+Value impl_parallel_reduce(HostContext& ctx, const std::vector<Value>& args) {
+    if (args.size() != 2 && args.size() != 3) {
+        throw std::runtime_error("parallel.reduce() requires 2 or 3 arguments: list, fn, initial");
+    }
+    std::vector<Value> items = itemsOf(ctx, args[0], "reduce");
+    if (args.size() == 3) {
+        items.insert(items.begin(), args[2]);
+    }
+    if (items.empty()) {
+        throw std::runtime_error("parallel.reduce() of an empty list needs an initial value");
+    }
+    while (items.size() > 1) {
+        const Value partials = ctx.parallelApply(args[1], items, true);
+        items = listData(ctx, partials);
+    }
+    return items.front();
+}
+
+} // namespace
+
+void registerParallelModule(HostRegistry& host) {
+    host.bindModuleFunction("parallel", "map", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_parallel_map(ctx, args);
+    });
+
+    host.bindModuleFunction("parallel", "for_range", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_parallel_for_range(ctx, args);
+    });
+
+    host.bindModuleFunction("parallel", "reduce", [](HostContext& ctx, const std::vector<Value>& args) -> Value {
+        return impl_parallel_reduce(ctx, args);
+    });
+}
+
+} // namespace gs
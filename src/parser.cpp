@@ -1,5 +1,6 @@
 #include "gs/parser.hpp"
 
+#include <cctype>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -15,6 +16,37 @@ Value parseNumericLiteral(const std::string& text) {
     return Value::Int(static_cast<std::int64_t>(std::stoll(text)));
 }
 
+// Module spec segments may be any identifier-like token, including keywords.
+bool isWordToken(const Token& token) {
+    if (token.type == TokenType::String || token.type == TokenType::Number || token.text.empty()) {
+        return false;
+    }
+    const unsigned char first = static_cast<unsigned char>(token.text.front());
+    return std::isalpha(first) || first == '_';
+}
+
+std::uint64_t fingerprintTokens(const std::vector<Token>& tokens, std::size_t begin, std::size_t end) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 0x100000001b3ULL;
+        }
+    };
+    const std::size_t firstLine = begin < end ? tokens[begin].line : 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        const Token& token = tokens[i];
+        mix(static_cast<std::uint64_t>(token.type));
+        mix(token.line - firstLine);
+        mix(token.column);
+        for (unsigned char c : token.text) {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+    }
+    return hash;
+}
+
 } // namespace
 
 Parser::Parser(std::vector<Token> tokens) : tokens_(std::move(tokens)) {}
@@ -22,7 +54,9 @@ Parser::Parser(std::vector<Token> tokens) : tokens_(std::move(tokens)) {}
 Program Parser::parseProgram() {
     Program program;
     while (!isAtEnd()) {
-        if (check(TokenType::KeywordClass)) {
+        if (isImportStart()) {
+            program.imports.push_back(parseImport());
+        } else if (check(TokenType::KeywordClass)) {
             program.classes.push_back(parseClass());
         } else if (check(TokenType::KeywordFn)) {
             program.functions.push_back(parseFunction());
@@ -34,6 +68,72 @@ Program Parser::parseProgram() {
     return program;
 }
 
+// `import` and `from` are contextual: they only start a declaration at top level when a module
+// spec follows on the same line, so both stay usable as ordinary identifiers.
+bool Parser::isImportStart() const {
+    const Token& head = peek();
+    if (head.type != TokenType::Identifier || (head.text != "import" && head.text != "from")) {
+        return false;
+    }
+    std::size_t i = current_ + 1;
+    if (i >= tokens_.size() || !isWordToken(tokens_[i]) || tokens_[i].line != head.line) {
+        return false;
+    }
+    if (head.text == "import") {
+        return true;
+    }
+    ++i;
+    while (i + 1 < tokens_.size() &&
+           (tokens_[i].type == TokenType::Dot || tokens_[i].type == TokenType::Slash) &&
+           isWordToken(tokens_[i + 1])) {
+        i += 2;
+    }
+    return i < tokens_.size() && tokens_[i].type == TokenType::Identifier && tokens_[i].text == "import";
+}
+
+std::string Parser::parseModuleSpec() {
+    if (isAtEnd() || !isWordToken(peek())) {
+        throw std::runtime_error(formatParseError("Expected module name", peek()));
+    }
+    std::string spec = tokens_[current_++].text;
+    while ((check(TokenType::Dot) || check(TokenType::Slash)) && current_ + 1 < tokens_.size() &&
+           isWordToken(tokens_[current_ + 1])) {
+        spec += tokens_[current_].text;
+        spec += tokens_[current_ + 1].text;
+        current_ += 2;
+    }
+    return spec;
+}
+
+ImportDecl Parser::parseImport() {
+    const Token& head = tokens_[current_++];
+    ImportDecl decl;
+    decl.line = head.line;
+    decl.column = head.column;
+    decl.isFrom = head.text == "from";
+    decl.moduleSpec = parseModuleSpec();
+
+    if (decl.isFrom) {
+        ++current_; // `import`, checked by isImportStart()
+        if (match(TokenType::Star)) {
+            decl.isWildcard = true;
+        } else {
+            do {
+                decl.names.push_back(consume(TokenType::Identifier, "Expected imported symbol name").text);
+            } while (match(TokenType::Comma));
+        }
+    }
+    if (match(TokenType::KeywordAs)) {
+        decl.alias = consume(TokenType::Identifier, "Expected import alias").text;
+    }
+    if (decl.isWildcard && decl.alias.empty()) {
+        throw std::runtime_error(formatParseError("from-import * requires an alias", head));
+    }
+    // The terminating ';' is optional, as it was for the line-based import syntax.
+    match(TokenType::Semicolon);
+    return decl;
+}
+
 std::string Parser::currentScopeName() const {
     if (!currentClassName_.empty() && !currentFunctionName_.empty()) {
         return currentClassName_ + "::" + currentFunctionName_;
@@ -140,6 +240,7 @@ ClassDecl Parser::parseClass() {
 }
 
 FunctionDecl Parser::parseFunction() {
+    const std::size_t firstToken = current_;
     consume(TokenType::KeywordFn, "Expected 'fn'");
     FunctionDecl fn;
     const Token& fnNameToken = consume(TokenType::Identifier, "Expected function name");
@@ -160,6 +261,7 @@ FunctionDecl Parser::parseFunction() {
     consume(TokenType::RParen, "Expected ')'");
     consume(TokenType::LBrace, "Expected '{'");
     fn.body = parseBlock();
+    fn.fingerprint = fingerprintTokens(tokens_, firstToken, current_);
     currentFunctionName_ = previousFunctionName;
     return fn;
 }
@@ -1,24 +1,19 @@
 #include "gs/runtime.hpp"
+#include "gs/bytecode_image.hpp"
+#include "gs/error_logger.hpp"
 #include "gs/global.hpp"
 
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
-#include <iterator>
+#include <future>
 #include <thread>
+#include <unordered_set>
 
 namespace gs {
 
 namespace {
 
-std::string readFile(const std::string& path) {
-    std::ifstream input(path, std::ios::binary);
-    if (!input) {
-        return {};
-    }
-    return std::string((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
-}
-
 bool writeFile(const std::string& path, const std::string& content) {
     std::ofstream output(path, std::ios::binary);
     if (!output) {
@@ -51,7 +46,8 @@ std::string resolveSourcePath(const std::string& path, const std::vector<std::st
 Runtime::Runtime()
     : module_(std::make_shared<Module>()),
       pool_(std::max<std::size_t>(2, std::thread::hardware_concurrency())),
-            tasks_(pool_) {
+            tasks_(pool_),
+            isolates_(pool_) {
         bindGlobalModule(hosts_);
 }
 
@@ -61,10 +57,16 @@ HostRegistry& Runtime::host() {
     return hosts_;
 }
 
-const std::string& Runtime::lastError() const {
+std::string Runtime::lastError() const {
+    std::scoped_lock lock(moduleMutex_);
     return lastError_;
 }
 
+void Runtime::setLastError(std::string message) {
+    std::scoped_lock lock(moduleMutex_);
+    lastError_ = std::move(message);
+}
+
 void Runtime::setDumpTransformedSource(bool enabled) {
     dumpTransformedSource_ = enabled;
 }
@@ -73,11 +75,21 @@ bool Runtime::dumpTransformedSourceEnabled() const {
     return dumpTransformedSource_;
 }
 
+void Runtime::setMemoryLimits(const MemoryLimits& limits) {
+    std::scoped_lock lock(moduleMutex_);
+    memoryLimits_ = limits;
+}
+
+MemoryLimits Runtime::memoryLimits() const {
+    std::scoped_lock lock(moduleMutex_);
+    return memoryLimits_;
+}
+
 bool Runtime::loadSourceFile(const std::string& path, const std::vector<std::string>& searchPaths) {
-    lastError_.clear();
+    setLastError({});
     const auto resolvedPath = resolveSourcePath(path, searchPaths);
     if (resolvedPath.empty()) {
-        lastError_ = "Source file not found: " + path;
+        setLastError("Source file not found: " + path);
         return false;
     }
 
@@ -90,59 +102,288 @@ bool Runtime::loadSourceFile(const std::string& path, const std::vector<std::str
                                      importSearchPaths,
                                      dumpTransformedSource_);
     } catch (const std::exception& ex) {
-        lastError_ = ex.what();
+        setLastError(ex.what());
         return false;
     } catch (...) {
-        lastError_ = "Unknown compile error";
+        setLastError("Unknown compile error");
         return false;
     }
 
     auto newModule = std::make_shared<Module>(std::move(compiled));
+    const std::string entry = newModule->sourcePath;
     {
         std::scoped_lock lock(moduleMutex_);
         module_ = std::move(newModule);
+        modulePatched_ = false;
+        sourceEntry_ = entry;
+        sourceSearchPaths_ = importSearchPaths;
+    }
+    if (watcher_) {
+        // Rediscover the import graph of the new entry in the background.
+        watcher_->setFiles({entry});
+        watcher_->requestCheck();
     }
     return true;
 }
 
 bool Runtime::loadBytecodeFile(const std::string& path) {
-    lastError_.clear();
-    const auto bc = readFile(path);
-    if (bc.empty()) {
-        lastError_ = "Bytecode file not found or empty: " + path;
+    setLastError({});
+    Module loaded;
+    try {
+        loaded = loadBytecodeModule(path);
+    } catch (const std::exception& ex) {
+        setLastError(ex.what());
         return false;
     }
 
-    auto newModule = std::make_shared<Module>(deserializeModuleText(bc));
+    auto newModule = std::make_shared<Module>(std::move(loaded));
     newModule->sourcePath = path;
     {
         std::scoped_lock lock(moduleMutex_);
         module_ = std::move(newModule);
+        modulePatched_ = false;
+        sourceEntry_.clear();
+        sourceSearchPaths_.clear();
     }
     return true;
 }
 
 bool Runtime::hotReloadSource(const std::string& path) {
-    return loadSourceFile(path);
+    setLastError({});
+    lastHotReload_ = {};
+    std::shared_ptr<Module> live;
+    {
+        std::scoped_lock lock(moduleMutex_);
+        live = module_;
+    }
+    std::error_code ec;
+    if (live->sourcePath.empty() ||
+        live->sourcePath != std::filesystem::weakly_canonical(path, ec).string()) {
+        lastHotReload_.reason = "no module was loaded from this source";
+        return loadSourceFile(path);
+    }
+
+    try {
+        lastHotReload_ = patchModuleSource(*live, path);
+    } catch (const std::exception& ex) {
+        setLastError(ex.what());
+        return false;
+    }
+    if (!lastHotReload_.patched) {
+        const std::string reason = lastHotReload_.reason;
+        const bool loaded = loadSourceFile(path);
+        lastHotReload_.reason = reason;
+        return loaded;
+    }
+    {
+        std::scoped_lock lock(moduleMutex_);
+        if (module_ == live) {
+            modulePatched_ = true;
+        }
+    }
+    return true;
+}
+
+const ModulePatchResult& Runtime::lastHotReload() const {
+    return lastHotReload_;
+}
+
+bool Runtime::watchSources(const ScriptWatcherOptions& options) {
+    std::string entry;
+    {
+        std::scoped_lock lock(moduleMutex_);
+        entry = sourceEntry_;
+    }
+    if (entry.empty()) {
+        setLastError("watchSources() needs a module loaded with loadSourceFile()");
+        return false;
+    }
+    stopWatchingSources();
+    watcher_ = std::make_unique<ScriptWatcher>(
+        options, [this](const std::vector<std::string>& changedPaths) { recompileWatchedSources(changedPaths); });
+    watcher_->setFiles({entry});
+    // Compiles the graph once to find the imported files and to have them ready for linking.
+    watcher_->requestCheck();
+    return true;
+}
+
+void Runtime::stopWatchingSources() {
+    if (watcher_) {
+        // Stop before releasing: the change handler reaches the watcher through watcher_.
+        watcher_->stop();
+        watcher_.reset();
+    }
+}
+
+std::uint64_t Runtime::sourceRevision() const {
+    std::scoped_lock lock(moduleMutex_);
+    return sourceRevision_;
+}
+
+// Runs on the watcher thread. Nothing is published unless the whole graph compiles.
+void Runtime::recompileWatchedSources(const std::vector<std::string>& changedPaths) {
+    std::string entry;
+    std::vector<std::string> searchPaths;
+    std::shared_ptr<Module> base;
+    {
+        std::scoped_lock lock(moduleMutex_);
+        entry = sourceEntry_;
+        searchPaths = sourceSearchPaths_;
+        base = module_;
+    }
+    if (entry.empty()) {
+        return;
+    }
+
+    std::vector<CompiledModule> graph = compileModuleGraph({entry}, pool_, searchPaths);
+    std::vector<std::string> files;
+    for (const auto& compiled : graph) {
+        files.push_back(compiled.path);
+    }
+
+    // A changed module and every module that imports it, directly or not, is republished. The
+    // entry reaches every module in the graph, so it is always among them.
+    std::unordered_set<std::string> affected(changedPaths.begin(), changedPaths.end());
+    for (bool grew = !affected.empty(); grew;) {
+        grew = false;
+        for (const auto& compiled : graph) {
+            if (affected.count(compiled.path) == 0 &&
+                std::any_of(compiled.dependencies.begin(), compiled.dependencies.end(), [&](const std::string& dep) {
+                    return affected.count(dep) != 0;
+                })) {
+                affected.insert(compiled.path);
+                grew = true;
+            }
+        }
+    }
+
+    // Compile the deferred bodies of everything about to be linked, so neither the calling
+    // thread nor a late body compile error meets them after publication.
+    std::vector<std::pair<const CompiledModule*, bool>> outgoing; // module, replaces the published one
+    for (const auto& compiled : graph) {
+        if (!compiled.module) {
+            continue;
+        }
+        if (affected.count(compiled.path) != 0) {
+            outgoing.emplace_back(&compiled, true);
+        } else if (compiled.path != entry && !findScriptModule(compiled.path)) {
+            outgoing.emplace_back(&compiled, false);
+        }
+    }
+    std::vector<std::future<std::string>> bodies;
+    for (const auto& [compiled, replaces] : outgoing) {
+        bodies.push_back(pool_.submit([module = compiled->module]() -> std::string {
+            try {
+                decodeAllFunctionBodies(*module);
+            } catch (const std::exception& ex) {
+                return ex.what();
+            }
+            return {};
+        }));
+    }
+    for (std::size_t i = 0; i < bodies.size(); ++i) {
+        if (std::string error = bodies[i].get(); !error.empty()) {
+            graph[static_cast<std::size_t>(outgoing[i].first - graph.data())].error = std::move(error);
+        }
+    }
+
+    std::string errors;
+    for (const auto& compiled : graph) {
+        if (compiled.error.empty()) {
+            continue;
+        }
+        ErrorLogger::instance().logError("Background recompilation failed: " + compiled.error, "", compiled.path);
+        errors += errors.empty() ? compiled.error : "\n" + compiled.error;
+    }
+    if (!errors.empty()) {
+        // The imports of a module that failed are unknown; keep watching what was watched.
+        for (auto& path : watcher_->files()) {
+            files.push_back(std::move(path));
+        }
+        watcher_->setFiles(files);
+        setLastError(errors);
+        return;
+    }
+    watcher_->setFiles(files);
+
+    // Imported modules first, so a call that picks up the new entry also links the new imports.
+    std::shared_ptr<Module> entryModule;
+    for (const auto& [compiled, replaces] : outgoing) {
+        if (compiled->path == entry) {
+            entryModule = compiled->module;
+        } else {
+            publishScriptModule(compiled->path, compiled->module, replaces);
+        }
+    }
+    if (!entryModule) {
+        return;
+    }
+    std::scoped_lock lock(moduleMutex_);
+    // A load on the calling thread since the compile started wins over this result.
+    if (module_ == base && sourceEntry_ == entry) {
+        module_ = std::move(entryModule);
+        modulePatched_ = false;
+        ++sourceRevision_;
+        lastError_.clear();
+    }
 }
 
 Value Runtime::call(const std::string& functionName, const std::vector<Value>& args) {
     std::shared_ptr<Module> snapshot;
+    MemoryLimits limits;
     {
         std::scoped_lock lock(moduleMutex_);
         snapshot = module_;
+        limits = memoryLimits_;
     }
     VirtualMachine vm(snapshot, hosts_, tasks_);
+    vm.setMemoryLimits(limits);
     return vm.runFunction(functionName, args);
 }
 
+std::unique_ptr<ScriptCall> Runtime::startCall(const std::string& functionName, const std::vector<Value>& args) {
+    std::shared_ptr<Module> snapshot;
+    MemoryLimits limits;
+    {
+        std::scoped_lock lock(moduleMutex_);
+        snapshot = module_;
+        limits = memoryLimits_;
+    }
+    return std::make_unique<ScriptCall>(snapshot, hosts_, tasks_, limits, functionName, args);
+}
+
+std::shared_ptr<Isolate> Runtime::createIsolate() {
+    std::shared_ptr<Module> snapshot;
+    MemoryLimits limits;
+    {
+        std::scoped_lock lock(moduleMutex_);
+        snapshot = module_;
+        limits = memoryLimits_;
+    }
+    return std::make_shared<Isolate>(isolates_, snapshot, hosts_, tasks_, limits);
+}
+
+IsolateScheduler& Runtime::isolates() {
+    return isolates_;
+}
+
 bool Runtime::saveBytecode(const std::string& path) const {
     std::shared_ptr<Module> snapshot;
+    bool patched = false;
     {
         std::scoped_lock lock(moduleMutex_);
         snapshot = module_;
+        patched = modulePatched_;
+    }
+    if (patched) {
+        // The image format has no replacement links, so write the current source compiled afresh.
+        try {
+            return writeFile(path, serializeModuleBinary(compileSourceFile(snapshot->sourcePath)));
+        } catch (const std::exception&) {
+            return false;
+        }
     }
-    return writeFile(path, serializeModuleText(*snapshot));
+    return writeFile(path, serializeModuleBinary(*snapshot));
 }
 
 } // namespace gs
@@ -0,0 +1,130 @@
+#include "gs/script_call.hpp"
+
+#include "gs/type_system/exception_type.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace gs {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Instructions between clock reads when a time budget or a timeout applies.
+constexpr std::size_t kClockCheckSteps = 256;
+
+std::string timeoutMessage(const CallWatchdog& watchdog) {
+    return std::string(kScriptTimedOutMessagePrefix) + " ran for more than " +
+           std::to_string(watchdog.limit.count()) + " us";
+}
+
+} // namespace
+
+bool runCallSlice(VirtualMachine& vm, ExecutionContext& ctx, const CallBudget& budget, CallWatchdog& watchdog) {
+    const bool timed = budget.time.count() > 0 || watchdog.limit.count() > 0;
+    if (!timed) {
+        return vm.resumeCall(ctx, budget.steps > 0 ? budget.steps : std::numeric_limits<std::size_t>::max());
+    }
+
+    const auto start = Clock::now();
+    auto last = start;
+    std::size_t stepsLeft = budget.steps > 0 ? budget.steps : std::numeric_limits<std::size_t>::max();
+    while (true) {
+        const std::size_t steps = std::min(stepsLeft, kClockCheckSteps);
+        const bool done = vm.resumeCall(ctx, steps);
+        const auto now = Clock::now();
+        watchdog.used += now - last;
+        last = now;
+        if (done) {
+            return true;
+        }
+
+        if (watchdog.limit.count() > 0 && watchdog.used >= watchdog.limit) {
+            if (!watchdog.raised) {
+                watchdog.raised = true;
+                vm.interruptCall(ctx, timeoutMessage(watchdog));
+            } else if (watchdog.used >= watchdog.limit + watchdog.grace) {
+                vm.abortCall(ctx);
+                throw std::runtime_error(std::string(kTimeoutExceptionTypeName) + ": " + timeoutMessage(watchdog) +
+                                         " and did not stop after the timeout was raised");
+            }
+        }
+
+        if (budget.steps > 0) {
+            stepsLeft -= steps;
+            if (stepsLeft == 0) {
+                return false;
+            }
+        }
+        if (budget.time.count() > 0 && now - start >= budget.time) {
+            return false;
+        }
+    }
+}
+
+ScriptCall::ScriptCall(std::shared_ptr<const Module> module,
+                       const HostRegistry& hosts,
+                       TaskSystem& tasks,
+                       const MemoryLimits& limits,
+                       const std::string& functionName,
+                       const std::vector<Value>& args)
+    : vm_(std::move(module), hosts, tasks) {
+    vm_.setMemoryLimits(limits);
+    try {
+        vm_.startCall(context_, functionName, args);
+    } catch (const std::exception& ex) {
+        status_ = CallStatus::Failed;
+        error_ = ex.what();
+    }
+}
+
+ScriptCall::~ScriptCall() {
+    try {
+        vm_.closeContext(context_);
+    } catch (...) {
+        // A __delete__ hook failed; the heap goes away regardless.
+    }
+}
+
+CallStatus ScriptCall::resume(const CallBudget& budget) {
+    if (status_ != CallStatus::Suspended) {
+        return status_;
+    }
+    const auto start = Clock::now();
+    try {
+        if (runCallSlice(vm_, context_, budget, watchdog_)) {
+            status_ = CallStatus::Done;
+        }
+    } catch (const std::exception& ex) {
+        status_ = CallStatus::Failed;
+        error_ = ex.what();
+    }
+    runTime_ += Clock::now() - start;
+    return status_;
+}
+
+CallStatus ScriptCall::status() const {
+    return status_;
+}
+
+const Value& ScriptCall::result() const {
+    return context_.returnValue;
+}
+
+const std::string& ScriptCall::error() const {
+    return error_;
+}
+
+void ScriptCall::setTimeout(std::chrono::microseconds limit) {
+    watchdog_.limit = limit;
+    watchdog_.grace = std::max<std::chrono::microseconds>(limit / 10, std::chrono::milliseconds(1));
+}
+
+std::chrono::microseconds ScriptCall::runTime() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(runTime_);
+}
+
+} // namespace gs
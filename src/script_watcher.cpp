@@ -0,0 +1,268 @@
+#include "gs/script_watcher.hpp"
+#include "gs/error_logger.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace gs {
+
+ScriptWatcher::ScriptWatcher(const ScriptWatcherOptions& options, ChangeHandler onChange)
+    : options_(options),
+      onChange_(std::move(onChange)) {
+#if defined(__linux__)
+    if (options_.useNotify) {
+        notifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (notifyFd_ < 0 || wakeFd_ < 0) {
+            // Out of inotify instances or descriptors: polling still works.
+            if (notifyFd_ >= 0) {
+                ::close(notifyFd_);
+            }
+            if (wakeFd_ >= 0) {
+                ::close(wakeFd_);
+            }
+            notifyFd_ = -1;
+            wakeFd_ = -1;
+        }
+    }
+#endif
+    thread_ = std::thread([this]() { run(); });
+}
+
+ScriptWatcher::~ScriptWatcher() {
+    stop();
+}
+
+void ScriptWatcher::setFiles(const std::vector<std::string>& paths) {
+    std::vector<std::string> added;
+    {
+        std::scoped_lock lock(mutex_);
+        for (const auto& path : paths) {
+            if (stamps_.count(path) == 0 && std::find(added.begin(), added.end(), path) == added.end()) {
+                added.push_back(path);
+            }
+        }
+    }
+    // Stat new files outside the lock; the watcher thread may be scanning.
+    std::unordered_map<std::string, FileStamp> next;
+    for (const auto& path : added) {
+        next.emplace(path, stampOf(path));
+    }
+    std::scoped_lock lock(mutex_);
+    for (const auto& path : paths) {
+        auto it = stamps_.find(path);
+        if (it != stamps_.end()) {
+            next.emplace(path, it->second);
+        }
+    }
+    stamps_ = std::move(next);
+    updateNotifyWatches();
+}
+
+std::vector<std::string> ScriptWatcher::files() const {
+    std::scoped_lock lock(mutex_);
+    std::vector<std::string> paths;
+    paths.reserve(stamps_.size());
+    for (const auto& entry : stamps_) {
+        paths.push_back(entry.first);
+    }
+    return paths;
+}
+
+void ScriptWatcher::requestCheck() {
+    {
+        std::scoped_lock lock(mutex_);
+        checkRequested_ = true;
+    }
+    wake_.notify_all();
+#if defined(__linux__)
+    if (wakeFd_ >= 0) {
+        const std::uint64_t one = 1;
+        (void)!::write(wakeFd_, &one, sizeof(one));
+    }
+#endif
+}
+
+void ScriptWatcher::stop() {
+    {
+        std::scoped_lock lock(mutex_);
+        if (stopping_.exchange(true)) {
+            return;
+        }
+    }
+    wake_.notify_all();
+#if defined(__linux__)
+    if (wakeFd_ >= 0) {
+        const std::uint64_t one = 1;
+        (void)!::write(wakeFd_, &one, sizeof(one));
+    }
+#endif
+    if (thread_.joinable()) {
+        if (thread_.get_id() == std::this_thread::get_id()) {
+            // Stopped from the change handler: the loop exits once the handler returns.
+            thread_.detach();
+            return;
+        }
+        thread_.join();
+    }
+#if defined(__linux__)
+    if (notifyFd_ >= 0) {
+        ::close(notifyFd_);
+        notifyFd_ = -1;
+    }
+    if (wakeFd_ >= 0) {
+        ::close(wakeFd_);
+        wakeFd_ = -1;
+    }
+#endif
+}
+
+bool ScriptWatcher::usesNotify() const {
+    return notifyFd_ >= 0;
+}
+
+ScriptWatcher::FileStamp ScriptWatcher::stampOf(const std::string& path) {
+    std::error_code ec;
+    FileStamp stamp;
+    stamp.modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return {};
+    }
+    stamp.size = std::filesystem::file_size(path, ec);
+    stamp.exists = !ec;
+    return stamp;
+}
+
+void ScriptWatcher::run() {
+    while (!stopping_) {
+        waitForActivity();
+        if (stopping_) {
+            break;
+        }
+        const std::vector<std::string> changed = collectChanges();
+        bool requested = false;
+        {
+            std::scoped_lock lock(mutex_);
+            requested = std::exchange(checkRequested_, false);
+        }
+        if (changed.empty() && !requested) {
+            continue;
+        }
+        try {
+            onChange_(changed);
+        } catch (const std::exception& ex) {
+            ErrorLogger::instance().logException(ex, "ScriptWatcher change handler");
+        }
+    }
+}
+
+// Returns true when a notification woke the thread; false on timeout, requestCheck() or stop().
+bool ScriptWatcher::waitForActivity() {
+#if defined(__linux__)
+    if (notifyFd_ >= 0) {
+        auto drain = [this]() {
+            alignas(inotify_event) char buffer[4096];
+            while (::read(notifyFd_, buffer, sizeof(buffer)) > 0) {
+            }
+        };
+        pollfd fds[2] = {{notifyFd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+        if (::poll(fds, 2, static_cast<int>(options_.pollInterval.count())) <= 0) {
+            return false;
+        }
+        if (fds[1].revents & POLLIN) {
+            std::uint64_t count = 0;
+            (void)!::read(wakeFd_, &count, sizeof(count));
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            return false;
+        }
+        // The events only say that something in a watched directory moved; collectChanges()
+        // decides what. Wait for the writer to go quiet so one save is reported once.
+        drain();
+        pollfd events{notifyFd_, POLLIN, 0};
+        while (!stopping_ && ::poll(&events, 1, static_cast<int>(options_.settleDelay.count())) > 0) {
+            drain();
+        }
+        return true;
+    }
+#endif
+    std::unique_lock lock(mutex_);
+    wake_.wait_for(lock, options_.pollInterval, [this]() { return stopping_.load() || checkRequested_; });
+    return false;
+}
+
+std::vector<std::string> ScriptWatcher::collectChanges() {
+    std::vector<std::pair<std::string, FileStamp>> seen;
+    {
+        std::scoped_lock lock(mutex_);
+        seen.reserve(stamps_.size());
+        for (const auto& entry : stamps_) {
+            seen.push_back(entry);
+        }
+    }
+
+    std::vector<std::string> changed;
+    for (auto& [path, stamp] : seen) {
+        const FileStamp now = stampOf(path);
+        if (now == stamp) {
+            continue;
+        }
+        stamp = now;
+        // A file that vanished is usually mid-save; it is reported once it is back.
+        if (now.exists) {
+            changed.push_back(path);
+        }
+    }
+
+    std::scoped_lock lock(mutex_);
+    for (const auto& [path, stamp] : seen) {
+        auto it = stamps_.find(path);
+        if (it != stamps_.end()) {
+            it->second = stamp;
+        }
+    }
+    return changed;
+}
+
+// Keeps one inotify watch per directory that holds a watched file. Called with mutex_ held.
+void ScriptWatcher::updateNotifyWatches() {
+#if defined(__linux__)
+    if (notifyFd_ < 0) {
+        return;
+    }
+    std::unordered_set<std::string> wanted;
+    for (const auto& entry : stamps_) {
+        wanted.insert(std::filesystem::path(entry.first).parent_path().string());
+    }
+    for (auto it = directoryWatches_.begin(); it != directoryWatches_.end();) {
+        if (wanted.count(it->first) == 0) {
+            ::inotify_rm_watch(notifyFd_, it->second);
+            it = directoryWatches_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& directory : wanted) {
+        if (directoryWatches_.count(directory) != 0) {
+            continue;
+        }
+        const int wd = ::inotify_add_watch(notifyFd_,
+                                           directory.c_str(),
+                                           IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+        // Without a watch the directory is still covered by the periodic scan.
+        if (wd >= 0) {
+            directoryWatches_.emplace(directory, wd);
+        }
+    }
+#endif
+}
+
+} // namespace gs
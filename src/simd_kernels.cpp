@@ -0,0 +1,241 @@
+#include "gs/simd_kernels.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GS_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace gs::simd {
+
+namespace {
+
+// Integer kernels wrap on overflow like the interpreter's 64-bit arithmetic.
+std::int64_t wrapAdd(std::int64_t lhs, std::int64_t rhs) {
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(lhs) + static_cast<std::uint64_t>(rhs));
+}
+
+std::int64_t wrapMul(std::int64_t lhs, std::int64_t rhs) {
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(lhs) * static_cast<std::uint64_t>(rhs));
+}
+
+#if GS_SIMD_SSE2
+double horizontalSum(__m128d value) {
+    return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+}
+#endif
+
+} // namespace
+
+void add(double* dst, const double* src, std::size_t count) {
+    std::size_t i = 0;
+#if GS_SIMD_SSE2
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] += src[i];
+    }
+}
+
+void addScalar(double* dst, double value, std::size_t count) {
+    std::size_t i = 0;
+#if GS_SIMD_SSE2
+    const __m128d splat = _mm_set1_pd(value);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(dst + i), splat));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] += value;
+    }
+}
+
+void scale(double* dst, double factor, std::size_t count) {
+    std::size_t i = 0;
+#if GS_SIMD_SSE2
+    const __m128d splat = _mm_set1_pd(factor);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(dst + i), splat));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] *= factor;
+    }
+}
+
+void clamp(double* dst, double lo, double hi, std::size_t count) {
+    std::size_t i = 0;
+#if GS_SIMD_SSE2
+    const __m128d low = _mm_set1_pd(lo);
+    const __m128d high = _mm_set1_pd(hi);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(dst + i, _mm_min_pd(_mm_max_pd(_mm_loadu_pd(dst + i), low), high));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = std::min(std::max(dst[i], lo), hi);
+    }
+}
+
+void lerp(double* dst, const double* target, double t, std::size_t count) {
+    std::size_t i = 0;
+#if GS_SIMD_SSE2
+    const __m128d weight = _mm_set1_pd(t);
+    for (; i + 2 <= count; i += 2) {
+        const __m128d from = _mm_loadu_pd(dst + i);
+        const __m128d delta = _mm_sub_pd(_mm_loadu_pd(target + i), from);
+        _mm_storeu_pd(dst + i, _mm_add_pd(from, _mm_mul_pd(delta, weight)));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] += (target[i] - dst[i]) * t;
+    }
+}
+
+double dot(const double* lhs, const double* rhs, std::size_t count) {
+    std::size_t i = 0;
+    double total = 0.0;
+#if GS_SIMD_SSE2
+    __m128d acc = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2) {
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(lhs + i), _mm_loadu_pd(rhs + i)));
+    }
+    total = horizontalSum(acc);
+#endif
+    for (; i < count; ++i) {
+        total += lhs[i] * rhs[i];
+    }
+    return total;
+}
+
+double sum(const double* src, std::size_t count) {
+    std::size_t i = 0;
+    double total = 0.0;
+#if GS_SIMD_SSE2
+    __m128d acc = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2) {
+        acc = _mm_add_pd(acc, _mm_loadu_pd(src + i));
+    }
+    total = horizontalSum(acc);
+#endif
+    for (; i < count; ++i) {
+        total += src[i];
+    }
+    return total;
+}
+
+double min(const double* src, std::size_t count) {
+    std::size_t i = 1;
+    double best = src[0];
+#if GS_SIMD_SSE2
+    if (count >= 2) {
+        __m128d acc = _mm_loadu_pd(src);
+        for (i = 2; i + 2 <= count; i += 2) {
+            acc = _mm_min_pd(acc, _mm_loadu_pd(src + i));
+        }
+        best = std::min(_mm_cvtsd_f64(acc), _mm_cvtsd_f64(_mm_unpackhi_pd(acc, acc)));
+    }
+#endif
+    for (; i < count; ++i) {
+        best = std::min(best, src[i]);
+    }
+    return best;
+}
+
+double max(const double* src, std::size_t count) {
+    std::size_t i = 1;
+    double best = src[0];
+#if GS_SIMD_SSE2
+    if (count >= 2) {
+        __m128d acc = _mm_loadu_pd(src);
+        for (i = 2; i + 2 <= count; i += 2) {
+            acc = _mm_max_pd(acc, _mm_loadu_pd(src + i));
+        }
+        best = std::max(_mm_cvtsd_f64(acc), _mm_cvtsd_f64(_mm_unpackhi_pd(acc, acc)));
+    }
+#endif
+    for (; i < count; ++i) {
+        best = std::max(best, src[i]);
+    }
+    return best;
+}
+
+void add(std::int64_t* dst, const std::int64_t* src, std::size_t count) {
+    std::size_t i = 0;
+#if GS_SIMD_SSE2
+    for (; i + 2 <= count; i += 2) {
+        auto* out = reinterpret_cast<__m128i*>(dst + i);
+        const auto* in = reinterpret_cast<const __m128i*>(src + i);
+        _mm_storeu_si128(out, _mm_add_epi64(_mm_loadu_si128(out), _mm_loadu_si128(in)));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = wrapAdd(dst[i], src[i]);
+    }
+}
+
+void addScalar(std::int64_t* dst, std::int64_t value, std::size_t count) {
+    std::size_t i = 0;
+#if GS_SIMD_SSE2
+    const __m128i splat = _mm_set1_epi64x(value);
+    for (; i + 2 <= count; i += 2) {
+        auto* out = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(out, _mm_add_epi64(_mm_loadu_si128(out), splat));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = wrapAdd(dst[i], value);
+    }
+}
+
+// SSE2 has no 64-bit multiply or compare; these loops are left to the auto-vectorizer.
+void scale(std::int64_t* dst, std::int64_t factor, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = wrapMul(dst[i], factor);
+    }
+}
+
+void clamp(std::int64_t* dst, std::int64_t lo, std::int64_t hi, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = std::min(std::max(dst[i], lo), hi);
+    }
+}
+
+std::int64_t dot(const std::int64_t* lhs, const std::int64_t* rhs, std::size_t count) {
+    std::int64_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        total = wrapAdd(total, wrapMul(lhs[i], rhs[i]));
+    }
+    return total;
+}
+
+std::int64_t sum(const std::int64_t* src, std::size_t count) {
+    std::size_t i = 0;
+    std::int64_t total = 0;
+#if GS_SIMD_SSE2
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 2 <= count; i += 2) {
+        acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    }
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    total = wrapAdd(lanes[0], lanes[1]);
+#endif
+    for (; i < count; ++i) {
+        total = wrapAdd(total, src[i]);
+    }
+    return total;
+}
+
+std::int64_t min(const std::int64_t* src, std::size_t count) {
+    return *std::min_element(src, src + count);
+}
+
+std::int64_t max(const std::int64_t* src, std::size_t count) {
+    return *std::max_element(src, src + count);
+}
+
+} // namespace gs::simd
@@ -1,31 +1,367 @@
 #include "gs/task_system.hpp"
 
+#include "gs/vm.hpp"
+
+#include <bit>
+#include <chrono>
 #include <stdexcept>
+#include <thread>
 
 namespace gs {
 
-TaskSystem::TaskSystem(ThreadPool& pool) : pool_(pool) {}
+namespace {
+
+// Modules a thread keeps VMs for; the least recently used one goes first.
+constexpr std::size_t kSpawnVmsPerThread = 4;
+
+// A handle is (generation << 31) | (slot index + 1) with the low 16 bits of the slot's
+// generation, so it fits the 47-bit positive integers of GS_COMPACT_VALUE. A stale handle is
+// mistaken for a live one only if its slot was reused a multiple of 65536 times meanwhile.
+constexpr unsigned kHandleIndexBits = 31;
+constexpr std::uint32_t kHandleGenerationMask = 0xffffu;
+
+std::uint32_t slotIndexOf(std::int64_t handle) {
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>(handle) & ((1u << kHandleIndexBits) - 1)) - 1;
+}
+
+std::uint32_t generationOf(std::int64_t handle) {
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>(handle) >> kHandleIndexBits);
+}
+
+std::uint32_t handleGeneration(std::uint32_t generation) {
+    return generation & kHandleGenerationMask;
+}
+
+} // namespace
+
+TaskSystem::TaskSystem(ThreadPool& pool) : pool_(pool), spawnVms_(pool.size() + 1) {}
+
+TaskSystem::~TaskSystem() {
+    // A task's last access to the table is its decrement of running_, so polling is enough.
+    while (running_.load(std::memory_order_acquire) != 0) {
+        cancelStrandedTasks();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (auto& chunk : slotChunks_) {
+        delete[] chunk.load(std::memory_order_acquire);
+    }
+}
+
+TaskSystem::Slot& TaskSystem::slotAt(std::uint32_t index) const {
+    const auto chunk = static_cast<std::size_t>(std::bit_width(index / kFirstSlotChunk + 1)) - 1;
+    const std::size_t offset = index - kFirstSlotChunk * ((std::size_t{1} << chunk) - 1);
+    Slot* slots = slotChunks_[chunk].load(std::memory_order_acquire);
+    if (!slots) {
+        auto fresh = std::make_unique<Slot[]>(kFirstSlotChunk << chunk);
+        if (slotChunks_[chunk].compare_exchange_strong(slots, fresh.get(), std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            slots = fresh.release();
+        }
+    }
+    return slots[offset];
+}
+
+std::uint32_t TaskSystem::acquireSlot() {
+    std::uint64_t head = freeHead_.load(std::memory_order_acquire);
+    while ((head & 0xffffffffu) != 0) {
+        const auto index = static_cast<std::uint32_t>(head & 0xffffffffu) - 1;
+        const std::uint32_t next = slotAt(index).nextFree.load(std::memory_order_relaxed);
+        const std::uint64_t popped = (((head >> 32) + 1) << 32) | next;
+        if (freeHead_.compare_exchange_weak(head, popped, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return index;
+        }
+    }
+    const std::uint32_t index = slotCount_.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= kFirstSlotChunk * ((std::size_t{1} << kSlotChunkCount) - 1) || index >= 0x7fffffffu) {
+        throw std::runtime_error("Too many tasks in flight");
+    }
+    (void)slotAt(index);
+    return index;
+}
+
+void TaskSystem::releaseSlot(std::uint32_t index) {
+    Slot& slot = slotAt(index);
+    slot.generation.fetch_add(1, std::memory_order_relaxed);
+    slot.state.store(SlotState::Free, std::memory_order_release);
+    std::uint64_t head = freeHead_.load(std::memory_order_relaxed);
+    std::uint64_t pushed = 0;
+    do {
+        slot.nextFree.store(static_cast<std::uint32_t>(head & 0xffffffffu), std::memory_order_relaxed);
+        pushed = (((head >> 32) + 1) << 32) | (index + 1);
+    } while (!freeHead_.compare_exchange_weak(head, pushed, std::memory_order_release, std::memory_order_relaxed));
+}
+
+TaskSystem::Slot& TaskSystem::resolve(std::int64_t handle) const {
+    const std::uint32_t index = slotIndexOf(handle);
+    if (handle <= 0 || index >= slotCount_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Task handle not found");
+    }
+    Slot& slot = slotAt(index);
+    if (handleGeneration(slot.generation.load(std::memory_order_acquire)) != generationOf(handle) ||
+        slot.state.load(std::memory_order_acquire) == SlotState::Free) {
+        throw std::runtime_error("Task handle not found");
+    }
+    return slot;
+}
+
+void TaskSystem::finish(Slot& slot, TransferredValues result, std::exception_ptr failure) {
+    slot.result = std::move(result);
+    slot.failure = std::move(failure);
+    slot.state.store(SlotState::Done, std::memory_order_seq_cst);
+    wakeSleepers();
+}
 
-std::int64_t TaskSystem::enqueue(std::function<Value()> task) {
-    auto future = pool_.submit([task = std::move(task)]() mutable { return task(); });
-    std::scoped_lock lock(mutex_);
-    const auto id = nextId_++;
-    tasks_.emplace(id, std::move(future));
-    return id;
+// Called after publishing what a waiter checks, with a seq_cst store. Paired with the
+// sleepers_ increment in waitUntil: either the waiter sees it before it sleeps or this sees the
+// sleeper and wakes it.
+void TaskSystem::wakeSleepers() {
+    if (sleepers_.load(std::memory_order_seq_cst) != 0) {
+        std::scoped_lock lock(waitMutex_);
+        finished_.notify_all();
+    }
 }
 
-Value TaskSystem::await(std::int64_t handle) {
-    std::future<Value> future;
+template <typename Ready>
+void TaskSystem::waitUntil(Ready&& ready) {
+    // Awaiting from inside a pool task would otherwise hold a worker the awaited task may need.
+    // Other threads only help while there is queued work, then sleep until a task is done: on
+    // a busy pool their polling would take time from the workers.
+    const bool worker = pool_.currentWorkerIndex() != ThreadPool::kNotAWorker;
+    while (!ready()) {
+        if (pool_.runPendingTask()) {
+            continue;
+        }
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock lock(waitMutex_);
+            if (worker) {
+                finished_.wait_for(lock, std::chrono::microseconds(50), ready);
+            } else {
+                finished_.wait(lock, ready);
+            }
+        }
+        sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+TransferredValues TaskSystem::collect(Slot& slot, std::int64_t handle) {
+    SlotState expected = SlotState::Done;
+    if (!slot.state.compare_exchange_strong(expected, SlotState::Collecting, std::memory_order_acq_rel)) {
+        throw std::runtime_error("Task handle not found");
+    }
+    // The handle was awaited elsewhere meanwhile and the slot already holds a later task.
+    if (handleGeneration(slot.generation.load(std::memory_order_acquire)) != generationOf(handle)) {
+        slot.state.store(SlotState::Done, std::memory_order_release);
+        throw std::runtime_error("Task handle not found");
+    }
+    TransferredValues result = std::move(slot.result);
+    slot.result = TransferredValues{};
+    std::exception_ptr failure = std::move(slot.failure);
+    slot.failure = nullptr;
+    releaseSlot(slotIndexOf(handle));
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return result;
+}
+
+std::int64_t TaskSystem::startTask(Slot*& slot) {
+    const std::uint32_t index = acquireSlot();
+    slot = &slotAt(index);
+    const std::uint32_t generation = handleGeneration(slot->generation.load(std::memory_order_relaxed));
+    slot->state.store(SlotState::Running, std::memory_order_release);
+    running_.fetch_add(1, std::memory_order_relaxed);
+    return (static_cast<std::int64_t>(generation) << kHandleIndexBits) | static_cast<std::int64_t>(index + 1);
+}
+
+std::int64_t TaskSystem::enqueue(std::function<TransferredValues()> task) {
+    Slot* slot = nullptr;
+    const std::int64_t handle = startTask(slot);
+    pool_.post([this, slot, task = std::move(task)]() mutable {
+        TransferredValues result;
+        std::exception_ptr failure;
+        try {
+            result = task();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        task = nullptr;
+        finish(*slot, std::move(result), std::move(failure));
+        running_.fetch_sub(1, std::memory_order_release);
+    });
+    return handle;
+}
+
+std::int64_t TaskSystem::enqueueResumable(TaskStep step) {
+    auto task = std::make_shared<ResumableTask>();
+    task->step = std::move(step);
+    const std::int64_t handle = startTask(task->slot);
+    pool_.post([this, task] { runStep(task); });
+    return handle;
+}
+
+void TaskSystem::runStep(const std::shared_ptr<ResumableTask>& task) {
+    TransferredValues result;
+    std::exception_ptr failure;
+    TaskParker parker;
+    bool done = true;
+    try {
+        done = task->step(result, parker);
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    if (!done) {
+        {
+            std::scoped_lock lock(parkedMutex_);
+            parked_.emplace(task.get(), task);
+        }
+        task->parked.store(true, std::memory_order_release);
+        // The last use of the task on this thread: the parker may resume it at once.
+        parker([this, task] { resume(task); });
+        return;
+    }
+    task->step = nullptr;
+    finish(*task->slot, std::move(result), std::move(failure));
+    running_.fetch_sub(1, std::memory_order_release);
+}
+
+void TaskSystem::resume(const std::shared_ptr<ResumableTask>& task) {
+    if (!task->parked.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
     {
-        std::scoped_lock lock(mutex_);
-        auto it = tasks_.find(handle);
-        if (it == tasks_.end()) {
-            throw std::runtime_error("Task handle not found");
+        std::scoped_lock lock(parkedMutex_);
+        parked_.erase(task.get());
+    }
+    pool_.post([this, task] { runStep(task); });
+}
+
+void TaskSystem::cancelStrandedTasks() {
+    std::vector<std::shared_ptr<ResumableTask>> stranded;
+    {
+        std::scoped_lock lock(parkedMutex_);
+        // While any task still runs, it may resume the parked ones.
+        if (parked_.empty() || parked_.size() != running_.load(std::memory_order_acquire)) {
+            return;
+        }
+        for (auto& [key, task] : parked_) {
+            if (task->parked.exchange(false, std::memory_order_acq_rel)) {
+                stranded.push_back(task);
+            }
         }
-        future = std::move(it->second);
-        tasks_.erase(it);
+        parked_.clear();
+    }
+    for (auto& task : stranded) {
+        // Drops the task's VM and, with it, what it held of the channel it waited on.
+        task->step = nullptr;
+        finish(*task->slot, {}, std::make_exception_ptr(std::runtime_error("Task was cancelled")));
+        running_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void TaskSystem::wait(const TaskParker& parker) {
+    auto resumed = std::make_shared<std::atomic<bool>>(false);
+    parker([this, resumed] {
+        resumed->store(true, std::memory_order_seq_cst);
+        wakeSleepers();
+    });
+    waitUntil([&] { return resumed->load(std::memory_order_acquire); });
+}
+
+TransferredValues TaskSystem::await(std::int64_t handle) {
+    Slot& slot = resolve(handle);
+    waitUntil([&] { return slot.state.load(std::memory_order_acquire) == SlotState::Done; });
+    return collect(slot, handle);
+}
+
+std::vector<TransferredValues> TaskSystem::awaitAll(const std::vector<std::int64_t>& handles) {
+    std::vector<Slot*> slots;
+    slots.reserve(handles.size());
+    for (const auto handle : handles) {
+        slots.push_back(&resolve(handle));
+    }
+    std::size_t pending = 0;
+    waitUntil([&] {
+        while (pending < slots.size() && slots[pending]->state.load(std::memory_order_acquire) == SlotState::Done) {
+            ++pending;
+        }
+        return pending == slots.size();
+    });
+
+    std::vector<TransferredValues> results(handles.size());
+    std::exception_ptr failure;
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+        try {
+            results[i] = collect(*slots[i], handles[i]);
+        } catch (...) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return results;
+}
+
+std::pair<std::size_t, TransferredValues> TaskSystem::awaitAny(const std::vector<std::int64_t>& handles) {
+    if (handles.empty()) {
+        throw std::runtime_error("await_any needs at least one task handle");
+    }
+    std::vector<Slot*> slots;
+    slots.reserve(handles.size());
+    for (const auto handle : handles) {
+        slots.push_back(&resolve(handle));
+    }
+    std::size_t found = 0;
+    waitUntil([&] {
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i]->state.load(std::memory_order_acquire) == SlotState::Done) {
+                found = i;
+                return true;
+            }
+        }
+        return false;
+    });
+    return {found, collect(*slots[found], handles[found])};
+}
+
+bool TaskSystem::poll(std::int64_t handle) const {
+    return resolve(handle).state.load(std::memory_order_acquire) == SlotState::Done;
+}
+
+std::vector<TaskSystem::SpawnVm>& TaskSystem::spawnVmSlot(std::unique_lock<std::mutex>& sharedLock) {
+    const std::size_t worker = pool_.currentWorkerIndex();
+    if (worker != ThreadPool::kNotAWorker) {
+        return spawnVms_[worker];
+    }
+    sharedLock = std::unique_lock(sharedSpawnVmMutex_);
+    return spawnVms_.back();
+}
+
+std::unique_ptr<VirtualMachine> TaskSystem::takeSpawnVm(const Module* module, const HostRegistry* hosts) {
+    std::unique_lock<std::mutex> sharedLock;
+    auto& slot = spawnVmSlot(sharedLock);
+    for (auto it = slot.begin(); it != slot.end(); ++it) {
+        if (it->module == module && it->hosts == hosts) {
+            auto vm = std::move(it->vm);
+            slot.erase(it);
+            return vm;
+        }
+    }
+    return nullptr;
+}
+
+void TaskSystem::returnSpawnVm(const Module* module, const HostRegistry* hosts, std::unique_ptr<VirtualMachine> vm) {
+    std::unique_ptr<VirtualMachine> evicted; // destroyed after the lock is released
+    std::unique_lock<std::mutex> sharedLock;
+    auto& slot = spawnVmSlot(sharedLock);
+    if (slot.size() >= kSpawnVmsPerThread) {
+        evicted = std::move(slot.front().vm);
+        slot.erase(slot.begin());
     }
-    return future.get();
+    slot.push_back({module, hosts, std::move(vm)});
 }
 
 } // namespace gs
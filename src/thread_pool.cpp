@@ -1,45 +1,398 @@
 #include "gs/thread_pool.hpp"
 
+#include "gs/error_logger.hpp"
+
 #include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
 
 namespace gs {
 
-ThreadPool::ThreadPool(std::size_t workers) {
+namespace {
+
+// Idle rounds a worker spends yielding before it parks.
+constexpr unsigned kSpinRounds = 32;
+// Task nodes each thread keeps for reuse.
+constexpr std::size_t kTaskCacheSize = 1024;
+constexpr std::size_t kInjectionCapacity = 8192;
+constexpr std::int64_t kInitialDequeCapacity = 256;
+
+struct CurrentWorker {
+    const ThreadPool* pool{nullptr};
+    std::size_t index{ThreadPool::kNotAWorker};
+};
+
+thread_local CurrentWorker tCurrentWorker;
+
+// Task nodes are freed by whichever thread ran them, so a producer's nodes migrate to the workers;
+// each cache is bounded and a miss falls back to the allocator.
+struct TaskCache {
+    std::vector<ThreadPool::Task*> free;
+
+    ~TaskCache() {
+        for (ThreadPool::Task* task : free) {
+            delete task;
+        }
+    }
+};
+
+thread_local TaskCache tTaskCache;
+
+std::size_t nextVictimSeed() {
+    thread_local std::uint32_t state = static_cast<std::uint32_t>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1u);
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Chase-Lev deque with the memory orderings of Le, Pop, Cohen and Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models". The owning worker pushes and pops at the
+// bottom; other threads steal from the top. Outgrown rings are kept until the deque dies because
+// a thief may still be reading one.
+class WorkDeque {
+public:
+    using Task = ThreadPool::Task;
+
+    WorkDeque() {
+        rings_.push_back(std::make_unique<Ring>(kInitialDequeCapacity));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    void push(Task* task) {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        if (bottom - top > ring->capacity - 1) {
+            ring = grow(ring, top, bottom);
+        }
+        ring->put(bottom, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    Task* pop() {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = top_.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Task* task = ring->get(bottom);
+        if (top == bottom) {
+            // Last element: race the thieves for it.
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task* steal() {
+        std::int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Task* task = ring_.load(std::memory_order_acquire)->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+private:
+    struct Ring {
+        explicit Ring(std::int64_t size)
+            : capacity(size), mask(size - 1), slots(std::make_unique<std::atomic<Task*>[]>(static_cast<std::size_t>(size))) {}
+
+        Task* get(std::int64_t i) const { return slots[static_cast<std::size_t>(i & mask)].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, Task* task) { slots[static_cast<std::size_t>(i & mask)].store(task, std::memory_order_relaxed); }
+
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+    };
+
+    Ring* grow(Ring* ring, std::int64_t top, std::int64_t bottom) {
+        auto bigger = std::make_unique<Ring>(ring->capacity * 2);
+        for (std::int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, ring->get(i));
+        }
+        Ring* raw = bigger.get();
+        rings_.push_back(std::move(bigger));
+        ring_.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<Ring*> ring_{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings_; // owner only
+};
+
+} // namespace
+
+struct ThreadPool::Worker {
+    alignas(64) WorkDeque deque;
+};
+
+// Bounded MPMC ring (Vyukov) for tasks submitted from outside the pool. When it is full,
+// producers fall back to a locked overflow list rather than block.
+class ThreadPool::InjectionQueue {
+public:
+    InjectionQueue() : cells_(kInjectionCapacity) {
+        for (std::size_t i = 0; i < cells_.size(); ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void push(Task* task) {
+        if (tryPush(task)) {
+            return;
+        }
+        std::scoped_lock lock(overflowMutex_);
+        overflow_.push_back(task);
+        overflowSize_.store(overflow_.size(), std::memory_order_release);
+    }
+
+    Task* pop() {
+        if (Task* task = tryPop()) {
+            return task;
+        }
+        if (overflowSize_.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+        std::scoped_lock lock(overflowMutex_);
+        if (overflow_.empty()) {
+            return nullptr;
+        }
+        Task* task = overflow_.front();
+        overflow_.pop_front();
+        overflowSize_.store(overflow_.size(), std::memory_order_release);
+        return task;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        Task* task{nullptr};
+    };
+
+    static constexpr std::size_t kMask = kInjectionCapacity - 1;
+
+    bool tryPush(Task* task) {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & kMask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.task = task;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Task* tryPop() {
+        std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & kMask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    Task* task = cell.task;
+                    cell.sequence.store(pos + kMask + 1, std::memory_order_release);
+                    return task;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<Cell> cells_;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(64) std::atomic<std::size_t> dequeuePos_{0};
+    std::mutex overflowMutex_;
+    std::deque<Task*> overflow_;
+    std::atomic<std::size_t> overflowSize_{0};
+};
+
+ThreadPool::Task* ThreadPool::Task::acquire() {
+    auto& cache = tTaskCache.free;
+    if (cache.empty()) {
+        return new Task();
+    }
+    Task* task = cache.back();
+    cache.pop_back();
+    return task;
+}
+
+void ThreadPool::Task::release(Task* task) {
+    auto& cache = tTaskCache.free;
+    if (cache.size() >= kTaskCacheSize) {
+        delete task;
+        return;
+    }
+    cache.push_back(task);
+}
+
+ThreadPool::ThreadPool(std::size_t workers) : injection_(std::make_unique<InjectionQueue>()) {
     if (workers == 0) {
         workers = 2;
     }
 
     workers_.reserve(workers);
     for (std::size_t i = 0; i < workers; ++i) {
-        workers_.emplace_back([this]() {
-            for (;;) {
-                std::function<void()> job;
-                {
-                    std::unique_lock lock(mutex_);
-                    cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
-                    if (stop_ && jobs_.empty()) {
-                        return;
-                    }
-                    job = std::move(jobs_.front());
-                    jobs_.pop();
-                }
-                job();
-            }
-        });
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    threads_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads_.emplace_back([this, i]() { workerLoop(i); });
     }
 }
 
 ThreadPool::~ThreadPool() {
-    {
-        std::scoped_lock lock(mutex_);
-        stop_ = true;
-    }
-    cv_.notify_all();
-    for (auto& t : workers_) {
+    stop_.store(true);
+    wakeEpoch_.fetch_add(1, std::memory_order_release);
+    wakeEpoch_.notify_all();
+    for (auto& t : threads_) {
         if (t.joinable()) {
             t.join();
         }
     }
+    // Workers drain every queue before they exit; anything left was posted during shutdown.
+    while (Task* task = injection_->pop()) {
+        task->run(false);
+        Task::release(task);
+    }
+}
+
+std::size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+std::size_t ThreadPool::currentWorkerIndex() const {
+    return tCurrentWorker.pool == this ? tCurrentWorker.index : kNotAWorker;
+}
+
+bool ThreadPool::runPendingTask() {
+    Task* task = findWork(currentWorkerIndex());
+    if (!task) {
+        return false;
+    }
+    execute(task);
+    return true;
+}
+
+void ThreadPool::schedule(Task* task) {
+    if (const std::size_t self = currentWorkerIndex(); self != kNotAWorker) {
+        workers_[self]->deque.push(task);
+    } else {
+        injection_->push(task);
+    }
+    wakeOne();
+}
+
+void ThreadPool::wakeOne() {
+    // Pairs with the sleeper's increment of sleepers_ before its last look for work: either the
+    // sleeper sees the new task or this sees the sleeper.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    wakeEpoch_.fetch_add(1, std::memory_order_release);
+    wakeEpoch_.notify_one();
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+    tCurrentWorker = {this, index};
+    unsigned idleRounds = 0;
+    for (;;) {
+        if (Task* task = findWork(index)) {
+            execute(task);
+            idleRounds = 0;
+            continue;
+        }
+        if (idleRounds < kSpinRounds) {
+            ++idleRounds;
+            std::this_thread::yield();
+            continue;
+        }
+
+        sleepers_.fetch_add(1);
+        const std::uint32_t epoch = wakeEpoch_.load(std::memory_order_acquire);
+        if (Task* task = findWork(index)) {
+            sleepers_.fetch_sub(1);
+            execute(task);
+            idleRounds = 0;
+            continue;
+        }
+        if (stop_.load()) {
+            sleepers_.fetch_sub(1);
+            break;
+        }
+        wakeEpoch_.wait(epoch, std::memory_order_acquire);
+        sleepers_.fetch_sub(1);
+        idleRounds = 0;
+    }
+    tCurrentWorker = {};
+}
+
+ThreadPool::Task* ThreadPool::findWork(std::size_t self) {
+    if (self != kNotAWorker) {
+        if (Task* task = workers_[self]->deque.pop()) {
+            return task;
+        }
+    }
+    if (Task* task = injection_->pop()) {
+        return task;
+    }
+    return steal(self);
+}
+
+ThreadPool::Task* ThreadPool::steal(std::size_t self) {
+    const std::size_t count = workers_.size();
+    const std::size_t start = nextVictimSeed() % count;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::size_t victim = (start + i) % count;
+        if (victim == self) {
+            continue;
+        }
+        if (Task* task = workers_[victim]->deque.steal()) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::execute(Task* task) {
+    try {
+        task->run(true);
+    } catch (const std::exception& ex) {
+        ErrorLogger::instance().logException(ex, "ThreadPool task");
+    } catch (...) {
+        ErrorLogger::instance().logError("Unknown exception", "ThreadPool task");
+    }
+    Task::release(task);
 }
 
 } // namespace gs
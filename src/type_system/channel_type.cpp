@@ -0,0 +1,81 @@
+#include "gs/type_system/channel_type.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace gs {
+
+ChannelObject::ChannelObject(const Type& typeRef, std::shared_ptr<Channel> channel)
+    : type_(&typeRef), channel_(std::move(channel)) {}
+
+const Type& ChannelObject::getType() const {
+    return *type_;
+}
+
+std::size_t ChannelObject::memoryFootprint() const {
+    return sizeof(ChannelObject);
+}
+
+Channel& ChannelObject::channel() const {
+    return *channel_;
+}
+
+const std::shared_ptr<Channel>& ChannelObject::shared() const {
+    return channel_;
+}
+
+ChannelType::ChannelType() {
+    registerMethodAttribute("__str__", 0, [this](Object& self,
+                                                  const std::vector<Value>& args,
+                                                  const StringFactory& makeString,
+                                                  const ValueStrInvoker& valueStr) {
+        (void)args;
+        return makeString(__str__(self, valueStr));
+    });
+
+    const auto readOnly = [](const char* member) {
+        return [member](Object& self, const Value& value) -> Value {
+            (void)self;
+            (void)value;
+            throw std::runtime_error(std::string("Channel.") + member + " is read-only");
+        };
+    };
+    registerMemberAttribute(
+        "capacity",
+        [](Object& self) { return Value::Int(static_cast<std::int64_t>(requireChannel(self).channel().capacity())); },
+        readOnly("capacity"));
+    registerMemberAttribute(
+        "length",
+        [](Object& self) { return Value::Int(static_cast<std::int64_t>(requireChannel(self).channel().size())); },
+        readOnly("length"));
+    registerMemberAttribute(
+        "closed",
+        [](Object& self) { return Value::Bool(requireChannel(self).channel().closed()); },
+        readOnly("closed"));
+}
+
+const char* ChannelType::name() const {
+    return "Channel";
+}
+
+std::string ChannelType::__str__(Object& self, const ValueStrInvoker& valueStr) const {
+    (void)valueStr;
+    const Channel& channel = requireChannel(self).channel();
+    return "<Channel " + std::to_string(channel.size()) + "/" + std::to_string(channel.capacity()) +
+           (channel.closed() ? " closed>" : ">");
+}
+
+ChannelObject& ChannelType::requireChannel(Object& self) {
+    auto* channel = dynamic_cast<ChannelObject*>(&self);
+    if (!channel) {
+        throw std::runtime_error("ChannelType called with non-Channel object");
+    }
+    return *channel;
+}
+
+const ChannelType& channelType() {
+    static const ChannelType type;
+    return type;
+}
+
+} // namespace gs
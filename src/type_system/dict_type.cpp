@@ -138,6 +138,13 @@ const Type& DictObject::getType() const {
     return *type_;
 }
 
+std::size_t DictObject::memoryFootprint() const {
+    // Bucket array plus one heap node (entry + next pointer + cached hash) per entry.
+    return sizeof(DictObject) +
+           data_.bucket_count() * sizeof(void*) +
+           data_.size() * (sizeof(MapType::value_type) + 2 * sizeof(void*));
+}
+
 DictObject::MapType& DictObject::data() {
     return data_;
 }
@@ -13,6 +13,10 @@ const std::string_view kPropertyNotFoundExceptionTypeName = "PropertyNotFoundExc
 const std::string_view kListIndexOutOfRangeExceptionTypeName = "ListIndexOutOfRangeException";
 const std::string_view kDictKeyNotFoundExceptionTypeName = "DictKeyNotFoundException";
 const std::string_view kUndefinedVariableExceptionTypeName = "UndefinedVariableException";
+const std::string_view kOutOfMemoryExceptionTypeName = "OutOfMemoryException";
+const std::string_view kMemoryLimitExceededMessagePrefix = "Memory limit exceeded:";
+const std::string_view kTimeoutExceptionTypeName = "TimeoutException";
+const std::string_view kScriptTimedOutMessagePrefix = "Script timed out:";
 
 ExceptionObject::ExceptionObject(const Type& typeRef, std::string exceptionName, std::string message)
     : type_(&typeRef),
@@ -171,6 +175,12 @@ DictKeyNotFoundExceptionObject::DictKeyNotFoundExceptionObject(const Type& typeR
 UndefinedVariableExceptionObject::UndefinedVariableExceptionObject(const Type& typeRef, std::string message)
     : ExceptionObject(typeRef, std::string(kUndefinedVariableExceptionTypeName), std::move(message)) {}
 
+OutOfMemoryExceptionObject::OutOfMemoryExceptionObject(const Type& typeRef, std::string message)
+    : ExceptionObject(typeRef, std::string(kOutOfMemoryExceptionTypeName), std::move(message)) {}
+
+TimeoutExceptionObject::TimeoutExceptionObject(const Type& typeRef, std::string message)
+    : ExceptionObject(typeRef, std::string(kTimeoutExceptionTypeName), std::move(message)) {}
+
 const char* DivideByZeroExceptionType::name() const {
     return "DivideByZeroException";
 }
@@ -199,6 +209,14 @@ const char* UndefinedVariableExceptionType::name() const {
     return "UndefinedVariableException";
 }
 
+const char* OutOfMemoryExceptionType::name() const {
+    return "OutOfMemoryException";
+}
+
+const char* TimeoutExceptionType::name() const {
+    return "TimeoutException";
+}
+
 bool isNativeExceptionTypeName(const std::string& nativeTypeName) {
     return nativeTypeName == kExceptionTypeName ||
            nativeTypeName == kDivideByZeroExceptionTypeName ||
@@ -207,7 +225,9 @@ bool isNativeExceptionTypeName(const std::string& nativeTypeName) {
            nativeTypeName == kPropertyNotFoundExceptionTypeName ||
            nativeTypeName == kListIndexOutOfRangeExceptionTypeName ||
            nativeTypeName == kDictKeyNotFoundExceptionTypeName ||
-           nativeTypeName == kUndefinedVariableExceptionTypeName;
+           nativeTypeName == kUndefinedVariableExceptionTypeName ||
+           nativeTypeName == kOutOfMemoryExceptionTypeName ||
+           nativeTypeName == kTimeoutExceptionTypeName;
 }
 
 std::string classifyRuntimeExceptionTypeName(const std::string& message) {
@@ -235,6 +255,12 @@ std::string classifyRuntimeExceptionTypeName(const std::string& message) {
     if (message.starts_with("Undefined symbol:")) {
         return std::string(kUndefinedVariableExceptionTypeName);
     }
+    if (message.starts_with(kMemoryLimitExceededMessagePrefix)) {
+        return std::string(kOutOfMemoryExceptionTypeName);
+    }
+    if (message.starts_with(kScriptTimedOutMessagePrefix)) {
+        return std::string(kTimeoutExceptionTypeName);
+    }
     return std::string(kExceptionTypeName);
 }
 
@@ -247,6 +273,8 @@ const Type& resolveNativeExceptionType(std::string_view exceptionName) {
     static ListIndexOutOfRangeExceptionType listIndexOutOfRangeType;
     static DictKeyNotFoundExceptionType dictKeyNotFoundType;
     static UndefinedVariableExceptionType undefinedVariableType;
+    static OutOfMemoryExceptionType outOfMemoryType;
+    static TimeoutExceptionType timeoutType;
 
     if (exceptionName == kDivideByZeroExceptionTypeName) {
         return divideByZeroType;
@@ -269,6 +297,12 @@ const Type& resolveNativeExceptionType(std::string_view exceptionName) {
     if (exceptionName == kUndefinedVariableExceptionTypeName) {
         return undefinedVariableType;
     }
+    if (exceptionName == kOutOfMemoryExceptionTypeName) {
+        return outOfMemoryType;
+    }
+    if (exceptionName == kTimeoutExceptionTypeName) {
+        return timeoutType;
+    }
     return baseType;
 }
 
@@ -296,6 +330,12 @@ std::unique_ptr<ExceptionObject> makeNativeExceptionObject(std::string_view exce
     if (exceptionName == kUndefinedVariableExceptionTypeName) {
         return std::make_unique<UndefinedVariableExceptionObject>(exceptionType, message);
     }
+    if (exceptionName == kOutOfMemoryExceptionTypeName) {
+        return std::make_unique<OutOfMemoryExceptionObject>(exceptionType, message);
+    }
+    if (exceptionName == kTimeoutExceptionTypeName) {
+        return std::make_unique<TimeoutExceptionObject>(exceptionType, message);
+    }
     return std::make_unique<ExceptionObject>(exceptionType, std::string(exceptionName), message);
 }
 
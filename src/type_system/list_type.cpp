@@ -14,6 +14,10 @@ const Type& ListObject::getType() const {
     return *type_;
 }
 
+std::size_t ListObject::memoryFootprint() const {
+    return sizeof(ListObject) + data_.capacity() * sizeof(Value);
+}
+
 std::vector<Value>& ListObject::data() {
     return data_;
 }
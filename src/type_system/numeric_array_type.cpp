@@ -0,0 +1,341 @@
+#include "gs/type_system/numeric_array_type.hpp"
+
+#include "gs/simd_kernels.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace gs {
+
+namespace {
+
+// What differs between IntArray and FloatArray: the script name and how elements convert.
+template <typename T>
+struct ElementTraits;
+
+template <>
+struct ElementTraits<std::int64_t> {
+    static constexpr const char* kTypeName = "IntArray";
+    static constexpr const char* kArrayArgument = "an IntArray";
+
+    static std::int64_t fromValue(const Value& value, const char* what) {
+        if (!value.isInt()) {
+            throw std::runtime_error(std::string(kTypeName) + "." + what + " expects an integer");
+        }
+        return value.asInt();
+    }
+    static Value toValue(std::int64_t element) { return Value::Int(element); }
+};
+
+template <>
+struct ElementTraits<double> {
+    static constexpr const char* kTypeName = "FloatArray";
+    static constexpr const char* kArrayArgument = "a FloatArray";
+
+    static double fromValue(const Value& value, const char* what) {
+        if (value.isFloat()) {
+            return value.asFloat();
+        }
+        if (value.isInt()) {
+            return static_cast<double>(value.asInt());
+        }
+        throw std::runtime_error(std::string(kTypeName) + "." + what + " expects a number");
+    }
+    static Value toValue(double element) { return Value::Float(element); }
+};
+
+template <typename T>
+std::runtime_error arrayError(const std::string& message) {
+    return std::runtime_error(std::string(ElementTraits<T>::kTypeName) + message);
+}
+
+template <typename T>
+std::size_t requireIndex(const NumericArrayObject<T>& array, const Value& index) {
+    if (!index.isInt()) {
+        throw arrayError<T>(" index must be an integer");
+    }
+    const std::int64_t raw = index.asInt();
+    if (raw < 0 || static_cast<std::size_t>(raw) >= array.data().size()) {
+        throw arrayError<T>(" index out of range");
+    }
+    return static_cast<std::size_t>(raw);
+}
+
+} // namespace
+
+template <typename T>
+NumericArrayObject<T>::NumericArrayObject(const Type& typeRef, std::vector<T> values)
+    : type_(&typeRef), data_(std::move(values)) {}
+
+template <typename T>
+const Type& NumericArrayObject<T>::getType() const {
+    return *type_;
+}
+
+template <typename T>
+std::size_t NumericArrayObject<T>::memoryFootprint() const {
+    return sizeof(NumericArrayObject) + data_.capacity() * sizeof(T);
+}
+
+template <typename T>
+std::vector<T>& NumericArrayObject<T>::data() {
+    return data_;
+}
+
+template <typename T>
+const std::vector<T>& NumericArrayObject<T>::data() const {
+    return data_;
+}
+
+template <typename T>
+const char* NumericArrayType<T>::name() const {
+    return ElementTraits<T>::kTypeName;
+}
+
+template <typename T>
+NumericArrayType<T>::NumericArrayType() {
+    registerMethodAttribute("__str__", 0, [this](Object& self,
+                                                  const std::vector<Value>& args,
+                                                  const StringFactory& makeString,
+                                                  const ValueStrInvoker& valueStr) {
+        (void)args;
+        return makeString(__str__(self, valueStr));
+    });
+    registerMethod("get", 1, &NumericArrayType::methodGet);
+    registerMethod("set", 2, &NumericArrayType::methodSet);
+    registerMethod("push", 1, &NumericArrayType::methodPush);
+    registerMethod("size", 0, &NumericArrayType::methodSize);
+    registerMethod("fill", 1, &NumericArrayType::methodFill);
+    registerMethod("add", 1, &NumericArrayType::methodAdd);
+    registerMethod("scale", 1, &NumericArrayType::methodScale);
+    registerMethod("clamp", 2, &NumericArrayType::methodClamp);
+    if constexpr (std::floating_point<T>) {
+        registerMethod("lerp", 2, &NumericArrayType::methodLerp);
+    }
+    registerMethod("dot", 1, &NumericArrayType::methodDot);
+    registerMethod("sum", 0, &NumericArrayType::methodSum);
+    registerMethod("min", 0, &NumericArrayType::methodMin);
+    registerMethod("max", 0, &NumericArrayType::methodMax);
+
+    registerMemberAttribute(
+        "length",
+        [this](Object& self) { return memberLengthGet(self); },
+        [this](Object& self, const Value& value) { return memberLengthSet(self, value); });
+}
+
+template <typename T>
+void NumericArrayType<T>::registerMethod(const std::string& name, std::size_t argc, MethodHandler handler) {
+    registerMethodAttribute(name, argc, [this, handler](Object& self, const std::vector<Value>& args) {
+        return (this->*handler)(self, args);
+    });
+}
+
+template <typename T>
+Value NumericArrayType<T>::callMethod(Object& self,
+                                      const std::string& method,
+                                      const std::vector<Value>& args,
+                                      const StringFactory& makeString,
+                                      const ValueStrInvoker& valueStr) const {
+    return Type::callMethod(self, method, args, makeString, valueStr);
+}
+
+template <typename T>
+Value NumericArrayType<T>::getMember(Object& self, const std::string& member) const {
+    return Type::getMember(self, member);
+}
+
+template <typename T>
+Value NumericArrayType<T>::setMember(Object& self, const std::string& member, const Value& value) const {
+    return Type::setMember(self, member, value);
+}
+
+template <typename T>
+std::string NumericArrayType<T>::__str__(Object& self, const ValueStrInvoker& valueStr) const {
+    auto& array = requireArray(self);
+    std::ostringstream ss;
+    ss << ElementTraits<T>::kTypeName << "[";
+    for (std::size_t i = 0; i < array.data().size(); ++i) {
+        if (i > 0) {
+            ss << ", ";
+        }
+        // Floats go through the script's formatting so 1.0 prints as it would on its own.
+        if constexpr (std::floating_point<T>) {
+            ss << valueStr(Value::Float(array.data()[i]));
+        } else {
+            ss << array.data()[i];
+        }
+    }
+    ss << "]";
+    return ss.str();
+}
+
+template <typename T>
+Value NumericArrayType<T>::readIndex(const NumericArrayObject<T>& array, const Value& index) {
+    return ElementTraits<T>::toValue(array.data()[requireIndex(array, index)]);
+}
+
+template <typename T>
+Value NumericArrayType<T>::writeIndex(NumericArrayObject<T>& array, const Value& index, const Value& value) {
+    array.data()[requireIndex(array, index)] = ElementTraits<T>::fromValue(value, "set");
+    return value;
+}
+
+template <typename T>
+NumericArrayObject<T>& NumericArrayType<T>::requireArray(Object& self) {
+    auto* array = dynamic_cast<NumericArrayObject<T>*>(&self);
+    if (!array) {
+        throw std::runtime_error(std::string(ElementTraits<T>::kTypeName) + "Type called with non-" +
+                                 ElementTraits<T>::kTypeName + " object");
+    }
+    return *array;
+}
+
+template <typename T>
+const NumericArrayObject<T>* NumericArrayType<T>::asArray(const Value& value) {
+    if (!value.isRef()) {
+        return nullptr;
+    }
+    return dynamic_cast<const NumericArrayObject<T>*>(value.asRef());
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodGet(Object& self, const std::vector<Value>& args) const {
+    return readIndex(requireArray(self), args[0]);
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodSet(Object& self, const std::vector<Value>& args) const {
+    return writeIndex(requireArray(self), args[0], args[1]);
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodPush(Object& self, const std::vector<Value>& args) const {
+    auto& array = requireArray(self);
+    array.data().push_back(ElementTraits<T>::fromValue(args[0], "push"));
+    return Value::Int(static_cast<std::int64_t>(array.data().size()));
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodSize(Object& self, const std::vector<Value>& args) const {
+    (void)args;
+    return Value::Int(static_cast<std::int64_t>(requireArray(self).data().size()));
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodFill(Object& self, const std::vector<Value>& args) const {
+    auto& array = requireArray(self);
+    std::fill(array.data().begin(), array.data().end(), ElementTraits<T>::fromValue(args[0], "fill"));
+    return Value::Ref(&self);
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodAdd(Object& self, const std::vector<Value>& args) const {
+    auto& array = requireArray(self);
+    if (const auto* other = asArray(args[0])) {
+        if (other->data().size() != array.data().size()) {
+            throw arrayError<T>(".add length mismatch");
+        }
+        simd::add(array.data().data(), other->data().data(), array.data().size());
+    } else {
+        simd::addScalar(array.data().data(), ElementTraits<T>::fromValue(args[0], "add"), array.data().size());
+    }
+    return Value::Ref(&self);
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodScale(Object& self, const std::vector<Value>& args) const {
+    auto& array = requireArray(self);
+    simd::scale(array.data().data(), ElementTraits<T>::fromValue(args[0], "scale"), array.data().size());
+    return Value::Ref(&self);
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodClamp(Object& self, const std::vector<Value>& args) const {
+    auto& array = requireArray(self);
+    const T lo = ElementTraits<T>::fromValue(args[0], "clamp");
+    const T hi = ElementTraits<T>::fromValue(args[1], "clamp");
+    if (lo > hi) {
+        throw arrayError<T>(".clamp lower bound exceeds upper bound");
+    }
+    simd::clamp(array.data().data(), lo, hi, array.data().size());
+    return Value::Ref(&self);
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodLerp(Object& self, const std::vector<Value>& args) const
+    requires std::floating_point<T>
+{
+    auto& array = requireArray(self);
+    const auto* target = asArray(args[0]);
+    if (!target) {
+        throw arrayError<T>(std::string(".lerp expects ") + ElementTraits<T>::kArrayArgument + " target");
+    }
+    if (target->data().size() != array.data().size()) {
+        throw arrayError<T>(".lerp length mismatch");
+    }
+    simd::lerp(array.data().data(),
+               target->data().data(),
+               ElementTraits<T>::fromValue(args[1], "lerp"),
+               array.data().size());
+    return Value::Ref(&self);
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodDot(Object& self, const std::vector<Value>& args) const {
+    auto& array = requireArray(self);
+    const auto* other = asArray(args[0]);
+    if (!other) {
+        throw arrayError<T>(std::string(".dot expects ") + ElementTraits<T>::kArrayArgument);
+    }
+    if (other->data().size() != array.data().size()) {
+        throw arrayError<T>(".dot length mismatch");
+    }
+    return ElementTraits<T>::toValue(simd::dot(array.data().data(), other->data().data(), array.data().size()));
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodSum(Object& self, const std::vector<Value>& args) const {
+    (void)args;
+    auto& array = requireArray(self);
+    return ElementTraits<T>::toValue(simd::sum(array.data().data(), array.data().size()));
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodMin(Object& self, const std::vector<Value>& args) const {
+    (void)args;
+    auto& array = requireArray(self);
+    if (array.data().empty()) {
+        throw arrayError<T>(".min of empty array");
+    }
+    return ElementTraits<T>::toValue(simd::min(array.data().data(), array.data().size()));
+}
+
+template <typename T>
+Value NumericArrayType<T>::methodMax(Object& self, const std::vector<Value>& args) const {
+    (void)args;
+    auto& array = requireArray(self);
+    if (array.data().empty()) {
+        throw arrayError<T>(".max of empty array");
+    }
+    return ElementTraits<T>::toValue(simd::max(array.data().data(), array.data().size()));
+}
+
+template <typename T>
+Value NumericArrayType<T>::memberLengthGet(Object& self) const {
+    return Value::Int(static_cast<std::int64_t>(requireArray(self).data().size()));
+}
+
+template <typename T>
+Value NumericArrayType<T>::memberLengthSet(Object& self, const Value& value) const {
+    (void)self;
+    (void)value;
+    throw arrayError<T>(".length is read-only");
+}
+
+template class NumericArrayObject<std::int64_t>;
+template class NumericArrayObject<double>;
+template class NumericArrayType<std::int64_t>;
+template class NumericArrayType<double>;
+
+} // namespace gs
@@ -19,6 +19,13 @@ const Type& ScriptInstanceObject::getType() const {
     return *type_;
 }
 
+std::size_t ScriptInstanceObject::memoryFootprint() const {
+    using FieldEntry = std::unordered_map<std::string, Value>::value_type;
+    return sizeof(ScriptInstanceObject) +
+           fields_.bucket_count() * sizeof(void*) +
+           fields_.size() * (sizeof(FieldEntry) + 2 * sizeof(void*));
+}
+
 std::size_t ScriptInstanceObject::classIndex() const {
     return classIndex_;
 }
@@ -43,6 +50,14 @@ void ScriptInstanceObject::setNativeBaseRef(const Value& nativeBaseRef) {
     nativeBaseRef_ = nativeBaseRef;
 }
 
+std::size_t ScriptInstanceObject::layoutStamp() const {
+    return layoutStamp_;
+}
+
+void ScriptInstanceObject::setLayoutStamp(std::size_t stamp) {
+    layoutStamp_ = stamp;
+}
+
 std::unordered_map<std::string, Value>& ScriptInstanceObject::fields() {
     return fields_;
 }
@@ -0,0 +1,150 @@
+#include "gs/type_system/string_builder_type.hpp"
+
+#include <stdexcept>
+
+namespace gs {
+
+StringBuilderObject::StringBuilderObject(const Type& typeRef, std::string initial)
+    : type_(&typeRef), data_(std::move(initial)) {}
+
+const Type& StringBuilderObject::getType() const {
+    return *type_;
+}
+
+std::size_t StringBuilderObject::memoryFootprint() const {
+    return sizeof(StringBuilderObject) + data_.capacity();
+}
+
+std::string& StringBuilderObject::data() {
+    return data_;
+}
+
+const std::string& StringBuilderObject::data() const {
+    return data_;
+}
+
+StringBuilderType::StringBuilderType() {
+    registerMethodAttribute("__str__", 0, [this](Object& self,
+                                                  const std::vector<Value>& args,
+                                                  const StringFactory& makeString,
+                                                  const ValueStrInvoker& valueStr) {
+        (void)args;
+        return makeString(__str__(self, valueStr));
+    });
+    registerMethod("append", 1, &StringBuilderType::methodAppend);
+    registerMethod("appendLine", 1, &StringBuilderType::methodAppendLine);
+    registerMethod("build", 0, &StringBuilderType::methodBuild);
+    registerMethod("clear", 0, &StringBuilderType::methodClear);
+    registerMethod("size", 0, &StringBuilderType::methodSize);
+
+    registerMemberAttribute(
+        "length",
+        [this](Object& self) { return memberLengthGet(self); },
+        [this](Object& self, const Value& value) { return memberLengthSet(self, value); });
+}
+
+const char* StringBuilderType::name() const {
+    return "StringBuilder";
+}
+
+void StringBuilderType::registerMethod(const std::string& name, std::size_t argc, MethodHandler handler) {
+    registerMethodAttribute(name,
+                            argc,
+                            [this, handler](Object& self,
+                                            const std::vector<Value>& args,
+                                            const StringFactory& makeString,
+                                            const ValueStrInvoker& valueStr) {
+        return (this->*handler)(self, args, makeString, valueStr);
+    });
+}
+
+Value StringBuilderType::callMethod(Object& self,
+                                    const std::string& method,
+                                    const std::vector<Value>& args,
+                                    const StringFactory& makeString,
+                                    const ValueStrInvoker& valueStr) const {
+    return Type::callMethod(self, method, args, makeString, valueStr);
+}
+
+Value StringBuilderType::getMember(Object& self, const std::string& member) const {
+    return Type::getMember(self, member);
+}
+
+Value StringBuilderType::setMember(Object& self, const std::string& member, const Value& value) const {
+    return Type::setMember(self, member, value);
+}
+
+std::string StringBuilderType::__str__(Object& self, const ValueStrInvoker& valueStr) const {
+    (void)valueStr;
+    return requireBuilder(self).data();
+}
+
+StringBuilderObject& StringBuilderType::requireBuilder(Object& self) {
+    auto* builder = dynamic_cast<StringBuilderObject*>(&self);
+    if (!builder) {
+        throw std::runtime_error("StringBuilderType called with non-StringBuilder object");
+    }
+    return *builder;
+}
+
+Value StringBuilderType::methodAppend(Object& self,
+                                      const std::vector<Value>& args,
+                                      const StringFactory& makeString,
+                                      const ValueStrInvoker& valueStr) const {
+    (void)makeString;
+    requireBuilder(self).data() += valueStr(args[0]);
+    return Value::Ref(&self);
+}
+
+Value StringBuilderType::methodAppendLine(Object& self,
+                                          const std::vector<Value>& args,
+                                          const StringFactory& makeString,
+                                          const ValueStrInvoker& valueStr) const {
+    (void)makeString;
+    auto& text = requireBuilder(self).data();
+    text += valueStr(args[0]);
+    text += '\n';
+    return Value::Ref(&self);
+}
+
+Value StringBuilderType::methodBuild(Object& self,
+                                     const std::vector<Value>& args,
+                                     const StringFactory& makeString,
+                                     const ValueStrInvoker& valueStr) const {
+    (void)args;
+    (void)valueStr;
+    return makeString(requireBuilder(self).data());
+}
+
+Value StringBuilderType::methodClear(Object& self,
+                                     const std::vector<Value>& args,
+                                     const StringFactory& makeString,
+                                     const ValueStrInvoker& valueStr) const {
+    (void)args;
+    (void)makeString;
+    (void)valueStr;
+    requireBuilder(self).data().clear();
+    return Value::Ref(&self);
+}
+
+Value StringBuilderType::methodSize(Object& self,
+                                    const std::vector<Value>& args,
+                                    const StringFactory& makeString,
+                                    const ValueStrInvoker& valueStr) const {
+    (void)args;
+    (void)makeString;
+    (void)valueStr;
+    return Value::Int(static_cast<std::int64_t>(requireBuilder(self).data().size()));
+}
+
+Value StringBuilderType::memberLengthGet(Object& self) const {
+    return Value::Int(static_cast<std::int64_t>(requireBuilder(self).data().size()));
+}
+
+Value StringBuilderType::memberLengthSet(Object& self, const Value& value) const {
+    (void)self;
+    (void)value;
+    throw std::runtime_error("StringBuilder.length is read-only");
+}
+
+} // namespace gs
@@ -17,6 +17,10 @@ const Type& StringObject::getType() const {
     return *type_;
 }
 
+std::size_t StringObject::memoryFootprint() const {
+    return sizeof(StringObject) + data_.capacity();
+}
+
 std::string& StringObject::data() {
     return data_;
 }
@@ -29,6 +33,14 @@ std::size_t StringObject::size() const {
     return data_.size();
 }
 
+bool StringObject::isAppendTarget() const {
+    return appendTarget_;
+}
+
+void StringObject::setAppendTarget(bool value) {
+    appendTarget_ = value;
+}
+
 char StringObject::at(std::size_t index) const {
     if (index >= data_.size()) {
         throw std::out_of_range("String index out of range");
@@ -148,7 +160,7 @@ std::string StringType::__str__(Object& self, const ValueStrInvoker& valueStr) c
 }
 
 std::string StringType::getStringContent(const Value& value, const ValueStrInvoker& valueStr) {
-    if (value.type == ValueType::Ref) {
+    if (value.valueType() == ValueType::Ref) {
         Object* obj = value.asRef();
         if (obj && dynamic_cast<StringObject*>(obj)) {
             return static_cast<StringObject*>(obj)->data();
@@ -215,7 +227,7 @@ Value StringType::methodSubstr(Object& self,
                                const ValueStrInvoker& valueStr) const {
     StringObject& str = requireString(self);
     (void)valueStr;
-    if (args[0].type != ValueType::Int || args[1].type != ValueType::Int) {
+    if (args[0].valueType() != ValueType::Int || args[1].valueType() != ValueType::Int) {
         throw std::runtime_error("substr expects integer arguments");
     }
     const std::int64_t startArg = args[0].asInt();
@@ -234,7 +246,7 @@ Value StringType::methodSlice(Object& self,
                               const ValueStrInvoker& valueStr) const {
     StringObject& str = requireString(self);
     (void)valueStr;
-    if (args[0].type != ValueType::Int || args[1].type != ValueType::Int) {
+    if (args[0].valueType() != ValueType::Int || args[1].valueType() != ValueType::Int) {
         throw std::runtime_error("slice expects integer arguments");
     }
     const std::int64_t startArg = args[0].asInt();
@@ -358,7 +370,7 @@ Value StringType::methodAt(Object& self,
                            const ValueStrInvoker& valueStr) const {
     StringObject& str = requireString(self);
     (void)valueStr;
-    if (args[0].type != ValueType::Int) {
+    if (args[0].valueType() != ValueType::Int) {
         throw std::runtime_error("at expects an integer index");
     }
     std::size_t index = static_cast<std::size_t>(args[0].asInt());
@@ -12,6 +12,10 @@ const Type& TupleObject::getType() const {
     return *type_;
 }
 
+std::size_t TupleObject::memoryFootprint() const {
+    return sizeof(TupleObject) + data_.capacity() * sizeof(Value);
+}
+
 std::vector<Value>& TupleObject::data() {
     return data_;
 }
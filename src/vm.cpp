@@ -1,5 +1,7 @@
 #include "gs/vm.hpp"
+#include "gs/aot.hpp"
 #include "gs/bound_class_type.hpp"
+#include "gs/bytecode_image.hpp"
 #include "gs/type_system/regex_type.hpp"
 #include "gs/error_logger.hpp"
 #include "gs/type_system/type_object_type.hpp"
@@ -7,13 +9,17 @@
 
 #include <chrono>
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <cctype>
 #include <cmath>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <new>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -21,6 +27,7 @@
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 namespace gs {
 
@@ -57,10 +64,10 @@ void collectArgs(std::vector<Value>& stack,
 
 const std::string& getString(const ExecutionContext& context, const Value& value) {
     const auto idx = static_cast<std::size_t>(value.asStringIndex());
-    if (idx >= context.stringPool.size()) {
+    if (!context.modulePin || idx >= context.modulePin->strings.size()) {
         throw std::runtime_error("String index out of range");
     }
-    return context.stringPool[idx];
+    return context.modulePin->strings[idx];
 }
 
 const StringObject* tryGetStringObject(const ExecutionContext& context, const Value& value) {
@@ -101,6 +108,12 @@ std::uint64_t nextGlobalObjectId() {
     return nextId.fetch_add(1, std::memory_order_relaxed);
 }
 
+// ModuleImage objects are marked shared. They live outside every context heap and are shared
+// between threads, so nothing may cache per-context state (protoRef) in them.
+bool isSharedObject(const Object& object) {
+    return object.isShared();
+}
+
 constexpr std::uint32_t kRegionSpanObjects = 256;
 
 bool tryGetObjectId(const ExecutionContext& context, Object* object, std::uint64_t& outId) {
@@ -313,7 +326,7 @@ const Type& immediateValueTypeOf(const Value& value) {
     static ModuleValueType moduleType;
     static RefValueType refType;
 
-    switch (value.type) {
+    switch (value.valueType()) {
     case ValueType::Nil:
         return nilType;
     case ValueType::Bool:
@@ -349,6 +362,19 @@ std::string __str__ImmediateValue(const ExecutionContext& context,
 }
 
 Value emplaceObject(ExecutionContext& context, std::unique_ptr<Object> object);
+// A spawned task between its runs. The VM it runs on stays with it while it is parked on a
+// channel and goes back to the task system's cache once the task is done.
+struct SpawnedTask {
+    std::shared_ptr<const Module> module;
+    const HostRegistry* hosts{nullptr};
+    TaskSystem* tasks{nullptr};
+    std::size_t functionIndex{0};
+    TransferredValues args;
+    MemoryLimits limits;
+    std::unique_ptr<VirtualMachine> vm;
+};
+
+bool runSpawnedTaskStep(SpawnedTask& task, TransferredValues& result, TaskParker& parker);
 
 Value getOrCreateModuleTypeObject(ExecutionContext& context,
                                   const std::shared_ptr<const Module>& modulePin,
@@ -529,7 +555,9 @@ Value ensureObjectProto(ExecutionContext& context,
                                               typeName,
                                               runtimeType,
                                               baseTypeRef);
-    object.setProtoRef(proto);
+    if (!isSharedObject(object)) {
+        object.setProtoRef(proto);
+    }
     return proto;
 }
 
@@ -812,17 +840,70 @@ bool matchExceptionTypeFast(ExecutionContext& context,
     return isTypeObjectAssignableFrom(actualTypeRef, expectedTypeRef);
 }
 
-std::size_t countYoungObjects(const ExecutionContext& context) {
-    std::size_t count = 0;
-    for (const auto& [id, meta] : context.gcMeta) {
-        (void)id;
-        if (meta.generation == GcGeneration::Young) {
-            ++count;
-        }
+void refreshObjectFootprint(ExecutionContext& context, std::uint64_t objectId, const Object& object) {
+    auto metaIt = context.gcMeta.find(objectId);
+    if (metaIt == context.gcMeta.end()) {
+        return;
+    }
+
+    const std::size_t bytes = object.memoryFootprint();
+    auto& meta = metaIt->second;
+    context.gc.liveBytes -= std::min(context.gc.liveBytes, meta.bytes);
+    context.gc.liveBytes += bytes;
+    meta.bytes = bytes;
+}
+
+std::string formatMemoryLimitMessage(const ExecutionContext& context, std::size_t requestedBytes) {
+    const auto& gc = context.gc;
+    std::ostringstream out;
+    out << kMemoryLimitExceededMessagePrefix
+        << " live=" << gc.liveBytes << " bytes/" << context.objectHeap.size() << " objects"
+        << ", requested=" << requestedBytes << " bytes"
+        << ", limit=" << gc.limits.maxBytes << " bytes/" << gc.limits.maxObjects << " objects";
+    return out.str();
+}
+
+bool exceedsMemoryLimits(const ExecutionContext& context, std::size_t extraBytes, std::size_t extraObjects) {
+    const auto& gc = context.gc;
+    if (gc.limitBypass) {
+        return false;
+    }
+    if (gc.limits.maxObjects != 0 && context.objectHeap.size() + extraObjects > gc.limits.maxObjects) {
+        return true;
+    }
+    return gc.limits.maxBytes != 0 && gc.liveBytes + extraBytes > gc.limits.maxBytes;
+}
+
+void updateEmergencyWatermarks(ExecutionContext& context) {
+    // The next emergency collection fires halfway between the surviving heap and the
+    // limit, so a live set close to the quota does not force a full GC on every step.
+    auto& gc = context.gc;
+    if (gc.limits.maxBytes != 0) {
+        const std::size_t live = std::min(gc.liveBytes, gc.limits.maxBytes);
+        gc.emergencyBytesWatermark = live + (gc.limits.maxBytes - live) / 2;
     }
-    return count;
+    if (gc.limits.maxObjects != 0) {
+        const std::size_t live = std::min(context.objectHeap.size(), gc.limits.maxObjects);
+        gc.emergencyObjectsWatermark = live + (gc.limits.maxObjects - live) / 2;
+    }
+}
+
+void applyMemoryLimits(ExecutionContext& context, const MemoryLimits& limits) {
+    context.gc.limits = limits;
+    updateEmergencyWatermarks(context);
 }
 
+struct MemoryLimitBypassScope {
+    explicit MemoryLimitBypassScope(ExecutionContext& context)
+        : gc(context.gc), previous(context.gc.limitBypass) {
+        gc.limitBypass = true;
+    }
+    ~MemoryLimitBypassScope() { gc.limitBypass = previous; }
+
+    GcState& gc;
+    bool previous;
+};
+
 bool markObjectId(ExecutionContext& context,
                   std::uint64_t objectId,
                   bool youngOnly,
@@ -858,17 +939,8 @@ void markValue(ExecutionContext& context, const Value& value, bool youngOnly) {
     (void)markObjectId(context, objectId, youngOnly, false);
 }
 
-void traceObjectChildren(ExecutionContext& context, std::uint64_t objectId, bool youngOnly) {
-    auto objectIt = context.objectHeap.find(objectId);
-    if (objectIt == context.objectHeap.end() || !objectIt->second) {
-        return;
-    }
-
-    Object* object = objectIt->second.get();
-    if (!object) {
-        return;
-    }
-
+void markObjectChildren(ExecutionContext& context, Object& objectRef, bool youngOnly) {
+    Object* object = &objectRef;
     const auto markChild = [&](const Value& value) {
         markValue(context, value, youngOnly);
     };
@@ -914,6 +986,13 @@ void traceObjectChildren(ExecutionContext& context, std::uint64_t objectId, bool
         return;
     }
 
+    if (auto* tuple = dynamic_cast<TupleObject*>(object)) {
+        for (const auto& value : tuple->data()) {
+            markChild(value);
+        }
+        return;
+    }
+
     if (auto* cell = dynamic_cast<UpvalueCellObject*>(object)) {
         markChild(cell->value());
         return;
@@ -930,6 +1009,18 @@ void traceObjectChildren(ExecutionContext& context, std::uint64_t objectId, bool
         }
 }
 
+void traceObjectChildren(ExecutionContext& context, std::uint64_t objectId, bool youngOnly) {
+    auto objectIt = context.objectHeap.find(objectId);
+    if (objectIt == context.objectHeap.end() || !objectIt->second) {
+        return;
+    }
+
+    if (context.gc.limits.maxBytes != 0) {
+        refreshObjectFootprint(context, objectId, *objectIt->second);
+    }
+    markObjectChildren(context, *objectIt->second, youngOnly);
+}
+
 void markRoots(ExecutionContext& context, bool youngOnly) {
     for (const auto& frame : context.frames) {
         markValue(context, frame.constructorInstance, youngOnly);
@@ -946,13 +1037,34 @@ void markRoots(ExecutionContext& context, bool youngOnly) {
         for (std::size_t i = 0; i < frame.stackTop; ++i) {
             markValue(context, frame.stack[i], youngOnly);
         }
+        if (frame.region) {
+            // Frame-scoped objects are not collected themselves; whatever they reference is live.
+            frame.region->forEachObject([&](Object& object) {
+                markObjectChildren(context, object, youngOnly);
+            });
+        }
     }
     markValue(context, context.returnValue, youngOnly);
+    for (const auto& value : context.hostRoots) {
+        markValue(context, value, youngOnly);
+    }
 
-    for (const auto& [modulePtr, globals] : context.moduleRuntimeGlobals) {
+    for (const auto& [modulePtr, globals] : context.moduleGlobals) {
         (void)modulePtr;
-        for (const auto& [name, value] : globals) {
-            (void)name;
+        for (const auto& value : globals.values) {
+            markValue(context, value, youngOnly);
+        }
+        for (const auto& slot : globals.names) {
+            markValue(context, slot.value, youngOnly);
+        }
+    }
+
+    for (const auto& [modulePtr, linked] : context.moduleImports) {
+        (void)modulePtr;
+        for (const auto& value : linked.modules) {
+            markValue(context, value, youngOnly);
+        }
+        for (const auto& value : linked.symbols) {
             markValue(context, value, youngOnly);
         }
     }
@@ -984,6 +1096,7 @@ void markRoots(ExecutionContext& context, bool youngOnly) {
 
 void beginMinorGc(ExecutionContext& context) {
     context.gc.phase = GcPhase::MinorMark;
+    context.gc.rootsRescanned = false;
     context.gc.markQueue.clear();
     context.gc.sweepList.clear();
     context.gc.markCursor = 0;
@@ -1001,6 +1114,7 @@ void beginMinorGc(ExecutionContext& context) {
 
 void beginMajorGc(ExecutionContext& context) {
     context.gc.phase = GcPhase::MajorMark;
+    context.gc.rootsRescanned = false;
     context.gc.markQueue.clear();
     context.gc.sweepList.clear();
     context.gc.markCursor = 0;
@@ -1014,18 +1128,22 @@ void beginMajorGc(ExecutionContext& context) {
     markRoots(context, false);
 }
 
+std::size_t majorTriggerObjects(const ExecutionContext& context) {
+    return std::max(context.gc.majorObjectThreshold, context.gc.nextMajorObjects);
+}
+
 void maybeStartGcCycle(ExecutionContext& context) {
     if (context.gc.phase != GcPhase::Idle) {
         return;
     }
 
-    if (context.gc.requestMajor || context.objectHeap.size() >= context.gc.majorObjectThreshold) {
+    if (context.gc.requestMajor || context.objectHeap.size() >= majorTriggerObjects(context)) {
         context.gc.requestMajor = false;
         beginMajorGc(context);
         return;
     }
 
-    if (countYoungObjects(context) >= context.gc.minorYoungThreshold) {
+    if (context.gc.youngObjects >= context.gc.minorYoungThreshold) {
         beginMinorGc(context);
     }
 }
@@ -1043,6 +1161,9 @@ void prepareSweepList(ExecutionContext& context, bool youngOnly) {
 }
 
 void finishGcCycle(ExecutionContext& context) {
+    if (context.gc.phase == GcPhase::MajorSweep) {
+        context.gc.nextMajorObjects = context.objectHeap.size() * context.gc.majorGrowthFactor;
+    }
     context.gc.phase = GcPhase::Idle;
     context.gc.markQueue.clear();
     context.gc.sweepList.clear();
@@ -1070,6 +1191,13 @@ void runGcSlice(ExecutionContext& context, std::size_t budgetObjects) {
             }
 
             const bool youngOnly = context.gc.phase == GcPhase::MinorMark;
+            // Roots were scanned when the cycle began; the mutator may since have moved
+            // references into locals/stack slots, so rescan before declaring marking done.
+            if (!context.gc.rootsRescanned) {
+                context.gc.rootsRescanned = true;
+                markRoots(context, youngOnly);
+                continue;
+            }
             prepareSweepList(context, youngOnly);
             context.gc.phase = youngOnly ? GcPhase::MinorSweep : GcPhase::MajorSweep;
             continue;
@@ -1103,6 +1231,10 @@ void runGcSlice(ExecutionContext& context, std::size_t budgetObjects) {
                     context.objectPtrToId.erase(objectIt->second.get());
                     context.objectHeap.erase(objectIt);
                 }
+                context.gc.liveBytes -= std::min(context.gc.liveBytes, meta.bytes);
+                if (meta.generation == GcGeneration::Young) {
+                    --context.gc.youngObjects;
+                }
                 context.gcMeta.erase(metaIt);
                 context.gc.rememberedSet.erase(objectId);
             } else {
@@ -1110,6 +1242,7 @@ void runGcSlice(ExecutionContext& context, std::size_t budgetObjects) {
                     ++meta.age;
                     if (meta.age >= context.gc.promotionAge) {
                         meta.generation = GcGeneration::Old;
+                        --context.gc.youngObjects;
                     }
                 }
                 meta.marked = false;
@@ -1160,11 +1293,21 @@ Value collectGarbageNow(ExecutionContext& context, std::int64_t generation) {
     return Value::Int(static_cast<std::int64_t>(reclaimed));
 }
 
+bool isGcMarking(const ExecutionContext& context) {
+    return context.gc.phase == GcPhase::MinorMark || context.gc.phase == GcPhase::MajorMark;
+}
+
 void rememberWriteBarrier(ExecutionContext& context, Object& owner, const Value& assigned) {
     if (!assigned.isRef()) {
         return;
     }
 
+    // Insertion barrier: an object stored into an already-traced owner mid-cycle
+    // would otherwise never be visited.
+    if (isGcMarking(context)) {
+        markValue(context, assigned, context.gc.phase == GcPhase::MinorMark);
+    }
+
     std::uint64_t ownerId = 0;
     std::uint64_t targetId = 0;
     if (!tryGetObjectId(context, &owner, ownerId)) {
@@ -1186,28 +1329,84 @@ void rememberWriteBarrier(ExecutionContext& context, Object& owner, const Value&
     }
 }
 
-void registerAllocatedObject(ExecutionContext& context, std::uint64_t id, Object* object) {
+void registerAllocatedObject(ExecutionContext& context, std::uint64_t id, Object* object, std::size_t bytes) {
     context.objectPtrToId[object] = id;
 
     GcObjectMeta meta;
     meta.regionId = static_cast<std::uint32_t>(id / kRegionSpanObjects);
+    meta.bytes = bytes;
     context.gcMeta[id] = meta;
+    context.gc.liveBytes += bytes;
+    ++context.gc.youngObjects;
+
+    // Allocate gray while marking: the new object may already hold references to
+    // unmarked objects (e.g. list literal elements) and is not reachable from scanned roots.
+    if (isGcMarking(context)) {
+        (void)markObjectId(context, id, context.gc.phase == GcPhase::MinorMark, false);
+    }
 
     ++context.gc.allocCountSinceLastCycle;
-    if (context.objectHeap.size() >= context.gc.majorObjectThreshold) {
+    if (context.objectHeap.size() >= majorTriggerObjects(context)) {
         context.gc.requestMajor = true;
     }
 }
 
 Value emplaceObject(ExecutionContext& context, std::unique_ptr<Object> object) {
+    const std::size_t bytes = object->memoryFootprint();
+    if (exceedsMemoryLimits(context, bytes, 1)) {
+        throw std::runtime_error(formatMemoryLimitMessage(context, bytes));
+    }
+
     const std::uint64_t id = nextGlobalObjectId();
     object->setObjectId(id);
     Object* rawObject = object.get();
     context.objectHeap.emplace(id, std::move(object));
-    registerAllocatedObject(context, id, rawObject);
+    registerAllocatedObject(context, id, rawObject, bytes);
     return Value::Ref(rawObject);
 }
 
+// Re-measures a container after a native method may have grown it in place.
+void accountObjectGrowth(ExecutionContext& context, Object& object) {
+    if (context.gc.limits.maxBytes == 0) {
+        return;
+    }
+
+    std::uint64_t objectId = 0;
+    if (!tryGetObjectId(context, &object, objectId)) {
+        return;
+    }
+
+    refreshObjectFootprint(context, objectId, object);
+    if (exceedsMemoryLimits(context, 0, 0)) {
+        throw std::runtime_error(formatMemoryLimitMessage(context, object.memoryFootprint()));
+    }
+}
+
+// Native methods such as list.push/dict.set may store their arguments inside the
+// receiver, so an old container must be remembered and its growth re-measured.
+void recordNativeMutation(ExecutionContext& context, Object& object, const std::vector<Value>& args) {
+    for (const auto& arg : args) {
+        rememberWriteBarrier(context, object, arg);
+    }
+    accountObjectGrowth(context, object);
+}
+
+// Called at instruction boundaries: once usage crosses the watermark, run a full major
+// collection synchronously instead of waiting for incremental slices to catch up.
+void relieveMemoryPressure(ExecutionContext& context) {
+    const auto& gc = context.gc;
+    const bool bytesHigh = gc.limits.maxBytes != 0 && gc.liveBytes >= gc.emergencyBytesWatermark;
+    const bool objectsHigh = gc.limits.maxObjects != 0 &&
+                             context.objectHeap.size() >= gc.emergencyObjectsWatermark;
+    if (!bytesHigh && !objectsHigh) {
+        return;
+    }
+
+    (void)collectGarbageNow(context, 1);
+    ++context.gc.emergencyCollections;
+    updateEmergencyWatermarks(context);
+}
+
 std::string __str__RefObject(const ExecutionContext& context,
                              Object* object,
                              std::unordered_set<std::uint64_t>& visitingRefs) {
@@ -1296,7 +1495,7 @@ std::string typeNameOfValue(const ExecutionContext& context, const Value& value)
         return "string";
     }
 
-    switch (value.type) {
+    switch (value.valueType()) {
     case ValueType::Nil:
         return "null";
     case ValueType::Bool:
@@ -1404,7 +1603,7 @@ const std::string* findClassAttributeDeclaredType(const Module& module,
                                                   const std::string& attrName) {
     std::int32_t walk = static_cast<std::int32_t>(classIndex);
     while (walk >= 0) {
-        const auto& cls = module.classes.at(static_cast<std::size_t>(walk));
+        const auto& cls = currentClass(module, static_cast<std::size_t>(walk));
         for (const auto& attr : cls.attributes) {
             if (attr.name == attrName) {
                 return &attr.declaredTypeName;
@@ -1416,9 +1615,175 @@ const std::string* findClassAttributeDeclaredType(const Module& module,
 }
 #endif
 
+StringType& runtimeStringType() {
+    static StringType type;
+    return type;
+}
+
+} // namespace
+
+// Shared string objects of a module's string table. Slots are filled on first use without a
+// lock; the table only grows (lazy compilation, hot reload), so they use StableVector's chunks.
+class ModuleImage {
+public:
+    ~ModuleImage() {
+        for (std::size_t chunk = 0; chunk < kChunkCount; ++chunk) {
+            std::atomic<Object*>* slots = strings_[chunk].load(std::memory_order_acquire);
+            if (!slots) {
+                continue;
+            }
+            for (std::size_t i = 0; i < (kFirstChunk << chunk); ++i) {
+                delete slots[i].load(std::memory_order_relaxed);
+            }
+            delete[] slots;
+        }
+    }
+
+    Object& string(const Module& module, std::size_t index) {
+        std::atomic<Object*>& slot = stringSlot(index);
+        Object* object = slot.load(std::memory_order_acquire);
+        if (object) {
+            return *object;
+        }
+        auto created = std::make_unique<StringObject>(runtimeStringType(), module.strings.at(index));
+        created->setObjectId(nextGlobalObjectId());
+        created->markShared();
+        if (slot.compare_exchange_strong(object, created.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return *created.release();
+        }
+        return *object;
+    }
+
+private:
+    static constexpr std::size_t kFirstChunk = 16;
+    static constexpr std::size_t kChunkCount = 40;
+
+    std::atomic<Object*>& stringSlot(std::size_t index) {
+        const auto chunk = static_cast<std::size_t>(std::bit_width(index / kFirstChunk + 1)) - 1;
+        const std::size_t offset = index - kFirstChunk * ((std::size_t{1} << chunk) - 1);
+        std::atomic<Object*>* slots = strings_[chunk].load(std::memory_order_acquire);
+        if (!slots) {
+            auto fresh = std::make_unique<std::atomic<Object*>[]>(kFirstChunk << chunk);
+            if (strings_[chunk].compare_exchange_strong(slots, fresh.get(), std::memory_order_acq_rel,
+                                                        std::memory_order_acquire)) {
+                slots = fresh.release();
+            }
+        }
+        return slots[offset];
+    }
+
+    std::array<std::atomic<std::atomic<Object*>*>, kChunkCount> strings_{};
+};
+
+namespace {
+
 Value makeRuntimeString(ExecutionContext& context, const std::string& text) {
-    static StringType runtimeStringType;
-    return emplaceObject(context, std::make_unique<StringObject>(runtimeStringType, text));
+    return emplaceObject(context, std::make_unique<StringObject>(runtimeStringType(), text));
+}
+
+bool isNonEscapingSite(const FunctionBytecode& fn, std::size_t ip) {
+    return !fn.nonEscapingAllocSites.empty() &&
+           std::binary_search(fn.nonEscapingAllocSites.begin(),
+                              fn.nonEscapingAllocSites.end(),
+                              static_cast<std::uint32_t>(ip));
+}
+
+// Frame-scoped objects get an identity (id(), stale-reference checks) but no GC metadata;
+// the collector only traces through them as roots.
+FrameRegion& prepareFrameRegionSite(ExecutionContext& context, Frame& frame, std::uint32_t site) {
+    if (!frame.region) {
+        frame.region = std::make_unique<FrameRegion>();
+    }
+    if (Object* retiring = frame.region->retiringOccupant(site)) {
+        context.objectPtrToId.erase(retiring);
+    }
+    return *frame.region;
+}
+
+void bindFrameScopedObject(ExecutionContext& context, Object& object) {
+    object.setObjectId(nextGlobalObjectId());
+    context.objectPtrToId[&object] = object.objectId();
+}
+
+template <typename T, typename... Args>
+Value emplaceFrameScopedObject(ExecutionContext& context, Frame& frame, std::uint32_t site, Args&&... args) {
+    FrameRegion& region = prepareFrameRegionSite(context, frame, site);
+    T* object = ::new (region.acquire(site, sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    region.commit(site, object);
+    bindFrameScopedObject(context, *object);
+    return Value::Ref(object);
+}
+
+Value adoptFrameScopedObject(ExecutionContext& context,
+                             Frame& frame,
+                             std::uint32_t site,
+                             std::unique_ptr<Object> object) {
+    Object* rawObject = object.get();
+    prepareFrameRegionSite(context, frame, site).adopt(site, std::move(object));
+    bindFrameScopedObject(context, *rawObject);
+    return Value::Ref(rawObject);
+}
+
+// String result of the instruction just dispatched from frame.
+Value makeInstructionString(ExecutionContext& context,
+                            const FunctionBytecode& fn,
+                            Frame& frame,
+                            const std::string& text) {
+    const std::size_t site = frame.ip - 1;
+    if (isNonEscapingSite(fn, site)) {
+        return emplaceFrameScopedObject<StringObject>(context,
+                                                      frame,
+                                                      static_cast<std::uint32_t>(site),
+                                                      runtimeStringType(),
+                                                      text);
+    }
+    return makeRuntimeString(context, text);
+}
+
+void releaseFrameRegion(ExecutionContext& context, Frame& frame) {
+    if (!frame.region) {
+        return;
+    }
+    frame.region->forEachObject([&](Object& object) {
+        context.objectPtrToId.erase(&object);
+    });
+    frame.region.reset();
+}
+
+void popFrame(ExecutionContext& context) {
+    releaseFrameRegion(context, context.frames.back());
+    context.frames.pop_back();
+}
+
+void clearFrames(ExecutionContext& context) {
+    while (!context.frames.empty()) {
+        popFrame(context);
+    }
+}
+
+// a[i] / a[i] = v on unboxed arrays: no attribute lookup, host context or write barrier.
+bool tryNumericArrayIndexFastPath(Object& object,
+                                  const std::string& methodName,
+                                  const std::vector<Value>& args,
+                                  Value& out) {
+    const bool isGet = args.size() == 1 && methodName == "get";
+    const bool isSet = args.size() == 2 && methodName == "set";
+    if (!isGet && !isSet) {
+        return false;
+    }
+    if (auto* ints = dynamic_cast<IntArrayObject*>(&object)) {
+        out = isGet ? IntArrayType::readIndex(*ints, args[0]) : IntArrayType::writeIndex(*ints, args[0], args[1]);
+        return true;
+    }
+    if (auto* floats = dynamic_cast<FloatArrayObject*>(&object)) {
+        out = isGet ? FloatArrayType::readIndex(*floats, args[0]) : FloatArrayType::writeIndex(*floats, args[0], args[1]);
+        return true;
+    }
+    return false;
+}
+
+bool isFrameScopedNative(const std::string& functionName) {
+    return functionName == "str" || functionName == "Tuple";
 }
 
 Value makeRuntimeExceptionObject(ExecutionContext& context,
@@ -1438,13 +1803,10 @@ bool valueEquals(const ExecutionContext& context, const Value& lhs, const Value&
     if (tryExtractStringData(context, lhs, lhsString) && tryExtractStringData(context, rhs, rhsString)) {
         return lhsString == rhsString;
     }
-    if (lhs.type != rhs.type) {
+    if (lhs.valueType() != rhs.valueType()) {
         return false;
     }
-    if (lhs.type == ValueType::Ref) {
-        return lhs.asRef() == rhs.asRef();
-    }
-    return lhs.payload == rhs.payload;
+    return lhs.rawPayload() == rhs.rawPayload();
 }
 
 class VmHostContext final : public HostContext {
@@ -1453,13 +1815,26 @@ public:
     VmHostContext(VirtualMachine& vm, ExecutionContext& context) : vm_(&vm), context_(context) {}
 
     Value createObject(std::unique_ptr<Object> object) override {
+        if (Frame* frame = takeScopedAllocationFrame()) {
+            return adoptFrameScopedObject(context_, *frame, scopedSite_, std::move(object));
+        }
         return emplaceObject(context_, std::move(object));
     }
 
     Value createString(const std::string& text) override {
+        if (Frame* frame = takeScopedAllocationFrame()) {
+            return emplaceFrameScopedObject<StringObject>(context_, *frame, scopedSite_, runtimeStringType(), text);
+        }
         return makeRuntimeString(context_, text);
     }
 
+    // Places the next object this host call creates in the caller's frame region.
+    void scopeNextAllocation(std::size_t frameIndex, std::uint32_t site) {
+        scopedPending_ = true;
+        scopedFrameIndex_ = frameIndex;
+        scopedSite_ = site;
+    }
+
     Object& getObject(const Value& ref) override {
         if (!ref.isRef()) {
             throw std::runtime_error("Host context expects object reference");
@@ -1497,6 +1872,36 @@ public:
         return collectGarbageNow(context_, generation);
     }
 
+    std::size_t memoryUsage() override {
+        return context_.gc.liveBytes;
+    }
+
+    void setMemoryLimits(std::size_t maxBytes, std::size_t maxObjects) override {
+        // The current limits started as the host's, so only lowering keeps a script under them.
+        MemoryLimits limits = context_.gc.limits;
+        if (limits.maxBytes != 0 && maxBytes > limits.maxBytes) {
+            throw std::runtime_error("system.setMemoryLimit cannot raise the memory limit above " +
+                                     std::to_string(limits.maxBytes) + " bytes");
+        }
+        if (maxObjects != 0 && limits.maxObjects != 0 && maxObjects > limits.maxObjects) {
+            throw std::runtime_error("system.setMemoryLimit cannot raise the object limit above " +
+                                     std::to_string(limits.maxObjects) + " objects");
+        }
+        if (maxBytes < context_.gc.liveBytes) {
+            throw std::runtime_error("system.setMemoryLimit cannot go below the " +
+                                     std::to_string(context_.gc.liveBytes) + " bytes in use");
+        }
+        if (maxObjects != 0 && maxObjects < context_.objectHeap.size()) {
+            throw std::runtime_error("system.setMemoryLimit cannot go below the " +
+                                     std::to_string(context_.objectHeap.size()) + " objects in use");
+        }
+        limits.maxBytes = maxBytes;
+        if (maxObjects != 0) {
+            limits.maxObjects = maxObjects;
+        }
+        applyMemoryLimits(context_, limits);
+    }
+
     void ensureModuleInitialized(const Value& moduleRef) override {
         if (!moduleRef.isRef()) {
             throw std::runtime_error("loadModule result is not an object reference");
@@ -1529,6 +1934,34 @@ public:
         return true;
     }
 
+    Value parallelApply(const Value& callable, const std::vector<Value>& items, bool fold) override {
+        if (!vm_) {
+            throw std::runtime_error("parallel is unavailable in this host context");
+        }
+        return vm_->runParallel(context_, callable, items, fold);
+    }
+
+    Value awaitTasks(const std::vector<Value>& handles) override {
+        if (!vm_) {
+            throw std::runtime_error("await_all is unavailable in this host context");
+        }
+        return vm_->awaitTasks(context_, handles);
+    }
+
+    Value awaitAnyTask(const std::vector<Value>& handles, std::size_t& position) override {
+        if (!vm_) {
+            throw std::runtime_error("await_any is unavailable in this host context");
+        }
+        return vm_->awaitAnyTask(context_, handles, position);
+    }
+
+    bool pollTask(const Value& handle) override {
+        if (!vm_) {
+            throw std::runtime_error("poll is unavailable in this host context");
+        }
+        return vm_->pollTask(handle);
+    }
+
     void cacheModuleObject(const std::string& moduleKey, const Value& moduleRef) override {
         context_.moduleObjectCache[moduleKey] = moduleRef;
         if (moduleRef.isRef()) {
@@ -1542,8 +1975,22 @@ public:
     }
 
 private:
+    Frame* takeScopedAllocationFrame() {
+        if (!scopedPending_) {
+            return nullptr;
+        }
+        scopedPending_ = false;
+        if (scopedFrameIndex_ >= context_.frames.size()) {
+            return nullptr;
+        }
+        return &context_.frames[scopedFrameIndex_];
+    }
+
     VirtualMachine* vm_;
     ExecutionContext& context_;
+    bool scopedPending_{false};
+    std::size_t scopedFrameIndex_{0};
+    std::uint32_t scopedSite_{0};
 };
 
 Value makeFunctionObject(ExecutionContext& context,
@@ -1644,7 +2091,11 @@ Value normalizeRuntimeValue(ExecutionContext& context,
         if (stringIndex >= modulePin->strings.size()) {
             throw std::runtime_error("String index out of range");
         }
-        return makeRuntimeString(context, modulePin->strings[stringIndex]);
+        // Each context references the module's one literal object rather than allocating a copy;
+        // registering it passes ref checks, and the GC leaves objects without gcMeta alone.
+        Object& literal = modulePin->image.get().string(*modulePin, stringIndex);
+        context.objectPtrToId.try_emplace(&literal, literal.objectId());
+        return Value::Ref(&literal);
     }
 
     if (value.isLegacyStringLiteral() && !modulePin) {
@@ -1654,131 +2105,224 @@ Value normalizeRuntimeValue(ExecutionContext& context,
     return value;
 }
 
-Value resolveRuntimeName(ExecutionContext& context,
-                         FunctionType& functionType,
-                         ClassType& classType,
-                         NativeFunctionType& nativeFunctionType,
-                         ModuleType& moduleType,
-                         const HostRegistry& hosts,
-                         const std::shared_ptr<const Module>& frameModule,
-                         const std::string& name) {
-    if (!frameModule) {
-        throw std::runtime_error("Frame module is null");
+Value resolveSuperProxy(ExecutionContext& context) {
+    if (context.frames.empty()) {
+        throw std::runtime_error("'super' can only be used inside methods");
     }
 
-    if (name == "super") {
-        if (context.frames.empty()) {
-            throw std::runtime_error("'super' can only be used inside methods");
-        }
-
-        Frame& frame = context.frames.back();
-        if (!frame.modulePin) {
-            throw std::runtime_error("'super' requires valid method module binding");
-        }
+    Frame& frame = context.frames.back();
+    if (!frame.modulePin) {
+        throw std::runtime_error("'super' requires valid method module binding");
+    }
 
-        std::int32_t ownerClassIndex = -1;
+    const auto findOwnerClass = [&](const auto& isFrameMethod) {
         for (std::size_t i = 0; i < frame.modulePin->classes.size(); ++i) {
             for (const auto& method : frame.modulePin->classes[i].methods) {
-                if (method.functionIndex == frame.functionIndex) {
-                    ownerClassIndex = static_cast<std::int32_t>(i);
-                    break;
+                if (isFrameMethod(method)) {
+                    return static_cast<std::int32_t>(i);
                 }
             }
-            if (ownerClassIndex >= 0) {
-                break;
-            }
         }
+        return std::int32_t{-1};
+    };
+    std::int32_t ownerClassIndex = findOwnerClass([&](const ClassMethodBinding& method) {
+        return method.functionIndex == frame.functionIndex;
+    });
+    if (ownerClassIndex < 0) {
+        // Methods are bound by their first entry; the frame may run a hot-reloaded version.
+        const std::string& methodName = frame.modulePin->functions[frame.functionIndex].name;
+        ownerClassIndex = findOwnerClass([&](const ClassMethodBinding& method) {
+            return frame.modulePin->functions[method.functionIndex].name == methodName;
+        });
+    }
 
-        if (ownerClassIndex < 0) {
-            throw std::runtime_error("'super' can only be used in class methods");
-        }
+    if (ownerClassIndex < 0) {
+        throw std::runtime_error("'super' can only be used in class methods");
+    }
 
-        if (frame.locals.empty()) {
-            throw std::runtime_error("'super' method frame is missing self argument");
-        }
+    if (frame.locals.empty()) {
+        throw std::runtime_error("'super' method frame is missing self argument");
+    }
 
-        const Value selfRef = frame.locals.front();
-        if (!selfRef.isRef()) {
-            throw std::runtime_error("'super' requires self to be an instance object");
-        }
+    const Value selfRef = frame.locals.front();
+    if (!selfRef.isRef()) {
+        throw std::runtime_error("'super' requires self to be an instance object");
+    }
 
-        Object* selfObject = selfRef.asRef();
-        if (!selfObject || !context.objectPtrToId.contains(selfObject)) {
-            throw std::runtime_error("'super' self reference is stale");
-        }
+    Object* selfObject = selfRef.asRef();
+    if (!selfObject || !context.objectPtrToId.contains(selfObject)) {
+        throw std::runtime_error("'super' self reference is stale");
+    }
 
-        auto* instance = dynamic_cast<ScriptInstanceObject*>(selfObject);
-        if (!instance) {
-            throw std::runtime_error("'super' requires script instance as self");
-        }
+    auto* instance = dynamic_cast<ScriptInstanceObject*>(selfObject);
+    if (!instance) {
+        throw std::runtime_error("'super' requires script instance as self");
+    }
 
-        const auto& ownerClass = frame.modulePin->classes.at(static_cast<std::size_t>(ownerClassIndex));
-        const std::int32_t scriptBaseClassIndex = ownerClass.baseClassIndex;
-        Value nativeBaseRef = Value::Nil();
-        if (instance->hasNativeBase()) {
-            nativeBaseRef = instance->nativeBaseRef();
-        }
+    const auto& ownerClass = frame.modulePin->classes.at(static_cast<std::size_t>(ownerClassIndex));
+    const std::int32_t scriptBaseClassIndex = ownerClass.baseClassIndex;
+    Value nativeBaseRef = Value::Nil();
+    if (instance->hasNativeBase()) {
+        nativeBaseRef = instance->nativeBaseRef();
+    }
 
-        if (scriptBaseClassIndex < 0 && !nativeBaseRef.isRef()) {
-            throw std::runtime_error("'super' used in class without base type");
-        }
+    if (scriptBaseClassIndex < 0 && !nativeBaseRef.isRef()) {
+        throw std::runtime_error("'super' used in class without base type");
+    }
+
+    static SuperProxyType superProxyType;
+    return emplaceObject(context,
+                         std::make_unique<SuperProxyObject>(superProxyType,
+                                                            selfRef,
+                                                            frame.modulePin,
+                                                            scriptBaseClassIndex,
+                                                            nativeBaseRef));
+}
 
-        static SuperProxyType superProxyType;
-        return emplaceObject(context,
-                             std::make_unique<SuperProxyObject>(superProxyType,
-                                                                selfRef,
-                                                                frame.modulePin,
-                                                                scriptBaseClassIndex,
-                                                                nativeBaseRef));
+ModuleGlobals& moduleGlobals(ExecutionContext& context, const Module& module) {
+    auto& globals = context.moduleGlobals[&module];
+    // Lazily compiled bodies add names and hot reload adds globals; values and slots linked so
+    // far stay.
+    if (globals.values.size() < module.globals.size()) {
+        globals.values.resize(module.globals.size(), Value::Nil());
+        globals.assigned.resize(module.globals.size(), 0);
+    }
+    if (globals.names.size() < module.strings.size()) {
+        globals.names.resize(module.strings.size());
     }
+    return globals;
+}
+
+const Value& readModuleGlobal(ExecutionContext& context,
+                              FunctionType& functionType,
+                              ClassType& classType,
+                              NativeFunctionType& nativeFunctionType,
+                              ModuleType& moduleType,
+                              const HostRegistry& hosts,
+                              const std::shared_ptr<const Module>& module,
+                              ModuleGlobals& globals,
+                              std::size_t globalIndex) {
+    if (!globals.assigned[globalIndex]) {
+        // Not stored yet: materialize the declared initial value once.
+        globals.values[globalIndex] = normalizeRuntimeValue(context,
+                                                            functionType,
+                                                            classType,
+                                                            nativeFunctionType,
+                                                            moduleType,
+                                                            hosts,
+                                                            module,
+                                                            module->globals[globalIndex].initialValue,
+                                                            true);
+        globals.assigned[globalIndex] = 1;
+    }
+    return globals.values[globalIndex];
+}
 
-    auto moduleGlobalsIt = context.moduleRuntimeGlobals.find(frameModule.get());
-    if (moduleGlobalsIt != context.moduleRuntimeGlobals.end()) {
-        auto nameIt = moduleGlobalsIt->second.find(name);
-        if (nameIt != moduleGlobalsIt->second.end()) {
-            return nameIt->second;
+bool linkGlobalName(const Module& module, ModuleGlobals& globals, NameSlot& slot, std::size_t nameIndex) {
+    const std::string& name = module.strings.at(nameIndex);
+    for (std::size_t i = 0; i < module.globals.size(); ++i) {
+        if (module.globals[i].name == name) {
+            if (i >= globals.values.size()) {
+                // Added by a hot reload since this context last looked.
+                globals.values.resize(i + 1, Value::Nil());
+                globals.assigned.resize(i + 1, 0);
+            }
+            slot.kind = NameSlot::Kind::Global;
+            slot.global = static_cast<std::uint32_t>(i);
+            return true;
         }
     }
+    return false;
+}
+
+// Binds `slot` to what strings[nameIndex] names in this module: a global, then a function or
+// class of the module, then a host builtin. Functions, classes and builtins are immutable
+// bindings, so their values are created once and kept in the slot.
+void linkRuntimeName(ExecutionContext& context,
+                     FunctionType& functionType,
+                     ClassType& classType,
+                     NativeFunctionType& nativeFunctionType,
+                     ModuleType& moduleType,
+                     const HostRegistry& hosts,
+                     const std::shared_ptr<const Module>& frameModule,
+                     ModuleGlobals& globals,
+                     NameSlot& slot,
+                     std::size_t nameIndex) {
+    const std::string& name = frameModule->strings.at(nameIndex);
+    if (name == "super") {
+        slot.kind = NameSlot::Kind::Super;
+        return;
+    }
 
-    for (const auto& global : frameModule->globals) {
-        if (global.name == name) {
-            Value normalized = normalizeRuntimeValue(context,
-                                                     functionType,
-                                                     classType,
-                                                     nativeFunctionType,
-                                                     moduleType,
-                                                     hosts,
-                                                     frameModule,
-                                                     global.initialValue,
-                                                     true);
-            context.moduleRuntimeGlobals[frameModule.get()][name] = normalized;
-            return normalized;
-        }
+    if (linkGlobalName(*frameModule, globals, slot, nameIndex)) {
+        return;
     }
 
     for (std::size_t i = 0; i < frameModule->functions.size(); ++i) {
         if (frameModule->functions[i].name == name) {
-            return makeFunctionObject(context, functionType, i, frameModule);
+            slot.value = makeFunctionObject(context, functionType, i, frameModule);
+            slot.kind = NameSlot::Kind::Value;
+            return;
         }
     }
 
     for (std::size_t i = 0; i < frameModule->classes.size(); ++i) {
         if (frameModule->classes[i].name == name) {
-            return makeClassObjectValue(context, classType, frameModule, i);
+            slot.value = makeClassObjectValue(context, classType, frameModule, i);
+            slot.kind = NameSlot::Kind::Value;
+            return;
         }
     }
 
     if (hosts.has(name)) {
         VmHostContext hostContext(context);
-        return hosts.resolveBuiltin(name,
-                                    hostContext,
-                                    nativeFunctionType,
-                                    moduleType);
+        slot.value = hosts.resolveBuiltin(name,
+                                          hostContext,
+                                          nativeFunctionType,
+                                          moduleType);
+        slot.kind = NameSlot::Kind::Value;
+        return;
     }
 
     throw std::runtime_error("Undefined symbol: " + name);
 }
 
+Value resolveRuntimeName(ExecutionContext& context,
+                         FunctionType& functionType,
+                         ClassType& classType,
+                         NativeFunctionType& nativeFunctionType,
+                         ModuleType& moduleType,
+                         const HostRegistry& hosts,
+                         const std::shared_ptr<const Module>& frameModule,
+                         std::size_t nameIndex) {
+    if (!frameModule) {
+        throw std::runtime_error("Frame module is null");
+    }
+
+    ModuleGlobals& globals = moduleGlobals(context, *frameModule);
+    NameSlot& slot = globals.names.at(nameIndex);
+    if (slot.kind == NameSlot::Kind::Unresolved) {
+        linkRuntimeName(context, functionType, classType, nativeFunctionType, moduleType, hosts, frameModule, globals, slot, nameIndex);
+    }
+
+    switch (slot.kind) {
+    case NameSlot::Kind::Global:
+        return readModuleGlobal(context,
+                                functionType,
+                                classType,
+                                nativeFunctionType,
+                                moduleType,
+                                hosts,
+                                frameModule,
+                                globals,
+                                slot.global);
+    case NameSlot::Kind::Super:
+        return resolveSuperProxy(context);
+    default:
+        return slot.value;
+    }
+}
+
 Object& getObjectFromHeap(ExecutionContext& context, const Value& ref) {
     if (!ref.isRef()) {
         throw std::runtime_error("Method target is not an object reference");
@@ -1793,12 +2337,11 @@ Object& getObjectFromHeap(ExecutionContext& context, const Value& ref) {
     return *object;
 }
 
-void storeRuntimeGlobal(ExecutionContext& context,
+// Keeps the module object's exports (seen by hosts and loadModule) in step with a global store.
+void mirrorModuleExport(ExecutionContext& context,
                         const std::shared_ptr<const Module>& frameModule,
                         const std::string& symbolName,
                         const Value& value) {
-    context.moduleRuntimeGlobals[frameModule.get()][symbolName] = value;
-
     auto moduleRefIt = context.moduleRuntimeObjects.find(frameModule.get());
     if (moduleRefIt != context.moduleRuntimeObjects.end() && moduleRefIt->second.isRef()) {
         Object& moduleObjectBase = getObjectFromHeap(context, moduleRefIt->second);
@@ -1809,6 +2352,33 @@ void storeRuntimeGlobal(ExecutionContext& context,
     }
 }
 
+void storeRuntimeGlobal(ExecutionContext& context,
+                        const std::shared_ptr<const Module>& frameModule,
+                        const std::string& symbolName,
+                        const Value& value) {
+    ModuleGlobals& globals = moduleGlobals(context, *frameModule);
+    bool stored = false;
+    for (std::size_t i = 0; i < globals.values.size(); ++i) {
+        if (frameModule->globals[i].name == symbolName) {
+            globals.values[i] = value;
+            globals.assigned[i] = 1;
+            stored = true;
+            break;
+        }
+    }
+    if (!stored) {
+        // Not a declared global: rebinding shadows the function/class/builtin of that name.
+        for (std::size_t i = 0; i < frameModule->strings.size(); ++i) {
+            if (frameModule->strings[i] == symbolName) {
+                globals.names[i].kind = NameSlot::Kind::Value;
+                globals.names[i].value = value;
+            }
+        }
+    }
+
+    mirrorModuleExport(context, frameModule, symbolName, value);
+}
+
 void initializeInstanceAttributes(const Module& module,
                                   ExecutionContext& context,
                                   FunctionType& functionType,
@@ -1881,6 +2451,7 @@ Value makeScriptInstance(ExecutionContext& context,
     if (!instance) {
         throw std::runtime_error("Failed to create script instance");
     }
+    instance->setLayoutStamp(module.classes.size());
     initializeInstanceAttributes(module,
                                  context,
                                  functionType,
@@ -1928,7 +2499,7 @@ bool tryFindClassMethodInModule(const Module& module,
                                 std::size_t& outFunctionIndex) {
     std::int32_t index = static_cast<std::int32_t>(classIndex);
     while (index >= 0) {
-        const auto& cls = module.classes.at(static_cast<std::size_t>(index));
+        const auto& cls = currentClass(module, static_cast<std::size_t>(index));
         for (const auto& method : cls.methods) {
             if (method.name == methodName) {
                 outFunctionIndex = method.functionIndex;
@@ -1954,7 +2525,7 @@ void initializeInstanceAttributes(const Module& module,
         throw std::runtime_error("Class index out of range");
     }
 
-    const auto& cls = module.classes[classIndex];
+    const auto& cls = currentClass(module, classIndex);
     if (cls.baseClassIndex >= 0) {
         initializeInstanceAttributes(module,
                                      context,
@@ -1988,8 +2559,192 @@ void initializeInstanceAttributes(const Module& module,
     }
 }
 
+// Brings an instance created before a hot reload to its class's current layout: attributes the
+// newer versions retired are removed and attributes they added get their defaults. Values of
+// attributes both layouts declare are kept.
+void migrateInstanceLayout(ExecutionContext& context,
+                           FunctionType& functionType,
+                           ClassType& classType,
+                           NativeFunctionType& nativeFunctionType,
+                           ModuleType& moduleType,
+                           const HostRegistry& hosts,
+                           ScriptInstanceObject& instance) {
+    const auto& modulePin = instance.modulePin();
+    const Module& module = *modulePin;
+    const std::size_t stamp = instance.layoutStamp();
+    const std::size_t classCount = module.classes.size();
+    std::unordered_set<std::string> declared;
+    std::vector<const std::string*> retired;
+    std::int32_t walk = static_cast<std::int32_t>(instance.classIndex());
+    while (walk >= 0) {
+        const ClassBytecode* version = &module.classes.at(static_cast<std::size_t>(walk));
+        for (std::int64_t next = version->replacedBy.get(); next >= 0; next = version->replacedBy.get()) {
+            version = &module.classes[static_cast<std::size_t>(next)];
+            if (static_cast<std::size_t>(next) >= stamp) {
+                for (const auto& name : version->retiredAttributes) {
+                    retired.push_back(&name);
+                }
+            }
+        }
+        for (const auto& attr : version->attributes) {
+            declared.insert(attr.name);
+            if (instance.fields().contains(attr.name)) {
+                continue;
+            }
+            const Value normalized = normalizeRuntimeValue(context,
+                                                           functionType,
+                                                           classType,
+                                                           nativeFunctionType,
+                                                           moduleType,
+                                                           hosts,
+                                                           modulePin,
+                                                           attr.defaultValue,
+                                                           true);
+            rememberWriteBarrier(context, instance, normalized);
+            instance.fields()[attr.name] = normalized;
+        }
+        walk = version->baseClassIndex;
+    }
+    for (const std::string* name : retired) {
+        if (!declared.contains(*name)) {
+            instance.fields().erase(*name);
+        }
+    }
+    instance.setLayoutStamp(classCount);
+}
+
+// Called before an instance's fields or methods are used. Hot reload only appends to the class
+// table, so an unchanged table size means the layout is current.
+void syncInstanceLayout(ExecutionContext& context,
+                        FunctionType& functionType,
+                        ClassType& classType,
+                        NativeFunctionType& nativeFunctionType,
+                        ModuleType& moduleType,
+                        const HostRegistry& hosts,
+                        ScriptInstanceObject& instance) {
+    if (instance.modulePin() && instance.layoutStamp() != instance.modulePin()->classes.size()) {
+        migrateInstanceLayout(context, functionType, classType, nativeFunctionType, moduleType, hosts, instance);
+    }
+}
+
+constexpr std::size_t kFrameRegionChunkBytes = 512;
+
 } // namespace
 
+ModuleImageHandle& ModuleImageHandle::operator=(const ModuleImageHandle&) noexcept {
+    // The module's tables were replaced; objects built from the old ones must not be reused.
+    delete image_.exchange(nullptr, std::memory_order_acq_rel);
+    return *this;
+}
+
+ModuleImageHandle::~ModuleImageHandle() {
+    delete image_.load(std::memory_order_acquire);
+}
+
+ModuleImage& ModuleImageHandle::get() const {
+    ModuleImage* image = image_.load(std::memory_order_acquire);
+    if (image) {
+        return *image;
+    }
+    auto created = std::make_unique<ModuleImage>();
+    if (image_.compare_exchange_strong(image, created.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return *created.release();
+    }
+    return *image;
+}
+
+FrameRegion::~FrameRegion() {
+    for (auto& slot : slots_) {
+        for (auto& occupant : slot.generations) {
+            destroy(occupant);
+        }
+    }
+}
+
+Object* FrameRegion::retiringOccupant(std::uint32_t site) const {
+    const Slot* slot = findSlot(site);
+    return slot ? slot->generations[1 - slot->newest].object : nullptr;
+}
+
+void* FrameRegion::acquire(std::uint32_t site, std::size_t bytes, std::size_t alignment) {
+    Slot& slot = slotFor(site);
+    Occupant& target = slot.generations[1 - slot.newest];
+    destroy(target);
+    const auto address = reinterpret_cast<std::uintptr_t>(target.block);
+    if (!target.block || target.blockBytes < bytes || address % alignment != 0) {
+        target.block = bump(bytes, alignment);
+        target.blockBytes = bytes;
+    }
+    return target.block;
+}
+
+void FrameRegion::commit(std::uint32_t site, Object* object) {
+    Slot& slot = slotFor(site);
+    const std::size_t next = 1 - slot.newest;
+    slot.generations[next].object = object;
+    slot.generations[next].heapOwned = false;
+    slot.newest = next;
+}
+
+void FrameRegion::adopt(std::uint32_t site, std::unique_ptr<Object> object) {
+    Slot& slot = slotFor(site);
+    const std::size_t next = 1 - slot.newest;
+    destroy(slot.generations[next]);
+    slot.generations[next].object = object.release();
+    slot.generations[next].heapOwned = true;
+    slot.newest = next;
+}
+
+const FrameRegion::Slot* FrameRegion::findSlot(std::uint32_t site) const {
+    for (const auto& slot : slots_) {
+        if (slot.site == site) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+FrameRegion::Slot& FrameRegion::slotFor(std::uint32_t site) {
+    for (auto& slot : slots_) {
+        if (slot.site == site) {
+            return slot;
+        }
+    }
+    Slot slot;
+    slot.site = site;
+    slots_.push_back(slot);
+    return slots_.back();
+}
+
+void FrameRegion::destroy(Occupant& occupant) {
+    if (!occupant.object) {
+        return;
+    }
+    if (occupant.heapOwned) {
+        delete occupant.object;
+    } else {
+        occupant.object->~Object();
+    }
+    occupant.object = nullptr;
+    occupant.heapOwned = false;
+}
+
+void* FrameRegion::bump(std::size_t bytes, std::size_t alignment) {
+    if (!chunks_.empty()) {
+        const auto base = reinterpret_cast<std::uintptr_t>(chunks_.back().get());
+        const std::uintptr_t aligned = (base + chunkUsed_ + alignment - 1) / alignment * alignment;
+        if (aligned - base + bytes <= chunkCapacity_) {
+            chunkUsed_ = aligned - base + bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+    // operator new[] storage is aligned for any fundamental type, so a fresh chunk starts aligned.
+    chunkCapacity_ = std::max(kFrameRegionChunkBytes, bytes);
+    chunks_.push_back(std::make_unique_for_overwrite<std::byte[]>(chunkCapacity_));
+    chunkUsed_ = bytes;
+    return chunks_.back().get();
+}
+
 VirtualMachine::VirtualMachine(std::shared_ptr<const Module> module,
                                const HostRegistry& hosts,
                                TaskSystem& tasks)
@@ -2031,6 +2786,7 @@ void VirtualMachine::ensureModuleInitialized(ExecutionContext& context, const st
 
     context.moduleInitInProgress.insert(moduleKey);
     try {
+        linkModuleImports(context, modulePin);
         if (moduleInitIndex != static_cast<std::size_t>(-1)) {
             const std::size_t baseFrameCount = context.frames.size();
             pushCallFrame(context, modulePin, moduleInitIndex, {});
@@ -2050,6 +2806,161 @@ void VirtualMachine::ensureModuleInitialized(ExecutionContext& context, const st
     }
 }
 
+LinkedModuleImports& VirtualMachine::linkedImports(ExecutionContext& context, const Module& module) {
+    auto& linked = context.moduleImports[&module];
+    if (linked.modules.size() != module.imports.size()) {
+        linked.modules.assign(module.imports.size(), Value::Nil());
+        linked.symbols.assign(module.importSymbols.size(), Value::Nil());
+        linked.symbolLinked.assign(module.importSymbols.size(), 0);
+    } else if (linked.symbols.size() < module.importSymbols.size()) {
+        // A lazily compiled body referenced more `alias.member` symbols.
+        linked.symbols.resize(module.importSymbols.size(), Value::Nil());
+        linked.symbolLinked.resize(module.importSymbols.size(), 0);
+    }
+    return linked;
+}
+
+// Module object of `module.imports[importIndex]`, loaded through the loadModule builtin on first
+// use so script and host modules share its caching and initialization.
+Value VirtualMachine::linkImport(ExecutionContext& context, const Module& module, std::size_t importIndex) {
+    const Value linked = linkedImports(context, module).modules.at(importIndex);
+    if (!linked.isNil()) {
+        return linked;
+    }
+    const auto& entry = module.imports[importIndex];
+    if (!hosts_.has("loadModule")) {
+        throw std::runtime_error("Module imports require the loadModule builtin: " + entry.moduleSpec);
+    }
+    VmHostContext hostContext(*this, context);
+    const Value moduleRef = hosts_.invoke("loadModule", hostContext, {makeRuntimeString(context, entry.moduleSpec)});
+    // Loading may have initialized other modules; look the table up again.
+    linkedImports(context, module).modules[importIndex] = moduleRef;
+    return moduleRef;
+}
+
+// Binds every import's local name before the module's __module_init__ runs.
+void VirtualMachine::linkModuleImports(ExecutionContext& context, const std::shared_ptr<const Module>& modulePin) {
+    const Module& module = *modulePin;
+    for (std::size_t i = 0; i < module.imports.size(); ++i) {
+        const auto& entry = module.imports[i];
+        Value binding = linkImport(context, module, i);
+        if (!entry.symbols.empty()) {
+            // loadModule(spec, names...) validates the exports and returns the single export or
+            // a module object projected onto the requested names.
+            std::vector<Value> args;
+            args.reserve(entry.symbols.size() + 1);
+            args.push_back(makeRuntimeString(context, entry.moduleSpec));
+            for (const auto& symbol : entry.symbols) {
+                args.push_back(makeRuntimeString(context, symbol));
+            }
+            VmHostContext hostContext(*this, context);
+            binding = hosts_.invoke("loadModule", hostContext, args);
+        }
+        storeRuntimeGlobal(context, modulePin, entry.localName, binding);
+
+        if (entry.bindsSymbol) {
+            // The name was bound once, like the `let` it replaces; LoadImport reuses that value.
+            auto& linked = linkedImports(context, module);
+            for (std::size_t slot = 0; slot < module.importSymbols.size(); ++slot) {
+                if (module.importSymbols[slot].importIndex == i) {
+                    linked.symbols[slot] = binding;
+                    linked.symbolLinked[slot] = 1;
+                }
+            }
+        }
+    }
+}
+
+Value VirtualMachine::loadImportSymbol(ExecutionContext& context, Frame& frame, std::size_t symbolIndex) {
+    const Module& module = *frame.modulePin;
+    if (!frame.imports) {
+        frame.imports = &linkedImports(context, module);
+    }
+    if (frame.imports->symbolLinked.at(symbolIndex)) {
+        return frame.imports->symbols[symbolIndex];
+    }
+
+    const auto& symbol = module.importSymbols[symbolIndex];
+    // May run the imported module's initializer, so `frame` is not used past this point.
+    const Value moduleRef = linkImport(context, module, symbol.importIndex);
+    auto* moduleObj = dynamic_cast<ModuleObject*>(&getObject(context, moduleRef));
+    if (!moduleObj) {
+        throw std::runtime_error("Import did not resolve to a module: " + module.imports[symbol.importIndex].moduleSpec);
+    }
+    bool cacheable = false;
+    const Value value = loadModuleMember(context, *moduleObj, symbol.name, &cacheable);
+    if (cacheable) {
+        auto& linked = linkedImports(context, module);
+        linked.symbols[symbolIndex] = value;
+        linked.symbolLinked[symbolIndex] = 1;
+    }
+    return value;
+}
+
+// `moduleObj.name`. Functions and classes resolve to objects that carry the defining module and
+// their index in it; `cacheable` is cleared for module globals, which scripts may reassign.
+Value VirtualMachine::loadModuleMember(ExecutionContext& context,
+                                       ModuleObject& moduleObj,
+                                       const std::string& name,
+                                       bool* cacheable) {
+    const auto& modulePin = moduleObj.modulePin();
+    if (cacheable) {
+        *cacheable = true;
+    }
+    if (modulePin) {
+        for (std::size_t i = 0; i < modulePin->globals.size(); ++i) {
+            if (modulePin->globals[i].name == name) {
+                if (cacheable) {
+                    *cacheable = false;
+                }
+                return readModuleGlobal(context,
+                                        functionType_,
+                                        classType_,
+                                        nativeFunctionType_,
+                                        moduleType_,
+                                        hosts_,
+                                        modulePin,
+                                        moduleGlobals(context, *modulePin),
+                                        i);
+            }
+        }
+    }
+
+    auto exportIt = moduleObj.exports().find(name);
+    if (exportIt != moduleObj.exports().end()) {
+        return exportIt->second;
+    }
+
+    if (modulePin) {
+        for (std::size_t i = 0; i < modulePin->functions.size(); ++i) {
+            if (modulePin->functions[i].name == name) {
+                Value functionRef = makeFunctionObject(context, functionType_, i, modulePin);
+                rememberWriteBarrier(context, moduleObj, functionRef);
+                moduleObj.exports()[name] = functionRef;
+                return functionRef;
+            }
+        }
+
+        for (std::size_t i = 0; i < modulePin->classes.size(); ++i) {
+            const auto& cls = modulePin->classes[i];
+            if (cls.name == name) {
+                Value classRef = emplaceObject(context,
+                                               std::make_unique<ClassObject>(classType_, cls.name, i, modulePin));
+                rememberWriteBarrier(context, moduleObj, classRef);
+                moduleObj.exports()[name] = classRef;
+                return classRef;
+            }
+        }
+    }
+
+    // Set thread-local context for BoundClassType
+    VmHostContext hostContext(*this, context);
+    BoundClassType::setThreadLocalContext(&hostContext);
+    Value member = moduleObj.getType().getMember(moduleObj, name);
+    BoundClassType::setThreadLocalContext(nullptr);
+    return member;
+}
+
 void VirtualMachine::pushCallFrame(ExecutionContext& ctx,
                                    std::shared_ptr<const Module> modulePin,
                                    std::size_t functionIndex,
@@ -2061,10 +2972,18 @@ void VirtualMachine::pushCallFrame(ExecutionContext& ctx,
         throw std::runtime_error("Call frame module is null");
     }
 
-    const auto& fn = modulePin->functions.at(functionIndex);
+    // New calls run the latest version of a function that a hot reload replaced.
+    functionIndex = currentFunctionIndex(*modulePin, functionIndex);
+    const auto& fn = modulePin->functions[functionIndex];
     if (args.size() != fn.params.size()) {
         throw std::runtime_error("Function argument count mismatch: " + fn.name);
     }
+    // Functions loaded from a GSBC3 image or compiled lazily get their body on their first call.
+    ensureFunctionDecoded(*modulePin, fn);
+    // Once the body is known, link the native one generated for it by `gsc --aot-cpp`, if any.
+    if (!fn.aotBody.resolved()) {
+        resolveAotBody(*modulePin, fn);
+    }
 
 #ifndef NDEBUG
     for (std::size_t i = 0; i < args.size() && i < fn.paramTypeNames.size(); ++i) {
@@ -2111,8 +3030,12 @@ Object& VirtualMachine::getObject(ExecutionContext& context, const Value& ref) {
 }
 
 bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget) {
+    // CallHost uses host function slots without further synchronization; a slot replaced by a
+    // concurrent rebind is not freed until this slice returns.
+    const HostRegistry::ReadGuard hostGuard(hosts_);
     std::size_t steps = 0;
     std::vector<Value> argScratch;
+    std::optional<std::uint32_t> frameScopedCallSite;
 
     const auto dispatchException = [&](const Value& thrownValue) -> bool {
         while (!context.frames.empty()) {
@@ -2147,12 +3070,30 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
                 }
             }
 
-            context.frames.pop_back();
+            popFrame(context);
         }
 
         return false;
     };
 
+    if (!context.pendingInterrupt.empty() && !context.frames.empty()) {
+        const std::string message = std::move(context.pendingInterrupt);
+        context.pendingInterrupt.clear();
+        MemoryLimitBypassScope bypass(context);
+        const Value interrupt =
+            makeRuntimeExceptionObject(context, classifyRuntimeExceptionTypeName(message), message);
+        if (!dispatchException(interrupt)) {
+            context.hasUnhandledScriptException = true;
+            context.unhandledScriptExceptionValue = interrupt;
+            clearFrames(context);
+            return true;
+        }
+    }
+
+    if (context.canPark) {
+        context.parker = nullptr;
+    }
+
     while (steps++ < stepBudget) {
         if (context.frames.empty()) {
             return true;
@@ -2165,6 +3106,11 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
         const auto frameModule = frame.modulePin;
         const auto& fn = frameModule->functions.at(frame.functionIndex);
         context.modulePin = frameModule;
+        // A native body runs up to the next instruction it leaves to the interpreter, which then
+        // executes that instruction below before the native body is entered again.
+        if (const AotFunction native = fn.aotBody.get(); native && frame.ip != frame.aotHandbackIp) {
+            native(frame, fn.code.data());
+        }
         if (frame.ip >= fn.code.size()) {
             throw std::runtime_error("Instruction pointer out of range");
         }
@@ -2190,6 +3136,45 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             }
         };
 
+        // Globals, module functions/classes and builtins named by strings[nameIndex]. Linked
+        // names are read straight from the module's slot arrays.
+        const auto loadName = [&](std::int32_t nameIndex) -> Value {
+            if (!frame.globals) {
+                frame.globals = &moduleGlobals(context, *frameModule);
+            }
+            const NameSlot& slot = frame.globals->names.at(static_cast<std::size_t>(nameIndex));
+            if (slot.kind == NameSlot::Kind::Value) {
+                return slot.value;
+            }
+            if (slot.kind == NameSlot::Kind::Global && frame.globals->assigned[slot.global]) {
+                return frame.globals->values[slot.global];
+            }
+            return resolveRuntimeName(context,
+                                      functionType_,
+                                      classType_,
+                                      nativeFunctionType_,
+                                      moduleType_,
+                                      hosts_,
+                                      frameModule,
+                                      static_cast<std::size_t>(nameIndex));
+        };
+
+        const auto storeName = [&](std::int32_t nameIndex, const Value& value) {
+            if (!frame.globals) {
+                frame.globals = &moduleGlobals(context, *frameModule);
+            }
+            NameSlot& slot = frame.globals->names.at(static_cast<std::size_t>(nameIndex));
+            if (slot.kind == NameSlot::Kind::Global ||
+                (slot.kind == NameSlot::Kind::Unresolved &&
+                 linkGlobalName(*frameModule, *frame.globals, slot, static_cast<std::size_t>(nameIndex)))) {
+                frame.globals->values[slot.global] = value;
+                frame.globals->assigned[slot.global] = 1;
+                mirrorModuleExport(context, frameModule, frameModule->globals[slot.global].name, value);
+                return;
+            }
+            storeRuntimeGlobal(context, frameModule, frameModule->strings.at(static_cast<std::size_t>(nameIndex)), value);
+        };
+
         const auto resolveSlotValue = [&](SlotType slotType, std::int32_t index) -> Value {
             switch (slotType) {
             case SlotType::None:
@@ -2293,6 +3278,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
 
         const auto tryInvokeClassOrNativeCallable = [&](Object& callableObject,
                                                         const std::vector<Value>& invokeArgs) -> bool {
+            const std::optional<std::uint32_t> scopedSite = std::exchange(frameScopedCallSite, std::nullopt);
             if (auto* classObject = dynamic_cast<ClassObject*>(&callableObject)) {
                 const auto& targetModule = classObject->modulePin();
                 if (!targetModule) {
@@ -2335,6 +3321,9 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             if (auto* nativeFunction = dynamic_cast<NativeFunctionObject*>(&callableObject)) {
                 const std::size_t callerFrameIndex = context.frames.size() - 1;
                 VmHostContext hostContext(*this, context);
+                if (scopedSite && isFrameScopedNative(nativeFunction->functionName())) {
+                    hostContext.scopeNextAllocation(callerFrameIndex, *scopedSite);
+                }
                 const Value result = nativeFunction->invoke(hostContext, invokeArgs);
                 if (callerFrameIndex < context.frames.size()) {
                     pushRaw(context.frames[callerFrameIndex].stack,
@@ -2417,30 +3406,12 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             pushRaw(frame.stack, frame.stackTop, value);
             break;
         }
-        case OpCode::LoadName: {
-            const auto& symbolName = frameModule->strings.at(ins.a);
-            pushRaw(frame.stack, frame.stackTop, resolveRuntimeName(context,
-                                                     functionType_,
-                                                     classType_,
-                                                     nativeFunctionType_,
-                                                     moduleType_,
-                                                     hosts_,
-                                                     frameModule,
-                                                     symbolName));
+        case OpCode::LoadName:
+            pushRaw(frame.stack, frame.stackTop, loadName(ins.a));
             break;
-        }
-        case OpCode::PushName: {
-            const auto& symbolName = frameModule->strings.at(ins.a);
-            pushRaw(frame.stack, frame.stackTop, resolveRuntimeName(context,
-                                                     functionType_,
-                                                     classType_,
-                                                     nativeFunctionType_,
-                                                     moduleType_,
-                                                     hosts_,
-                                                     frameModule,
-                                                     symbolName));
+        case OpCode::PushName:
+            pushRaw(frame.stack, frame.stackTop, loadName(ins.a));
             break;
-        }
         case OpCode::LoadLocal:
             pushRaw(frame.stack, frame.stackTop, resolveSlotValue(SlotType::Local, ins.a));
             break;
@@ -2475,10 +3446,79 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             localValue = v;
             break;
         }
+        case OpCode::AppendLocal: {
+            const Value rhs = popRaw(frame.stack, frame.stackTop);
+            const Value localValue = frame.locals.at(ins.a);
+            UpvalueCellObject* cell = nullptr;
+            if (localValue.isRef() && localValue.asRef()) {
+                Object* localObject = localValue.asRef();
+                auto* accumulated = dynamic_cast<StringObject*>(localObject);
+                if (accumulated && accumulated->isAppendTarget()) {
+                    accumulated->data() += __str__Value(context, rhs);
+                    accountObjectGrowth(context, *accumulated);
+                    break;
+                }
+                cell = dynamic_cast<UpvalueCellObject*>(localObject);
+            }
+
+            const Value lhs = cell ? cell->value() : localValue;
+            Value out = Value::Nil();
+            if (lhs.isInt() && rhs.isInt()) {
+                out = Value::Int(lhs.asInt() + rhs.asInt());
+            } else if (isNumericValue(lhs) && isNumericValue(rhs)) {
+                out = Value::Float(toDouble(lhs) + toDouble(rhs));
+            } else {
+                out = makeRuntimeString(context, __str__Value(context, lhs) + __str__Value(context, rhs));
+                // A captured local is visible to closures, so only a plain slot owns its string.
+                if (!cell) {
+                    static_cast<StringObject*>(out.asRef())->setAppendTarget(true);
+                }
+            }
+#ifndef NDEBUG
+            if (ins.a >= 0 && static_cast<std::size_t>(ins.a) < fn.localTypeNames.size()) {
+                debugEnsureTypeMatch(context,
+                                     fn.localTypeNames[static_cast<std::size_t>(ins.a)],
+                                     out,
+                                     "local variable '" +
+                                         (static_cast<std::size_t>(ins.a) < fn.params.size()
+                                              ? fn.params[static_cast<std::size_t>(ins.a)]
+                                              : ("slot#" + std::to_string(ins.a))) + "'");
+            }
+#endif
+            if (cell) {
+                rememberWriteBarrier(context, *cell, out);
+                cell->value() = out;
+            } else {
+                frame.locals.at(ins.a) = out;
+            }
+            break;
+        }
+        case OpCode::LoadImport: {
+            const auto symbolIndex = static_cast<std::size_t>(ins.a);
+            if (frame.imports && frame.imports->symbolLinked[symbolIndex]) {
+                pushRaw(frame.stack, frame.stackTop, frame.imports->symbols[symbolIndex]);
+                break;
+            }
+            const std::size_t callerFrameIndex = context.frames.size() - 1;
+            const Value value = loadImportSymbol(context, frame, symbolIndex);
+            Frame& caller = context.frames[callerFrameIndex];
+            pushRaw(caller.stack, caller.stackTop, value);
+            break;
+        }
+        case OpCode::SealLocal: {
+            const Value& localValue = frame.locals.at(ins.a);
+            if (localValue.isRef() && localValue.asRef()) {
+                auto* accumulated = dynamic_cast<StringObject*>(localValue.asRef());
+                if (accumulated && accumulated->isAppendTarget()) {
+                    accumulated->setAppendTarget(false);
+                }
+            }
+            break;
+        }
         case OpCode::StoreName: {
             const Value value = popRaw(frame.stack, frame.stackTop);
-            const auto& symbolName = frameModule->strings.at(ins.a);
 #ifndef NDEBUG
+            const auto& symbolName = frameModule->strings.at(ins.a);
             if (const std::string* declaredType = findGlobalDeclaredType(*frameModule, symbolName)) {
                 debugEnsureTypeMatch(context,
                                      *declaredType,
@@ -2486,7 +3526,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
                                      "global variable '" + symbolName + "'");
             }
 #endif
-            storeRuntimeGlobal(context, frameModule, symbolName, value);
+            storeName(ins.a, value);
             break;
         }
         case OpCode::Add: {
@@ -2499,7 +3539,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
                 } else if (isNumericValue(lhs) && isNumericValue(rhs)) {
                     out = Value::Float(toDouble(lhs) + toDouble(rhs));
                 } else {
-                    out = makeRuntimeString(context, __str__Value(context, lhs) + __str__Value(context, rhs));
+                    out = makeInstructionString(context, fn, frame, __str__Value(context, lhs) + __str__Value(context, rhs));
                 }
                 writeRegister(0, out);
                 break;
@@ -2515,7 +3555,8 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             } else if (isNumericValue(lhs) && isNumericValue(rhs)) {
                 frame.stack[frame.stackTop - 1] = Value::Float(toDouble(lhs) + toDouble(rhs));
             } else {
-                frame.stack[frame.stackTop - 1] = makeRuntimeString(context, __str__Value(context, lhs) + __str__Value(context, rhs));
+                frame.stack[frame.stackTop - 1] =
+                    makeInstructionString(context, fn, frame, __str__Value(context, lhs) + __str__Value(context, rhs));
             }
             break;
         }
@@ -2848,7 +3889,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
                 const Value lhs = resolveSlotValue(ins.aSlotType, ins.a);
                 const Value rhs = resolveSlotValue(ins.bSlotType, ins.b);
                 // Identity check: same object pointer or same value representation
-                const bool same = (lhs.type == rhs.type && lhs.payload == rhs.payload);
+                const bool same = (lhs.valueType() == rhs.valueType() && lhs.rawPayload() == rhs.rawPayload());
                 writeRegister(0, Value::Int(same ? 1 : 0));
                 break;
             }
@@ -2858,7 +3899,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             const Value rhs = frame.stack[frame.stackTop - 1];
             const Value lhs = frame.stack[frame.stackTop - 2];
             --frame.stackTop;
-            const bool same = (lhs.type == rhs.type && lhs.payload == rhs.payload);
+            const bool same = (lhs.valueType() == rhs.valueType() && lhs.rawPayload() == rhs.rawPayload());
             frame.stack[frame.stackTop - 1] = Value::Int(same ? 1 : 0);
             break;
         }
@@ -2866,7 +3907,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             if (ins.aSlotType != SlotType::None || ins.bSlotType != SlotType::None) {
                 const Value lhs = resolveSlotValue(ins.aSlotType, ins.a);
                 const Value rhs = resolveSlotValue(ins.bSlotType, ins.b);
-                const bool same = (lhs.type == rhs.type && lhs.payload == rhs.payload);
+                const bool same = (lhs.valueType() == rhs.valueType() && lhs.rawPayload() == rhs.rawPayload());
                 writeRegister(0, Value::Int(same ? 0 : 1));
                 break;
             }
@@ -2876,7 +3917,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             const Value rhs = frame.stack[frame.stackTop - 1];
             const Value lhs = frame.stack[frame.stackTop - 2];
             --frame.stackTop;
-            const bool same = (lhs.type == rhs.type && lhs.payload == rhs.payload);
+            const bool same = (lhs.valueType() == rhs.valueType() && lhs.rawPayload() == rhs.rawPayload());
             frame.stack[frame.stackTop - 1] = Value::Int(same ? 0 : 1);
             break;
         }
@@ -3436,11 +4477,54 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
             frame.activeExceptionValue = Value::Nil();
             break;
         case OpCode::CallHost: {
-            collectArgs(frame.stack, frame.stackTop, static_cast<std::size_t>(ins.b), argScratch);
-            const auto& name = frameModule->strings.at(ins.a);
+            if (!frame.globals) {
+                frame.globals = &moduleGlobals(context, *frameModule);
+            }
+            NameSlot& slot = frame.globals->names.at(static_cast<std::size_t>(ins.a));
+            if (slot.host == kInvalidHostHandle) {
+                slot.host = hosts_.resolveHandle(frameModule->strings[static_cast<std::size_t>(ins.a)]);
+            }
+            const auto argc = static_cast<std::size_t>(ins.b);
+            if (slot.host == kInvalidHostHandle) {
+                // Not a host function (a host module, a name bound later, or a script function a
+                // hot reload added): call whatever the name resolves to, as CallValue would.
+                const Value callable = loadName(ins.a);
+                collectArgs(frame.stack, frame.stackTop, argc, argScratch);
+                if (!callable.isRef()) {
+                    throw std::runtime_error("Attempted to call a non-function object");
+                }
+                Object& callableObject = getObject(context, callable);
+                if (!tryInvokeScriptCallable(callableObject,
+                                             frameModule,
+                                             argScratch,
+                                             "Function object is missing module binding") &&
+                    !tryInvokeClassOrNativeCallable(callableObject, argScratch)) {
+                    throw std::runtime_error("Attempted to call a non-function object");
+                }
+                break;
+            }
+
+            const auto& target = hosts_.functionSlot(slot.host);
             const std::size_t callerFrameIndex = context.frames.size() - 1;
             VmHostContext hostContext(*this, context);
-            const Value result = hosts_.invoke(name, hostContext, argScratch);
+            if (isFrameScopedNative(target.name) && isNonEscapingSite(fn, frame.ip - 1)) {
+                hostContext.scopeNextAllocation(callerFrameIndex, static_cast<std::uint32_t>(frame.ip - 1));
+            }
+            Value result = Value::Nil();
+            if (target.spanFunction) {
+                // Arguments stay on the caller's stack, which also keeps them rooted during the
+                // call; a nested call may move the Frame but not its stack buffer.
+                if (frame.stackTop < argc) {
+                    throw std::runtime_error("Not enough arguments on stack");
+                }
+                result = target.spanFunction(hostContext, frame.stack.data() + (frame.stackTop - argc), argc);
+                if (callerFrameIndex < context.frames.size()) {
+                    context.frames[callerFrameIndex].stackTop -= argc;
+                }
+            } else {
+                collectArgs(frame.stack, frame.stackTop, argc, argScratch);
+                result = target.function(hostContext, argScratch);
+            }
             if (callerFrameIndex < context.frames.size()) {
                 pushRaw(context.frames[callerFrameIndex].stack, context.frames[callerFrameIndex].stackTop, result);
             }
@@ -3502,6 +4586,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
                 break;
             }
             if (auto* instance = dynamic_cast<ScriptInstanceObject*>(&object)) {
+                syncInstanceLayout(context, functionType_, classType_, nativeFunctionType_, moduleType_, hosts_, *instance);
                 auto it = instance->fields().find(attrName);
                 if (it == instance->fields().end()) {
                     if (instance->hasNativeBase()) {
@@ -3581,64 +4666,7 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
                 pushRaw(frame.stack, frame.stackTop, object.getType().getMember(object, attrName));
                 BoundClassType::setThreadLocalContext(nullptr);
             } else if (auto* moduleObj = dynamic_cast<ModuleObject*>(&object)) {
-                auto exportIt = moduleObj->exports().find(attrName);
-                if (exportIt != moduleObj->exports().end()) {
-                    pushRaw(frame.stack, frame.stackTop, exportIt->second);
-                    break;
-                }
-
-                const auto& modulePin = moduleObj->modulePin();
-                if (modulePin) {
-                    for (const auto& global : modulePin->globals) {
-                        if (global.name == attrName) {
-                            Value globalValue = normalizeRuntimeValue(context,
-                                                                      functionType_,
-                                                                      classType_,
-                                                                      nativeFunctionType_,
-                                                                      moduleType_,
-                                                                      hosts_,
-                                                                      modulePin,
-                                                                      global.initialValue,
-                                                                      true);
-                            rememberWriteBarrier(context, *moduleObj, globalValue);
-                            moduleObj->exports()[attrName] = globalValue;
-                            pushRaw(frame.stack, frame.stackTop, globalValue);
-                            goto load_attr_done;
-                        }
-                    }
-
-                    for (std::size_t i = 0; i < modulePin->functions.size(); ++i) {
-                        const auto& fn = modulePin->functions[i];
-                        if (fn.name == attrName) {
-                            Value functionRef = makeFunctionObject(context, functionType_, i, modulePin);
-                            rememberWriteBarrier(context, *moduleObj, functionRef);
-                            moduleObj->exports()[attrName] = functionRef;
-                            pushRaw(frame.stack, frame.stackTop, functionRef);
-                            goto load_attr_done;
-                        }
-                    }
-
-                    for (std::size_t i = 0; i < modulePin->classes.size(); ++i) {
-                        const auto& cls = modulePin->classes[i];
-                        if (cls.name == attrName) {
-                            Value classRef = emplaceObject(context,
-                                                           std::make_unique<ClassObject>(classType_,
-                                                                                         cls.name,
-                                                                                         i,
-                                                                                         modulePin));
-                            rememberWriteBarrier(context, *moduleObj, classRef);
-                            moduleObj->exports()[attrName] = classRef;
-                            pushRaw(frame.stack, frame.stackTop, classRef);
-                            goto load_attr_done;
-                        }
-                    }
-                }
-
-                // Set thread-local context for BoundClassType
-                VmHostContext hostContext(*this, context);
-                BoundClassType::setThreadLocalContext(&hostContext);
-                pushRaw(frame.stack, frame.stackTop, object.getType().getMember(object, attrName));
-                BoundClassType::setThreadLocalContext(nullptr);
+                pushRaw(frame.stack, frame.stackTop, loadModuleMember(context, *moduleObj, attrName, nullptr));
             } else {
                 // Set thread-local context for BoundClassType
                 VmHostContext hostContext(*this, context);
@@ -3646,7 +4674,6 @@ bool VirtualMachine::execute(ExecutionContext& context, std::size_t stepBudget)
                 pushRaw(frame.stack, frame.stackTop, object.getType().getMember(object, attrName));
                 BoundClassType::setThreadLocalContext(nullptr);
             }
-load_attr_done:
             break;
         }
         case OpCode::StoreAttr: {
@@ -3667,6 +4694,7 @@ load_attr_done:
                                                            assigned,
                                                            false);
             if (auto* instance = dynamic_cast<ScriptInstanceObject*>(&object)) {
+                syncInstanceLayout(context, functionType_, classType_, nativeFunctionType_, moduleType_, hosts_, *instance);
 #ifndef NDEBUG
                 if (instance->modulePin() && instance->classIndex() < instance->modulePin()->classes.size()) {
                     if (const std::string* declaredType = findClassAttributeDeclaredType(*instance->modulePin(),
@@ -3832,6 +4860,26 @@ load_attr_done:
                 throw std::runtime_error("super has no callable base method: " + methodName);
             }
 
+            if (Value indexed = Value::Nil(); tryNumericArrayIndexFastPath(object, methodName, argScratch, indexed)) {
+                pushRaw(frame.stack, frame.stackTop, indexed);
+                break;
+            }
+
+            if (auto* channel = dynamic_cast<ChannelObject*>(&object)) {
+                Value channelResult = Value::Nil();
+                if (!callChannelMethod(context, *channel, methodName, argScratch, channelResult)) {
+                    // Parked: the call is put back and runs again when the task resumes.
+                    pushRaw(frame.stack, frame.stackTop, selfRef);
+                    for (const auto& arg : argScratch) {
+                        pushRaw(frame.stack, frame.stackTop, arg);
+                    }
+                    --frame.ip;
+                    return false;
+                }
+                pushRaw(frame.stack, frame.stackTop, channelResult);
+                break;
+            }
+
             if (auto* list = dynamic_cast<ListObject*>(&object)) {
                 if (methodName == "push" && !argScratch.empty()) {
                     rememberWriteBarrier(context, *list, argScratch[0]);
@@ -3845,6 +4893,7 @@ load_attr_done:
             }
 
             if (auto* instance = dynamic_cast<ScriptInstanceObject*>(&object)) {
+                syncInstanceLayout(context, functionType_, classType_, nativeFunctionType_, moduleType_, hosts_, *instance);
                 auto fieldIt = instance->fields().find(methodName);
                 if (fieldIt != instance->fields().end()) {
                     const auto callValueModule = instance->modulePin() ? instance->modulePin() : frameModule;
@@ -3918,6 +4967,7 @@ load_attr_done:
                                                                   valueStr));
                 BoundClassType::setThreadLocalContext(nullptr);
                 PatternType::setThreadLocalContext(nullptr);
+                recordNativeMutation(context, object, argScratch);
             } else {
                 // Set thread-local context for BoundClassType and PatternType
                 VmHostContext hostContext(*this, context);
@@ -3930,6 +4980,7 @@ load_attr_done:
                                                                   valueStr));
                 BoundClassType::setThreadLocalContext(nullptr);
                 PatternType::setThreadLocalContext(nullptr);
+                recordNativeMutation(context, object, argScratch);
             }
 call_method_done:
             break;
@@ -3958,6 +5009,9 @@ call_method_done:
                 break;
             }
 
+            if (isNonEscapingSite(fn, frame.ip - 1)) {
+                frameScopedCallSite = static_cast<std::uint32_t>(frame.ip - 1);
+            }
             if (tryInvokeClassOrNativeCallable(callableObject, argScratch)) {
                 break;
             }
@@ -3968,21 +5022,30 @@ call_method_done:
             throw std::runtime_error("CallIntrinsic is deprecated. Use Type exported methods.");
         case OpCode::SpawnFunc: {
             collectArgs(frame.stack, frame.stackTop, static_cast<std::size_t>(ins.b), argScratch);
-            const auto funcName = frameModule->functions.at(ins.a).name;
-            const auto module = frameModule;
-            const auto* hosts = &hosts_;
-            auto& tasks = tasks_;
-            const std::vector<Value> asyncArgs = argScratch;
-            const std::int64_t handle = tasks_.enqueue([module, hosts, &tasks, funcName, asyncArgs]() {
-                VirtualMachine vm(module, *hosts, tasks);
-                return vm.runFunction(funcName, asyncArgs);
-            });
+            // Shared: std::function needs a copyable callable.
+            auto task = std::make_shared<SpawnedTask>();
+            task->module = frameModule;
+            task->hosts = &hosts_;
+            task->tasks = &tasks_;
+            task->functionIndex = static_cast<std::size_t>(ins.a);
+            task->limits = memoryLimits_;
+            exportValues(context, argScratch, false, task->args);
+            const std::int64_t handle =
+                tasks_.enqueueResumable([task](TransferredValues& result, TaskParker& parker) {
+                    return runSpawnedTaskStep(*task, result, parker);
+                });
             pushRaw(frame.stack, frame.stackTop, Value::Int(handle));
             break;
         }
         case OpCode::Await: {
             const auto handle = popRaw(frame.stack, frame.stackTop).asInt();
-            pushRaw(frame.stack, frame.stackTop, tasks_.await(handle));
+            TransferredValues result = tasks_.await(handle);
+            const Value value = importValues(context, result).front();
+            if (result.thrown) {
+                raiseScriptThrow(value);
+                break;
+            }
+            pushRaw(frame.stack, frame.stackTop, value);
             break;
         }
         case OpCode::MakeList: {
@@ -4020,7 +5083,7 @@ call_method_done:
             if (frame.replaceReturnWithInstance) {
                 ret = frame.constructorInstance;
             }
-            context.frames.pop_back();
+            popFrame(context);
             if (context.frames.empty()) {
                 context.returnValue = ret;
                 return true;
@@ -4037,18 +5100,9 @@ call_method_done:
         case OpCode::MoveLocalToReg:
             writeRegister(ins.b, resolveSlotValue(SlotType::Local, ins.a));
             break;
-        case OpCode::MoveNameToReg: {
-            const auto& symbolName = frameModule->strings.at(ins.a);
-            writeRegister(ins.b, resolveRuntimeName(context,
-                                                    functionType_,
-                                                    classType_,
-                                                    nativeFunctionType_,
-                                                    moduleType_,
-                                                    hosts_,
-                                                    frameModule,
-                                                    symbolName));
+        case OpCode::MoveNameToReg:
+            writeRegister(ins.b, loadName(ins.a));
             break;
-        }
         case OpCode::ConstToReg:
             writeRegister(ins.b, normalizeRuntimeValue(context,
                                                        functionType_,
@@ -4151,11 +5205,20 @@ call_method_done:
             for (std::size_t i = 0; i < captureCount; ++i) {
                 captures[captureCount - 1 - i] = popRaw(frame.stack, frame.stackTop);
             }
-            const Value fnRef = makeLambdaObject(context,
-                                                 lambdaType_,
-                                                 static_cast<std::size_t>(ins.a),
-                                                 frameModule,
-                                                 std::move(captures));
+            const std::size_t site = frame.ip - 1;
+            const Value fnRef = isNonEscapingSite(fn, site)
+                                    ? emplaceFrameScopedObject<LambdaObject>(context,
+                                                                             frame,
+                                                                             static_cast<std::uint32_t>(site),
+                                                                             lambdaType_,
+                                                                             static_cast<std::size_t>(ins.a),
+                                                                             frameModule,
+                                                                             std::move(captures))
+                                    : makeLambdaObject(context,
+                                                       lambdaType_,
+                                                       static_cast<std::size_t>(ins.a),
+                                                       frameModule,
+                                                       std::move(captures));
             pushRaw(frame.stack, frame.stackTop, fnRef);
             break;
         }
@@ -4188,8 +5251,8 @@ call_method_done:
             }
             break;
         case OpCode::StoreNameFromReg: {
-            const auto& symbolName = frameModule->strings.at(ins.a);
 #ifndef NDEBUG
+            const auto& symbolName = frameModule->strings.at(ins.a);
             if (const std::string* declaredType = findGlobalDeclaredType(*frameModule, symbolName)) {
                 debugEnsureTypeMatch(context,
                                      *declaredType,
@@ -4197,14 +5260,29 @@ call_method_done:
                                      "global variable '" + symbolName + "'");
             }
 #endif
-            storeRuntimeGlobal(context, frameModule, symbolName, readRegister(ins.b));
+            storeName(ins.a, readRegister(ins.b));
             break;
         }
         }
 
+        } catch (const ScriptThrownException& thrown) {
+            // A native call rethrowing a value a task threw (parallel.map).
+            raiseScriptThrow(thrown.value());
         } catch (const std::exception& ex) {
             const std::string message = ex.what();
             const std::string exceptionName = classifyRuntimeExceptionTypeName(message);
+            // The failed instruction has been abandoned, so this is a safe point for an
+            // emergency collection; the exception object itself may exceed the quota.
+            const bool outOfMemory = exceptionName == kOutOfMemoryExceptionTypeName;
+            if (outOfMemory) {
+                (void)collectGarbageNow(context, 1);
+                ++context.gc.emergencyCollections;
+                updateEmergencyWatermarks(context);
+            }
+            std::optional<MemoryLimitBypassScope> bypass;
+            if (outOfMemory) {
+                bypass.emplace(context);
+            }
             const Value mappedException = makeRuntimeExceptionObject(context,
                                                                      exceptionName,
                                                                      message);
@@ -4212,6 +5290,11 @@ call_method_done:
                 attachThrowSiteIfException(context, mappedException);
                 throw ScriptThrownException(mappedException);
             }
+            if (outOfMemory) {
+                // The unwound frames held what filled the quota; free it before the handler runs.
+                (void)collectGarbageNow(context, 1);
+                updateEmergencyWatermarks(context);
+            }
             continue;
         }
 
@@ -4219,29 +5302,716 @@ call_method_done:
             if (!dispatchException(scriptThrowValue)) {
                 context.hasUnhandledScriptException = true;
                 context.unhandledScriptExceptionValue = scriptThrowValue;
-                context.frames.clear();
+                clearFrames(context);
                 return true;
             }
             continue;
         }
 
         runGcSlice(context, context.gc.sliceBudgetObjects);
+        relieveMemoryPressure(context);
     }
 
     return context.frames.empty();
 }
 
+namespace {
+
+std::atomic<bool> gSpawnVmReuse{true};
+
+template <typename Map>
+void clearMap(Map& map) {
+    // clear() keeps the bucket array; do not keep one that a large task grew.
+    if (map.bucket_count() > 1024) {
+        Map().swap(map);
+    } else {
+        map.clear();
+    }
+}
+
+// Returns `ctx` to the state of a default-constructed context, keeping small allocations.
+void resetExecutionContext(ExecutionContext& ctx) {
+    ctx.frames.clear();
+    ctx.returnValue = Value::Nil();
+    ctx.hasUnhandledScriptException = false;
+    ctx.unhandledScriptExceptionValue = Value::Nil();
+    ctx.deleteHooksRan = false;
+    ctx.modulePin.reset();
+    clearMap(ctx.moduleGlobals);
+    clearMap(ctx.moduleTypeObjectCache);
+    clearMap(ctx.moduleRuntimeObjects);
+    clearMap(ctx.initializedModules);
+    clearMap(ctx.moduleInitInProgress);
+    clearMap(ctx.moduleImports);
+    clearMap(ctx.moduleObjectCache);
+    clearMap(ctx.objectHeap);
+    clearMap(ctx.gcMeta);
+    clearMap(ctx.objectPtrToId);
+    ctx.gc = GcState{};
+    ctx.hostRoots.clear();
+    ctx.pendingInterrupt.clear();
+    ctx.canPark = false;
+    ctx.parker = nullptr;
+}
+
+// Takes `object` out of ctx's heap and GC bookkeeping. Returns null for objects ctx does not own
+// (frame-scoped allocations).
+std::unique_ptr<Object> detachObject(ExecutionContext& ctx, Object& object) {
+    auto idIt = ctx.objectPtrToId.find(&object);
+    if (idIt == ctx.objectPtrToId.end()) {
+        return nullptr;
+    }
+    const std::uint64_t id = idIt->second;
+    auto heapIt = ctx.objectHeap.find(id);
+    if (heapIt == ctx.objectHeap.end() || !heapIt->second) {
+        return nullptr;
+    }
+    std::unique_ptr<Object> owned = std::move(heapIt->second);
+    ctx.objectHeap.erase(heapIt);
+    ctx.objectPtrToId.erase(idIt);
+    if (auto metaIt = ctx.gcMeta.find(id); metaIt != ctx.gcMeta.end()) {
+        ctx.gc.liveBytes -= std::min(ctx.gc.liveBytes, metaIt->second.bytes);
+        if (metaIt->second.generation == GcGeneration::Young) {
+            --ctx.gc.youngObjects;
+        }
+        ctx.gcMeta.erase(metaIt);
+    }
+    ctx.gc.rememberedSet.erase(id);
+    // The proto is a type object in ctx; the receiver resolves its own.
+    owned->setProtoRef(Value::Nil());
+    return owned;
+}
+
+// Runs `run(vm)` on a VM kept by the task system, or a new one that is kept afterwards.
+template <typename Run>
+TransferredValues runOnTaskVm(const std::shared_ptr<const Module>& module,
+                              const HostRegistry& hosts,
+                              TaskSystem& tasks,
+                              const MemoryLimits& limits,
+                              Run&& run) {
+    if (!gSpawnVmReuse.load(std::memory_order_relaxed)) {
+        VirtualMachine vm(module, hosts, tasks);
+        vm.setMemoryLimits(limits);
+        return run(vm);
+    }
+
+    struct ReturnToCache {
+        TaskSystem& tasks;
+        const Module* module;
+        const HostRegistry* hosts;
+        std::unique_ptr<VirtualMachine> vm;
+        ~ReturnToCache() { tasks.returnSpawnVm(module, hosts, std::move(vm)); }
+    } cached{tasks, module.get(), &hosts, tasks.takeSpawnVm(module.get(), &hosts)};
+    if (!cached.vm) {
+        cached.vm = std::make_unique<VirtualMachine>(module, hosts, tasks);
+    }
+    cached.vm->setMemoryLimits(limits);
+    return run(*cached.vm);
+}
+
+bool runSpawnedTaskStep(SpawnedTask& task, TransferredValues& result, TaskParker& parker) {
+    if (!task.vm) {
+        if (gSpawnVmReuse.load(std::memory_order_relaxed)) {
+            task.vm = task.tasks->takeSpawnVm(task.module.get(), task.hosts);
+        }
+        if (!task.vm) {
+            task.vm = std::make_unique<VirtualMachine>(task.module, *task.hosts, *task.tasks);
+        }
+        task.vm->setMemoryLimits(task.limits);
+    }
+    const auto release = [&] {
+        if (gSpawnVmReuse.load(std::memory_order_relaxed)) {
+            task.tasks->returnSpawnVm(task.module.get(), task.hosts, std::move(task.vm));
+        }
+        task.vm.reset();
+    };
+    bool done = true;
+    try {
+        done = task.vm->runSpawnedFunction(task.functionIndex, task.args, result, parker);
+    } catch (...) {
+        release();
+        throw;
+    }
+    if (done) {
+        release();
+    }
+    return done;
+}
+
+// Items per parallel chunk: about four chunks per pool worker, so uneven items still balance.
+// A fold chunk takes at least two items, so each round of parallel.reduce shrinks the list.
+std::size_t parallelChunkSize(std::size_t items, std::size_t workers, bool fold) {
+    const std::size_t chunks = std::max<std::size_t>(1, workers) * 4;
+    return std::max<std::size_t>(fold ? 2 : 1, (items + chunks - 1) / chunks);
+}
+
+} // namespace
+
+void setSpawnVmReuseEnabled(bool enabled) {
+    gSpawnVmReuse.store(enabled, std::memory_order_relaxed);
+}
+
+bool spawnVmReuseEnabled() {
+    return gSpawnVmReuse.load(std::memory_order_relaxed);
+}
+
 Value VirtualMachine::runFunction(const std::string& functionName, const std::vector<Value>& args) {
     ExecutionContext ctx;
+    return runInContext(ctx, functionName, static_cast<std::size_t>(-1), args);
+}
+
+void VirtualMachine::startCall(ExecutionContext& ctx,
+                               const std::string& functionName,
+                               const std::vector<Value>& args,
+                               TransferredValues* transferredArgs) {
     ctx.modulePin = module_;
-    ctx.stringPool = module_->strings;
-    
+    applyMemoryLimits(ctx, memoryLimits_);
+    ctx.returnValue = Value::Nil();
+    ctx.hasUnhandledScriptException = false;
+    ctx.unhandledScriptExceptionValue = Value::Nil();
+    ctx.pendingInterrupt.clear();
+    try {
+        ensureModuleInitialized(ctx, module_);
+        const std::size_t functionIndex = findFunctionIndex(functionName);
+        if (transferredArgs) {
+            pushCallFrame(ctx, module_, functionIndex, importValues(ctx, *transferredArgs));
+        } else {
+            pushCallFrame(ctx, module_, functionIndex, args);
+        }
+    } catch (const ScriptThrownException& thrown) {
+        clearFrames(ctx);
+        throw std::runtime_error(__str__Value(ctx, thrown.value()));
+    } catch (...) {
+        clearFrames(ctx);
+        throw;
+    }
+}
+
+bool VirtualMachine::resumeCall(ExecutionContext& ctx, std::size_t stepBudget) {
+    try {
+        if (!execute(ctx, stepBudget)) {
+            return false;
+        }
+    } catch (const ScriptThrownException& thrown) {
+        clearFrames(ctx);
+        throw std::runtime_error(__str__Value(ctx, thrown.value()));
+    } catch (...) {
+        clearFrames(ctx);
+        throw;
+    }
+    if (ctx.hasUnhandledScriptException) {
+        const Value thrown = ctx.unhandledScriptExceptionValue;
+        ctx.hasUnhandledScriptException = false;
+        ctx.unhandledScriptExceptionValue = Value::Nil();
+        throw std::runtime_error(__str__Value(ctx, thrown));
+    }
+    return true;
+}
+
+TransferredValues VirtualMachine::takeResult(ExecutionContext& ctx) {
+    TransferredValues result;
+    exportValues(ctx, {ctx.returnValue}, false, result);
+    ctx.returnValue = Value::Nil();
+    return result;
+}
+
+void VirtualMachine::interruptCall(ExecutionContext& ctx, std::string message) {
+    ctx.pendingInterrupt = std::move(message);
+}
+
+void VirtualMachine::abortCall(ExecutionContext& ctx) {
+    ctx.pendingInterrupt.clear();
+    clearFrames(ctx);
+}
+
+void VirtualMachine::closeContext(ExecutionContext& ctx) {
+    clearFrames(ctx);
+    runDeleteHooks(ctx);
+}
+
+namespace {
+
+std::vector<std::int64_t> taskHandles(const std::vector<Value>& handles) {
+    std::vector<std::int64_t> ids;
+    ids.reserve(handles.size());
+    for (const auto& handle : handles) {
+        if (!handle.isInt()) {
+            throw std::runtime_error("Task handle must be an int returned by spawn");
+        }
+        ids.push_back(handle.asInt());
+    }
+    return ids;
+}
+
+} // namespace
+
+bool VirtualMachine::callChannelMethod(ExecutionContext& ctx,
+                                       ChannelObject& channelObject,
+                                       const std::string& method,
+                                       const std::vector<Value>& args,
+                                       Value& result) {
+    Channel& channel = channelObject.channel();
+    const auto expectArgs = [&](std::size_t count) {
+        if (args.size() != count) {
+            throw std::runtime_error("Channel." + method + " argument count mismatch");
+        }
+    };
+
+    if (method == "send" || method == "try_send") {
+        expectArgs(1);
+        const bool wait = method == "send";
+        TransferredValues value;
+        exportValues(ctx, args, false, value);
+        while (!channel.trySend(value)) {
+            if (!wait) {
+                result = Value::Bool(false);
+                return true;
+            }
+            if (ctx.canPark) {
+                ctx.parker = channel.parkSender();
+                return false;
+            }
+            tasks_.wait(channel.parkSender());
+        }
+        result = wait ? Value::Nil() : Value::Bool(true);
+        return true;
+    }
+
+    if (method == "recv" || method == "try_recv") {
+        expectArgs(0);
+        const bool wait = method == "recv";
+        TransferredValues value;
+        while (!channel.tryRecv(value)) {
+            if (!wait) {
+                result = Value::Nil();
+                return true;
+            }
+            if (channel.closed()) {
+                // A value sent just before the close may not have been visible yet.
+                if (channel.tryRecv(value)) {
+                    break;
+                }
+                result = Value::Nil();
+                return true;
+            }
+            if (ctx.canPark) {
+                ctx.parker = channel.parkReceiver();
+                return false;
+            }
+            tasks_.wait(channel.parkReceiver());
+        }
+        result = importValues(ctx, value).front();
+        return true;
+    }
+
+    if (method == "close") {
+        expectArgs(0);
+        result = Value::Bool(channel.close());
+        return true;
+    }
+
+    throw std::runtime_error("Unknown Channel method: " + method);
+}
+
+Value VirtualMachine::awaitTasks(ExecutionContext& context, const std::vector<Value>& handles) {
+    std::vector<TransferredValues> results = tasks_.awaitAll(taskHandles(handles));
+    std::vector<Value> values;
+    values.reserve(results.size());
+    Value thrown = Value::Nil();
+    bool hasThrown = false;
+    for (auto& result : results) {
+        const Value value = importValues(context, result).front();
+        if (result.thrown && !hasThrown) {
+            thrown = value;
+            hasThrown = true;
+        }
+        values.push_back(value);
+    }
+    if (hasThrown) {
+        throw ScriptThrownException(thrown);
+    }
+    return emplaceObject(context, std::make_unique<ListObject>(listType_, std::move(values)));
+}
+
+Value VirtualMachine::awaitAnyTask(ExecutionContext& context, const std::vector<Value>& handles, std::size_t& position) {
+    auto [found, result] = tasks_.awaitAny(taskHandles(handles));
+    position = found;
+    const Value value = importValues(context, result).front();
+    if (result.thrown) {
+        throw ScriptThrownException(value);
+    }
+    return value;
+}
+
+bool VirtualMachine::pollTask(const Value& handle) const {
+    return tasks_.poll(taskHandles({handle}).front());
+}
+
+ExecutionContext& VirtualMachine::taskContext() {
+    if (!spawnContext_) {
+        spawnContext_ = std::make_unique<ExecutionContext>();
+    }
+    return *spawnContext_;
+}
+
+TransferredValues VirtualMachine::exportThrownValue(ExecutionContext& ctx, const Value& thrown) {
+    TransferredValues out;
+    try {
+        exportValues(ctx, {thrown}, true, out);
+    } catch (const std::runtime_error&) {
+        // exportValues checks the whole graph before detaching anything, so ctx is intact.
+        out = TransferredValues{};
+        const Value exception =
+            makeRuntimeExceptionObject(ctx, std::string(kExceptionTypeName), __str__Value(ctx, thrown));
+        exportValues(ctx, {exception}, true, out);
+    }
+    out.thrown = true;
+    return out;
+}
+
+bool VirtualMachine::runSpawnedFunction(std::size_t functionIndex,
+                                        TransferredValues& args,
+                                        TransferredValues& result,
+                                        TaskParker& parker) {
+    ExecutionContext& ctx = taskContext();
+    // Copied: a hot reload may grow the function table while the task runs.
+    const std::string functionName = module_->functions.at(functionIndex).name;
+    try {
+        bool parked = false;
+        const Value value = runInContext(ctx, functionName, functionIndex, {}, &args, &parked);
+        if (parked) {
+            parker = std::move(ctx.parker);
+            ctx.parker = nullptr;
+            return false;
+        }
+        exportValues(ctx, {value}, true, result);
+    } catch (const ScriptThrownException& e) {
+        result = exportThrownValue(ctx, e.value());
+    } catch (...) {
+        resetExecutionContext(ctx);
+        throw;
+    }
+    resetExecutionContext(ctx);
+    return true;
+}
+
+TransferredValues VirtualMachine::runParallelChunk(std::size_t functionIndex,
+                                                   TransferredValues& payload,
+                                                   const std::vector<bool>& captureCells,
+                                                   bool fold) {
+    ExecutionContext& ctx = taskContext();
+    struct Reset {
+        ExecutionContext& ctx;
+        ~Reset() { resetExecutionContext(ctx); }
+    } reset{ctx};
+    ctx.modulePin = module_;
+    applyMemoryLimits(ctx, memoryLimits_);
+
     try {
         ensureModuleInitialized(ctx, module_);
-        pushCallFrame(ctx, module_, findFunctionIndex(functionName), args);
+        ctx.hostRoots = importValues(ctx, payload);
+        const auto itemsBegin = ctx.hostRoots.begin() + static_cast<std::ptrdiff_t>(captureCells.size());
+        std::vector<Value> captures(ctx.hostRoots.begin(), itemsBegin);
+        const std::vector<Value> items(itemsBegin, ctx.hostRoots.end());
+        for (std::size_t i = 0; i < captures.size(); ++i) {
+            if (captureCells[i]) {
+                captures[i] = emplaceObject(ctx, std::make_unique<UpvalueCellObject>(upvalueCellType_, captures[i]));
+                ctx.hostRoots.push_back(captures[i]);
+            }
+        }
+
+        const auto call = [&](const std::vector<Value>& args) {
+            pushCallFrame(ctx, module_, functionIndex, args, false, Value::Nil(), captures);
+            while (!execute(ctx, 1000)) {
+            }
+            if (ctx.hasUnhandledScriptException) {
+                throw ScriptThrownException(ctx.unhandledScriptExceptionValue);
+            }
+            ctx.hostRoots.push_back(ctx.returnValue);
+            return ctx.returnValue;
+        };
+
+        std::vector<Value> results;
+        if (fold) {
+            Value acc = items.front();
+            for (std::size_t i = 1; i < items.size(); ++i) {
+                acc = call({acc, items[i]});
+            }
+            results.push_back(acc);
+        } else {
+            results.reserve(items.size());
+            for (const auto& item : items) {
+                results.push_back(call({item}));
+            }
+        }
+        runDeleteHooks(ctx);
+        TransferredValues out;
+        exportValues(ctx, results, true, out);
+        return out;
+    } catch (const ScriptThrownException& e) {
+        return exportThrownValue(ctx, e.value());
+    }
+}
+
+Value VirtualMachine::runParallel(ExecutionContext& context,
+                                  const Value& callable,
+                                  const std::vector<Value>& items,
+                                  bool fold) {
+    Object* callableObject = callable.isRef() ? callable.asRef() : nullptr;
+    auto* scriptCallable = dynamic_cast<ScriptCallableObjectBase*>(callableObject);
+    if (!scriptCallable) {
+        throw std::runtime_error("parallel expects a script function or lambda, got " + __str__Value(context, callable));
+    }
+    const std::shared_ptr<const Module> module = scriptCallable->modulePin() ? scriptCallable->modulePin() : module_;
+    const std::size_t functionIndex = scriptCallable->functionIndex();
+
+    // A task cannot share the caller's upvalue cells: it gets their current values in cells of
+    // its own, so assignments to captured variables stay inside the chunk.
+    std::vector<Value> captureValues;
+    std::vector<bool> captureCells;
+    if (auto* lambda = dynamic_cast<LambdaObject*>(callableObject)) {
+        for (const auto& capture : lambda->captures()) {
+            auto* cell = capture.isRef() ? dynamic_cast<UpvalueCellObject*>(capture.asRef()) : nullptr;
+            captureValues.push_back(cell ? cell->value() : capture);
+            captureCells.push_back(cell != nullptr);
+        }
+    }
+
+    const std::size_t chunkSize = parallelChunkSize(items.size(), tasks_.workerCount(), fold);
+    std::vector<std::int64_t> handles;
+    for (std::size_t begin = 0; begin < items.size(); begin += chunkSize) {
+        const std::size_t end = std::min(items.size(), begin + chunkSize);
+        auto payload = std::make_shared<TransferredValues>();
+        std::vector<Value> roots = captureValues;
+        roots.insert(roots.end(), items.begin() + static_cast<std::ptrdiff_t>(begin), items.begin() + static_cast<std::ptrdiff_t>(end));
+        exportValues(context, roots, false, *payload);
+        const auto* hosts = &hosts_;
+        auto& tasks = tasks_;
+        const MemoryLimits limits = memoryLimits_;
+        handles.push_back(tasks_.enqueue([module, hosts, &tasks, functionIndex, payload, captureCells, fold, limits]() {
+            return runOnTaskVm(module, *hosts, tasks, limits, [&](VirtualMachine& vm) {
+                return vm.runParallelChunk(functionIndex, *payload, captureCells, fold);
+            });
+        }));
+    }
+
+    // Every chunk is awaited, so none outlives the call; the first failure in item order wins.
+    std::vector<Value> results;
+    results.reserve(fold ? handles.size() : items.size());
+    std::exception_ptr failure;
+    Value thrown = Value::Nil();
+    bool hasThrown = false;
+    for (const auto handle : handles) {
+        TransferredValues chunk;
+        try {
+            chunk = tasks_.await(handle);
+        } catch (...) {
+            if (!failure && !hasThrown) {
+                failure = std::current_exception();
+            }
+            continue;
+        }
+        if (failure || hasThrown) {
+            continue;
+        }
+        std::vector<Value> values = importValues(context, chunk);
+        if (chunk.thrown) {
+            thrown = values.front();
+            hasThrown = true;
+            continue;
+        }
+        results.insert(results.end(), values.begin(), values.end());
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (hasThrown) {
+        throw ScriptThrownException(thrown);
+    }
+    return emplaceObject(context, std::make_unique<ListObject>(listType_, std::move(results)));
+}
+
+void VirtualMachine::exportValues(ExecutionContext& ctx,
+                                  const std::vector<Value>& values,
+                                  bool takeObjects,
+                                  TransferredValues& out) {
+    using NodeKind = TransferredValues::NodeKind;
+    // out.nodes[base + i] is made from reached[i]; the map keeps shared references and cycles intact.
+    const std::size_t base = out.nodes.size();
+    std::vector<Object*> reached;
+    std::unordered_map<Object*, std::int32_t> nodeOf;
+    const auto slotFor = [&](const Value& value) {
+        TransferredValues::Slot slot;
+        if (!value.isRef() || !value.asRef()) {
+            slot.value = value;
+            return slot;
+        }
+        const auto [it, inserted] =
+            nodeOf.try_emplace(value.asRef(), static_cast<std::int32_t>(base + reached.size()));
+        if (inserted) {
+            reached.push_back(value.asRef());
+            out.nodes.emplace_back();
+        }
+        slot.node = it->second;
+        return slot;
+    };
+
+    out.roots.reserve(out.roots.size() + values.size());
+    for (const auto& value : values) {
+        out.roots.push_back(slotFor(value));
+    }
+    // Walk and check the whole graph first, so a failure leaves ctx untouched.
+    for (std::size_t i = 0; i < reached.size(); ++i) {
+        Object* object = reached[i];
+        std::vector<TransferredValues::Slot> items;
+        NodeKind kind = NodeKind::Object;
+        if (auto* list = dynamic_cast<ListObject*>(object)) {
+            kind = NodeKind::List;
+            items.reserve(list->data().size());
+            for (const auto& element : list->data()) {
+                items.push_back(slotFor(element));
+            }
+        } else if (auto* dict = dynamic_cast<DictObject*>(object)) {
+            kind = NodeKind::Dict;
+            items.reserve(dict->data().size() * 2);
+            for (const auto& [key, element] : dict->data()) {
+                items.push_back(slotFor(key));
+                items.push_back(slotFor(element));
+            }
+        } else if (auto* tuple = dynamic_cast<TupleObject*>(object)) {
+            items.reserve(tuple->data().size());
+            for (const auto& element : tuple->data()) {
+                items.push_back(slotFor(element));
+            }
+        } else if (!dynamic_cast<StringObject*>(object) && !dynamic_cast<IntArrayObject*>(object) &&
+                   !dynamic_cast<FloatArrayObject*>(object) && !dynamic_cast<ExceptionObject*>(object) &&
+                   !dynamic_cast<ChannelObject*>(object)) {
+            throw std::runtime_error(std::string("Cannot pass a ") + object->getType().name() + " between tasks");
+        }
+        out.nodes[base + i].kind = kind;
+        out.nodes[base + i].items = std::move(items);
+    }
+
+    for (std::size_t i = 0; i < reached.size(); ++i) {
+        auto& node = out.nodes[base + i];
+        if (node.kind != NodeKind::Object) {
+            continue;
+        }
+        Object* object = reached[i];
+        if (auto* exception = dynamic_cast<ExceptionObject*>(object)) {
+            auto copy = makeNativeExceptionObject(exception->exceptionName(), exception->message());
+            copy->setStackTrace(exception->stackTrace());
+            node.object = std::move(copy);
+            continue;
+        }
+        auto* string = dynamic_cast<StringObject*>(object);
+        // Strings typed by this VM's stringType_ would outlive it; every other type here is static.
+        if (takeObjects && !(string && &string->getType() == &stringType_)) {
+            node.object = detachObject(ctx, *object);
+            if (node.object) {
+                if (string) {
+                    string->setAppendTarget(false);
+                }
+                continue;
+            }
+        }
+        if (string) {
+            node.object = std::make_unique<StringObject>(runtimeStringType(), string->data());
+        } else if (auto* tuple = dynamic_cast<TupleObject*>(object)) {
+            node.object = std::make_unique<TupleObject>(tuple->getType(), std::vector<Value>(tuple->data().size()));
+        } else if (auto* ints = dynamic_cast<IntArrayObject*>(object)) {
+            node.object = std::make_unique<IntArrayObject>(ints->getType(), ints->data());
+        } else if (auto* floats = dynamic_cast<FloatArrayObject*>(object)) {
+            node.object = std::make_unique<FloatArrayObject>(floats->getType(), floats->data());
+        } else if (auto* channel = dynamic_cast<ChannelObject*>(object)) {
+            node.object = std::make_unique<ChannelObject>(channel->getType(), channel->shared());
+        }
+    }
+}
+
+std::vector<Value> VirtualMachine::importValues(ExecutionContext& ctx, TransferredValues& values) {
+    using NodeKind = TransferredValues::NodeKind;
+    std::vector<Value> refs;
+    refs.reserve(values.nodes.size());
+    for (auto& node : values.nodes) {
+        switch (node.kind) {
+        case NodeKind::List:
+            refs.push_back(emplaceObject(ctx, std::make_unique<ListObject>(listType_)));
+            break;
+        case NodeKind::Dict:
+            refs.push_back(emplaceObject(ctx, std::make_unique<DictObject>(dictType_)));
+            break;
+        case NodeKind::Object:
+            refs.push_back(emplaceObject(ctx, std::move(node.object)));
+            break;
+        }
+    }
+
+    const auto resolve = [&](const TransferredValues::Slot& slot) {
+        return slot.node >= 0 ? refs[static_cast<std::size_t>(slot.node)] : slot.value;
+    };
+    for (std::size_t i = 0; i < values.nodes.size(); ++i) {
+        const auto& items = values.nodes[i].items;
+        if (items.empty()) {
+            continue;
+        }
+        Object& object = *refs[i].asRef();
+        if (auto* list = dynamic_cast<ListObject*>(&object)) {
+            list->data().reserve(items.size());
+            for (const auto& item : items) {
+                list->data().push_back(resolve(item));
+            }
+        } else if (auto* dict = dynamic_cast<DictObject*>(&object)) {
+            dict->data().reserve(items.size() / 2);
+            for (std::size_t item = 0; item + 1 < items.size(); item += 2) {
+                dict->data()[resolve(items[item])] = resolve(items[item + 1]);
+            }
+        } else if (auto* tuple = dynamic_cast<TupleObject*>(&object)) {
+            for (std::size_t item = 0; item < items.size(); ++item) {
+                tuple->data()[item] = resolve(items[item]);
+            }
+        }
+        accountObjectGrowth(ctx, object);
+    }
+
+    std::vector<Value> roots;
+    roots.reserve(values.roots.size());
+    for (const auto& slot : values.roots) {
+        roots.push_back(resolve(slot));
+    }
+    return roots;
+}
+
+Value VirtualMachine::runInContext(ExecutionContext& ctx,
+                                   const std::string& functionName,
+                                   std::size_t functionIndex,
+                                   const std::vector<Value>& args,
+                                   TransferredValues* transferredArgs,
+                                   bool* parked) {
+    try {
+        // canPark stays set while a parked call waits in ctx.
+        if (!parked || !ctx.canPark) {
+            ctx.modulePin = module_;
+            applyMemoryLimits(ctx, memoryLimits_);
+            ensureModuleInitialized(ctx, module_);
+            if (functionIndex == static_cast<std::size_t>(-1)) {
+                functionIndex = findFunctionIndex(functionName);
+            }
+            if (transferredArgs) {
+                pushCallFrame(ctx, module_, functionIndex, importValues(ctx, *transferredArgs));
+            } else {
+                pushCallFrame(ctx, module_, functionIndex, args);
+            }
+            ctx.canPark = parked != nullptr;
+        }
 
         while (!execute(ctx, 1000)) {
+            if (ctx.parker) {
+                *parked = true;
+                return Value::Nil();
+            }
         }
+        ctx.canPark = false;
 
         if (ctx.hasUnhandledScriptException) {
             throw ScriptThrownException(ctx.unhandledScriptExceptionValue);
@@ -4346,6 +6116,14 @@ Value VirtualMachine::runFunction(const std::string& functionName, const std::ve
     }
 }
 
+void VirtualMachine::setMemoryLimits(const MemoryLimits& limits) {
+    memoryLimits_ = limits;
+}
+
+const MemoryLimits& VirtualMachine::memoryLimits() const {
+    return memoryLimits_;
+}
+
 void VirtualMachine::runDeleteHooks(ExecutionContext& context) {
     if (context.deleteHooksRan) {
         return;
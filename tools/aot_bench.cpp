@@ -0,0 +1,109 @@
+// Runs a script with and without the native bodies that `gsc --aot-cpp` generated for it. The
+// build links the generated file for scripts/benchmark_aot.gs into this tool, so its functions
+// are registered before main() runs.
+//
+//   aot_bench [script.gs] [iterations]
+
+#include "gs/aot.hpp"
+#include "gs/runtime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef GS_AOT_BENCH_SCRIPT
+#define GS_AOT_BENCH_SCRIPT "scripts/benchmark_aot.gs"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+    double millis{0.0};
+    gs::Value result;
+};
+
+// Each run loads the script into a fresh runtime, so every function is linked on its first call
+// under the current setting.
+bool runOnce(const std::string& path, Sample& sample) {
+    gs::Runtime runtime;
+    runtime.setDumpTransformedSource(false);
+    if (!runtime.loadSourceFile(path)) {
+        std::cerr << "Failed to load " << path << ": " << runtime.lastError() << "\n";
+        return false;
+    }
+    const auto start = Clock::now();
+    sample.result = runtime.call("main");
+    sample.millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return true;
+}
+
+bool sameResult(const gs::Value& lhs, const gs::Value& rhs) {
+    return lhs.valueType() == rhs.valueType() && lhs.rawPayload() == rhs.rawPayload();
+}
+
+double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : GS_AOT_BENCH_SCRIPT;
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+    if (gs::registeredAotFunctionCount() == 0) {
+        std::cerr << "No native functions are linked into this binary\n";
+        return 1;
+    }
+
+    try {
+        std::vector<double> interpreted;
+        std::vector<double> native;
+        gs::Value expected;
+        for (int i = 0; i < iterations; ++i) {
+            Sample sample;
+            gs::setAotFunctionsEnabled(false);
+            if (!runOnce(path, sample)) {
+                return 2;
+            }
+            interpreted.push_back(sample.millis);
+            expected = sample.result;
+
+            gs::setAotFunctionsEnabled(true);
+            if (!runOnce(path, sample)) {
+                return 2;
+            }
+            native.push_back(sample.millis);
+            if (!sameResult(expected, sample.result)) {
+                std::cerr << "Result mismatch: interpreter " << expected << ", native " << sample.result << "\n";
+                return 3;
+            }
+        }
+        if (gs::linkedAotFunctionCount() == 0) {
+            std::cerr << "No function of " << path << " matched a native body; regenerate it with gsc --aot-cpp\n";
+            return 4;
+        }
+
+        const double interpretedMs = median(interpreted);
+        const double nativeMs = median(native);
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "script:       " << path << "\n"
+                  << "native:       " << gs::registeredAotFunctionCount() << " registered, "
+                  << gs::linkedAotFunctionCount() / static_cast<std::size_t>(iterations) << " linked per run\n"
+                  << "iterations:   " << iterations << " (median)\n"
+                  << "result:       " << expected << "\n\n";
+        std::cout << "mode            main() (ms)\n";
+        std::cout << "interpreter     " << std::setw(11) << interpretedMs << "\n";
+        std::cout << "native          " << std::setw(11) << nativeMs << "   (" << interpretedMs / nativeMs << "x)\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Channel pipelines: runs pipeline() of scripts/benchmark_channels.gs, with more producer tasks
+// than pool threads, against the same work in one loop, and reports the cost per message.
+// Blocked stages park, so a small buffer does not stall the pool.
+//
+//   channel_bench [script.gs] [producers] [messages per producer]
+
+#include "gs/runtime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef GS_PROJECT_ROOT
+#define GS_PROJECT_ROOT "."
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double medianMillis(gs::Runtime& runtime,
+                    const std::string& function,
+                    const std::vector<gs::Value>& args,
+                    std::int64_t expected) {
+    std::vector<double> samples;
+    for (int i = 0; i < 5; ++i) {
+        const auto start = Clock::now();
+        const gs::Value result = runtime.call(function, args);
+        samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        if (result.asInt() != expected) {
+            throw std::runtime_error(function + " returned " + std::to_string(result.asInt()) + ", expected " +
+                                     std::to_string(expected));
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : GS_PROJECT_ROOT "/scripts/benchmark_channels.gs";
+    const std::int64_t producers = argc > 2 ? std::max(1, std::atoi(argv[2])) : 16;
+    const std::int64_t perProducer = argc > 3 ? std::max(1, std::atoi(argv[3])) : 2000;
+
+    try {
+        gs::Runtime runtime;
+        runtime.setDumpTransformedSource(false);
+        if (!runtime.loadSourceFile(path)) {
+            std::cerr << "Failed to load " << path << ": " << runtime.lastError() << "\n";
+            return 1;
+        }
+
+        const std::vector<gs::Value> sizes{gs::Value::Int(producers), gs::Value::Int(perProducer)};
+        const std::int64_t expected = runtime.call("direct", sizes).asInt();
+        const double directMs = medianMillis(runtime, "direct", sizes, expected);
+        const double messages = static_cast<double>(producers * perProducer);
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "script:    " << path << "\n"
+                  << "pipeline:  " << producers << " producers x " << perProducer
+                  << " messages, 3 stages (median of 5)\n\n";
+        std::cout << "mode                  ms     us/message\n";
+        std::cout << "direct loop    " << std::setw(10) << directMs << std::setw(12) << directMs * 1000.0 / messages
+                  << "\n";
+        for (const std::int64_t capacity : {1, 16, 256}) {
+            const double ms = medianMillis(runtime,
+                                           "pipeline",
+                                           {gs::Value::Int(producers), gs::Value::Int(perProducer),
+                                            gs::Value::Int(capacity)},
+                                           expected);
+            std::cout << "capacity " << std::left << std::setw(6) << capacity << std::right << std::setw(10) << ms
+                      << std::setw(12) << ms * 1000.0 / messages << "\n";
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+// Compares bytecode load time of the GSBC2 text format and the GSBC3 binary image, after
+// checking that both round-trip and that corrupt GSBC3 images are rejected.
+//
+//   gsbc_load_bench <input.gs> [iterations]
+//   gsbc_load_bench --synthetic <functionCount> [iterations]
+
+#include "gs/bytecode_image.hpp"
+#include "gs/compiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool writeAll(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary);
+    out << bytes;
+    return static_cast<bool>(out);
+}
+
+std::string readAll(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+std::string syntheticSource(std::size_t functionCount) {
+    std::ostringstream src;
+    for (std::size_t i = 0; i < functionCount; ++i) {
+        src << "fn f" << i << "(a, b) {\n"
+            << "    let total = 0;\n"
+            << "    let label = \"fn" << i << "\";\n"
+            << "    for (k in range(0, a)) {\n"
+            << "        if (k % 3 == 0) {\n"
+            << "            total = total + k * b;\n"
+            << "        } else {\n"
+            << "            total = total - " << i << ";\n"
+            << "        }\n"
+            << "    }\n"
+            << "    let items = [a, b, total, label];\n"
+            << "    return items[2] + items.length;\n"
+            << "}\n";
+    }
+    src << "fn main() {\n    return f0(10, 2);\n}\n";
+    return src.str();
+}
+
+bool sameInstructions(const gs::FunctionBytecode& lhs, const gs::FunctionBytecode& rhs) {
+    if (lhs.code.size() != rhs.code.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.code.size(); ++i) {
+        const auto& a = lhs.code[i];
+        const auto& b = rhs.code[i];
+        if (a.op != b.op || a.aSlotType != b.aSlotType || a.a != b.a || a.bSlotType != b.bSlotType ||
+            a.b != b.b || a.line != b.line || a.column != b.column) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sameModule(const gs::Module& expected, const gs::Module& actual) {
+    if (expected.constants.size() != actual.constants.size() || expected.strings != actual.strings ||
+        expected.functions.size() != actual.functions.size() || expected.classes.size() != actual.classes.size() ||
+        expected.globals.size() != actual.globals.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < expected.constants.size(); ++i) {
+        if (expected.constants[i].valueType() != actual.constants[i].valueType() ||
+            expected.constants[i].rawPayload() != actual.constants[i].rawPayload()) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < expected.functions.size(); ++i) {
+        const auto& a = expected.functions[i];
+        const auto& b = actual.functions[i];
+        if (a.name != b.name || a.params != b.params || a.paramTypeNames != b.paramTypeNames ||
+            a.localTypeNames != b.localTypeNames || a.localCount != b.localCount ||
+            a.stackSlotCount != b.stackSlotCount || a.nonEscapingAllocSites != b.nonEscapingAllocSites ||
+            !sameInstructions(a, b)) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < expected.classes.size(); ++i) {
+        const auto& a = expected.classes[i];
+        const auto& b = actual.classes[i];
+        if (a.name != b.name || a.baseClassIndex != b.baseClassIndex || a.baseNativeTypeName != b.baseNativeTypeName ||
+            a.attributes.size() != b.attributes.size() || a.methods.size() != b.methods.size()) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < expected.globals.size(); ++i) {
+        if (expected.globals[i].name != actual.globals[i].name ||
+            expected.globals[i].declaredTypeName != actual.globals[i].declaredTypeName) {
+            return false;
+        }
+    }
+    if (expected.imports.size() != actual.imports.size() ||
+        expected.importSymbols.size() != actual.importSymbols.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < expected.imports.size(); ++i) {
+        const auto& a = expected.imports[i];
+        const auto& b = actual.imports[i];
+        if (a.moduleSpec != b.moduleSpec || a.localName != b.localName || a.symbols != b.symbols ||
+            a.bindsSymbol != b.bindsSymbol) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < expected.importSymbols.size(); ++i) {
+        if (expected.importSymbols[i].importIndex != actual.importSymbols[i].importIndex ||
+            expected.importSymbols[i].name != actual.importSymbols[i].name) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Loading `bytes` must fail with the loader's validation error rather than succeed or crash.
+bool rejectsImage(const std::string& bytes, const char* what) {
+    try {
+        gs::Module m = gs::loadModuleImage(gs::BytecodeImage::fromBytes(bytes));
+        gs::decodeAllFunctionBodies(m);
+    } catch (const std::exception& ex) {
+        if (std::string(ex.what()).rfind("Invalid GSBC3 image", 0) == 0) {
+            return true;
+        }
+        std::cerr << what << ": unexpected error: " << ex.what() << "\n";
+        return false;
+    }
+    std::cerr << what << ": corrupt image loaded\n";
+    return false;
+}
+
+// Truncated files and records with out-of-range types or indices.
+bool rejectsCorruptImages(const gs::Module& module) {
+    const std::string image = gs::serializeModuleBinary(module);
+    bool ok = rejectsImage(image.substr(0, image.size() / 2), "truncated image");
+
+    gs::Module badValue = module;
+    badValue.constants.push_back(gs::Value::FromRaw(gs::ValueType::Ref, 0x1000));
+    ok = rejectsImage(gs::serializeModuleBinary(badValue), "reference constant") && ok;
+
+    gs::Module badString = module;
+    badString.constants.push_back(gs::Value::FromRaw(gs::ValueType::String, 1 << 30));
+    ok = rejectsImage(gs::serializeModuleBinary(badString), "string constant index") && ok;
+
+    gs::Module badOpcode = module;
+    badOpcode.functions.back().code.front().op = static_cast<gs::OpCode>(0xff);
+    ok = rejectsImage(gs::serializeModuleBinary(badOpcode), "opcode") && ok;
+
+    gs::Module badClass = module;
+    badClass.classes.emplace_back();
+    badClass.classes.back().baseClassIndex = 7;
+    ok = rejectsImage(gs::serializeModuleBinary(badClass), "base class index") && ok;
+
+    gs::Module badMethod = module;
+    badMethod.classes.emplace_back();
+    badMethod.classes.back().methods.push_back({"m", module.functions.size()});
+    ok = rejectsImage(gs::serializeModuleBinary(badMethod), "method function index") && ok;
+    return ok;
+}
+
+// Median wall time of `iterations` runs, in microseconds.
+double medianMicros(int iterations, const std::function<void()>& run) {
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(iterations));
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = Clock::now();
+        run();
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2 || (std::string(argv[1]) == "--synthetic" && argc < 3)) {
+        std::cerr << "Usage: gsbc_load_bench <input.gs> [iterations]\n"
+                  << "       gsbc_load_bench --synthetic <functionCount> [iterations]\n";
+        return 1;
+    }
+
+    try {
+        const bool synthetic = std::string(argv[1]) == "--synthetic";
+        const int iterArg = synthetic ? 3 : 2;
+        const int iterations = argc > iterArg ? std::max(1, std::atoi(argv[iterArg])) : 20;
+
+        gs::Module module = synthetic ? gs::compileSource(syntheticSource(std::stoul(argv[2])))
+                                      : gs::compileSourceFile(argv[1]);
+
+        const auto dir = std::filesystem::temp_directory_path();
+        const std::string textPath = (dir / "gsbc_load_bench.gsbc2").string();
+        const std::string binaryPath = (dir / "gsbc_load_bench.gsbc3").string();
+        if (!writeAll(textPath, gs::serializeModuleText(module)) ||
+            !writeAll(binaryPath, gs::serializeModuleBinary(module))) {
+            std::cerr << "Failed to write temporary bytecode files in " << dir << "\n";
+            return 3;
+        }
+
+        // GSBC2 does not carry allocation-site metadata, so compare it without that field.
+        gs::Module withoutSites = module;
+        for (auto& fn : withoutSites.functions) {
+            fn.nonEscapingAllocSites.clear();
+        }
+        gs::Module fromText = gs::deserializeModuleText(readAll(textPath));
+        gs::Module fromImage = gs::loadBytecodeModule(binaryPath);
+        gs::decodeAllFunctionBodies(fromImage);
+        if (!sameModule(withoutSites, fromText) || !sameModule(module, fromImage)) {
+            std::cerr << "Round-trip mismatch\n";
+            return 2;
+        }
+        if (!rejectsCorruptImages(module)) {
+            return 2;
+        }
+
+        std::size_t instructionCount = 0;
+        for (const auto& fn : module.functions) {
+            instructionCount += fn.code.size();
+        }
+
+        const double textLoad = medianMicros(iterations, [&] {
+            gs::Module m = gs::deserializeModuleText(readAll(textPath));
+            (void)m;
+        });
+        const double imageLoad = medianMicros(iterations, [&] {
+            gs::Module m = gs::loadBytecodeModule(binaryPath);
+            gs::ensureFunctionDecoded(m, m.functions.back());
+        });
+        const double imageFull = medianMicros(iterations, [&] {
+            gs::Module m = gs::loadBytecodeModule(binaryPath);
+            gs::decodeAllFunctionBodies(m);
+        });
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "functions:    " << module.functions.size() << "\n"
+                  << "instructions: " << instructionCount << "\n"
+                  << "iterations:   " << iterations << " (median)\n\n";
+        std::cout << "format                         size (KB)   load (us)\n";
+        std::cout << "GSBC2 text                     " << std::setw(9)
+                  << std::filesystem::file_size(textPath) / 1024.0 << "   " << std::setw(9) << textLoad << "\n";
+        std::cout << "GSBC3 image (call main only)   " << std::setw(9)
+                  << std::filesystem::file_size(binaryPath) / 1024.0 << "   " << std::setw(9) << imageLoad << "\n";
+        std::cout << "GSBC3 image (decode all)       " << std::setw(9)
+                  << std::filesystem::file_size(binaryPath) / 1024.0 << "   " << std::setw(9) << imageFull << "\n";
+
+        std::filesystem::remove(textPath);
+        std::filesystem::remove(binaryPath);
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
@@ -1,8 +1,15 @@
+#include "gs/bytecode_image.hpp"
+#include "gs/compile_cache.hpp"
 #include "gs/compiler.hpp"
+#include "gs/thread_pool.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <thread>
 
 namespace {
 
@@ -15,26 +22,125 @@ bool writeAll(const std::string& path, const std::string& text) {
     return static_cast<bool>(out);
 }
 
+void printUsage() {
+    std::cerr << "Usage: gsc <input.gs> <output.gsbc> [--text] [--cache-dir <dir>] [--aot-cpp <output.cpp>]\n"
+              << "       gsc --batch <outDir> <input.gs>... [--jobs <n>] [--text] [--cache-dir <dir>]\n"
+              << "  --batch      compile the inputs and every script they import in parallel; each module\n"
+              << "               is written to <outDir>/<path relative to the working directory>.gsbc\n"
+              << "  --jobs       worker threads for --batch (default: hardware concurrency)\n"
+              << "  --text       write the legacy GSBC2 text format instead of the binary GSBC3 image\n"
+              << "  --cache-dir  reuse/populate a compile cache (default: $GS_COMPILE_CACHE_DIR)\n";
+}
+
+std::filesystem::path batchOutputPath(const std::filesystem::path& outDir, const std::string& sourcePath) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path relative = fs::relative(sourcePath, fs::current_path(), ec);
+    if (ec || relative.empty() || *relative.begin() == "..") {
+        relative = fs::path(sourcePath).filename();
+    }
+    relative.replace_extension(".gsbc");
+    return outDir / relative;
+}
+
+int runBatch(int argc, char** argv) {
+    namespace fs = std::filesystem;
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    const fs::path outDir = argv[2];
+    std::vector<std::string> inputs;
+    std::size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+    bool textFormat = false;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--text") {
+            textFormat = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            gs::setCompileCacheDirectory(argv[++i]);
+        } else if (arg.starts_with("--")) {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<gs::CompiledModule> results;
+    {
+        gs::ThreadPool pool(jobs);
+        results = gs::compileModuleGraph(inputs, pool);
+    }
+
+    std::size_t failed = 0;
+    for (const auto& result : results) {
+        if (!result.module) {
+            ++failed;
+            std::cerr << "Compile failed: " << result.error << "\n";
+            continue;
+        }
+        const fs::path outPath = batchOutputPath(outDir, result.path);
+        std::error_code ec;
+        fs::create_directories(outPath.parent_path(), ec);
+        const std::string bytecode =
+            textFormat ? gs::serializeModuleText(*result.module) : gs::serializeModuleBinary(*result.module);
+        if (!writeAll(outPath.string(), bytecode)) {
+            ++failed;
+            std::cerr << "Failed to write bytecode file: " << outPath.string() << "\n";
+        }
+    }
+
+    const auto elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Compiled " << (results.size() - failed) << "/" << results.size() << " modules with " << jobs
+              << " workers in " << elapsedMs << " ms\n";
+    return failed == 0 ? 0 : 10;
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
+    if (argc >= 2 && std::string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
     if (argc < 3) {
-        std::cerr << "Usage: gsc <input.gs> <output.gsbc> [--aot-cpp <output.cpp>]\n";
+        printUsage();
         return 1;
     }
 
     const std::string inputPath = argv[1];
     const std::string outputPath = argv[2];
+    bool textFormat = false;
+    std::string cppOut;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--text") {
+            textFormat = true;
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            gs::setCompileCacheDirectory(argv[++i]);
+        } else if (arg == "--aot-cpp" && i + 1 < argc) {
+            cppOut = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
 
     try {
         const gs::Module module = gs::compileSourceFile(inputPath);
-        if (!writeAll(outputPath, gs::serializeModuleText(module))) {
+        const std::string bytecode =
+            textFormat ? gs::serializeModuleText(module) : gs::serializeModuleBinary(module);
+        if (!writeAll(outputPath, bytecode)) {
             std::cerr << "Failed to write bytecode file: " << outputPath << "\n";
             return 3;
         }
 
-        if (argc == 5 && std::string(argv[3]) == "--aot-cpp") {
-            const std::string cppOut = argv[4];
+        if (!cppOut.empty()) {
             if (!writeAll(cppOut, gs::generateAotCpp(module, "build_script_module"))) {
                 std::cerr << "Failed to write AOT C++ file: " << cppOut << "\n";
                 return 4;
@@ -0,0 +1,114 @@
+// Host calls while the registry changes: times call_host_tasks() of scripts/benchmark_host_bind.gs
+// with the host registry left alone, then while another thread keeps rebinding the function the
+// tasks call and binding new ones. Every binding of plugin_scale doubles its argument, so the
+// total must not change. Each binding of plugin_scale holds a token, so once the writer has
+// stopped and no script runs, one more bind must leave only the live binding holding it.
+//
+//   host_bind_bench [script.gs] [tasks] [calls per task]
+
+#include "gs/runtime.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef GS_PROJECT_ROOT
+#define GS_PROJECT_ROOT "."
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void bindScale(gs::HostRegistry& host, const std::shared_ptr<int>& token) {
+    host.bindSpan("plugin_scale", [token](gs::HostContext&, const gs::Value* args, std::size_t argc) {
+        if (argc != 1) {
+            throw std::runtime_error("plugin_scale expects 1 argument");
+        }
+        return gs::Value::Int(args[0].asInt() * 2);
+    });
+}
+
+double medianMillis(gs::Runtime& runtime, const std::vector<gs::Value>& args, std::int64_t expected) {
+    std::vector<double> samples;
+    for (int i = 0; i < 5; ++i) {
+        const auto start = Clock::now();
+        const gs::Value result = runtime.call("call_host_tasks", args);
+        samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        if (result.asInt() != expected) {
+            throw std::runtime_error("call_host_tasks returned " + std::to_string(result.asInt()) + ", expected " +
+                                     std::to_string(expected));
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : GS_PROJECT_ROOT "/scripts/benchmark_host_bind.gs";
+    const std::int64_t tasks = argc > 2 ? std::max(1, std::atoi(argv[2])) : 8;
+    const std::int64_t count = argc > 3 ? std::max(1, std::atoi(argv[3])) : 50000;
+
+    try {
+        gs::Runtime runtime;
+        runtime.setDumpTransformedSource(false);
+        const auto token = std::make_shared<int>(0);
+        bindScale(runtime.host(), token);
+        if (!runtime.loadSourceFile(path)) {
+            std::cerr << "Failed to load " << path << ": " << runtime.lastError() << "\n";
+            return 1;
+        }
+
+        const std::vector<gs::Value> args{gs::Value::Int(tasks), gs::Value::Int(count)};
+        const std::int64_t expected = tasks * count * (count - 1);
+        const double quiet = medianMillis(runtime, args, expected);
+
+        std::atomic<bool> stop{false};
+        std::int64_t binds = 0;
+        std::thread writer([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                bindScale(runtime.host(), token);
+                runtime.host().bind("plugin_" + std::to_string(binds % 512),
+                                    [](gs::HostContext&, const std::vector<gs::Value>&) { return gs::Value::Nil(); });
+                binds += 2;
+                std::this_thread::yield();
+            }
+        });
+        double busy = 0.0;
+        try {
+            busy = medianMillis(runtime, args, expected);
+        } catch (...) {
+            stop.store(true);
+            writer.join();
+            throw;
+        }
+        stop.store(true);
+        writer.join();
+        bindScale(runtime.host(), token);
+        if (token.use_count() != 2) {
+            throw std::runtime_error("replaced host functions still held: " + std::to_string(token.use_count() - 2));
+        }
+
+        const double calls = static_cast<double>(tasks * count);
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "script:   " << path << "\n"
+                  << "calls:    " << tasks << " tasks x " << count << " host calls (median of 5)\n\n";
+        std::cout << "registry unchanged   " << std::setw(10) << quiet << " ms " << std::setw(8)
+                  << quiet * 1e6 / calls << " ns/call\n";
+        std::cout << "binding concurrently " << std::setw(10) << busy << " ms " << std::setw(8)
+                  << busy * 1e6 / calls << " ns/call (" << binds << " binds)\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
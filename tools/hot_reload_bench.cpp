@@ -0,0 +1,297 @@
+// Checks that Runtime::hotReloadSource patches a running module in place and that
+// Runtime::watchSources recompiles edited files in the background, then compares the latency of
+// a hot reload with a full reload after editing one function of a large module.
+//
+//   hot_reload_bench [functionCount] [iterations]
+
+#include "gs/runtime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool writeAll(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+    return static_cast<bool>(out);
+}
+
+// main() runs across the reload: its own frame keeps the first revision's code, while the
+// calls it makes afterwards reach the second revision.
+constexpr const char* kLiveBefore = R"(let frames = 0;
+
+class Unit {
+    hp = 100;
+    speed = 1;
+
+    fn __new__(self, hp) {
+        self.hp = hp;
+    }
+
+    fn tick(self) {
+        return self.hp - self.speed;
+    }
+}
+
+fn damage() {
+    return 10;
+}
+
+fn main() {
+    let unit = Unit(50);
+    frames = 7;
+    assert(damage() == 10 && unit.tick() == 49, "first revision");
+    reload();
+    assert(frames == 7, "global kept across the reload");
+    return damage() * 1000000 + unit.tick() * 1000 + report(unit);
+}
+)";
+
+constexpr const char* kLiveAfter = R"(let frames = 0;
+
+class Unit {
+    hp = 100;
+    armor = 3;
+
+    fn __new__(self, hp) {
+        self.hp = hp;
+    }
+
+    fn tick(self) {
+        return self.hp - self.armor;
+    }
+}
+
+fn damage() {
+    return 20;
+}
+
+fn report(unit) {
+    return unit.hp + unit.armor;
+}
+
+fn main() {
+    let unit = Unit(50);
+    frames = 7;
+    assert(damage() == 10 && unit.tick() == 49, "first revision");
+    reload();
+    assert(frames == 7, "global kept across the reload");
+    return damage() * 1000000 + unit.tick() * 1000 + report(unit);
+}
+)";
+
+int checkLiveReload(const std::string& path) {
+    gs::Runtime runtime;
+    runtime.setDumpTransformedSource(false);
+    bool reloaded = false;
+    runtime.host().bind("reload", [&](gs::HostContext&, const std::vector<gs::Value>&) {
+        if (!reloaded) {
+            reloaded = writeAll(path, kLiveAfter) && runtime.hotReloadSource(path);
+        }
+        return gs::Value::Bool(reloaded);
+    });
+
+    if (!writeAll(path, kLiveBefore) || !runtime.loadSourceFile(path)) {
+        std::cerr << "Failed to load live-reload script: " << runtime.lastError() << "\n";
+        return 1;
+    }
+    const gs::Value result = runtime.call("main");
+    const auto& patch = runtime.lastHotReload();
+    // damage() = 20, tick() = 50 - 3 on the migrated instance, report() added by the reload.
+    if (!reloaded || !patch.patched || !result.isInt() || result.asInt() != 20047053) {
+        std::cerr << "Live reload mismatch: result " << result << ", patched " << patch.patched << " ("
+                  << patch.reason << ") " << runtime.lastError() << "\n";
+        return 1;
+    }
+    std::cout << "live reload:  " << patch.functionsReplaced << " replaced, " << patch.functionsAdded
+              << " added, " << patch.classesReshaped << " class reshaped; main() -> " << result << "\n\n";
+    return 0;
+}
+
+// Polls until `done` holds or five seconds pass; returns the wait in milliseconds, or -1.
+double waitFor(const std::function<bool()>& done) {
+    const auto start = Clock::now();
+    while (!done()) {
+        if (Clock::now() - start > std::chrono::seconds(5)) {
+            return -1.0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Edits the entry and an imported module while watchSources() is on. Imports resolve against
+// the working directory, so the scripts live in their own directory and the check runs there.
+int checkBackgroundReload(const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir);
+    const auto previousDir = std::filesystem::current_path();
+    std::filesystem::current_path(dir);
+    const std::string entryPath = (dir / "watch_main.gs").string();
+    const std::string depPath = (dir / "watch_dep.gs").string();
+    auto entrySource = [](int bonus) {
+        return "import watch_dep as dep;\n\nfn main() {\n    return dep.value() * 10 + " + std::to_string(bonus) + ";\n}\n";
+    };
+    auto depSource = [](int value) {
+        return "fn value() {\n    let v = " + std::to_string(value) + ";\n    return v;\n}\n";
+    };
+
+    gs::Runtime runtime;
+    runtime.setDumpTransformedSource(false);
+    gs::ScriptWatcherOptions options;
+    options.pollInterval = std::chrono::milliseconds(50);
+    int failed = 0;
+    auto expect = [&](bool ok, const std::string& what) {
+        if (!ok && failed == 0) {
+            std::cerr << "Background reload: " << what << " (" << runtime.lastError() << ")\n";
+            failed = 4;
+        }
+        return ok;
+    };
+    auto mainResult = [&]() {
+        const gs::Value result = runtime.call("main");
+        return result.isInt() ? result.asInt() : -1;
+    };
+
+    if (expect(writeAll(depPath, depSource(4)) && writeAll(entryPath, entrySource(1)) &&
+                   runtime.loadSourceFile(entryPath) && runtime.watchSources(options),
+               "load") &&
+        expect(mainResult() == 41, "first revision")) {
+        // The entry is watched from the start; the imported file once the first compile is done.
+        writeAll(entryPath, entrySource(2));
+        const double entryMs = waitFor([&] { return runtime.sourceRevision() == 1; });
+        expect(entryMs >= 0 && mainResult() == 42, "entry edit");
+
+        writeAll(depPath, depSource(15));
+        const double depMs = waitFor([&] { return runtime.sourceRevision() == 2; });
+        expect(depMs >= 0 && mainResult() == 152, "imported module edit");
+
+        writeAll(depPath, "fn value( {\n");
+        expect(waitFor([&] { return !runtime.lastError().empty(); }) >= 0 && mainResult() == 152,
+               "compile error keeps the previous module");
+
+        writeAll(depPath, depSource(6));
+        expect(waitFor([&] { return runtime.sourceRevision() == 3; }) >= 0 && runtime.lastError().empty() &&
+                   mainResult() == 62,
+               "fixed revision");
+        if (failed == 0) {
+            std::cout << std::fixed << std::setprecision(1) << "background reload: entry published after " << entryMs
+                      << " ms, imported module after " << depMs << " ms\n\n";
+        }
+    }
+    runtime.stopWatchingSources();
+    std::filesystem::current_path(previousDir);
+    std::filesystem::remove_all(dir);
+    return failed;
+}
+
+std::string syntheticSource(std::size_t functionCount, std::size_t revision) {
+    std::ostringstream src;
+    for (std::size_t i = 0; i < functionCount; ++i) {
+        src << "fn f" << i << "(a, b) {\n"
+            << "    let total = 0;\n"
+            << "    for (k in range(0, a)) {\n"
+            << "        if (k % 3 == 0) {\n"
+            << "            total = total + k * b;\n"
+            << "        } else {\n"
+            << "            total = total - " << (i == 0 ? revision : i) << ";\n"
+            << "        }\n"
+            << "    }\n"
+            << "    return total;\n"
+            << "}\n";
+    }
+    src << "fn main() {\n    let total = 0;\n";
+    for (std::size_t i = 0; i < functionCount; ++i) {
+        src << "    total = total + f" << i << "(4, 2);\n";
+    }
+    src << "    return total;\n}\n";
+    return src.str();
+}
+
+double medianMillis(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t functionCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000;
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string livePath = (dir / "hot_reload_live.gs").string();
+    const std::string benchPath = (dir / "hot_reload_bench.gs").string();
+
+    try {
+        if (const int failed = checkLiveReload(livePath)) {
+            return failed;
+        }
+        if (const int failed = checkBackgroundReload(dir / "hot_reload_watch")) {
+            return failed;
+        }
+
+        gs::Runtime runtime;
+        runtime.setDumpTransformedSource(false);
+        if (!writeAll(benchPath, syntheticSource(functionCount, 1)) || !runtime.loadSourceFile(benchPath)) {
+            std::cerr << "Failed to load benchmark script: " << runtime.lastError() << "\n";
+            return 2;
+        }
+        runtime.call("main");
+
+        // Each sample edits f0, reloads, and runs main(), which calls every function once.
+        std::size_t revision = 1;
+        auto sample = [&](const std::function<bool()>& reload, std::vector<double>& reloadMs, std::vector<double>& totalMs) {
+            if (!writeAll(benchPath, syntheticSource(functionCount, ++revision))) {
+                return false;
+            }
+            const auto start = Clock::now();
+            if (!reload()) {
+                return false;
+            }
+            const auto reloaded = Clock::now();
+            runtime.call("main");
+            const auto done = Clock::now();
+            reloadMs.push_back(std::chrono::duration<double, std::milli>(reloaded - start).count());
+            totalMs.push_back(std::chrono::duration<double, std::milli>(done - start).count());
+            return true;
+        };
+
+        std::vector<double> fullReload, fullTotal, hotReload, hotTotal;
+        for (int i = 0; i < iterations; ++i) {
+            if (!sample([&] { return runtime.loadSourceFile(benchPath); }, fullReload, fullTotal) ||
+                !sample([&] { return runtime.hotReloadSource(benchPath) && runtime.lastHotReload().patched; },
+                        hotReload,
+                        hotTotal)) {
+                std::cerr << "Reload failed: " << runtime.lastError() << runtime.lastHotReload().reason << "\n";
+                return 3;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "functions:    " << functionCount + 1 << " (one edited per reload)\n"
+                  << "iterations:   " << iterations << " (median)\n\n";
+        std::cout << "mode            reload (ms)   reload + main() (ms)\n";
+        std::cout << "full reload     " << std::setw(11) << medianMillis(fullReload) << "   " << std::setw(20)
+                  << medianMillis(fullTotal) << "\n";
+        std::cout << "hot reload      " << std::setw(11) << medianMillis(hotReload) << "   " << std::setw(20)
+                  << medianMillis(hotTotal) << "\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    std::filesystem::remove(livePath);
+    std::filesystem::remove(benchPath);
+    return 0;
+}
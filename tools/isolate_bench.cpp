@@ -0,0 +1,139 @@
+// Many isolates on one Runtime: runs scripts/benchmark_isolates.gs as player sandboxes, each
+// with its own globals, and checks that a sandbox stuck in a long call does not hold up the
+// others.
+//
+//   isolate_bench [script.gs] [isolates] [ticks]
+
+#include "gs/runtime.hpp"
+#include "gs/type_system/string_type.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef GS_PROJECT_ROOT
+#define GS_PROJECT_ROOT "."
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : GS_PROJECT_ROOT "/scripts/benchmark_isolates.gs";
+    const std::size_t count = argc > 2 ? static_cast<std::size_t>(std::max(1, std::atoi(argv[2]))) : 1000;
+    const std::int64_t ticks = argc > 3 ? std::max(1, std::atoi(argv[3])) : 10;
+    constexpr std::int64_t kTickWork = 100;
+
+    try {
+        gs::Runtime runtime;
+        runtime.setDumpTransformedSource(false);
+        if (!runtime.loadSourceFile(path)) {
+            std::cerr << "Failed to load " << path << ": " << runtime.lastError() << "\n";
+            return 1;
+        }
+
+        auto start = Clock::now();
+        std::vector<std::shared_ptr<gs::Isolate>> sandboxes;
+        for (std::size_t i = 0; i < count; ++i) {
+            sandboxes.push_back(runtime.createIsolate());
+        }
+        const double createMs = millisSince(start);
+
+        start = Clock::now();
+        std::vector<std::future<gs::TransferredValues>> last(count);
+        for (std::int64_t t = 0; t < ticks; ++t) {
+            for (std::size_t i = 0; i < count; ++i) {
+                last[i] = sandboxes[i]->post("tick", {gs::Value::Int(kTickWork)});
+            }
+        }
+        runtime.isolates().waitIdle();
+        const double tickMs = millisSince(start);
+        for (auto& result : last) {
+            // Every sandbox counted its own ticks in its own globals.
+            expect(result.get().value().asInt() == ticks, "a sandbox saw another sandbox's ticks");
+        }
+
+        // One sandbox spins while the others keep ticking; their calls finish long before it does.
+        const std::int64_t spinSteps = 2000000;
+        start = Clock::now();
+        auto spinning = sandboxes[0]->post("spin", {gs::Value::Int(spinSteps)});
+        std::vector<std::future<gs::TransferredValues>> quick;
+        for (std::size_t i = 1; i < std::min<std::size_t>(count, 101); ++i) {
+            quick.push_back(sandboxes[i]->post("tick", {gs::Value::Int(kTickWork)}));
+        }
+        for (auto& result : quick) {
+            result.wait();
+        }
+        const double quickMs = millisSince(start);
+        expect(spinning.get().value().asInt() == spinSteps, "spin returned the wrong count");
+        const double spinMs = millisSince(start);
+
+        // A script exception fails its call only; the sandbox keeps its state.
+        bool failed = false;
+        try {
+            sandboxes[1]->call("fail");
+        } catch (const std::exception&) {
+            failed = true;
+        }
+        expect(failed, "fail() did not report its exception");
+        expect(sandboxes[1]->call("tick", {gs::Value::Int(1)}).value().asInt() == ticks + 2, "a failed call lost state");
+
+        // Arguments and results are copied between heaps: the first result stays readable while
+        // the next call already runs on the sandbox.
+        const auto listOf = [](std::int64_t first, std::int64_t second) {
+            gs::TransferredValues packet;
+            packet.nodes.push_back(gs::TransferredValues::Node{
+                gs::TransferredValues::NodeKind::List,
+                nullptr,
+                {gs::TransferredValues::Slot{gs::Value::Int(first)}, gs::TransferredValues::Slot{gs::Value::Int(second)}}});
+            packet.roots.push_back(gs::TransferredValues::Slot{gs::Value::Nil(), 0});
+            return packet;
+        };
+        auto firstSummary = sandboxes[0]->post("remember", listOf(1, 2));
+        auto secondSummary = sandboxes[0]->post("remember", listOf(3, 4));
+        secondSummary.wait();
+        const gs::TransferredValues summary = firstSummary.get();
+        const auto* text = dynamic_cast<const gs::StringObject*>(summary.value().asRef());
+        expect(text && text->data() == "seen 2", "a result did not survive the next call");
+        bool refused = false;
+        try {
+            sandboxes[0]->post("remember", {summary.value()});
+        } catch (const std::exception&) {
+            refused = true;
+        }
+        expect(refused, "an object was passed to an isolate as a Value");
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "script:    " << path << "\n"
+                  << "isolates:  " << count << ", " << ticks << " ticks each, slices of "
+                  << runtime.isolates().sliceSteps() << " steps\n\n";
+        std::cout << "create                " << std::setw(10) << createMs * 1000.0 / static_cast<double>(count)
+                  << " us/isolate\n";
+        std::cout << "tick                  " << std::setw(10)
+                  << tickMs * 1000.0 / static_cast<double>(count * static_cast<std::size_t>(ticks)) << " us/call\n";
+        std::cout << "100 ticks beside spin " << std::setw(10) << quickMs << " ms (spin took " << spinMs << " ms)\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
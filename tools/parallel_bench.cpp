@@ -0,0 +1,69 @@
+// parallel.map against a serial loop: times update_serial() and update_parallel() of
+// scripts/benchmark_parallel.gs over the same agents.
+//
+//   parallel_bench [script.gs] [agents]
+
+#include "gs/runtime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef GS_PROJECT_ROOT
+#define GS_PROJECT_ROOT "."
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double medianMillis(gs::Runtime& runtime, const std::string& function, std::int64_t count, const gs::Value& expected) {
+    std::vector<double> samples;
+    for (int i = 0; i < 5; ++i) {
+        const auto start = Clock::now();
+        const gs::Value result = runtime.call(function, {gs::Value::Int(count)});
+        samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        if (result.valueType() != expected.valueType() || result.rawPayload() != expected.rawPayload()) {
+            throw std::runtime_error(function + " returned " + std::to_string(result.asInt()) + ", expected " +
+                                     std::to_string(expected.asInt()));
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : GS_PROJECT_ROOT "/scripts/benchmark_parallel.gs";
+    const std::int64_t count = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5000;
+
+    try {
+        gs::Runtime runtime;
+        runtime.setDumpTransformedSource(false);
+        if (!runtime.loadSourceFile(path)) {
+            std::cerr << "Failed to load " << path << ": " << runtime.lastError() << "\n";
+            return 1;
+        }
+
+        const gs::Value expected = runtime.call("update_serial", {gs::Value::Int(count)});
+        const double serial = medianMillis(runtime, "update_serial", count, expected);
+        const double parallel = medianMillis(runtime, "update_parallel", count, expected);
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "script:   " << path << "\n"
+                  << "agents:   " << count << " (median of 5), hardware threads: "
+                  << std::thread::hardware_concurrency() << "\n\n";
+        std::cout << "update_serial     " << std::setw(10) << serial << " ms\n";
+        std::cout << "update_parallel   " << std::setw(10) << parallel << " ms   (" << serial / parallel << "x)\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
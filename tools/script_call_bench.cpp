@@ -0,0 +1,113 @@
+// Host-driven script calls: runs plan() of scripts/benchmark_script_call.gs a frame budget at a
+// time and reports how closely resume() keeps to the budget, then checks that a timeout is
+// raised as a catchable TimeoutException and that a script ignoring it is stopped.
+//
+//   script_call_bench [script.gs] [plan steps] [frame budget us]
+
+#include "gs/runtime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef GS_PROJECT_ROOT
+#define GS_PROJECT_ROOT "."
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : GS_PROJECT_ROOT "/scripts/benchmark_script_call.gs";
+    const std::int64_t steps = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000000;
+    const std::chrono::microseconds frame(argc > 3 ? std::max(1, std::atoi(argv[3])) : 2000);
+
+    try {
+        gs::Runtime runtime;
+        runtime.setDumpTransformedSource(false);
+        if (!runtime.loadSourceFile(path)) {
+            std::cerr << "Failed to load " << path << ": " << runtime.lastError() << "\n";
+            return 1;
+        }
+
+        auto start = Clock::now();
+        const gs::Value expected = runtime.call("plan", {gs::Value::Int(steps)});
+        const double blockingMs = millisSince(start);
+
+        // The same call spread over frames.
+        auto sliced = runtime.startCall("plan", {gs::Value::Int(steps)});
+        std::vector<double> frames;
+        start = Clock::now();
+        while (true) {
+            const auto frameStart = Clock::now();
+            const gs::CallStatus status = sliced->resume(gs::CallBudget{0, frame});
+            frames.push_back(millisSince(frameStart));
+            if (status != gs::CallStatus::Suspended) {
+                expect(status == gs::CallStatus::Done, "plan failed: " + sliced->error());
+                break;
+            }
+        }
+        const double slicedMs = millisSince(start);
+        expect(sliced->result().asInt() == expected.asInt(), "sliced plan returned a different result");
+        std::sort(frames.begin(), frames.end());
+
+        // A step budget suspends after exactly that many instructions.
+        auto stepped = runtime.startCall("plan", {gs::Value::Int(100)});
+        std::size_t resumes = 0;
+        while (stepped->resume(gs::CallBudget{50, {}}) == gs::CallStatus::Suspended) {
+            ++resumes;
+        }
+        expect(stepped->status() == gs::CallStatus::Done && resumes > 10, "step budget did not suspend the call");
+
+        // A timeout is raised in the script, which catches it.
+        auto caught = runtime.startCall("plan_until_timeout");
+        caught->setTimeout(std::chrono::milliseconds(20));
+        while (caught->resume(gs::CallBudget{0, frame}) == gs::CallStatus::Suspended) {
+        }
+        expect(caught->status() == gs::CallStatus::Done && caught->result().asInt() == -1,
+               "TimeoutException was not caught: " + caught->error());
+
+        // A script that swallows the timeout is stopped after the grace period.
+        auto runaway = runtime.startCall("runaway");
+        runaway->setTimeout(std::chrono::milliseconds(20));
+        start = Clock::now();
+        while (runaway->resume(gs::CallBudget{0, frame}) == gs::CallStatus::Suspended) {
+            expect(millisSince(start) < 5000.0, "runaway script was not stopped");
+        }
+        const double runawayMs = millisSince(start);
+        expect(runaway->status() == gs::CallStatus::Failed &&
+                   runaway->error().find("TimeoutException") != std::string::npos,
+               "runaway script did not fail with TimeoutException: " + runaway->error());
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "script:    " << path << "\n"
+                  << "plan:      " << steps << " steps, frame budget " << frame.count() << " us\n\n";
+        std::cout << "blocking call         " << std::setw(10) << blockingMs << " ms\n";
+        std::cout << "sliced call           " << std::setw(10) << slicedMs << " ms over " << frames.size()
+                  << " frames\n";
+        std::cout << "frame median / max    " << std::setw(10) << frames[frames.size() / 2] << " / "
+                  << frames.back() << " ms\n";
+        std::cout << "runaway stopped after " << std::setw(10) << runawayMs << " ms (timeout 20 ms)\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
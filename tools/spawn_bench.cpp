@@ -0,0 +1,76 @@
+// Per-spawn overhead: times the spawn loops of scripts/benchmark_spawn.gs against the same job
+// called directly, with spawned tasks reusing pooled VMs and with a VM built per task.
+//
+//   spawn_bench [script.gs] [spawns]
+
+#include "gs/runtime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef GS_PROJECT_ROOT
+#define GS_PROJECT_ROOT "."
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double medianMicros(gs::Runtime& runtime, const std::string& function, std::int64_t count, const gs::Value& expected) {
+    std::vector<double> samples;
+    for (int i = 0; i < 5; ++i) {
+        const auto start = Clock::now();
+        const gs::Value result = runtime.call(function, {gs::Value::Int(count)});
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        if (result.valueType() != expected.valueType() || result.rawPayload() != expected.rawPayload()) {
+            throw std::runtime_error(function + " returned " + std::to_string(result.asInt()) + ", expected " +
+                                     std::to_string(expected.asInt()));
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : GS_PROJECT_ROOT "/scripts/benchmark_spawn.gs";
+    const std::int64_t count = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20000;
+
+    try {
+        gs::Runtime runtime;
+        runtime.setDumpTransformedSource(false);
+        if (!runtime.loadSourceFile(path)) {
+            std::cerr << "Failed to load " << path << ": " << runtime.lastError() << "\n";
+            return 1;
+        }
+
+        const gs::Value expected = runtime.call("call_direct", {gs::Value::Int(count)});
+        const double direct = medianMicros(runtime, "call_direct", count, expected) / static_cast<double>(count);
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "script:   " << path << "\n"
+                  << "spawns:   " << count << " per run (median of 5)\n\n";
+        std::cout << "mode                      us/task   overhead vs call (us)\n";
+        std::cout << "direct call             " << std::setw(9) << direct << "\n";
+        for (const bool reuse : {false, true}) {
+            gs::setSpawnVmReuseEnabled(reuse);
+            for (const char* function : {"spawn_await", "spawn_batch", "spawn_await_all"}) {
+                const double perTask = medianMicros(runtime, function, count, expected) / static_cast<double>(count);
+                std::cout << std::left << std::setw(24)
+                          << std::string(function) + (reuse ? " pooled" : " fresh") << std::right << std::setw(9)
+                          << perTask << std::setw(24) << perTask - direct << "\n";
+            }
+        }
+        gs::setSpawnVmReuseEnabled(true);
+    } catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        return 10;
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Task throughput of gs::ThreadPool against the single-queue pool it replaced, at 1..N workers.
+//
+//   thread_pool_bench [tasks] [max workers]
+//
+// spawn+await   submit one task and wait for its future, from outside the pool
+// batch         submit `tasks` tasks, then wait for all of them
+// fork-join     a binary tree of tasks that submit their children from inside the pool
+
+#include "gs/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The pool as it was before the work-stealing rewrite: one locked queue of std::function jobs,
+// with a shared packaged_task per submit.
+class LockedQueuePool {
+public:
+    explicit LockedQueuePool(std::size_t workers) {
+        for (std::size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back([this]() {
+                for (;;) {
+                    std::function<void()> job;
+                    {
+                        std::unique_lock lock(mutex_);
+                        cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                        if (stop_ && jobs_.empty()) {
+                            return;
+                        }
+                        job = std::move(jobs_.front());
+                        jobs_.pop();
+                    }
+                    job();
+                }
+            });
+        }
+    }
+
+    ~LockedQueuePool() {
+        {
+            std::scoped_lock lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    template <typename F>
+    auto submit(F&& fn) -> std::future<decltype(fn())> {
+        using ReturnType = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<F>(fn));
+        std::future<ReturnType> future = task->get_future();
+        {
+            std::scoped_lock lock(mutex_);
+            jobs_.push([task]() { (*task)(); });
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_{false};
+};
+
+// A few hundred nanoseconds of work, so the numbers are not pure queue overhead.
+std::uint64_t spin(std::uint64_t seed) {
+    for (int i = 0; i < 64; ++i) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return seed;
+}
+
+template <typename Pool>
+double spawnAwait(Pool& pool, std::size_t tasks) {
+    std::uint64_t sum = 0;
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < tasks; ++i) {
+        sum += pool.submit([i]() { return spin(i); }).get();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return sum == 1 ? 0.0 : static_cast<double>(tasks) / seconds;
+}
+
+template <typename Pool>
+double batch(Pool& pool, std::size_t tasks) {
+    std::vector<std::future<std::uint64_t>> futures;
+    futures.reserve(tasks);
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < tasks; ++i) {
+        futures.push_back(pool.submit([i]() { return spin(i); }));
+    }
+    std::uint64_t sum = 0;
+    for (auto& future : futures) {
+        sum += future.get();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return sum == 1 ? 0.0 : static_cast<double>(tasks) / seconds;
+}
+
+// Each node submits its two children; the last node to finish signals the caller.
+template <typename Pool>
+struct ForkJoin {
+    Pool& pool;
+    std::atomic<std::size_t> remaining;
+    std::promise<void> done;
+
+    void node(std::size_t depth) {
+        spin(depth);
+        if (depth > 0) {
+            pool.submit([this, depth]() { node(depth - 1); });
+            pool.submit([this, depth]() { node(depth - 1); });
+        }
+        if (remaining.fetch_sub(1) == 1) {
+            done.set_value();
+        }
+    }
+};
+
+template <typename Pool>
+double forkJoin(Pool& pool, std::size_t tasks) {
+    std::size_t depth = 0;
+    while ((std::size_t{2} << (depth + 1)) - 1 <= tasks) {
+        ++depth;
+    }
+    const std::size_t nodes = (std::size_t{2} << depth) - 1;
+    ForkJoin<Pool> tree{pool, {nodes}, {}};
+    auto finished = tree.done.get_future();
+    const auto start = Clock::now();
+    pool.submit([&tree, depth]() { tree.node(depth); });
+    finished.get();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(nodes) / seconds;
+}
+
+void printRow(const char* name, std::size_t workers, double locked, double stealing) {
+    std::cout << std::left << std::setw(14) << name << std::right << std::setw(8) << workers << std::setw(14)
+              << locked / 1000.0 << std::setw(14) << stealing / 1000.0 << "   (" << stealing / locked << "x)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t tasks = argc > 1 ? static_cast<std::size_t>(std::max(1, std::atoi(argv[1]))) : 200000;
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t maxWorkers =
+        argc > 2 ? static_cast<std::size_t>(std::max(1, std::atoi(argv[2]))) : hardware;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "tasks: " << tasks << ", hardware threads: " << hardware << "\n\n";
+    std::cout << "benchmark      workers  locked k/s  stealing k/s\n";
+    std::vector<std::size_t> workerCounts;
+    for (std::size_t workers = 1; workers < maxWorkers; workers *= 2) {
+        workerCounts.push_back(workers);
+    }
+    workerCounts.push_back(maxWorkers);
+
+    for (const std::size_t workers : workerCounts) {
+        double locked[3];
+        double stealing[3];
+        {
+            LockedQueuePool pool(workers);
+            locked[0] = spawnAwait(pool, tasks / 4);
+            locked[1] = batch(pool, tasks);
+            locked[2] = forkJoin(pool, tasks);
+        }
+        {
+            gs::ThreadPool pool(workers);
+            stealing[0] = spawnAwait(pool, tasks / 4);
+            stealing[1] = batch(pool, tasks);
+            stealing[2] = forkJoin(pool, tasks);
+        }
+        printRow("spawn+await", workers, locked[0], stealing[0]);
+        printRow("batch", workers, locked[1], stealing[1]);
+        printRow("fork-join", workers, locked[2], stealing[2]);
+    }
+    return 0;
+}